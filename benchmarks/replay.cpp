@@ -0,0 +1,447 @@
+// Re-drive a stream with the appends logged by ZarrStreamSettings.capture,
+// against a local store, and report throughput and append latency.
+//
+// usage: acquire-zarr-replay CAPTURE STORE_PATH [--fast] [--synthetic]
+//                            [--max-threads N]
+//
+//   --fast         append as fast as possible instead of on the recorded
+//                  schedule
+//   --synthetic    ignore recorded payloads and append generated data
+//   --max-threads  override the recorded thread count
+
+#include "acquire.zarr.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+struct Options
+{
+    fs::path capture_path;
+    std::string store_path;
+    bool fast{ false };
+    bool synthetic{ false };
+    std::optional<unsigned int> max_threads;
+};
+
+struct Record
+{
+    std::chrono::nanoseconds t;
+    std::chrono::nanoseconds latency;
+    std::optional<std::string> key;
+    size_t bytes_in;
+    bool null_data;
+    std::optional<uint64_t> payload_offset;
+};
+
+// stream settings rebuilt from a capture, with the storage they point into
+struct ReplaySettings
+{
+    ZarrStreamSettings stream{};
+    std::vector<ZarrArraySettings> arrays;
+
+    std::deque<std::string> strings;
+    std::deque<std::vector<ZarrDimensionProperties>> dimensions;
+    std::deque<std::vector<size_t>> storage_orders;
+    std::deque<ZarrCompressionSettings> compressions;
+    std::deque<ZarrInputConversion> conversions;
+    std::deque<ZarrFrameReduction> reductions;
+    std::deque<ZarrProjection> projections;
+    std::deque<std::vector<const char*>> field_names;
+    std::deque<ZarrFrameMetadataSettings> frame_metadata;
+    std::deque<ZarrBandwidthLimit> bandwidth_limits;
+
+    const char* keep(const json& value)
+    {
+        if (value.is_null()) {
+            return nullptr;
+        }
+        return strings.emplace_back(value.get<std::string>()).c_str();
+    }
+};
+
+void
+usage(const char* program)
+{
+    std::cerr << "usage: " << program
+              << " CAPTURE STORE_PATH [--fast] [--synthetic]"
+                 " [--max-threads N]\n";
+}
+
+std::optional<Options>
+parse_options(int argc, char* argv[])
+{
+    std::vector<std::string> positional;
+    Options options;
+    for (auto i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--fast") {
+            options.fast = true;
+        } else if (arg == "--synthetic") {
+            options.synthetic = true;
+        } else if (arg == "--max-threads" && i + 1 < argc) {
+            options.max_threads = std::stoul(argv[++i]);
+        } else if (arg.starts_with("--")) {
+            return std::nullopt;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 2) {
+        return std::nullopt;
+    }
+    options.capture_path = positional[0];
+    options.store_path = positional[1];
+
+    return options;
+}
+
+void
+load_array(const json& j, ReplaySettings& settings, ZarrArraySettings& array)
+{
+    array = {};
+    array.output_key = settings.keep(j["output_key"]);
+    array.data_type = j["data_type"];
+    array.multiscale = j["multiscale"];
+    array.downsampling_method = j["downsampling_method"];
+    array.input_pixel_format = j["input_pixel_format"];
+    array.significant_bits = j["significant_bits"];
+    array.compute_statistics = j["compute_statistics"];
+    array.enable_preview = j["enable_preview"];
+    array.chunk_checksums = j["chunk_checksums"];
+    array.chunk_order = j["chunk_order"];
+
+    auto& dims = settings.dimensions.emplace_back();
+    for (const auto& dim : j["dimensions"]) {
+        dims.push_back({
+          .name = settings.keep(dim["name"]),
+          .type = dim["type"],
+          .array_size_px = dim["array_size_px"],
+          .chunk_size_px = dim["chunk_size_px"],
+          .shard_size_chunks = dim["shard_size_chunks"],
+          .unit = settings.keep(dim["unit"]),
+          .scale = dim["scale"],
+        });
+    }
+    array.dimensions = dims.data();
+    array.dimension_count = dims.size();
+
+    if (const auto& c = j["compression"]; !c.is_null()) {
+        array.compression_settings = &settings.compressions.emplace_back(
+          ZarrCompressionSettings{ .compressor = c["compressor"],
+                                   .codec = c["codec"],
+                                   .level = c["level"],
+                                   .shuffle = c["shuffle"] });
+    }
+    if (const auto& order = j["storage_dimension_order"]; !order.is_null()) {
+        array.storage_dimension_order =
+          settings.storage_orders.emplace_back(order.get<std::vector<size_t>>())
+            .data();
+    }
+    if (const auto& c = j["input_conversion"]; !c.is_null()) {
+        array.input_conversion = &settings.conversions.emplace_back(
+          ZarrInputConversion{ .data_type = c["data_type"],
+                               .scale = c["scale"],
+                               .offset = c["offset"],
+                               .right_shift = c["right_shift"] });
+    }
+    if (const auto& r = j["frame_reduction"]; !r.is_null()) {
+        array.frame_reduction = &settings.reductions.emplace_back(
+          ZarrFrameReduction{ .frame_width = r["frame_width"],
+                              .frame_height = r["frame_height"],
+                              .roi_x = r["roi_x"],
+                              .roi_y = r["roi_y"],
+                              .binning = r["binning"],
+                              .binning_method = r["binning_method"] });
+    }
+    if (const auto& p = j["projection"]; !p.is_null()) {
+        array.projection = &settings.projections.emplace_back(
+          ZarrProjection{ .dimension_name = settings.keep(p["dimension_name"]),
+                          .method = p["method"] });
+    }
+    if (const auto& m = j["frame_metadata"]; !m.is_null()) {
+        const char** names = nullptr;
+        if (const auto& n = m["field_names"]; !n.is_null()) {
+            auto& kept = settings.field_names.emplace_back();
+            for (const auto& name : n) {
+                kept.push_back(settings.keep(name));
+            }
+            names = kept.data();
+        }
+        array.frame_metadata = &settings.frame_metadata.emplace_back(
+          ZarrFrameMetadataSettings{
+            .data_type = m["data_type"],
+            .field_count = m["field_count"],
+            .field_names = names,
+            .records_per_chunk = m["records_per_chunk"],
+            .chunks_per_shard = m["chunks_per_shard"] });
+    }
+}
+
+void
+load_settings(const json& j,
+              const Options& options,
+              ReplaySettings& settings)
+{
+    if (j["s3"].get<bool>()) {
+        std::cerr << "Captured stream wrote to S3, replaying to the "
+                     "filesystem\n";
+    }
+
+    const auto& arrays = j["arrays"];
+    settings.arrays.resize(arrays.size());
+    for (auto i = 0; i < arrays.size(); ++i) {
+        load_array(arrays[i], settings, settings.arrays[i]);
+    }
+
+    auto& stream = settings.stream;
+    stream.store_path = options.store_path.c_str();
+    stream.overwrite = true;
+    stream.max_threads = options.max_threads.value_or(j["max_threads"]);
+    stream.metadata_update_interval_ms = j["metadata_update_interval_ms"];
+    stream.checkpoint_interval_ms = j["checkpoint_interval_ms"];
+    stream.consolidate_metadata = j["consolidate_metadata"];
+    stream.flush_interval_ms = j["flush_interval_ms"];
+    stream.max_region_buffer_bytes = j["max_region_buffer_bytes"];
+    stream.verify_writes = j["verify_writes"];
+    stream.calibrate = j["calibrate"];
+    stream.frame_rate_hz = j["frame_rate_hz"];
+    if (const auto& b = j["bandwidth_limit"]; !b.is_null()) {
+        stream.bandwidth_limit = &settings.bandwidth_limits.emplace_back(
+          ZarrBandwidthLimit{ .bytes_per_second = b["bytes_per_second"],
+                              .burst_bytes = b["burst_bytes"],
+                              .shared = b["shared"] });
+    }
+    stream.arrays = settings.arrays.data();
+    stream.array_count = settings.arrays.size();
+}
+
+std::vector<Record>
+load_records(std::ifstream& file)
+{
+    std::vector<Record> records;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        const auto j = json::parse(line);
+        Record record{
+            .t = std::chrono::nanoseconds(j["t_ns"].get<int64_t>()),
+            .latency = std::chrono::nanoseconds(j["latency_ns"].get<int64_t>()),
+            .bytes_in = j["bytes_in"],
+            .null_data = j.value("null_data", false),
+        };
+        if (!j["key"].is_null()) {
+            record.key = j["key"].get<std::string>();
+        }
+        if (j.contains("payload_offset")) {
+            record.payload_offset = j["payload_offset"].get<uint64_t>();
+        }
+        records.push_back(std::move(record));
+    }
+
+    return records;
+}
+
+// a gradient with a little noise, so compression has something to do
+std::vector<uint8_t>
+make_synthetic(size_t n_bytes)
+{
+    std::vector<uint8_t> data(n_bytes);
+    uint32_t state = 1;
+    for (auto i = 0; i < n_bytes; ++i) {
+        state = state * 1664525u + 1013904223u;
+        data[i] = static_cast<uint8_t>((i % 4096) / 32 + (state >> 29));
+    }
+    return data;
+}
+
+// Recorded payloads where they were sampled, the last sampled payload of the
+// same key and size between samples, and synthetic data otherwise.
+std::vector<const std::vector<uint8_t>*>
+load_payloads(const std::vector<Record>& records,
+              const fs::path& payload_path,
+              bool synthetic,
+              std::deque<std::vector<uint8_t>>& storage)
+{
+    std::ifstream file;
+    if (!synthetic && fs::exists(payload_path)) {
+        file.open(payload_path, std::ios::binary);
+    }
+
+    std::map<size_t, const std::vector<uint8_t>*> synthetic_by_size;
+    std::map<std::pair<std::string, size_t>, const std::vector<uint8_t>*>
+      recorded;
+
+    std::vector<const std::vector<uint8_t>*> payloads;
+    for (const auto& record : records) {
+        const auto key =
+          std::make_pair(record.key.value_or(""), record.bytes_in);
+
+        if (record.null_data) {
+            payloads.push_back(nullptr);
+        } else if (file.is_open() && record.payload_offset) {
+            auto& data = storage.emplace_back(record.bytes_in);
+            file.seekg(static_cast<std::streamoff>(*record.payload_offset));
+            file.read(reinterpret_cast<char*>(data.data()), data.size());
+            if (!file) {
+                throw std::runtime_error("Truncated payload file " +
+                                         payload_path.string());
+            }
+            recorded[key] = &data;
+            payloads.push_back(&data);
+        } else if (const auto it = recorded.find(key); it != recorded.end()) {
+            payloads.push_back(it->second);
+        } else {
+            auto& data = synthetic_by_size[record.bytes_in];
+            if (data == nullptr) {
+                data = &storage.emplace_back(make_synthetic(record.bytes_in));
+            }
+            payloads.push_back(data);
+        }
+    }
+
+    return payloads;
+}
+
+double
+percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::ranges::sort(values);
+    const auto i = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[i];
+}
+
+void
+print_latency(const char* label, const std::vector<double>& latency_ms)
+{
+    std::printf("%-18s p50 %9.3f ms  p99 %9.3f ms  max %9.3f ms\n",
+                label,
+                percentile(latency_ms, 0.5),
+                percentile(latency_ms, 0.99),
+                percentile(latency_ms, 1.0));
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        std::ifstream file(options->capture_path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " +
+                                     options->capture_path.string());
+        }
+
+        std::string line;
+        std::getline(file, line);
+        const auto header = json::parse(line);
+        if (header["version"] != 2) {
+            throw std::runtime_error("Unsupported capture version " +
+                                     header["version"].dump());
+        }
+
+        ReplaySettings settings;
+        load_settings(header["settings"], *options, settings);
+
+        const auto records = load_records(file);
+        std::deque<std::vector<uint8_t>> storage;
+        const auto payloads = load_payloads(
+          records,
+          options->capture_path.string() + ".payloads",
+          options->synthetic,
+          storage);
+
+        ZarrStream* stream = ZarrStream_create(&settings.stream);
+        if (stream == nullptr) {
+            throw std::runtime_error("Failed to create the stream");
+        }
+
+        std::vector<double> recorded_ms, replayed_ms;
+        double max_lag_ms = 0.0;
+        size_t total_bytes = 0, n_failed = 0;
+
+        const auto start = Clock::now();
+        for (auto i = 0; i < records.size(); ++i) {
+            const auto& record = records[i];
+            if (!options->fast) {
+                std::this_thread::sleep_until(start + record.t);
+            }
+
+            const auto* payload = payloads[i];
+            size_t bytes_out = 0;
+            const auto t0 = Clock::now();
+            const auto status =
+              ZarrStream_append(stream,
+                                payload ? payload->data() : nullptr,
+                                record.bytes_in,
+                                &bytes_out,
+                                record.key ? record.key->c_str() : nullptr);
+            const auto t1 = Clock::now();
+
+            if (status != ZarrStatusCode_Success) {
+                ++n_failed;
+            }
+            total_bytes += bytes_out;
+
+            using ms = std::chrono::duration<double, std::milli>;
+            recorded_ms.push_back(ms(record.latency).count());
+            replayed_ms.push_back(ms(t1 - t0).count());
+            if (!options->fast) {
+                max_lag_ms =
+                  std::max(max_lag_ms, ms(t0 - (start + record.t)).count());
+            }
+        }
+        ZarrStream_destroy(stream);
+        const auto elapsed =
+          std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::printf("appends            %zu (%zu failed)\n",
+                    records.size(),
+                    n_failed);
+        std::printf("bytes              %zu\n", total_bytes);
+        std::printf("elapsed            %.3f s, including close\n", elapsed);
+        std::printf("throughput         %.1f MiB/s\n",
+                    total_bytes / elapsed / (1 << 20));
+        print_latency("recorded latency", recorded_ms);
+        print_latency("replayed latency", replayed_ms);
+        if (!options->fast) {
+            std::printf("max schedule lag   %.3f ms\n", max_lag_ms);
+        }
+
+        return n_failed == 0 ? 0 : 1;
+    } catch (const std::exception& exc) {
+        std::cerr << "Replay failed: " << exc.what() << "\n";
+        return 1;
+    }
+}
@@ -35,10 +35,83 @@ extern "C"
         ZarrHCSSettings* hcs_settings; /**< Optional HCS plate settings. If
                                                non-NULL, the stream will be
                                                configured for HCS data. */
+        unsigned int
+          metadata_update_interval_ms; /**< Minimum time between intermediate
+                                          array metadata updates, in
+                                          milliseconds. Set to 0 to update on
+                                          every shard rollover. Final metadata
+                                          is always written on close. */
+        unsigned int
+          checkpoint_interval_ms; /**< Minimum time between checkpoints of the
+                                     indices of partially written shards, in
+                                     milliseconds. Set to 0 to disable. See
+                                     Zarr_recover_store. Filesystem only. */
+        bool consolidate_metadata; /**< If true, embed the metadata of every
+                                      node in the root group (and each HCS
+                                      plate) on close, so readers can open the
+                                      hierarchy with a single request. */
+        bool resume; /**< If true, continue appending to arrays already in
+                        store_path instead of starting over at index 0.
+                        Requires overwrite to be false. Filesystem only, and
+                        not supported for multiscale arrays or for arrays
+                        whose last plane was only partially written. */
+        unsigned int
+          flush_interval_ms; /**< Maximum time appended frames are held only in
+                                memory, in milliseconds, before they are
+                                flushed as with ZarrStream_flush. Set to 0 to
+                                flush only on chunk boundaries. Filesystem
+                                only. */
+        size_t max_region_buffer_bytes; /**< Memory each array may hold in
+                                           partly written chunks from
+                                           ZarrStream_write_region before the
+                                           least recently written are flushed
+                                           to storage. Set to 0 for no limit. */
+        bool verify_writes; /**< If true, re-read each shard in the
+                               background once it is finalized and check it
+                               against its index checksum and, for arrays
+                               with chunk_checksums, its chunk checksums.
+                               Mismatches are reported as stream errors,
+                               and fail the stream's finalization in
+                               ZarrStream_destroy. Filesystem only. */
+        bool calibrate; /**< If true, spend a fraction of a second at
+                           creation measuring compression throughput and
+                           write bandwidth to the store. See
+                           ZarrStream_get_calibration. */
+        double frame_rate_hz; /**< Frames expected per second to each array,
+                                 or 0 if unknown. With calibrate, a warning
+                                 is logged if this exceeds the estimated
+                                 maximum. */
+        ZarrCaptureSettings* capture; /**< Optional settings for capturing
+                                         the appends made to the stream. */
+        ZarrCooperativeSettings*
+          cooperative; /**< Optional settings for writing into a store along
+                          with other writers. Requires overwrite to be false.
+                          Filesystem only. */
+        ZarrBandwidthLimit* bandwidth_limit; /**< Optional limit on the
+                                                bandwidth of writes to the
+                                                store. */
     } ZarrStreamSettings;
 
     typedef struct ZarrStream_s ZarrStream;
 
+    /**
+     * @brief The settings for reading back an array written by a Zarr stream.
+     */
+    typedef struct ZarrReaderSettings_s
+    {
+        const char* store_path; /**< Path to the store. Filesystem path or S3
+                                   key prefix. */
+        ZarrS3Settings* s3_settings; /**< Optional S3 settings for the store. */
+        const char* array_key; /**< Key of the array in the store, e.g.,
+                                  "my/array/0". May be NULL for an array at
+                                  the root of the store. */
+        unsigned int max_threads; /**< The maximum number of threads to read
+                                     and decode chunks with. Set to 0 to use
+                                     the number of available threads. */
+    } ZarrReaderSettings;
+
+    typedef struct ZarrReader_s ZarrReader;
+
     /**
      * @brief Get the version of the Zarr API.
      * @return Semver formatted version of the Zarr API.
@@ -65,6 +138,17 @@ extern "C"
      */
     const char* Zarr_get_status_message(ZarrStatusCode code);
 
+    /**
+     * @brief Make the shards of an interrupted acquisition readable.
+     * @details Finds every array under @p store_path that was written with
+     * checkpointing enabled and did not close cleanly. Each open shard is
+     * truncated to its last checkpoint and its index is restored, and the
+     * array's append dimension is set to match. Filesystem stores only.
+     * @param store_path Path to the root of the store.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode Zarr_recover_store(const char* store_path);
+
     /**
      * @brief Allocate memory for the ZarrArraySettings array in the Zarr stream
      * settings struct.
@@ -140,6 +224,34 @@ extern "C"
      */
     void ZarrArraySettings_destroy_dimension_array(ZarrArraySettings* settings);
 
+    /**
+     * @brief Suggest chunk and shard sizes for an array.
+     * @details Chunks are shaped for @p read_pattern and sized so that a layer
+     * of them, one chunk deep along the append dimension, fits in
+     * @p target_memory_bytes. Chunks are then grouped into shards of up to
+     * @p target_shard_bytes. Memory is estimated as in
+     * ZarrStreamSettings_estimate_max_memory_usage.
+     * @note If even a layer one pixel deep exceeds @p target_memory_bytes, the
+     * suggestion uses that and reports the memory it needs.
+     * @param[in, out] settings The array settings. The name, type and array
+     * size of each dimension are read, and the chunk and shard sizes written.
+     * The data type, compression and multiscale settings are read.
+     * @param target_memory_bytes Memory the array may use while streaming.
+     * @param target_shard_bytes Uncompressed size of a shard to aim for.
+     * @param read_pattern How the array will mostly be read.
+     * @param frame_rate_hz Frames appended per second, or 0 if unknown. Only
+     * used for the time between flushes and files per hour.
+     * @param[out] suggestion The expected behaviour of the suggested geometry.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrArraySettings_suggest_geometry(
+      ZarrArraySettings* settings,
+      size_t target_memory_bytes,
+      size_t target_shard_bytes,
+      ZarrReadPattern read_pattern,
+      double frame_rate_hz,
+      ZarrGeometrySuggestion* suggestion);
+
     /**
      * @brief Allocate memory for the images array in the ZarrHCSWell struct.
      * @param[in,out] well The ZarrHCSWell struct.
@@ -273,7 +385,9 @@ extern "C"
      * @brief Append data to the Zarr stream.
      * @details This function will block while chunks are compressed and written
      * to the store. It will return when all data has been written. Multiple
-     * frames can be appended in a single call.
+     * frames can be appended in a single call. Different arrays may be
+     * appended to concurrently from different threads; to share one array
+     * between several threads, use ZarrStream_append_frame.
      * @param[in, out] stream The Zarr stream struct.
      * @param[in] data The data to append. If @p data is NULL, append
      * @p bytes_in zeros instead.
@@ -290,6 +404,136 @@ extern "C"
                                      size_t* bytes_out,
                                      const char* key);
 
+    /**
+     * @brief Append a single frame to the Zarr stream at an explicit index.
+     * @details The index is the position the frame would have if frames were
+     * appended in order, i.e., the flattened index over the non-spatial
+     * dimensions in acquisition order. Frames may arrive out of order, e.g.,
+     * from several producers, within the chunk layer currently being filled
+     * and the one after it. A layer is written as soon as all of its frames
+     * have arrived, or once a frame arrives past the layer after it, in which
+     * case its missing frames are left as the fill value. An array appended
+     * to by index cannot also be appended to with ZarrStream_append, and
+     * downsampled arrays cannot be appended to by index. Safe to call from
+     * several threads at once, including for the same array.
+     * @param[in, out] stream The Zarr stream struct.
+     * @param[in] data The frame data.
+     * @param[in] bytes_in The number of bytes in @p data. Must be exactly one
+     * frame.
+     * @param[in] frame_index The index of the frame.
+     * @param[in] key The key of the array to append to. May be NULL if the
+     * stream has only one array.
+     * @return ZarrStatusCode_Success on success, ZarrStatusCode_InvalidIndex
+     * if the frame was already appended or its layer was already written, or
+     * another error code on failure. A rejected frame leaves the stream
+     * usable.
+     */
+    ZarrStatusCode ZarrStream_append_frame(ZarrStream* stream,
+                                           const void* data,
+                                           size_t bytes_in,
+                                           uint64_t frame_index,
+                                           const char* key);
+
+    /**
+     * @brief Append per-frame metadata records to an array.
+     * @details Records are written to the array's frame metadata array, in the
+     * order they are appended, independently of its frames. The array must
+     * have been created with frame_metadata settings. Records are copied into
+     * a shard buffer, and full shards are written in the background, so this
+     * call is cheap. Safe to call from several threads at once.
+     * @param[in, out] stream The Zarr stream struct.
+     * @param[in] data The records, back to back, each holding field_count
+     * values of the frame metadata data type.
+     * @param[in] bytes_in The number of bytes in @p data. Must be a whole
+     * number of records.
+     * @param[out] bytes_out The number of bytes appended.
+     * @param[in] key The key of the array the records describe. May be NULL
+     * if the stream has only one array.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrStream_append_frame_metadata(ZarrStream* stream,
+                                                    const void* data,
+                                                    size_t bytes_in,
+                                                    size_t* bytes_out,
+                                                    const char* key);
+
+    /**
+     * @brief Write all data appended so far to the store without closing the
+     * stream.
+     * @details Blocks until every queued frame has been processed, then writes
+     * each array's partially filled chunks and shard indices, and updates the
+     * array metadata, so that everything appended before this call can be
+     * read. Frames appended afterwards continue to fill the same chunks, which
+     * are written again once complete: over the flushed copy, or, with
+     * checkpoint_interval_ms set, after it, so that a recovered store never
+     * indexes chunks that were written over. Filesystem only.
+     * @param[in, out] stream The Zarr stream struct.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrStream_flush(ZarrStream* stream);
+
+    /**
+     * @brief Write a single chunk directly into its shard, bypassing the frame
+     * queue, tiling and compression.
+     * @details Meant for data that is already chunked, and possibly encoded,
+     * e.g., by a GPU. The chunk must have the array's full chunk shape. An
+     * array written this way cannot also be appended to. Each shard is closed
+     * once all of its chunks have been written, or when the stream is
+     * destroyed.
+     * @param[in, out] stream The Zarr stream struct.
+     * @param[in] key The key of the array to write to. May be NULL if the
+     * stream has only one array.
+     * @param[in] chunk_coords The coordinates of the chunk in the chunk grid,
+     * one for each dimension of the array.
+     * @param[in] coord_count The number of coordinates in @p chunk_coords.
+     * @param[in] data The chunk data.
+     * @param[in] bytes_in The number of bytes in @p data.
+     * @param[in] is_compressed True if @p data is already compressed with the
+     * array's Blosc codec, compressor, shuffle and element size, false if it
+     * holds the raw chunk. Chunks compressed any other way are rejected with
+     * ZarrStatusCode_InvalidArgument, unless Blosc stored them uncompressed.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrStream_write_chunk(ZarrStream* stream,
+                                          const char* key,
+                                          const uint64_t* chunk_coords,
+                                          size_t coord_count,
+                                          const void* data,
+                                          size_t bytes_in,
+                                          bool is_compressed);
+
+    /**
+     * @brief Write a hyperslab of raw data into an array, e.g., one tile of a
+     * mosaic, bypassing the frame queue.
+     * @details The region is scattered into the chunks it overlaps. Each chunk
+     * is compressed and written once every element in it has been written, so
+     * regions may arrive in any order. Where regions overlap, the pixels
+     * written first are kept, since a chunk may already be written by the
+     * time a later region reaches it; write the tiles that should end up on
+     * top first. Partly written chunks are held in memory until the stream
+     * is destroyed, or until they are evicted to stay under
+     * max_region_buffer_bytes. Writing into an evicted
+     * chunk again reads it back from storage, which is only supported on the
+     * filesystem. An array written this way cannot also be appended to.
+     * @param[in, out] stream The Zarr stream struct.
+     * @param[in] key The key of the array to write to. May be NULL if the
+     * stream has only one array.
+     * @param[in] offset The offset of the region, in pixels, one for each
+     * dimension of the array.
+     * @param[in] shape The shape of the region, in pixels.
+     * @param[in] ndims The number of elements in @p offset and @p shape.
+     * @param[in] data The region data, in C order.
+     * @param[in] bytes_in The number of bytes in @p data.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrStream_write_region(ZarrStream* stream,
+                                           const char* key,
+                                           const uint64_t* offset,
+                                           const uint64_t* shape,
+                                           size_t ndims,
+                                           const void* data,
+                                           size_t bytes_in);
+
     /**
      * @brief Write custom metadata to the Zarr stream.
      * @param stream The Zarr stream struct.
@@ -304,6 +548,62 @@ extern "C"
                                                     const char* custom_metadata,
                                                     bool overwrite);
 
+    /**
+     * @brief Get the statistics of the frames appended to an array so far.
+     * @details The array must have been created with compute_statistics set.
+     * Frames still waiting in the stream's queue are not counted yet.
+     * @param[in] stream The Zarr stream struct.
+     * @param[in] key The key of the array. May be NULL if the stream has only
+     * one array.
+     * @param[in] channel The index along the array's first channel dimension
+     * to get the statistics of, or -1 for the whole array.
+     * @param[out] stats The statistics.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrStream_get_statistics(const ZarrStream* stream,
+                                             const char* key,
+                                             int64_t channel,
+                                             ZarrArrayStatistics* stats);
+
+    /**
+     * @brief Copy out the most recent frame appended to an array, e.g., for
+     * live display.
+     * @details The array must have been created with enable_preview set.
+     * Frames are published once the stream has taken them off its queue, in
+     * the layout they were appended in, and after any input conversion and
+     * frame reduction. Publishing never waits on readers.
+     * @param[in] stream The Zarr stream struct.
+     * @param[in] key The key of the array. May be NULL if the stream has only
+     * one array.
+     * @param[in] level The multiscale level to preview, 0 for full resolution.
+     * @param[out] data Buffer to copy the frame into, or NULL to only get
+     * @p info.
+     * @param[in] bytes_in The size of @p data in bytes.
+     * @param[out] info The size and data type of the frame, and whether one
+     * has been written yet.
+     * @return ZarrStatusCode_Success on success, ZarrStatusCode_Overflow if
+     * @p data is too small, or an error code on failure.
+     */
+    ZarrStatusCode ZarrStream_get_preview(const ZarrStream* stream,
+                                          const char* key,
+                                          uint16_t level,
+                                          void* data,
+                                          size_t bytes_in,
+                                          ZarrPreviewInfo* info);
+
+    /**
+     * @brief Get the results of the stream's startup calibration.
+     * @details The stream must have been created with calibrate set, or
+     * @p calibration is returned with calibrated false. The thread split is a
+     * suggestion for sizing max_threads: compression and write jobs share the
+     * stream's pool.
+     * @param[in] stream The Zarr stream struct.
+     * @param[out] calibration The calibration results.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrStream_get_calibration(const ZarrStream* stream,
+                                              ZarrCalibration* calibration);
+
     /**
      * @brief Get the current memory usage of the Zarr stream.
      * @param[in] stream The Zarr stream struct.
@@ -313,6 +613,87 @@ extern "C"
     ZarrStatusCode ZarrStream_get_current_memory_usage(const ZarrStream* stream,
                                                        size_t* usage);
 
+    /**
+     * @brief Open an array written by a Zarr stream for reading.
+     * @details Only the layout written by this library is supported: a single
+     * sharding_indexed codec with its crc32c-checked index at the end of each
+     * shard, and bytes or packbits inner codecs, optionally followed by Blosc
+     * and crc32c. The array's shape is read when it is opened. Shard indices
+     * are cached once read.
+     * @param settings The reader settings.
+     * @return A pointer to the reader, or NULL on failure.
+     */
+    ZarrReader* ZarrReader_open(const ZarrReaderSettings* settings);
+
+    /**
+     * @brief Close a Zarr reader.
+     * @param reader The reader to close.
+     */
+    void ZarrReader_close(ZarrReader* reader);
+
+    /**
+     * @brief Get the data type and number of dimensions of the array.
+     * @param[in] reader The Zarr reader struct.
+     * @param[out] data_type The data type of the array.
+     * @param[out] ndims The number of dimensions of the array.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrReader_get_array_info(const ZarrReader* reader,
+                                             ZarrDataType* data_type,
+                                             size_t* ndims);
+
+    /**
+     * @brief Get the shape of the array and of its chunks.
+     * @param[in] reader The Zarr reader struct.
+     * @param[out] shape The size of each dimension of the array, in pixels.
+     * @param[out] chunk_shape The size of each dimension of a chunk, in pixels.
+     * May be NULL.
+     * @param[in] ndims The number of elements in @p shape and @p chunk_shape.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrReader_get_shape(const ZarrReader* reader,
+                                        uint64_t* shape,
+                                        uint64_t* chunk_shape,
+                                        size_t ndims);
+
+    /**
+     * @brief Read and decode a single chunk.
+     * @details The whole chunk is returned, including any padding past the
+     * edge of the array. Chunks that were never written read as zeros.
+     * @param[in] reader The Zarr reader struct.
+     * @param[in] chunk_coords The coordinates of the chunk in the chunk grid,
+     * one for each dimension of the array.
+     * @param[in] coord_count The number of coordinates in @p chunk_coords.
+     * @param[out] data Buffer to decode the chunk into, in C order.
+     * @param[in] bytes_in The size of @p data in bytes.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrReader_read_chunk(ZarrReader* reader,
+                                         const uint64_t* chunk_coords,
+                                         size_t coord_count,
+                                         void* data,
+                                         size_t bytes_in);
+
+    /**
+     * @brief Read a hyperslab of an array.
+     * @details The chunks overlapping the region are read and decoded in
+     * parallel. Adjacent chunks in a shard are read together.
+     * @param[in] reader The Zarr reader struct.
+     * @param[in] offset The offset of the region, in pixels, one for each
+     * dimension of the array.
+     * @param[in] shape The shape of the region, in pixels.
+     * @param[in] ndims The number of elements in @p offset and @p shape.
+     * @param[out] data Buffer to read the region into, in C order.
+     * @param[in] bytes_in The size of @p data in bytes.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode ZarrReader_read_region(ZarrReader* reader,
+                                          const uint64_t* offset,
+                                          const uint64_t* shape,
+                                          size_t ndims,
+                                          void* data,
+                                          size_t bytes_in);
+
 #ifdef __cplusplus
 }
 #endif
@@ -94,6 +94,45 @@ extern "C"
         ZarrDownsamplingMethodCount,
     } ZarrDownsamplingMethod;
 
+    typedef enum
+    {
+        ZarrPixelFormat_Native = 0,   // one pixel of data_type per element
+        ZarrPixelFormat_Mono10p,      // 4 10-bit pixels in 5 bytes, LSB first
+        ZarrPixelFormat_Mono12p,      // 2 12-bit pixels in 3 bytes, LSB first
+        ZarrPixelFormat_Mono12Packed, // 2 12-bit pixels in 3 bytes, GigE Vision
+        ZarrPixelFormatCount
+    } ZarrPixelFormat;
+
+    typedef enum
+    {
+        ZarrBinningMethod_Mean = 0,
+        ZarrBinningMethod_Sum, // saturates at the maximum of the data type
+        ZarrBinningMethodCount
+    } ZarrBinningMethod;
+
+    typedef enum
+    {
+        ZarrProjectionMethod_Max = 0,
+        ZarrProjectionMethod_Mean, // rounded to nearest for integer types
+        ZarrProjectionMethodCount
+    } ZarrProjectionMethod;
+
+    typedef enum
+    {
+        ZarrChunkOrder_RowMajor = 0, // chunks in index order
+        ZarrChunkOrder_Morton,       // Z-order curve over the chunk coordinates
+        ZarrChunkOrder_TileMajor,    // each YX tile's chunks stored together
+        ZarrChunkOrderCount
+    } ZarrChunkOrder;
+
+    typedef enum
+    {
+        ZarrReadPattern_Frames = 0, // whole frames, one plane at a time
+        ZarrReadPattern_Tiles,      // YX tiles through every plane
+        ZarrReadPattern_Volumes,    // neighbourhoods in every spatial dimension
+        ZarrReadPatternCount
+    } ZarrReadPattern;
+
     /**
      * @brief S3 settings for streaming to Zarr.
      */
@@ -104,6 +143,66 @@ extern "C"
         const char* region;
     } ZarrS3Settings;
 
+    /**
+     * @brief Settings for capturing the appends made to a stream, so the
+     * workload can be replayed offline with the acquire-zarr-replay benchmark.
+     * @detail The capture is a JSON Lines file: a record of the stream
+     * settings, then one record per call to ZarrStream_append with its array
+     * key, bytes passed in and taken, status, start time and latency.
+     */
+    typedef struct
+    {
+        const char* path;   /**< Path of the capture file to write */
+        bool hash_payloads; /**< Whether to record a crc32c of each payload */
+        unsigned int
+          payload_sample_interval; /**< Copy every nth payload to
+                                      "<path>.payloads" for replay. Set to 0
+                                      to copy none. */
+    } ZarrCaptureSettings;
+
+    /**
+     * @brief Settings for one of several writers streaming disjoint arrays
+     * into one filesystem store, e.g., from processes on different hosts
+     * sharing a parallel filesystem.
+     * @detail Writers claim their arrays with lock files in the store's
+     * ".writers" directory. On close, each writer publishes the metadata of
+     * its groups and arrays there, and the coordinator merges it into the
+     * hierarchy metadata, including HCS plate and well metadata, then
+     * removes the directory.
+     */
+    typedef struct
+    {
+        const char* writer_id;     /**< Name of this writer, unique among the
+                                      writers of the store */
+        unsigned int writer_count; /**< Number of writers of the store,
+                                      including this one */
+        bool coordinator; /**< Whether this writer merges the hierarchy
+                             metadata on close. Exactly one writer must be
+                             the coordinator. */
+        unsigned int timeout_ms; /**< How long the coordinator waits on close
+                                    for the other writers to finish, in
+                                    milliseconds. Set to 0 to wait
+                                    indefinitely. */
+    } ZarrCooperativeSettings;
+
+    /**
+     * @brief A limit on the bandwidth a stream writes to storage with.
+     * @detail Writes to the store draw from a token bucket, which smooths
+     * flushes while the frame queue absorbs the difference. While the queue
+     * is more than three quarters full, writes may borrow up to another burst
+     * ahead of the limit.
+     */
+    typedef struct
+    {
+        uint64_t bytes_per_second; /**< Sustained write bandwidth */
+        uint64_t burst_bytes; /**< Bytes that may be written at once after an
+                                 idle period. Set to 0 for a tenth of a
+                                 second's worth. */
+        bool shared; /**< Whether to share one limit among all streams in the
+                        process that set this. The first such stream's limit
+                        applies while any of them is open. */
+    } ZarrBandwidthLimit;
+
     /**
      * @brief Compression settings for a Zarr array.
      * @detail The compressor is not the same as the codec. A codec is
@@ -118,6 +217,156 @@ extern "C"
         uint8_t shuffle; /**< Whether to shuffle the data before compressing */
     } ZarrCompressionSettings;
 
+    /**
+     * @brief Conversion of appended samples to the data type of an array.
+     * @detail Each sample x is stored as (x >> right_shift) * scale + offset,
+     * rounded to nearest and saturated to the array's data type. With a scale
+     * of 1 and no offset, integer samples are shifted and saturated without
+     * going through floating point.
+     */
+    typedef struct
+    {
+        ZarrDataType data_type; /**< Data type of the appended samples */
+        double scale;           /**< Multiplier; 0 is treated as 1 */
+        double offset;          /**< Added after scaling */
+        uint8_t right_shift;    /**< Shift applied first, integer types only */
+    } ZarrInputConversion;
+
+    /**
+     * @brief Cropping and binning of appended frames.
+     * @detail A window of (width * binning) x (height * binning) pixels, where
+     * width and height are the sizes of the array's last two dimensions, is
+     * cut out of each appended frame at (roi_x, roi_y) and binned down to
+     * width x height. Sizes and offsets are in acquisition order.
+     */
+    typedef struct
+    {
+        uint32_t frame_width;  /**< Width of appended frames, in pixels */
+        uint32_t frame_height; /**< Height of appended frames, in pixels */
+        uint32_t roi_x;        /**< Left edge of the kept window */
+        uint32_t roi_y;        /**< Top edge of the kept window */
+        uint32_t binning;      /**< Binning factor; 0 or 1 for no binning */
+        ZarrBinningMethod binning_method;
+    } ZarrFrameReduction;
+
+    /**
+     * @brief A running projection of an array along one of its dimensions.
+     * @detail The projection is accumulated as frames are appended and written
+     * to a sibling array named "<key>_<method>_<dimension>", e.g. "raw_max_z",
+     * with the projected dimension left out. Each projected frame is written
+     * as soon as the projected dimension wraps; projections along the append
+     * dimension are written on close.
+     */
+    typedef struct
+    {
+        const char* dimension_name; /**< Name of the dimension to project
+                                       along; not one of the last two */
+        ZarrProjectionMethod method;
+    } ZarrProjection;
+
+    /**
+     * @brief Fixed-size records, e.g. a timestamp, a stage position and an
+     * exposure, appended alongside the frames of an array.
+     * @detail Records are passed to ZarrStream_append_frame_metadata and
+     * written to a sibling array named "<key>_frame_metadata", of shape
+     * (records) if a record has one field, or (records, fields) otherwise.
+     * They are chunked along the records, sharded, and compressed with the
+     * array's compression settings. Full shards are written in the
+     * background; the last, partial shard is written on close.
+     */
+    typedef struct
+    {
+        ZarrDataType data_type;     /**< Type of every field */
+        uint32_t field_count;       /**< Number of fields per record */
+        const char** field_names;   /**< field_count names, stored in the
+                                       array's attributes, or NULL */
+        uint32_t records_per_chunk; /**< 0 for 4096 */
+        uint32_t chunks_per_shard;  /**< 0 for 16 */
+    } ZarrFrameMetadataSettings;
+
+#define ZARR_HISTOGRAM_BINS 256
+
+    /**
+     * @brief Statistics of the pixels appended to an array, or to one of its
+     * channels.
+     * @detail Integer histograms split the range of the data type, or of its
+     * significant bits, into equal bins. Floating point data has no histogram.
+     */
+    typedef struct
+    {
+        uint64_t count;       /**< Number of pixels */
+        double min;           /**< Smallest pixel value, 0 if count is 0 */
+        double max;           /**< Largest pixel value, 0 if count is 0 */
+        double sum;           /**< Sum of the pixel values */
+        double histogram_min; /**< Lower edge of the first histogram bin */
+        double histogram_max; /**< Upper edge of the last histogram bin */
+        size_t histogram_bins; /**< Number of histogram bins in use */
+        uint64_t histogram[ZARR_HISTOGRAM_BINS]; /**< Pixels per bin */
+    } ZarrArrayStatistics;
+
+    /**
+     * @brief Description of the most recent frame written to an array, or to
+     * one of its multiscale levels.
+     */
+    typedef struct
+    {
+        uint32_t width;         /**< Frame width, in pixels */
+        uint32_t height;        /**< Frame height, in pixels */
+        ZarrDataType data_type; /**< Data type of the frame's pixels */
+        bool has_frame;         /**< False if no frame was written yet */
+        uint64_t frame_id;      /**< Index of the frame in append order, if
+                                   has_frame */
+    } ZarrPreviewInfo;
+
+    /**
+     * @brief Expected behaviour of an array streamed with a suggested chunk
+     * and shard geometry.
+     */
+    typedef struct
+    {
+        size_t memory_bytes;       /**< Peak memory of the array while
+                                      streaming, as estimated for the stream
+                                      less the frame queue */
+        size_t chunk_bytes;        /**< Uncompressed size of a chunk */
+        size_t shard_bytes;        /**< Uncompressed size of a full shard */
+        uint64_t frames_per_flush; /**< Frames appended between writes of a
+                                      layer of chunks to storage */
+        double seconds_per_flush;  /**< Time between those writes, or 0 if the
+                                      frame rate is unknown */
+        double files_per_hour;     /**< Shard files created per hour at full
+                                      resolution, or 0 if the frame rate is
+                                      unknown */
+    } ZarrGeometrySuggestion;
+
+    /**
+     * @brief Results of a stream's startup calibration. See
+     * ZarrStreamSettings.calibrate.
+     */
+    typedef struct
+    {
+        bool calibrated;      /**< False if the stream was not calibrated */
+        unsigned int cores;   /**< Hardware threads on the host, or 0 if
+                                 unknown */
+        unsigned int threads; /**< Threads in the stream's pool */
+        double compress_bytes_per_second; /**< Blosc throughput of one thread
+                                             on synthetic frames of the
+                                             compressed arrays, or 0 if no
+                                             array is compressed */
+        double write_bytes_per_second;    /**< Bandwidth of writes to the
+                                             store, capped at the stream's
+                                             bandwidth_limit, or 0 if not
+                                             measured, as for S3 stores */
+        unsigned int compression_threads; /**< Suggested share of the pool
+                                             for compression */
+        unsigned int io_threads;          /**< Suggested share of the pool
+                                             for writes. Shares with the
+                                             compression threads if the pool
+                                             has one thread */
+        double max_frame_rate_hz;         /**< Estimated number of frames per
+                                             second each array can sustain,
+                                             or 0 if nothing was measured */
+    } ZarrCalibration;
+
     /**
      * @brief Properties of a dimension of a Zarr array.
      */
@@ -162,6 +411,52 @@ extern "C"
         bool multiscale;
         ZarrDownsamplingMethod downsampling_method;
         const size_t* storage_dimension_order;
+        ZarrPixelFormat input_pixel_format; /**< Layout of the frames passed to
+                                               ZarrStream_append. Packed
+                                               formats require
+                                               ZarrDataType_uint16 and are
+                                               unpacked as they are written to
+                                               chunks. */
+        uint8_t significant_bits; /**< Number of low bits stored per sample
+                                     with the packbits codec, e.g. 12 for a
+                                     12-bit camera. Requires an unsigned
+                                     integer data type. 0 stores samples in
+                                     full. */
+        ZarrInputConversion* input_conversion; /**< Conversion of appended
+                                                  frames to data_type, or NULL
+                                                  to append data_type as is.
+                                                  Chunks and regions written
+                                                  directly are not converted. */
+        ZarrFrameReduction* frame_reduction; /**< Cropping and binning of
+                                                appended frames, applied after
+                                                input_conversion, or NULL to
+                                                append frames the size of the
+                                                array's last two dimensions.
+                                                */
+        bool compute_statistics; /**< Accumulate the pixel statistics of
+                                    appended frames, per array and per
+                                    channel, and write them to the array's
+                                    attributes on close. */
+        ZarrProjection* projection; /**< Running projection of appended frames,
+                                       or NULL for none. Requires a nonempty
+                                       output_key. */
+        bool enable_preview; /**< Keep the most recently appended frame, at
+                                each multiscale level, for
+                                ZarrStream_get_preview. */
+        bool chunk_checksums; /**< End each encoded chunk with its CRC32C,
+                                 as a crc32c codec after any compression, so
+                                 corrupted chunks are detected when read. */
+        ZarrChunkOrder chunk_order; /**< Order in which the chunks appended to
+                                       each layer of a shard are laid out in
+                                       the shard file. The shard index is
+                                       unaffected, so readers see no
+                                       difference beyond fewer, larger reads
+                                       of neighbouring chunks. */
+        ZarrFrameMetadataSettings* frame_metadata; /**< Per-frame records
+                                                      written next to the
+                                                      array, or NULL for none.
+                                                      Requires a nonempty
+                                                      output_key. */
     } ZarrArraySettings;
 
     /**
@@ -21,6 +21,12 @@ auto ZarrStreamDeleter = [](ZarrStream_s* stream) {
     }
 };
 
+auto ZarrReaderDeleter = [](ZarrReader_s* reader) {
+    if (reader) {
+        ZarrReader_close(reader);
+    }
+};
+
 struct ArrayLifetimeProps
 {
     std::string output_key;
@@ -37,6 +43,23 @@ struct ArrayLifetimeProps
     bool has_compression{ false };
     ZarrDataType data_type;
     std::optional<ZarrDownsamplingMethod> downsampling_method;
+    ZarrPixelFormat input_pixel_format{ ZarrPixelFormat_Native };
+    uint8_t significant_bits{ 0 };
+    ZarrInputConversion input_conversion;
+    bool has_input_conversion{ false };
+    ZarrFrameReduction frame_reduction;
+    bool has_frame_reduction{ false };
+    bool compute_statistics{ false };
+    std::string projection_dimension;
+    ZarrProjection projection;
+    bool has_projection{ false };
+    bool enable_preview{ false };
+    bool chunk_checksums{ false };
+    ZarrChunkOrder chunk_order{ ZarrChunkOrder_RowMajor };
+    std::vector<std::string> frame_metadata_names;
+    std::vector<const char*> frame_metadata_name_ptrs;
+    ZarrFrameMetadataSettings frame_metadata;
+    bool has_frame_metadata{ false };
 
     ZarrArraySettings* array_settings()
     {
@@ -78,6 +101,34 @@ struct ArrayLifetimeProps
         array_settings_.multiscale = downsampling_method.has_value();
         array_settings_.downsampling_method =
           downsampling_method.value_or(ZarrDownsamplingMethod_Mean);
+        array_settings_.input_pixel_format = input_pixel_format;
+        array_settings_.significant_bits = significant_bits;
+        array_settings_.input_conversion =
+          has_input_conversion ? &input_conversion : nullptr;
+        array_settings_.frame_reduction =
+          has_frame_reduction ? &frame_reduction : nullptr;
+        array_settings_.compute_statistics = compute_statistics;
+        if (has_projection) {
+            projection.dimension_name = projection_dimension.c_str();
+            array_settings_.projection = &projection;
+        } else {
+            array_settings_.projection = nullptr;
+        }
+        array_settings_.enable_preview = enable_preview;
+        array_settings_.chunk_checksums = chunk_checksums;
+        array_settings_.chunk_order = chunk_order;
+        if (has_frame_metadata) {
+            frame_metadata_name_ptrs.clear();
+            for (const auto& name : frame_metadata_names) {
+                frame_metadata_name_ptrs.push_back(name.c_str());
+            }
+            frame_metadata.field_names = frame_metadata_name_ptrs.empty()
+                                           ? nullptr
+                                           : frame_metadata_name_ptrs.data();
+            array_settings_.frame_metadata = &frame_metadata;
+        } else {
+            array_settings_.frame_metadata = nullptr;
+        }
 
         if (!storage_dimension_order.empty()) {
             array_settings_.storage_dimension_order =
@@ -390,6 +441,52 @@ numpy_dtype_to_zarr_datatype(const py::dtype& dtype)
         throw py::error_already_set();
     }
 }
+
+py::dtype
+zarr_datatype_to_numpy_dtype(ZarrDataType type)
+{
+    switch (type) {
+        case ZarrDataType_uint8:
+            return py::dtype::of<uint8_t>();
+        case ZarrDataType_uint16:
+            return py::dtype::of<uint16_t>();
+        case ZarrDataType_uint32:
+            return py::dtype::of<uint32_t>();
+        case ZarrDataType_uint64:
+            return py::dtype::of<uint64_t>();
+        case ZarrDataType_int8:
+            return py::dtype::of<int8_t>();
+        case ZarrDataType_int16:
+            return py::dtype::of<int16_t>();
+        case ZarrDataType_int32:
+            return py::dtype::of<int32_t>();
+        case ZarrDataType_int64:
+            return py::dtype::of<int64_t>();
+        case ZarrDataType_float32:
+            return py::dtype::of<float>();
+        case ZarrDataType_float64:
+            return py::dtype::of<double>();
+        default:
+            PyErr_SetString(PyExc_ValueError, "Unsupported data type");
+            throw py::error_already_set();
+    }
+}
+
+// accepts a NumPy dtype, anything NumPy can make one from, or a DataType
+ZarrDataType
+to_zarr_datatype(const py::object& obj)
+{
+    if (py::isinstance<py::dtype>(obj)) {
+        return numpy_dtype_to_zarr_datatype(obj.cast<py::dtype>());
+    }
+
+    try {
+        py::module np = py::module::import("numpy");
+        return numpy_dtype_to_zarr_datatype(np.attr("dtype")(obj));
+    } catch (const std::exception& exc) {
+        return obj.cast<ZarrDataType>();
+    }
+}
 } // namespace
 
 class PyZarrS3Settings
@@ -436,6 +533,134 @@ class PyZarrS3Settings
     ZarrS3Settings s3_settings_{};
 };
 
+class PyZarrCaptureSettings
+{
+  public:
+    PyZarrCaptureSettings() = default;
+    ~PyZarrCaptureSettings() = default;
+
+    void set_path(const std::string& path) { path_ = path; }
+    const std::string& path() const { return path_; }
+
+    void set_hash_payloads(bool hash) { hash_payloads_ = hash; }
+    bool hash_payloads() const { return hash_payloads_; }
+
+    void set_payload_sample_interval(unsigned int interval)
+    {
+        payload_sample_interval_ = interval;
+    }
+    unsigned int payload_sample_interval() const
+    {
+        return payload_sample_interval_;
+    }
+
+    std::string repr() const
+    {
+        return "CaptureSettings(path='" + path_ + "', hash_payloads=" +
+               (hash_payloads_ ? "True" : "False") +
+               ", payload_sample_interval=" +
+               std::to_string(payload_sample_interval_) + ")";
+    }
+
+    ZarrCaptureSettings* settings()
+    {
+        capture_settings_.path = path_.c_str();
+        capture_settings_.hash_payloads = hash_payloads_;
+        capture_settings_.payload_sample_interval = payload_sample_interval_;
+        return &capture_settings_;
+    }
+
+  private:
+    std::string path_;
+    bool hash_payloads_{ false };
+    unsigned int payload_sample_interval_{ 0 };
+
+    ZarrCaptureSettings capture_settings_{};
+};
+
+class PyZarrCooperativeSettings
+{
+  public:
+    PyZarrCooperativeSettings() = default;
+    ~PyZarrCooperativeSettings() = default;
+
+    void set_writer_id(const std::string& id) { writer_id_ = id; }
+    const std::string& writer_id() const { return writer_id_; }
+
+    void set_writer_count(unsigned int count) { writer_count_ = count; }
+    unsigned int writer_count() const { return writer_count_; }
+
+    void set_coordinator(bool coordinator) { coordinator_ = coordinator; }
+    bool coordinator() const { return coordinator_; }
+
+    void set_timeout_ms(unsigned int timeout) { timeout_ms_ = timeout; }
+    unsigned int timeout_ms() const { return timeout_ms_; }
+
+    std::string repr() const
+    {
+        return "CooperativeSettings(writer_id='" + writer_id_ +
+               "', writer_count=" + std::to_string(writer_count_) +
+               ", coordinator=" + (coordinator_ ? "True" : "False") +
+               ", timeout_ms=" + std::to_string(timeout_ms_) + ")";
+    }
+
+    ZarrCooperativeSettings* settings()
+    {
+        cooperative_settings_.writer_id = writer_id_.c_str();
+        cooperative_settings_.writer_count = writer_count_;
+        cooperative_settings_.coordinator = coordinator_;
+        cooperative_settings_.timeout_ms = timeout_ms_;
+        return &cooperative_settings_;
+    }
+
+  private:
+    std::string writer_id_;
+    unsigned int writer_count_{ 1 };
+    bool coordinator_{ false };
+    unsigned int timeout_ms_{ 0 };
+
+    ZarrCooperativeSettings cooperative_settings_{};
+};
+
+class PyZarrBandwidthLimit
+{
+  public:
+    PyZarrBandwidthLimit() = default;
+    ~PyZarrBandwidthLimit() = default;
+
+    void set_bytes_per_second(uint64_t rate) { bytes_per_second_ = rate; }
+    uint64_t bytes_per_second() const { return bytes_per_second_; }
+
+    void set_burst_bytes(uint64_t burst) { burst_bytes_ = burst; }
+    uint64_t burst_bytes() const { return burst_bytes_; }
+
+    void set_shared(bool shared) { shared_ = shared; }
+    bool shared() const { return shared_; }
+
+    std::string repr() const
+    {
+        return "BandwidthLimit(bytes_per_second=" +
+               std::to_string(bytes_per_second_) +
+               ", burst_bytes=" + std::to_string(burst_bytes_) +
+               ", shared=" + (shared_ ? "True" : "False") + ")";
+    }
+
+    ZarrBandwidthLimit* settings()
+    {
+        bandwidth_limit_.bytes_per_second = bytes_per_second_;
+        bandwidth_limit_.burst_bytes = burst_bytes_;
+        bandwidth_limit_.shared = shared_;
+        return &bandwidth_limit_;
+    }
+
+  private:
+    uint64_t bytes_per_second_{ 0 };
+    uint64_t burst_bytes_{ 0 };
+    bool shared_{ false };
+
+    ZarrBandwidthLimit bandwidth_limit_{};
+};
+
 class PyZarrCompressionSettings
 {
   public:
@@ -471,6 +696,161 @@ class PyZarrCompressionSettings
     uint8_t shuffle_{ 0 };
 };
 
+class PyZarrInputConversion
+{
+  public:
+    PyZarrInputConversion() = default;
+    ~PyZarrInputConversion() = default;
+
+    ZarrDataType data_type() const { return data_type_; }
+    void set_data_type(ZarrDataType type) { data_type_ = type; }
+
+    double scale() const { return scale_; }
+    void set_scale(double scale) { scale_ = scale; }
+
+    double offset() const { return offset_; }
+    void set_offset(double offset) { offset_ = offset; }
+
+    uint8_t right_shift() const { return right_shift_; }
+    void set_right_shift(uint8_t shift) { right_shift_ = shift; }
+
+    std::string repr() const
+    {
+        return "InputConversion(data_type=DataType." +
+               std::string(data_type_to_str(data_type_)) +
+               ", scale=" + std::to_string(scale_) +
+               ", offset=" + std::to_string(offset_) +
+               ", right_shift=" + std::to_string(right_shift_) + ")";
+    }
+
+  private:
+    ZarrDataType data_type_{ ZarrDataType_uint16 };
+    double scale_{ 1.0 };
+    double offset_{ 0.0 };
+    uint8_t right_shift_{ 0 };
+};
+
+class PyZarrFrameReduction
+{
+  public:
+    PyZarrFrameReduction() = default;
+    ~PyZarrFrameReduction() = default;
+
+    uint32_t frame_width() const { return frame_width_; }
+    void set_frame_width(uint32_t width) { frame_width_ = width; }
+
+    uint32_t frame_height() const { return frame_height_; }
+    void set_frame_height(uint32_t height) { frame_height_ = height; }
+
+    uint32_t roi_x() const { return roi_x_; }
+    void set_roi_x(uint32_t x) { roi_x_ = x; }
+
+    uint32_t roi_y() const { return roi_y_; }
+    void set_roi_y(uint32_t y) { roi_y_ = y; }
+
+    uint32_t binning() const { return binning_; }
+    void set_binning(uint32_t binning) { binning_ = binning; }
+
+    ZarrBinningMethod binning_method() const { return binning_method_; }
+    void set_binning_method(ZarrBinningMethod method)
+    {
+        binning_method_ = method;
+    }
+
+    std::string repr() const
+    {
+        return "FrameReduction(frame_width=" + std::to_string(frame_width_) +
+               ", frame_height=" + std::to_string(frame_height_) +
+               ", roi_x=" + std::to_string(roi_x_) +
+               ", roi_y=" + std::to_string(roi_y_) +
+               ", binning=" + std::to_string(binning_) +
+               ", binning_method=BinningMethod." +
+               (binning_method_ == ZarrBinningMethod_Sum ? "SUM" : "MEAN") +
+               ")";
+    }
+
+  private:
+    uint32_t frame_width_{ 0 };
+    uint32_t frame_height_{ 0 };
+    uint32_t roi_x_{ 0 };
+    uint32_t roi_y_{ 0 };
+    uint32_t binning_{ 1 };
+    ZarrBinningMethod binning_method_{ ZarrBinningMethod_Mean };
+};
+
+class PyZarrProjection
+{
+  public:
+    PyZarrProjection() = default;
+    ~PyZarrProjection() = default;
+
+    const std::string& dimension() const { return dimension_; }
+    void set_dimension(const std::string& dimension) { dimension_ = dimension; }
+
+    ZarrProjectionMethod method() const { return method_; }
+    void set_method(ZarrProjectionMethod method) { method_ = method; }
+
+    std::string repr() const
+    {
+        return "Projection(dimension='" + dimension_ +
+               "', method=ProjectionMethod." +
+               (method_ == ZarrProjectionMethod_Mean ? "MEAN" : "MAX") + ")";
+    }
+
+  private:
+    std::string dimension_;
+    ZarrProjectionMethod method_{ ZarrProjectionMethod_Max };
+};
+
+class PyZarrFrameMetadata
+{
+  public:
+    PyZarrFrameMetadata() = default;
+    ~PyZarrFrameMetadata() = default;
+
+    ZarrDataType data_type() const { return data_type_; }
+    void set_data_type(ZarrDataType type) { data_type_ = type; }
+
+    uint32_t field_count() const { return field_count_; }
+    void set_field_count(uint32_t count) { field_count_ = count; }
+
+    const std::vector<std::string>& field_names() const
+    {
+        return field_names_;
+    }
+    void set_field_names(const std::vector<std::string>& names)
+    {
+        field_names_ = names;
+    }
+
+    uint32_t records_per_chunk() const { return records_per_chunk_; }
+    void set_records_per_chunk(uint32_t n) { records_per_chunk_ = n; }
+
+    uint32_t chunks_per_shard() const { return chunks_per_shard_; }
+    void set_chunks_per_shard(uint32_t n) { chunks_per_shard_ = n; }
+
+    std::string repr() const
+    {
+        std::string names;
+        for (const auto& name : field_names_) {
+            names += (names.empty() ? "'" : ", '") + name + "'";
+        }
+        return "FrameMetadata(data_type=DataType." +
+               std::string(data_type_to_str(data_type_)) +
+               ", field_count=" + std::to_string(field_count_) +
+               ", field_names=[" + names + "]" +
+               ", records_per_chunk=" + std::to_string(records_per_chunk_) +
+               ", chunks_per_shard=" + std::to_string(chunks_per_shard_) + ")";
+    }
+
+  private:
+    ZarrDataType data_type_{ ZarrDataType_float64 };
+    uint32_t field_count_{ 1 };
+    std::vector<std::string> field_names_;
+    uint32_t records_per_chunk_{ 0 };
+    uint32_t chunks_per_shard_{ 0 };
+};
+
 class PyZarrDimensionProperties
 {
   public:
@@ -572,6 +952,65 @@ class PyZarrArraySettings
         downsampling_method_ = method;
     }
 
+    ZarrPixelFormat input_pixel_format() const { return input_pixel_format_; }
+    void set_input_pixel_format(ZarrPixelFormat format)
+    {
+        input_pixel_format_ = format;
+    }
+
+    uint8_t significant_bits() const { return significant_bits_; }
+    void set_significant_bits(uint8_t bits) { significant_bits_ = bits; }
+
+    const std::optional<PyZarrInputConversion>& input_conversion() const
+    {
+        return input_conversion_;
+    }
+    void set_input_conversion(
+      const std::optional<PyZarrInputConversion>& conversion)
+    {
+        input_conversion_ = conversion;
+    }
+
+    const std::optional<PyZarrFrameReduction>& frame_reduction() const
+    {
+        return frame_reduction_;
+    }
+    void set_frame_reduction(
+      const std::optional<PyZarrFrameReduction>& reduction)
+    {
+        frame_reduction_ = reduction;
+    }
+
+    bool compute_statistics() const { return compute_statistics_; }
+    void set_compute_statistics(bool compute) { compute_statistics_ = compute; }
+
+    const std::optional<PyZarrProjection>& projection() const
+    {
+        return projection_;
+    }
+    void set_projection(const std::optional<PyZarrProjection>& projection)
+    {
+        projection_ = projection;
+    }
+
+    const std::optional<PyZarrFrameMetadata>& frame_metadata() const
+    {
+        return frame_metadata_;
+    }
+    void set_frame_metadata(const std::optional<PyZarrFrameMetadata>& metadata)
+    {
+        frame_metadata_ = metadata;
+    }
+
+    bool enable_preview() const { return enable_preview_; }
+    void set_enable_preview(bool enable) { enable_preview_ = enable; }
+
+    bool chunk_checksums() const { return chunk_checksums_; }
+    void set_chunk_checksums(bool enable) { chunk_checksums_ = enable; }
+
+    ZarrChunkOrder chunk_order() const { return chunk_order_; }
+    void set_chunk_order(ZarrChunkOrder order) { chunk_order_ = order; }
+
     const std::vector<std::string>& storage_dimension_order() const
     {
         return storage_dimension_order_;
@@ -626,6 +1065,47 @@ class PyZarrArraySettings
         lt_props.output_key = output_key_;
         lt_props.data_type = data_type_;
         lt_props.downsampling_method = downsampling_method_;
+        lt_props.input_pixel_format = input_pixel_format_;
+        lt_props.significant_bits = significant_bits_;
+        if (input_conversion_.has_value()) {
+            lt_props.input_conversion = {
+                .data_type = input_conversion_->data_type(),
+                .scale = input_conversion_->scale(),
+                .offset = input_conversion_->offset(),
+                .right_shift = input_conversion_->right_shift(),
+            };
+            lt_props.has_input_conversion = true;
+        }
+        if (frame_reduction_.has_value()) {
+            lt_props.frame_reduction = {
+                .frame_width = frame_reduction_->frame_width(),
+                .frame_height = frame_reduction_->frame_height(),
+                .roi_x = frame_reduction_->roi_x(),
+                .roi_y = frame_reduction_->roi_y(),
+                .binning = frame_reduction_->binning(),
+                .binning_method = frame_reduction_->binning_method(),
+            };
+            lt_props.has_frame_reduction = true;
+        }
+        lt_props.compute_statistics = compute_statistics_;
+        if (projection_.has_value()) {
+            lt_props.projection_dimension = projection_->dimension();
+            lt_props.projection.method = projection_->method();
+            lt_props.has_projection = true;
+        }
+        lt_props.enable_preview = enable_preview_;
+        lt_props.chunk_checksums = chunk_checksums_;
+        lt_props.chunk_order = chunk_order_;
+        if (frame_metadata_.has_value()) {
+            lt_props.frame_metadata_names = frame_metadata_->field_names();
+            lt_props.frame_metadata = {
+                .data_type = frame_metadata_->data_type(),
+                .field_count = frame_metadata_->field_count(),
+                .records_per_chunk = frame_metadata_->records_per_chunk(),
+                .chunks_per_shard = frame_metadata_->chunks_per_shard(),
+            };
+            lt_props.has_frame_metadata = true;
+        }
 
         // compression settings
         if (compression_settings_.has_value()) {
@@ -686,6 +1166,48 @@ class PyZarrArraySettings
         return lt_props;
     }
 
+    py::dict suggest_geometry(size_t target_memory_bytes,
+                              size_t target_shard_bytes,
+                              ZarrReadPattern read_pattern,
+                              double frame_rate_hz)
+    {
+        auto lt_props = to_lifetime_props();
+        ZarrArraySettings* settings = lt_props.array_settings();
+
+        ZarrGeometrySuggestion suggestion;
+        const auto status =
+          ZarrArraySettings_suggest_geometry(settings,
+                                             target_memory_bytes,
+                                             target_shard_bytes,
+                                             read_pattern,
+                                             frame_rate_hz,
+                                             &suggestion);
+        if (status != ZarrStatusCode_Success) {
+            ZarrArraySettings_destroy_dimension_array(settings);
+            std::string err = "Failed to suggest geometry: " +
+                              std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+
+        for (auto i = 0; i < dims_.size(); ++i) {
+            dims_[i].set_chunk_size_px(settings->dimensions[i].chunk_size_px);
+            dims_[i].set_shard_size_chunks(
+              settings->dimensions[i].shard_size_chunks);
+        }
+        ZarrArraySettings_destroy_dimension_array(settings);
+
+        py::dict result;
+        result["memory_bytes"] = suggestion.memory_bytes;
+        result["chunk_bytes"] = suggestion.chunk_bytes;
+        result["shard_bytes"] = suggestion.shard_bytes;
+        result["frames_per_flush"] = suggestion.frames_per_flush;
+        result["seconds_per_flush"] = suggestion.seconds_per_flush;
+        result["files_per_hour"] = suggestion.files_per_hour;
+
+        return result;
+    }
+
   private:
     std::string output_key_;
     std::optional<PyZarrCompressionSettings> compression_settings_;
@@ -693,6 +1215,16 @@ class PyZarrArraySettings
     ZarrDataType data_type_{ ZarrDataType_uint8 };
     std::optional<ZarrDownsamplingMethod> downsampling_method_{ std::nullopt };
     std::vector<std::string> storage_dimension_order_;
+    ZarrPixelFormat input_pixel_format_{ ZarrPixelFormat_Native };
+    uint8_t significant_bits_{ 0 };
+    std::optional<PyZarrInputConversion> input_conversion_;
+    std::optional<PyZarrFrameReduction> frame_reduction_;
+    bool compute_statistics_{ false };
+    std::optional<PyZarrProjection> projection_;
+    bool enable_preview_{ false };
+    bool chunk_checksums_{ false };
+    ZarrChunkOrder chunk_order_{ ZarrChunkOrder_RowMajor };
+    std::optional<PyZarrFrameMetadata> frame_metadata_;
 };
 
 class PyZarrFieldOfView
@@ -953,6 +1485,37 @@ class PyZarrStreamSettings
         py_s3_settings_ = settings;
     }
 
+    const std::optional<PyZarrCaptureSettings>& capture() const
+    {
+        return py_capture_settings_;
+    }
+
+    void set_capture(const std::optional<PyZarrCaptureSettings>& settings)
+    {
+        py_capture_settings_ = settings;
+    }
+
+    const std::optional<PyZarrCooperativeSettings>& cooperative() const
+    {
+        return py_cooperative_settings_;
+    }
+
+    void set_cooperative(
+      const std::optional<PyZarrCooperativeSettings>& settings)
+    {
+        py_cooperative_settings_ = settings;
+    }
+
+    const std::optional<PyZarrBandwidthLimit>& bandwidth_limit() const
+    {
+        return py_bandwidth_limit_;
+    }
+
+    void set_bandwidth_limit(const std::optional<PyZarrBandwidthLimit>& limit)
+    {
+        py_bandwidth_limit_ = limit;
+    }
+
     unsigned int max_threads() const { return max_threads_; }
 
     void set_max_threads(unsigned int max_threads)
@@ -963,6 +1526,54 @@ class PyZarrStreamSettings
     bool overwrite() const { return overwrite_; }
     void set_overwrite(bool overwrite) { overwrite_ = overwrite; }
 
+    unsigned int metadata_update_interval_ms() const
+    {
+        return metadata_update_interval_ms_;
+    }
+    void set_metadata_update_interval_ms(unsigned int interval_ms)
+    {
+        metadata_update_interval_ms_ = interval_ms;
+    }
+
+    unsigned int checkpoint_interval_ms() const
+    {
+        return checkpoint_interval_ms_;
+    }
+    void set_checkpoint_interval_ms(unsigned int interval_ms)
+    {
+        checkpoint_interval_ms_ = interval_ms;
+    }
+
+    bool consolidate_metadata() const { return consolidate_metadata_; }
+    void set_consolidate_metadata(bool consolidate)
+    {
+        consolidate_metadata_ = consolidate;
+    }
+
+    bool resume() const { return resume_; }
+    void set_resume(bool resume) { resume_ = resume; }
+
+    unsigned int flush_interval_ms() const { return flush_interval_ms_; }
+    void set_flush_interval_ms(unsigned int interval_ms)
+    {
+        flush_interval_ms_ = interval_ms;
+    }
+
+    size_t max_region_buffer_bytes() const { return max_region_buffer_bytes_; }
+    void set_max_region_buffer_bytes(size_t bytes)
+    {
+        max_region_buffer_bytes_ = bytes;
+    }
+
+    bool verify_writes() const { return verify_writes_; }
+    void set_verify_writes(bool verify) { verify_writes_ = verify; }
+
+    bool calibrate() const { return calibrate_; }
+    void set_calibrate(bool calibrate) { calibrate_ = calibrate; }
+
+    double frame_rate_hz() const { return frame_rate_hz_; }
+    void set_frame_rate_hz(double rate) { frame_rate_hz_ = rate; }
+
     const std::vector<PyZarrArraySettings>& arrays() const { return arrays_; }
     std::vector<PyZarrArraySettings>& arrays() { return arrays_; }
 
@@ -986,12 +1597,36 @@ class PyZarrStreamSettings
         settings_.store_path = store_path_.c_str();
         settings_.max_threads = max_threads_;
         settings_.overwrite = static_cast<int>(overwrite_);
+        settings_.metadata_update_interval_ms = metadata_update_interval_ms_;
+        settings_.consolidate_metadata = consolidate_metadata_;
+        settings_.checkpoint_interval_ms = checkpoint_interval_ms_;
+        settings_.resume = resume_;
+        settings_.flush_interval_ms = flush_interval_ms_;
+        settings_.max_region_buffer_bytes = max_region_buffer_bytes_;
+        settings_.verify_writes = verify_writes_;
+        settings_.calibrate = calibrate_;
+        settings_.frame_rate_hz = frame_rate_hz_;
 
         if (py_s3_settings_) {
             s3_settings_ = *py_s3_settings_->settings();
             settings_.s3_settings = &s3_settings_;
         }
 
+        if (py_capture_settings_) {
+            capture_settings_ = *py_capture_settings_->settings();
+            settings_.capture = &capture_settings_;
+        }
+
+        if (py_cooperative_settings_) {
+            cooperative_settings_ = *py_cooperative_settings_->settings();
+            settings_.cooperative = &cooperative_settings_;
+        }
+
+        if (py_bandwidth_limit_) {
+            bandwidth_limit_ = *py_bandwidth_limit_->settings();
+            settings_.bandwidth_limit = &bandwidth_limit_;
+        }
+
         // construct array lifetime props and set up arrays
         const size_t n_arrays = arrays_.size();
 
@@ -1079,13 +1714,34 @@ class PyZarrStreamSettings
   private:
     std::string store_path_;
     mutable std::optional<PyZarrS3Settings> py_s3_settings_{ std::nullopt };
+    mutable std::optional<PyZarrCaptureSettings> py_capture_settings_{
+        std::nullopt
+    };
+    mutable std::optional<PyZarrCooperativeSettings> py_cooperative_settings_{
+        std::nullopt
+    };
+    mutable std::optional<PyZarrBandwidthLimit> py_bandwidth_limit_{
+        std::nullopt
+    };
     unsigned int max_threads_{ std::thread::hardware_concurrency() };
     bool overwrite_{ false };
+    unsigned int metadata_update_interval_ms_{ 0 };
+    bool consolidate_metadata_{ false };
+    unsigned int checkpoint_interval_ms_{ 0 };
+    bool resume_{ false };
+    unsigned int flush_interval_ms_{ 0 };
+    size_t max_region_buffer_bytes_{ 0 };
+    bool verify_writes_{ false };
+    bool calibrate_{ false };
+    double frame_rate_hz_{ 0.0 };
 
     std::vector<PyZarrArraySettings> arrays_;
     std::vector<PyZarrPlate> plates_;
 
     mutable ZarrS3Settings s3_settings_;
+    mutable ZarrCaptureSettings capture_settings_;
+    mutable ZarrCooperativeSettings cooperative_settings_;
+    mutable ZarrBandwidthLimit bandwidth_limit_;
 
     mutable std::vector<ArrayLifetimeProps> array_lifetimes_;
     mutable std::vector<PlateLifetimeProps> plate_lifetimes_;
@@ -1131,6 +1787,78 @@ class PyZarrStream
         iterate_and_append(image_data, 0, std::vector<py::ssize_t>(), key);
     }
 
+    void append_frame(py::array frame,
+                      uint64_t frame_index,
+                      const std::optional<std::string>& key) const
+    {
+        if (!is_active()) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Stream not open for appending.");
+            throw py::error_already_set();
+        }
+
+        py::array contiguous_data = frame;
+        if (!(frame.flags() & py::array::c_style)) {
+            py::module np = py::module::import("numpy");
+            contiguous_data = np.attr("ascontiguousarray")(frame);
+        }
+
+        const auto buf = contiguous_data.request();
+        const char* key_str = key.has_value() ? key->c_str() : nullptr;
+        const size_t bytes_in = buf.itemsize * buf.size;
+
+        ZarrStatusCode status;
+        {
+            py::gil_scoped_release release;
+            status = ZarrStream_append_frame(
+              stream_.get(), buf.ptr, bytes_in, frame_index, key_str);
+        }
+
+        if (status != ZarrStatusCode_Success) {
+            const std::string err =
+              "Failed to append frame " + std::to_string(frame_index) + ": " +
+              std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+    }
+
+    void append_frame_metadata(py::array records,
+                               const std::optional<std::string>& key) const
+    {
+        if (!is_active()) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Stream not open for appending.");
+            throw py::error_already_set();
+        }
+
+        py::array contiguous_data = records;
+        if (!(records.flags() & py::array::c_style)) {
+            py::module np = py::module::import("numpy");
+            contiguous_data = np.attr("ascontiguousarray")(records);
+        }
+
+        const auto buf = contiguous_data.request();
+        const char* key_str = key.has_value() ? key->c_str() : nullptr;
+        const size_t bytes_in = buf.itemsize * buf.size;
+
+        size_t bytes_out;
+        ZarrStatusCode status;
+        {
+            py::gil_scoped_release release;
+            status = ZarrStream_append_frame_metadata(
+              stream_.get(), buf.ptr, bytes_in, &bytes_out, key_str);
+        }
+
+        if (status != ZarrStatusCode_Success) {
+            const std::string err =
+              "Failed to append frame metadata: " +
+              std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+    }
+
     void skip(size_t bytes_in, const std::optional<std::string>& key) const
     {
         size_t bytes_out;
@@ -1273,47 +2001,275 @@ class PyZarrStream
             throw py::error_already_set();
         }
 
-        return true;
-    }
+        return true;
+    }
+
+    void flush() const
+    {
+        if (!is_active()) {
+            PyErr_SetString(PyExc_RuntimeError, "Stream not open for flushing.");
+            throw py::error_already_set();
+        }
+
+        ZarrStatusCode status;
+        {
+            py::gil_scoped_release release;
+            status = ZarrStream_flush(stream_.get());
+        }
+
+        if (status != ZarrStatusCode_Success) {
+            const std::string err = "Failed to flush Zarr stream: " +
+                                    std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+    }
+
+    void write_chunk(py::buffer data,
+                     const std::vector<uint64_t>& chunk_coords,
+                     const std::optional<std::string>& key,
+                     bool is_compressed) const
+    {
+        if (!is_active()) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Cannot write chunks unless streaming.");
+            throw py::error_already_set();
+        }
+
+        const auto buf = data.request();
+        if (!PyBuffer_IsContiguous(buf.view(), 'C')) {
+            PyErr_SetString(PyExc_ValueError, "Chunk data must be contiguous.");
+            throw py::error_already_set();
+        }
+
+        const char* key_str = key.has_value() ? key->c_str() : nullptr;
+        const size_t bytes_in = buf.itemsize * buf.size;
+
+        ZarrStatusCode status;
+        {
+            py::gil_scoped_release release;
+            status = ZarrStream_write_chunk(stream_.get(),
+                                            key_str,
+                                            chunk_coords.data(),
+                                            chunk_coords.size(),
+                                            buf.ptr,
+                                            bytes_in,
+                                            is_compressed);
+        }
+
+        if (status != ZarrStatusCode_Success) {
+            const std::string err = "Failed to write chunk: " +
+                                    std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+    }
+
+    void write_region(py::array data,
+                      const std::vector<uint64_t>& offset,
+                      const std::optional<std::string>& key) const
+    {
+        if (!is_active()) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Cannot write regions unless streaming.");
+            throw py::error_already_set();
+        }
+
+        if (offset.size() != data.ndim()) {
+            PyErr_SetString(PyExc_ValueError,
+                            "Region offset must have one entry for each "
+                            "dimension of the data.");
+            throw py::error_already_set();
+        }
+
+        py::array contiguous_data = data;
+        if (!(data.flags() & py::array::c_style)) {
+            py::module np = py::module::import("numpy");
+            contiguous_data = np.attr("ascontiguousarray")(data);
+        }
+
+        const auto buf = contiguous_data.request();
+        const std::vector<uint64_t> shape(buf.shape.begin(), buf.shape.end());
+        const char* key_str = key.has_value() ? key->c_str() : nullptr;
+        const size_t bytes_in = buf.itemsize * buf.size;
+
+        ZarrStatusCode status;
+        {
+            py::gil_scoped_release release;
+            status = ZarrStream_write_region(stream_.get(),
+                                             key_str,
+                                             offset.data(),
+                                             shape.data(),
+                                             shape.size(),
+                                             buf.ptr,
+                                             bytes_in);
+        }
+
+        if (status != ZarrStatusCode_Success) {
+            const std::string err = "Failed to write region: " +
+                                    std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+    }
+
+    bool is_active() const { return static_cast<bool>(stream_); }
+
+    void close()
+    {
+        if (!is_active()) {
+            return;
+        }
+
+        try {
+            stream_.reset(); // calls ZarrStream_destroy
+        } catch (const std::exception& exc) {
+            std::string err =
+              "Failed to close Zarr stream: " + std::string(exc.what());
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+    }
+
+    size_t get_current_memory_usage() const
+    {
+        if (!is_active()) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Stream not open for memory usage query.");
+            throw py::error_already_set();
+        }
+
+        size_t usage = 0;
+        auto status =
+          ZarrStream_get_current_memory_usage(stream_.get(), &usage);
+
+        if (status != ZarrStatusCode_Success) {
+            std::string err = "Failed to get current memory usage: " +
+                              std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+
+        return usage;
+    }
+
+    py::dict get_statistics(const std::optional<std::string>& key,
+                            std::optional<int64_t> channel) const
+    {
+        if (!is_active()) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Stream not open for statistics query.");
+            throw py::error_already_set();
+        }
+
+        const char* key_str = key.has_value() ? key->c_str() : nullptr;
+        ZarrArrayStatistics stats;
+        auto status = ZarrStream_get_statistics(
+          stream_.get(), key_str, channel.value_or(-1), &stats);
+
+        if (status != ZarrStatusCode_Success) {
+            std::string err = "Failed to get statistics: " +
+                              std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+
+        py::dict result;
+        result["count"] = stats.count;
+        result["sum"] = stats.sum;
+        if (stats.count > 0) {
+            result["min"] = stats.min;
+            result["max"] = stats.max;
+            result["mean"] = stats.sum / static_cast<double>(stats.count);
+        } else {
+            result["min"] = py::none();
+            result["max"] = py::none();
+            result["mean"] = py::none();
+        }
+        if (stats.histogram_bins > 0) {
+            result["histogram_min"] = stats.histogram_min;
+            result["histogram_max"] = stats.histogram_max;
+            result["histogram"] = std::vector<uint64_t>(
+              stats.histogram, stats.histogram + stats.histogram_bins);
+        }
 
-    bool is_active() const { return static_cast<bool>(stream_); }
+        return result;
+    }
 
-    void close()
+    py::object get_preview(const std::optional<std::string>& key,
+                           uint16_t level) const
     {
         if (!is_active()) {
-            return;
+            PyErr_SetString(PyExc_RuntimeError,
+                            "Stream not open for preview query.");
+            throw py::error_already_set();
         }
 
-        try {
-            stream_.reset(); // calls ZarrStream_destroy
-        } catch (const std::exception& exc) {
-            std::string err =
-              "Failed to close Zarr stream: " + std::string(exc.what());
+        const char* key_str = key.has_value() ? key->c_str() : nullptr;
+        ZarrPreviewInfo info;
+        auto status = ZarrStream_get_preview(
+          stream_.get(), key_str, level, nullptr, 0, &info);
+        if (status != ZarrStatusCode_Success) {
+            std::string err = "Failed to get preview: " +
+                              std::string(Zarr_get_status_message(status));
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+
+        py::array frame(zarr_datatype_to_numpy_dtype(info.data_type),
+                        { info.height, info.width });
+        status = ZarrStream_get_preview(stream_.get(),
+                                        key_str,
+                                        level,
+                                        frame.mutable_data(),
+                                        frame.nbytes(),
+                                        &info);
+        if (status != ZarrStatusCode_Success) {
+            std::string err = "Failed to get preview: " +
+                              std::string(Zarr_get_status_message(status));
             PyErr_SetString(PyExc_RuntimeError, err.c_str());
             throw py::error_already_set();
         }
+
+        if (!info.has_frame) {
+            return py::none();
+        }
+
+        return frame;
     }
 
-    size_t get_current_memory_usage() const
+    py::object get_calibration() const
     {
         if (!is_active()) {
             PyErr_SetString(PyExc_RuntimeError,
-                            "Stream not open for memory usage query.");
+                            "Stream not open for calibration query.");
             throw py::error_already_set();
         }
 
-        size_t usage = 0;
-        auto status =
-          ZarrStream_get_current_memory_usage(stream_.get(), &usage);
-
+        ZarrCalibration calibration;
+        auto status = ZarrStream_get_calibration(stream_.get(), &calibration);
         if (status != ZarrStatusCode_Success) {
-            std::string err = "Failed to get current memory usage: " +
+            std::string err = "Failed to get calibration: " +
                               std::string(Zarr_get_status_message(status));
             PyErr_SetString(PyExc_RuntimeError, err.c_str());
             throw py::error_already_set();
         }
 
-        return usage;
+        if (!calibration.calibrated) {
+            return py::none();
+        }
+
+        py::dict result;
+        result["cores"] = calibration.cores;
+        result["threads"] = calibration.threads;
+        result["compress_bytes_per_second"] =
+          calibration.compress_bytes_per_second;
+        result["write_bytes_per_second"] = calibration.write_bytes_per_second;
+        result["compression_threads"] = calibration.compression_threads;
+        result["io_threads"] = calibration.io_threads;
+        result["max_frame_rate_hz"] = calibration.max_frame_rate_hz;
+
+        return result;
     }
 
   private:
@@ -1345,6 +2301,113 @@ class PyZarrStream
     }
 };
 
+class PyZarrReader
+{
+  public:
+    PyZarrReader(const std::string& store_path,
+                 const std::optional<std::string>& key,
+                 std::optional<PyZarrS3Settings> s3,
+                 unsigned int max_threads)
+    {
+        ZarrReaderSettings settings{
+            .store_path = store_path.c_str(),
+            .s3_settings = s3 ? s3->settings() : nullptr,
+            .array_key = key ? key->c_str() : nullptr,
+            .max_threads = max_threads,
+        };
+
+        reader_ = ZarrReaderPtr(ZarrReader_open(&settings), ZarrReaderDeleter);
+        if (!reader_) {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to open Zarr array");
+            throw py::error_already_set();
+        }
+
+        size_t ndims;
+        check_status_(
+          ZarrReader_get_array_info(reader_.get(), &data_type_, &ndims),
+          "Failed to get array info");
+
+        shape_.resize(ndims);
+        chunk_shape_.resize(ndims);
+        check_status_(
+          ZarrReader_get_shape(
+            reader_.get(), shape_.data(), chunk_shape_.data(), ndims),
+          "Failed to get array shape");
+    }
+
+    ZarrDataType data_type() const { return data_type_; }
+    std::vector<uint64_t> shape() const { return shape_; }
+    std::vector<uint64_t> chunk_shape() const { return chunk_shape_; }
+
+    py::array read_chunk(const std::vector<uint64_t>& chunk_coords)
+    {
+        py::array chunk(zarr_datatype_to_numpy_dtype(data_type_),
+                        std::vector<py::ssize_t>(chunk_shape_.begin(),
+                                                 chunk_shape_.end()));
+
+        ZarrStatusCode status;
+        {
+            py::gil_scoped_release release;
+            status = ZarrReader_read_chunk(reader_.get(),
+                                           chunk_coords.data(),
+                                           chunk_coords.size(),
+                                           chunk.mutable_data(),
+                                           chunk.nbytes());
+        }
+        check_status_(status, "Failed to read chunk");
+
+        return chunk;
+    }
+
+    py::array read_region(const std::vector<uint64_t>& offset,
+                          const std::vector<uint64_t>& shape)
+    {
+        if (offset.size() != shape.size()) {
+            PyErr_SetString(PyExc_ValueError,
+                            "offset and shape must have the same length");
+            throw py::error_already_set();
+        }
+
+        py::array region(zarr_datatype_to_numpy_dtype(data_type_),
+                         std::vector<py::ssize_t>(shape.begin(), shape.end()));
+
+        ZarrStatusCode status;
+        {
+            py::gil_scoped_release release;
+            status = ZarrReader_read_region(reader_.get(),
+                                            offset.data(),
+                                            shape.data(),
+                                            shape.size(),
+                                            region.mutable_data(),
+                                            region.nbytes());
+        }
+        check_status_(status, "Failed to read region");
+
+        return region;
+    }
+
+    void close() { reader_.reset(); }
+
+  private:
+    using ZarrReaderPtr =
+      std::unique_ptr<ZarrReader, decltype(ZarrReaderDeleter)>;
+
+    ZarrReaderPtr reader_{ nullptr, ZarrReaderDeleter };
+    ZarrDataType data_type_{ ZarrDataType_uint8 };
+    std::vector<uint64_t> shape_;
+    std::vector<uint64_t> chunk_shape_;
+
+    void check_status_(ZarrStatusCode status, const std::string& what) const
+    {
+        if (status != ZarrStatusCode_Success) {
+            const std::string err =
+              what + ": " + Zarr_get_status_message(status);
+            PyErr_SetString(PyExc_RuntimeError, err.c_str());
+            throw py::error_already_set();
+        }
+    }
+};
+
 PYBIND11_MODULE(acquire_zarr, m)
 {
     py::options options;
@@ -1408,6 +2471,30 @@ PYBIND11_MODULE(acquire_zarr, m)
       .value("MIN", ZarrDownsamplingMethod_Min)
       .value("MAX", ZarrDownsamplingMethod_Max);
 
+    py::enum_<ZarrPixelFormat>(m, "PixelFormat")
+      .value("NATIVE", ZarrPixelFormat_Native)
+      .value("MONO10P", ZarrPixelFormat_Mono10p)
+      .value("MONO12P", ZarrPixelFormat_Mono12p)
+      .value("MONO12PACKED", ZarrPixelFormat_Mono12Packed);
+
+    py::enum_<ZarrBinningMethod>(m, "BinningMethod")
+      .value("MEAN", ZarrBinningMethod_Mean)
+      .value("SUM", ZarrBinningMethod_Sum);
+
+    py::enum_<ZarrProjectionMethod>(m, "ProjectionMethod")
+      .value("MAX", ZarrProjectionMethod_Max)
+      .value("MEAN", ZarrProjectionMethod_Mean);
+
+    py::enum_<ZarrChunkOrder>(m, "ChunkOrder")
+      .value("ROW_MAJOR", ZarrChunkOrder_RowMajor)
+      .value("MORTON", ZarrChunkOrder_Morton)
+      .value("TILE_MAJOR", ZarrChunkOrder_TileMajor);
+
+    py::enum_<ZarrReadPattern>(m, "ReadPattern")
+      .value("FRAMES", ZarrReadPattern_Frames)
+      .value("TILES", ZarrReadPattern_Tiles)
+      .value("VOLUMES", ZarrReadPattern_Volumes);
+
     py::enum_<ZarrLogLevel>(m, "LogLevel")
       .value(log_level_to_str(ZarrLogLevel_Debug), ZarrLogLevel_Debug)
       .value(log_level_to_str(ZarrLogLevel_Info), ZarrLogLevel_Info)
@@ -1447,6 +2534,118 @@ PYBIND11_MODULE(acquire_zarr, m)
       .def_property(
         "region", &PyZarrS3Settings::region, &PyZarrS3Settings::set_region);
 
+    py::class_<PyZarrCaptureSettings>(m, "CaptureSettings", py::dynamic_attr())
+      .def(py::init([](std::optional<std::string> path,
+                       std::optional<bool> hash_payloads,
+                       std::optional<unsigned int> payload_sample_interval) {
+               PyZarrCaptureSettings settings;
+
+               if (path) {
+                   settings.set_path(*path);
+               }
+               if (hash_payloads) {
+                   settings.set_hash_payloads(*hash_payloads);
+               }
+               if (payload_sample_interval) {
+                   settings.set_payload_sample_interval(
+                     *payload_sample_interval);
+               }
+
+               return settings;
+           }),
+           py::kw_only(),
+           py::arg("path") = std::nullopt,
+           py::arg("hash_payloads") = std::nullopt,
+           py::arg("payload_sample_interval") = std::nullopt)
+      .def("__repr__",
+           [](const PyZarrCaptureSettings& self) { return self.repr(); })
+      .def_property("path",
+                    &PyZarrCaptureSettings::path,
+                    &PyZarrCaptureSettings::set_path)
+      .def_property("hash_payloads",
+                    &PyZarrCaptureSettings::hash_payloads,
+                    &PyZarrCaptureSettings::set_hash_payloads)
+      .def_property("payload_sample_interval",
+                    &PyZarrCaptureSettings::payload_sample_interval,
+                    &PyZarrCaptureSettings::set_payload_sample_interval);
+
+    py::class_<PyZarrCooperativeSettings>(
+      m, "CooperativeSettings", py::dynamic_attr())
+      .def(py::init([](std::optional<std::string> writer_id,
+                       std::optional<unsigned int> writer_count,
+                       std::optional<bool> coordinator,
+                       std::optional<unsigned int> timeout_ms) {
+               PyZarrCooperativeSettings settings;
+
+               if (writer_id) {
+                   settings.set_writer_id(*writer_id);
+               }
+               if (writer_count) {
+                   settings.set_writer_count(*writer_count);
+               }
+               if (coordinator) {
+                   settings.set_coordinator(*coordinator);
+               }
+               if (timeout_ms) {
+                   settings.set_timeout_ms(*timeout_ms);
+               }
+
+               return settings;
+           }),
+           py::kw_only(),
+           py::arg("writer_id") = std::nullopt,
+           py::arg("writer_count") = std::nullopt,
+           py::arg("coordinator") = std::nullopt,
+           py::arg("timeout_ms") = std::nullopt)
+      .def("__repr__",
+           [](const PyZarrCooperativeSettings& self) { return self.repr(); })
+      .def_property("writer_id",
+                    &PyZarrCooperativeSettings::writer_id,
+                    &PyZarrCooperativeSettings::set_writer_id)
+      .def_property("writer_count",
+                    &PyZarrCooperativeSettings::writer_count,
+                    &PyZarrCooperativeSettings::set_writer_count)
+      .def_property("coordinator",
+                    &PyZarrCooperativeSettings::coordinator,
+                    &PyZarrCooperativeSettings::set_coordinator)
+      .def_property("timeout_ms",
+                    &PyZarrCooperativeSettings::timeout_ms,
+                    &PyZarrCooperativeSettings::set_timeout_ms);
+
+    py::class_<PyZarrBandwidthLimit>(m, "BandwidthLimit", py::dynamic_attr())
+      .def(py::init([](std::optional<uint64_t> bytes_per_second,
+                       std::optional<uint64_t> burst_bytes,
+                       std::optional<bool> shared) {
+               PyZarrBandwidthLimit limit;
+
+               if (bytes_per_second) {
+                   limit.set_bytes_per_second(*bytes_per_second);
+               }
+               if (burst_bytes) {
+                   limit.set_burst_bytes(*burst_bytes);
+               }
+               if (shared) {
+                   limit.set_shared(*shared);
+               }
+
+               return limit;
+           }),
+           py::kw_only(),
+           py::arg("bytes_per_second") = std::nullopt,
+           py::arg("burst_bytes") = std::nullopt,
+           py::arg("shared") = std::nullopt)
+      .def("__repr__",
+           [](const PyZarrBandwidthLimit& self) { return self.repr(); })
+      .def_property("bytes_per_second",
+                    &PyZarrBandwidthLimit::bytes_per_second,
+                    &PyZarrBandwidthLimit::set_bytes_per_second)
+      .def_property("burst_bytes",
+                    &PyZarrBandwidthLimit::burst_bytes,
+                    &PyZarrBandwidthLimit::set_burst_bytes)
+      .def_property("shared",
+                    &PyZarrBandwidthLimit::shared,
+                    &PyZarrBandwidthLimit::set_shared);
+
     py::class_<PyZarrCompressionSettings>(
       m, "CompressionSettings", py::dynamic_attr())
       .def(py::init([](std::optional<ZarrCompressor> compressor,
@@ -1489,6 +2688,183 @@ PYBIND11_MODULE(acquire_zarr, m)
                     &PyZarrCompressionSettings::shuffle,
                     &PyZarrCompressionSettings::set_shuffle);
 
+    py::class_<PyZarrInputConversion>(m, "InputConversion", py::dynamic_attr())
+      .def(py::init([](std::optional<py::object> data_type,
+                       std::optional<double> scale,
+                       std::optional<double> offset,
+                       std::optional<int> right_shift) {
+               PyZarrInputConversion conversion;
+
+               if (data_type) {
+                   conversion.set_data_type(to_zarr_datatype(*data_type));
+               }
+               if (scale) {
+                   conversion.set_scale(*scale);
+               }
+               if (offset) {
+                   conversion.set_offset(*offset);
+               }
+               if (right_shift) {
+                   conversion.set_right_shift(*right_shift);
+               }
+               return conversion;
+           }),
+           py::kw_only(),
+           py::arg("data_type") = std::nullopt,
+           py::arg("scale") = std::nullopt,
+           py::arg("offset") = std::nullopt,
+           py::arg("right_shift") = std::nullopt)
+      .def("__repr__",
+           [](const PyZarrInputConversion& self) { return self.repr(); })
+      .def_property(
+        "data_type",
+        &PyZarrInputConversion::data_type,
+        [](PyZarrInputConversion& self, const py::object& obj) {
+            self.set_data_type(to_zarr_datatype(obj));
+        })
+      .def_property("scale",
+                    &PyZarrInputConversion::scale,
+                    &PyZarrInputConversion::set_scale)
+      .def_property("offset",
+                    &PyZarrInputConversion::offset,
+                    &PyZarrInputConversion::set_offset)
+      .def_property("right_shift",
+                    &PyZarrInputConversion::right_shift,
+                    &PyZarrInputConversion::set_right_shift);
+
+    py::class_<PyZarrFrameReduction>(m, "FrameReduction", py::dynamic_attr())
+      .def(py::init([](std::optional<uint32_t> frame_width,
+                       std::optional<uint32_t> frame_height,
+                       std::optional<uint32_t> roi_x,
+                       std::optional<uint32_t> roi_y,
+                       std::optional<uint32_t> binning,
+                       std::optional<ZarrBinningMethod> binning_method) {
+               PyZarrFrameReduction reduction;
+
+               if (frame_width) {
+                   reduction.set_frame_width(*frame_width);
+               }
+               if (frame_height) {
+                   reduction.set_frame_height(*frame_height);
+               }
+               if (roi_x) {
+                   reduction.set_roi_x(*roi_x);
+               }
+               if (roi_y) {
+                   reduction.set_roi_y(*roi_y);
+               }
+               if (binning) {
+                   reduction.set_binning(*binning);
+               }
+               if (binning_method) {
+                   reduction.set_binning_method(*binning_method);
+               }
+               return reduction;
+           }),
+           py::kw_only(),
+           py::arg("frame_width") = std::nullopt,
+           py::arg("frame_height") = std::nullopt,
+           py::arg("roi_x") = std::nullopt,
+           py::arg("roi_y") = std::nullopt,
+           py::arg("binning") = std::nullopt,
+           py::arg("binning_method") = std::nullopt)
+      .def("__repr__",
+           [](const PyZarrFrameReduction& self) { return self.repr(); })
+      .def_property("frame_width",
+                    &PyZarrFrameReduction::frame_width,
+                    &PyZarrFrameReduction::set_frame_width)
+      .def_property("frame_height",
+                    &PyZarrFrameReduction::frame_height,
+                    &PyZarrFrameReduction::set_frame_height)
+      .def_property("roi_x",
+                    &PyZarrFrameReduction::roi_x,
+                    &PyZarrFrameReduction::set_roi_x)
+      .def_property("roi_y",
+                    &PyZarrFrameReduction::roi_y,
+                    &PyZarrFrameReduction::set_roi_y)
+      .def_property("binning",
+                    &PyZarrFrameReduction::binning,
+                    &PyZarrFrameReduction::set_binning)
+      .def_property("binning_method",
+                    &PyZarrFrameReduction::binning_method,
+                    &PyZarrFrameReduction::set_binning_method);
+
+    py::class_<PyZarrProjection>(m, "Projection", py::dynamic_attr())
+      .def(py::init([](std::optional<std::string> dimension,
+                       std::optional<ZarrProjectionMethod> method) {
+               PyZarrProjection projection;
+
+               if (dimension) {
+                   projection.set_dimension(*dimension);
+               }
+               if (method) {
+                   projection.set_method(*method);
+               }
+               return projection;
+           }),
+           py::kw_only(),
+           py::arg("dimension") = std::nullopt,
+           py::arg("method") = std::nullopt)
+      .def("__repr__", [](const PyZarrProjection& self) { return self.repr(); })
+      .def_property("dimension",
+                    &PyZarrProjection::dimension,
+                    &PyZarrProjection::set_dimension)
+      .def_property(
+        "method", &PyZarrProjection::method, &PyZarrProjection::set_method);
+
+    py::class_<PyZarrFrameMetadata>(m, "FrameMetadata", py::dynamic_attr())
+      .def(py::init([](std::optional<py::object> data_type,
+                       std::optional<uint32_t> field_count,
+                       std::optional<std::vector<std::string>> field_names,
+                       std::optional<uint32_t> records_per_chunk,
+                       std::optional<uint32_t> chunks_per_shard) {
+               PyZarrFrameMetadata metadata;
+
+               if (data_type) {
+                   metadata.set_data_type(to_zarr_datatype(*data_type));
+               }
+               if (field_names) {
+                   metadata.set_field_names(*field_names);
+                   metadata.set_field_count(field_names->size());
+               }
+               if (field_count) {
+                   metadata.set_field_count(*field_count);
+               }
+               if (records_per_chunk) {
+                   metadata.set_records_per_chunk(*records_per_chunk);
+               }
+               if (chunks_per_shard) {
+                   metadata.set_chunks_per_shard(*chunks_per_shard);
+               }
+               return metadata;
+           }),
+           py::kw_only(),
+           py::arg("data_type") = std::nullopt,
+           py::arg("field_count") = std::nullopt,
+           py::arg("field_names") = std::nullopt,
+           py::arg("records_per_chunk") = std::nullopt,
+           py::arg("chunks_per_shard") = std::nullopt)
+      .def("__repr__",
+           [](const PyZarrFrameMetadata& self) { return self.repr(); })
+      .def_property(
+        "data_type",
+        &PyZarrFrameMetadata::data_type,
+        [](PyZarrFrameMetadata& self, const py::object& obj) {
+            self.set_data_type(to_zarr_datatype(obj));
+        })
+      .def_property("field_count",
+                    &PyZarrFrameMetadata::field_count,
+                    &PyZarrFrameMetadata::set_field_count)
+      .def_property("field_names",
+                    &PyZarrFrameMetadata::field_names,
+                    &PyZarrFrameMetadata::set_field_names)
+      .def_property("records_per_chunk",
+                    &PyZarrFrameMetadata::records_per_chunk,
+                    &PyZarrFrameMetadata::set_records_per_chunk)
+      .def_property("chunks_per_shard",
+                    &PyZarrFrameMetadata::chunks_per_shard,
+                    &PyZarrFrameMetadata::set_chunks_per_shard);
+
     py::class_<PyZarrDimensionProperties>(m, "Dimension", py::dynamic_attr())
       .def(py::init([](std::optional<std::string> name,
                        std::optional<ZarrDimensionType> kind,
@@ -1562,7 +2938,17 @@ PYBIND11_MODULE(acquire_zarr, m)
                     std::optional<py::list> dimensions,
                     std::optional<py::object> data_type,
                     std::optional<ZarrDownsamplingMethod> downsampling_method,
-                    std::optional<py::list> storage_dimension_order) {
+                    std::optional<py::list> storage_dimension_order,
+                    std::optional<ZarrPixelFormat> input_pixel_format,
+                    std::optional<uint8_t> significant_bits,
+                    std::optional<PyZarrInputConversion> input_conversion,
+                    std::optional<PyZarrFrameReduction> frame_reduction,
+                    std::optional<bool> compute_statistics,
+                    std::optional<PyZarrProjection> projection,
+                    std::optional<bool> enable_preview,
+                    std::optional<bool> chunk_checksums,
+                    std::optional<ZarrChunkOrder> chunk_order,
+                    std::optional<PyZarrFrameMetadata> frame_metadata) {
             PyZarrArraySettings settings;
 
             if (output_key) {
@@ -1608,6 +2994,36 @@ PYBIND11_MODULE(acquire_zarr, m)
                 }
                 settings.set_storage_dimension_order(order_vec);
             }
+            if (input_pixel_format) {
+                settings.set_input_pixel_format(*input_pixel_format);
+            }
+            if (significant_bits) {
+                settings.set_significant_bits(*significant_bits);
+            }
+            if (input_conversion) {
+                settings.set_input_conversion(*input_conversion);
+            }
+            if (frame_reduction) {
+                settings.set_frame_reduction(*frame_reduction);
+            }
+            if (compute_statistics) {
+                settings.set_compute_statistics(*compute_statistics);
+            }
+            if (projection) {
+                settings.set_projection(*projection);
+            }
+            if (enable_preview) {
+                settings.set_enable_preview(*enable_preview);
+            }
+            if (chunk_checksums) {
+                settings.set_chunk_checksums(*chunk_checksums);
+            }
+            if (chunk_order) {
+                settings.set_chunk_order(*chunk_order);
+            }
+            if (frame_metadata) {
+                settings.set_frame_metadata(*frame_metadata);
+            }
 
             return settings;
         }),
@@ -1617,7 +3033,17 @@ PYBIND11_MODULE(acquire_zarr, m)
         py::arg("dimensions") = std::nullopt,
         py::arg("data_type") = std::nullopt,
         py::arg("downsampling_method") = std::nullopt,
-        py::arg("storage_dimension_order") = std::nullopt)
+        py::arg("storage_dimension_order") = std::nullopt,
+        py::arg("input_pixel_format") = std::nullopt,
+        py::arg("significant_bits") = std::nullopt,
+        py::arg("input_conversion") = std::nullopt,
+        py::arg("frame_reduction") = std::nullopt,
+        py::arg("compute_statistics") = std::nullopt,
+        py::arg("projection") = std::nullopt,
+        py::arg("enable_preview") = std::nullopt,
+        py::arg("chunk_checksums") = std::nullopt,
+        py::arg("chunk_order") = std::nullopt,
+        py::arg("frame_metadata") = std::nullopt)
       .def("__repr__",
            [](const PyZarrArraySettings& self) {
                std::string repr =
@@ -1733,7 +3159,93 @@ PYBIND11_MODULE(acquire_zarr, m)
         })
       .def_property("storage_dimension_order",
                     &PyZarrArraySettings::storage_dimension_order,
-                    &PyZarrArraySettings::set_storage_dimension_order);
+                    &PyZarrArraySettings::set_storage_dimension_order)
+      .def_property("input_pixel_format",
+                    &PyZarrArraySettings::input_pixel_format,
+                    &PyZarrArraySettings::set_input_pixel_format)
+      .def_property("significant_bits",
+                    &PyZarrArraySettings::significant_bits,
+                    &PyZarrArraySettings::set_significant_bits)
+      .def_property(
+        "input_conversion",
+        [](const PyZarrArraySettings& self) -> py::object {
+            if (self.input_conversion()) {
+                return py::cast(*self.input_conversion());
+            }
+            return py::none();
+        },
+        [](PyZarrArraySettings& self, py::object& obj) {
+            if (obj.is_none()) {
+                self.set_input_conversion(std::nullopt);
+            } else {
+                self.set_input_conversion(obj.cast<PyZarrInputConversion>());
+            }
+        })
+      .def_property(
+        "frame_reduction",
+        [](const PyZarrArraySettings& self) -> py::object {
+            if (self.frame_reduction()) {
+                return py::cast(*self.frame_reduction());
+            }
+            return py::none();
+        },
+        [](PyZarrArraySettings& self, py::object& obj) {
+            if (obj.is_none()) {
+                self.set_frame_reduction(std::nullopt);
+            } else {
+                self.set_frame_reduction(obj.cast<PyZarrFrameReduction>());
+            }
+        })
+      .def_property("compute_statistics",
+                    &PyZarrArraySettings::compute_statistics,
+                    &PyZarrArraySettings::set_compute_statistics)
+      .def_property(
+        "projection",
+        [](const PyZarrArraySettings& self) -> py::object {
+            if (self.projection()) {
+                return py::cast(*self.projection());
+            }
+            return py::none();
+        },
+        [](PyZarrArraySettings& self, py::object& obj) {
+            if (obj.is_none()) {
+                self.set_projection(std::nullopt);
+            } else {
+                self.set_projection(obj.cast<PyZarrProjection>());
+            }
+        })
+      .def_property(
+        "frame_metadata",
+        [](const PyZarrArraySettings& self) -> py::object {
+            if (self.frame_metadata()) {
+                return py::cast(*self.frame_metadata());
+            }
+            return py::none();
+        },
+        [](PyZarrArraySettings& self, py::object& obj) {
+            if (obj.is_none()) {
+                self.set_frame_metadata(std::nullopt);
+            } else {
+                self.set_frame_metadata(obj.cast<PyZarrFrameMetadata>());
+            }
+        })
+      .def_property("enable_preview",
+                    &PyZarrArraySettings::enable_preview,
+                    &PyZarrArraySettings::set_enable_preview)
+      .def_property("chunk_checksums",
+                    &PyZarrArraySettings::chunk_checksums,
+                    &PyZarrArraySettings::set_chunk_checksums)
+      .def_property("chunk_order",
+                    &PyZarrArraySettings::chunk_order,
+                    &PyZarrArraySettings::set_chunk_order)
+      .def("suggest_geometry",
+           &PyZarrArraySettings::suggest_geometry,
+           py::arg("target_memory_bytes"),
+           py::arg("target_shard_bytes"),
+           py::arg("read_pattern") = ZarrReadPattern_Frames,
+           py::arg("frame_rate_hz") = 0.0,
+           "Set chunk and shard sizes suited to the read pattern and memory "
+           "budget, and return the expected streaming behaviour.");
 
     py::class_<PyZarrFieldOfView>(m, "FieldOfView", py::dynamic_attr())
       .def(py::init([](std::optional<std::string> path,
@@ -2098,7 +3610,19 @@ PYBIND11_MODULE(acquire_zarr, m)
                        std::optional<unsigned> max_threads,
                        std::optional<bool> overwrite,
                        std::optional<py::list> arrays,
-                       std::optional<py::list> hcs_plates) {
+                       std::optional<py::list> hcs_plates,
+                       std::optional<unsigned> metadata_update_interval_ms,
+                       std::optional<bool> consolidate_metadata,
+                       std::optional<unsigned> checkpoint_interval_ms,
+                       std::optional<bool> resume,
+                       std::optional<unsigned> flush_interval_ms,
+                       std::optional<size_t> max_region_buffer_bytes,
+                       std::optional<bool> verify_writes,
+                       std::optional<bool> calibrate,
+                       std::optional<double> frame_rate_hz,
+                       std::optional<PyZarrCaptureSettings> capture,
+                       std::optional<PyZarrCooperativeSettings> cooperative,
+                       std::optional<PyZarrBandwidthLimit> bandwidth_limit) {
                PyZarrStreamSettings settings;
                if (store_path) {
                    settings.set_store_path(*store_path);
@@ -2119,6 +3643,44 @@ PYBIND11_MODULE(acquire_zarr, m)
                if (overwrite) {
                    settings.set_overwrite(*overwrite);
                }
+               if (metadata_update_interval_ms) {
+                   settings.set_metadata_update_interval_ms(
+                     *metadata_update_interval_ms);
+               }
+               if (consolidate_metadata) {
+                   settings.set_consolidate_metadata(*consolidate_metadata);
+               }
+               if (checkpoint_interval_ms) {
+                   settings.set_checkpoint_interval_ms(*checkpoint_interval_ms);
+               }
+               if (resume) {
+                   settings.set_resume(*resume);
+               }
+               if (flush_interval_ms) {
+                   settings.set_flush_interval_ms(*flush_interval_ms);
+               }
+               if (max_region_buffer_bytes) {
+                   settings.set_max_region_buffer_bytes(
+                     *max_region_buffer_bytes);
+               }
+               if (verify_writes) {
+                   settings.set_verify_writes(*verify_writes);
+               }
+               if (calibrate) {
+                   settings.set_calibrate(*calibrate);
+               }
+               if (frame_rate_hz) {
+                   settings.set_frame_rate_hz(*frame_rate_hz);
+               }
+               if (capture) {
+                   settings.set_capture(*capture);
+               }
+               if (cooperative) {
+                   settings.set_cooperative(*cooperative);
+               }
+               if (bandwidth_limit) {
+                   settings.set_bandwidth_limit(*bandwidth_limit);
+               }
                if (arrays) {
                    auto& arrs = *arrays;
                    std::vector<PyZarrArraySettings> arrs_vec(arrs.size());
@@ -2147,7 +3709,19 @@ PYBIND11_MODULE(acquire_zarr, m)
            py::arg("max_threads") = std::nullopt,
            py::arg("overwrite") = std::nullopt,
            py::arg("arrays") = std::nullopt,
-           py::arg("hcs_plates") = std::nullopt)
+           py::arg("hcs_plates") = std::nullopt,
+           py::arg("metadata_update_interval_ms") = std::nullopt,
+           py::arg("consolidate_metadata") = std::nullopt,
+           py::arg("checkpoint_interval_ms") = std::nullopt,
+           py::arg("resume") = std::nullopt,
+           py::arg("flush_interval_ms") = std::nullopt,
+           py::arg("max_region_buffer_bytes") = std::nullopt,
+           py::arg("verify_writes") = std::nullopt,
+           py::arg("calibrate") = std::nullopt,
+           py::arg("frame_rate_hz") = std::nullopt,
+           py::arg("capture") = std::nullopt,
+           py::arg("cooperative") = std::nullopt,
+           py::arg("bandwidth_limit") = std::nullopt)
       .def("__repr__",
            [](const PyZarrStreamSettings& self) {
                std::string repr =
@@ -2183,6 +3757,51 @@ PYBIND11_MODULE(acquire_zarr, m)
                 self.set_s3(obj.cast<PyZarrS3Settings>());
             }
         })
+      .def_property(
+        "capture",
+        [](const PyZarrStreamSettings& self) -> py::object {
+            if (self.capture()) {
+                return py::cast(*self.capture());
+            }
+            return py::none();
+        },
+        [](PyZarrStreamSettings& self, py::object& obj) {
+            if (obj.is_none()) {
+                self.set_capture(std::nullopt);
+            } else {
+                self.set_capture(obj.cast<PyZarrCaptureSettings>());
+            }
+        })
+      .def_property(
+        "cooperative",
+        [](const PyZarrStreamSettings& self) -> py::object {
+            if (self.cooperative()) {
+                return py::cast(*self.cooperative());
+            }
+            return py::none();
+        },
+        [](PyZarrStreamSettings& self, py::object& obj) {
+            if (obj.is_none()) {
+                self.set_cooperative(std::nullopt);
+            } else {
+                self.set_cooperative(obj.cast<PyZarrCooperativeSettings>());
+            }
+        })
+      .def_property(
+        "bandwidth_limit",
+        [](const PyZarrStreamSettings& self) -> py::object {
+            if (self.bandwidth_limit()) {
+                return py::cast(*self.bandwidth_limit());
+            }
+            return py::none();
+        },
+        [](PyZarrStreamSettings& self, py::object& obj) {
+            if (obj.is_none()) {
+                self.set_bandwidth_limit(std::nullopt);
+            } else {
+                self.set_bandwidth_limit(obj.cast<PyZarrBandwidthLimit>());
+            }
+        })
       .def_property(
         "version",
         [](const PyZarrStreamSettings& self) { return ZarrVersion_3; },
@@ -2202,6 +3821,33 @@ PYBIND11_MODULE(acquire_zarr, m)
       .def_property("overwrite",
                     &PyZarrStreamSettings::overwrite,
                     &PyZarrStreamSettings::set_overwrite)
+      .def_property("metadata_update_interval_ms",
+                    &PyZarrStreamSettings::metadata_update_interval_ms,
+                    &PyZarrStreamSettings::set_metadata_update_interval_ms)
+      .def_property("consolidate_metadata",
+                    &PyZarrStreamSettings::consolidate_metadata,
+                    &PyZarrStreamSettings::set_consolidate_metadata)
+      .def_property("checkpoint_interval_ms",
+                    &PyZarrStreamSettings::checkpoint_interval_ms,
+                    &PyZarrStreamSettings::set_checkpoint_interval_ms)
+      .def_property("resume",
+                    &PyZarrStreamSettings::resume,
+                    &PyZarrStreamSettings::set_resume)
+      .def_property("flush_interval_ms",
+                    &PyZarrStreamSettings::flush_interval_ms,
+                    &PyZarrStreamSettings::set_flush_interval_ms)
+      .def_property("max_region_buffer_bytes",
+                    &PyZarrStreamSettings::max_region_buffer_bytes,
+                    &PyZarrStreamSettings::set_max_region_buffer_bytes)
+      .def_property("verify_writes",
+                    &PyZarrStreamSettings::verify_writes,
+                    &PyZarrStreamSettings::set_verify_writes)
+      .def_property("calibrate",
+                    &PyZarrStreamSettings::calibrate,
+                    &PyZarrStreamSettings::set_calibrate)
+      .def_property("frame_rate_hz",
+                    &PyZarrStreamSettings::frame_rate_hz,
+                    &PyZarrStreamSettings::set_frame_rate_hz)
       .def_property(
         "arrays",
         [](PyZarrStreamSettings& self) -> py::object {
@@ -2258,6 +3904,17 @@ PYBIND11_MODULE(acquire_zarr, m)
            &PyZarrStream::append,
            py::arg("data"),
            py::arg("key") = std::nullopt)
+      .def("append_frame",
+           &PyZarrStream::append_frame,
+           py::arg("data"),
+           py::arg("frame_index"),
+           py::arg("key") = std::nullopt,
+           "Append a single frame at an explicit index, possibly out of order.")
+      .def("append_frame_metadata",
+           &PyZarrStream::append_frame_metadata,
+           py::arg("records"),
+           py::arg("key") = std::nullopt,
+           "Append per-frame metadata records to an array.")
       .def("skip",
            &PyZarrStream::skip,
            py::arg("n_bytes"),
@@ -2266,10 +3923,68 @@ PYBIND11_MODULE(acquire_zarr, m)
            &PyZarrStream::write_custom_metadata,
            py::arg("custom_metadata"),
            py::arg("overwrite"))
+      .def("flush",
+           &PyZarrStream::flush,
+           "Write all data appended so far to the store without closing the "
+           "stream.")
+      .def("write_chunk",
+           &PyZarrStream::write_chunk,
+           py::arg("data"),
+           py::arg("chunk_coords"),
+           py::arg("key") = std::nullopt,
+           py::arg("is_compressed") = false,
+           "Write a single, possibly compressed, chunk directly into its "
+           "shard.")
+      .def("write_region",
+           &PyZarrStream::write_region,
+           py::arg("data"),
+           py::arg("offset"),
+           py::arg("key") = std::nullopt,
+           "Write a hyperslab of data, e.g., one tile of a mosaic, at the "
+           "given offset.")
       .def("is_active", &PyZarrStream::is_active)
       .def("get_current_memory_usage",
            &PyZarrStream::get_current_memory_usage,
-           "Get the current memory usage of the stream in bytes.");
+           "Get the current memory usage of the stream in bytes.")
+      .def("get_statistics",
+           &PyZarrStream::get_statistics,
+           py::arg("key") = std::nullopt,
+           py::arg("channel") = std::nullopt,
+           "Get the pixel statistics of an array, or of one of its channels.")
+      .def("get_preview",
+           &PyZarrStream::get_preview,
+           py::arg("key") = std::nullopt,
+           py::arg("level") = 0,
+           "Get a copy of the most recent frame appended to an array, or None "
+           "if no frame has been appended yet.")
+      .def("get_calibration",
+           &PyZarrStream::get_calibration,
+           "Get the results of the startup calibration, or None if the stream "
+           "was not calibrated.");
+
+    py::class_<PyZarrReader>(m, "ZarrReader")
+      .def(py::init<const std::string&,
+                    const std::optional<std::string>&,
+                    std::optional<PyZarrS3Settings>,
+                    unsigned int>(),
+           py::arg("store_path"),
+           py::arg("key") = std::nullopt,
+           py::arg("s3") = std::nullopt,
+           py::arg("max_threads") = std::thread::hardware_concurrency())
+      .def_property_readonly("data_type", &PyZarrReader::data_type)
+      .def_property_readonly("shape", &PyZarrReader::shape)
+      .def_property_readonly("chunk_shape", &PyZarrReader::chunk_shape)
+      .def("read_chunk",
+           &PyZarrReader::read_chunk,
+           py::arg("chunk_coords"),
+           "Read and decode a single chunk, including any padding past the "
+           "edge of the array.")
+      .def("read_region",
+           &PyZarrReader::read_region,
+           py::arg("offset"),
+           py::arg("shape"),
+           "Read a hyperslab of the array at the given offset.")
+      .def("close", &PyZarrReader::close);
 
     m.def(
       "set_log_level",
@@ -2285,6 +4000,20 @@ PYBIND11_MODULE(acquire_zarr, m)
       "Set the log level for the Zarr API",
       py::arg("level"));
 
+    m.def(
+      "recover_store",
+      [](const std::string& store_path) {
+          auto status = Zarr_recover_store(store_path.c_str());
+          if (status != ZarrStatusCode_Success) {
+              std::string err = "Failed to recover store: " +
+                                std::string(Zarr_get_status_message(status));
+              PyErr_SetString(PyExc_RuntimeError, err.c_str());
+              throw py::error_already_set();
+          }
+      },
+      "Make the shards of an interrupted, checkpointed acquisition readable",
+      py::arg("store_path"));
+
     m.def(
       "get_log_level",
       []() { return Zarr_get_log_level(); },
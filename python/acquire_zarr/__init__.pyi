@@ -16,22 +16,36 @@ from typing import Any, ClassVar, List, Optional, Union
 __all__ = [
     "Acquisition",
     "ArraySettings",
+    "BandwidthLimit",
+    "BinningMethod",
+    "CaptureSettings",
+    "ChunkOrder",
     "CompressionCodec",
     "CompressionSettings",
     "Compressor",
+    "CooperativeSettings",
     "DataType",
     "Dimension",
     "DimensionType",
     "DownsamplingMethod",
     "FieldOfView",
+    "FrameMetadata",
+    "FrameReduction",
+    "InputConversion",
     "LogLevel",
+    "PixelFormat",
     "Plate",
+    "Projection",
+    "ProjectionMethod",
+    "ReadPattern",
     "S3Settings",
     "StreamSettings",
     "Well",
+    "ZarrReader",
     "ZarrStream",
     "ZarrVersion",
     "get_log_level",
+    "recover_store",
     "set_log_level",
 ]
 
@@ -95,6 +109,33 @@ class ArraySettings:
             - The first dimension *may not* be moved to a non-leading position.
             - The last two dimensions *may not* be moved out of the final two positions,
               but MAY be swapped with each other.
+      input_pixel_format: Layout of the frames passed to append. Packed formats
+        require a uint16 data type; frames are then passed as packed bytes and
+        unpacked as they are written to chunks.
+      significant_bits: Number of low bits stored per sample with the packbits
+        codec, e.g., 12 for a 12-bit camera. Requires an unsigned integer data
+        type. 0 (default) stores samples in full.
+      input_conversion: Conversion of appended frames from another data type,
+        e.g., appending uint16 frames to a uint8 array. If None (default),
+        frames are appended in `data_type`.
+      frame_reduction: Cropping and binning of appended frames, applied after
+        `input_conversion`. If None (default), appended frames are the size of
+        the last two dimensions.
+      compute_statistics: Accumulate the count, extrema, sum and histogram of
+        appended pixels, for the whole array and for each channel, and write
+        them to the array's attributes on close. Defaults to False.
+      projection: Running projection of appended frames, written to a sibling
+        array. Requires a nonempty `output_key`. If None (default), no
+        projection is made.
+      enable_preview: Keep the most recently appended frame, at every
+        multiscale level, for `ZarrStream.get_preview`. Defaults to False.
+      chunk_checksums: Append a crc32c checksum to each chunk, listed as a
+        `crc32c` codec in the array metadata. Defaults to False.
+      chunk_order: Order in which the chunks appended to each layer of a shard
+        are laid out in the shard file. Defaults to ChunkOrder.ROW_MAJOR.
+      frame_metadata: Per-frame records appended with
+        `ZarrStream.append_frame_metadata` and written to a sibling array.
+        Requires a nonempty `output_key`. If None (default), none are kept.
     """
 
     output_key: str
@@ -103,9 +144,174 @@ class ArraySettings:
     compression: Optional[CompressionSettings]
     downsampling_method: Optional[DownsamplingMethod]
     storage_dimension_order: List[str]
+    input_pixel_format: PixelFormat
+    significant_bits: int
+    input_conversion: Optional[InputConversion]
+    frame_reduction: Optional[FrameReduction]
+    compute_statistics: bool
+    projection: Optional[Projection]
+    enable_preview: bool
+    chunk_checksums: bool
+    chunk_order: ChunkOrder
+    frame_metadata: Optional[FrameMetadata]
 
     def __init__(self, **kwargs) -> None: ...
     def __repr__(self) -> str: ...
+    def suggest_geometry(
+        self,
+        target_memory_bytes: int,
+        target_shard_bytes: int,
+        read_pattern: ReadPattern = ReadPattern.FRAMES,
+        frame_rate_hz: float = 0.0,
+    ) -> dict[str, Any]:
+        """Set chunk and shard sizes suited to a read pattern and memory budget.
+
+        The array sizes, types, data type, compression and downsampling method
+        must already be set. Overwrites each dimension's `chunk_size_px` and
+        `shard_size_chunks`, and returns a dict with the expected
+        `memory_bytes`, `chunk_bytes`, `shard_bytes`, `frames_per_flush`,
+        `seconds_per_flush` and `files_per_hour`. The last two are 0 unless
+        `frame_rate_hz` is given.
+        """
+
+class BandwidthLimit:
+    """A limit on the bandwidth a stream writes to storage with.
+
+    Writes draw from a token bucket, which smooths flushes while the frame queue absorbs
+    the difference. While the queue is more than three quarters full, writes may borrow
+    up to another burst ahead of the limit.
+
+    Attributes:
+        bytes_per_second: Sustained write bandwidth.
+        burst_bytes: Bytes that may be written at once after an idle period. 0 means a
+            tenth of a second's worth.
+        shared: If True, share one limit among all streams in the process that set this.
+            The first such stream's limit applies while any of them is open.
+    """
+
+    bytes_per_second: int
+    burst_bytes: int
+    shared: bool
+
+    def __init__(self, **kwargs) -> None: ...
+    def __repr__(self) -> str: ...
+
+class BinningMethod:
+    """
+    How binned pixels are combined.
+
+    Attributes:
+      MEAN: The mean of the binned pixels, rounded to nearest
+      SUM: The sum of the binned pixels, saturated to the array's data type
+    """
+
+    MEAN: ClassVar[BinningMethod]  # value = <BinningMethod.MEAN: 0>
+    SUM: ClassVar[BinningMethod]  # value = <BinningMethod.SUM: 1>
+    __members__: ClassVar[
+        dict[str, BinningMethod]
+    ]  # value = {'MEAN': <BinningMethod.MEAN: 0>, 'SUM': <BinningMethod.SUM: 1>}
+
+    def __eq__(self, other: Any) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __init__(self, value: int) -> None: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __repr__(self) -> str: ...
+    def __setstate__(self, state: int) -> None: ...
+    def __str__(self) -> str: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class CaptureSettings:
+    """Settings for capturing the appends made to a stream, for offline replay.
+
+    The capture is a JSON Lines file: the stream settings, then one record per append
+    with its array key, byte counts, status, start time and latency. Replay it with the
+    acquire-zarr-replay benchmark.
+
+    Attributes:
+        path: Path of the capture file to write.
+        hash_payloads: If True, record a crc32c of each payload.
+        payload_sample_interval: Copy every nth payload to "<path>.payloads" for replay.
+            0 copies none.
+    """
+
+    path: str
+    hash_payloads: bool
+    payload_sample_interval: int
+
+    def __init__(self, **kwargs) -> None: ...
+    def __repr__(self) -> str: ...
+
+class ChunkOrder:
+    """
+    Physical order of the chunks in each layer of a shard. The shard index
+    records where each chunk lands, so the order only affects how many
+    separate reads it takes to fetch neighbouring chunks.
+
+    Attributes:
+      ROW_MAJOR: Chunks in index order
+      MORTON: Z-order curve over the chunk coordinates
+      TILE_MAJOR: Every chunk of a YX tile stored together
+    """
+
+    ROW_MAJOR: ClassVar[ChunkOrder]  # value = <ChunkOrder.ROW_MAJOR: 0>
+    MORTON: ClassVar[ChunkOrder]  # value = <ChunkOrder.MORTON: 1>
+    TILE_MAJOR: ClassVar[ChunkOrder]  # value = <ChunkOrder.TILE_MAJOR: 2>
+    __members__: ClassVar[
+        dict[str, ChunkOrder]
+    ]  # value = {'ROW_MAJOR': <ChunkOrder.ROW_MAJOR: 0>, 'MORTON': <ChunkOrder.MORTON: 1>, 'TILE_MAJOR': <ChunkOrder.TILE_MAJOR: 2>}
+
+    def __eq__(self, other: Any) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __init__(self, value: int) -> None: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __repr__(self) -> str: ...
+    def __setstate__(self, state: int) -> None: ...
+    def __str__(self) -> str: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class ReadPattern:
+    """
+    How an array will mostly be read, for `ArraySettings.suggest_geometry`.
+
+    Attributes:
+      FRAMES: Whole frames, one at a time
+      TILES: Small YX tiles, deep through the other dimensions
+      VOLUMES: Cubes of the spatial dimensions
+    """
+
+    FRAMES: ClassVar[ReadPattern]  # value = <ReadPattern.FRAMES: 0>
+    TILES: ClassVar[ReadPattern]  # value = <ReadPattern.TILES: 1>
+    VOLUMES: ClassVar[ReadPattern]  # value = <ReadPattern.VOLUMES: 2>
+    __members__: ClassVar[
+        dict[str, ReadPattern]
+    ]  # value = {'FRAMES': <ReadPattern.FRAMES: 0>, 'TILES': <ReadPattern.TILES: 1>, 'VOLUMES': <ReadPattern.VOLUMES: 2>}
+
+    def __eq__(self, other: Any) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __init__(self, value: int) -> None: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __repr__(self) -> str: ...
+    def __setstate__(self, state: int) -> None: ...
+    def __str__(self) -> str: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
 
 class CompressionCodec:
     """Codec to use for compression, if any.
@@ -183,6 +389,31 @@ class Compressor:
     @property
     def value(self) -> int: ...
 
+class CooperativeSettings:
+    """Settings for one of several writers streaming disjoint arrays into one store.
+
+    Writers, e.g., processes on different hosts sharing a parallel filesystem, claim
+    their arrays with lock files in the store's ".writers" directory. On close, each
+    publishes the metadata of its groups and arrays there, and the coordinator merges
+    it into the hierarchy metadata, including HCS plate and well metadata.
+
+    Attributes:
+        writer_id: Name of this writer, unique among the writers of the store.
+        writer_count: Number of writers of the store, including this one.
+        coordinator: If True, this writer merges the hierarchy metadata on close.
+            Exactly one writer must be the coordinator.
+        timeout_ms: How long the coordinator waits on close for the other writers to
+            finish, in milliseconds. 0 waits indefinitely.
+    """
+
+    writer_id: str
+    writer_count: int
+    coordinator: bool
+    timeout_ms: int
+
+    def __init__(self, **kwargs) -> None: ...
+    def __repr__(self) -> str: ...
+
 class DataType:
     """
     Data type used in the stream.
@@ -330,6 +561,118 @@ class FieldOfView:
     def __init__(self, **kwargs) -> None: ...
     def __repr__(self) -> str: ...
 
+class PixelFormat:
+    """
+    Layout of appended frames.
+
+    Attributes:
+      NATIVE: One pixel of the array's data type per element
+      MONO10P: 4 10-bit pixels in 5 bytes, least significant bits first (GenICam PFNC)
+      MONO12P: 2 12-bit pixels in 3 bytes, least significant bits first (GenICam PFNC)
+      MONO12PACKED: 2 12-bit pixels in 3 bytes, GigE Vision layout
+    """
+
+    NATIVE: ClassVar[PixelFormat]  # value = <PixelFormat.NATIVE: 0>
+    MONO10P: ClassVar[PixelFormat]  # value = <PixelFormat.MONO10P: 1>
+    MONO12P: ClassVar[PixelFormat]  # value = <PixelFormat.MONO12P: 2>
+    MONO12PACKED: ClassVar[PixelFormat]  # value = <PixelFormat.MONO12PACKED: 3>
+    __members__: ClassVar[
+        dict[str, PixelFormat]
+    ]  # value = {'NATIVE': <PixelFormat.NATIVE: 0>, 'MONO10P': <PixelFormat.MONO10P: 1>, 'MONO12P': <PixelFormat.MONO12P: 2>, 'MONO12PACKED': <PixelFormat.MONO12PACKED: 3>}
+
+    def __eq__(self, other: Any) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __init__(self, value: int) -> None: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __repr__(self) -> str: ...
+    def __setstate__(self, state: int) -> None: ...
+    def __str__(self) -> str: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
+class FrameMetadata:
+    """
+    Fixed-size records, e.g. a timestamp, a stage position and an exposure,
+    appended alongside the frames of an array.
+
+    Records are written to a sibling array named "<output_key>_frame_metadata",
+    of shape (records,) if a record has one field, or (records, fields)
+    otherwise. They are chunked along the records, sharded, and compressed with
+    the array's compression settings. Full shards are written in the background;
+    the last, partial shard is written on close.
+
+    Attributes:
+      data_type: Type of every field. Defaults to float64.
+      field_count: Number of fields per record. Defaults to the number of
+        field names, or 1.
+      field_names: Names of the fields, stored in the array's attributes.
+      records_per_chunk: Records per chunk. 0 (default) means 4096.
+      chunks_per_shard: Chunks per shard. 0 (default) means 16.
+    """
+
+    data_type: Union[DataType, numpy.dtype]
+    field_count: int
+    field_names: List[str]
+    records_per_chunk: int
+    chunks_per_shard: int
+
+    def __init__(self, **kwargs) -> None: ...
+    def __repr__(self) -> str: ...
+
+class FrameReduction:
+    """
+    Cropping and binning of appended frames.
+
+    A window of (width * binning) x (height * binning) pixels, where width and
+    height are the sizes of the array's last two dimensions, is cut out of each
+    appended frame at (roi_x, roi_y) and binned down to width x height.
+
+    Attributes:
+      frame_width: Width of appended frames, in pixels.
+      frame_height: Height of appended frames, in pixels.
+      roi_x: Left edge of the kept window. Defaults to 0.
+      roi_y: Top edge of the kept window. Defaults to 0.
+      binning: Binning factor. Defaults to 1, no binning.
+      binning_method: How binned pixels are combined. Defaults to MEAN.
+    """
+
+    frame_width: int
+    frame_height: int
+    roi_x: int
+    roi_y: int
+    binning: int
+    binning_method: BinningMethod
+
+    def __init__(self, **kwargs) -> None: ...
+    def __repr__(self) -> str: ...
+
+class InputConversion:
+    """
+    Conversion of appended samples to the data type of an array.
+
+    Each sample x is stored as (x >> right_shift) * scale + offset, rounded to
+    nearest and saturated to the array's data type.
+
+    Attributes:
+      data_type: Data type of the appended samples.
+      scale: Multiplier applied after shifting. Defaults to 1.
+      offset: Added after scaling. Defaults to 0.
+      right_shift: Bits to shift integer samples right by first. Defaults to 0.
+    """
+
+    data_type: Union[DataType, numpy.dtype]
+    scale: float
+    offset: float
+    right_shift: int
+
+    def __init__(self, **kwargs) -> None: ...
+    def __repr__(self) -> str: ...
+
 class LogLevel:
     """
     Severity level to filter logs by.
@@ -388,6 +731,56 @@ class Plate:
     def __init__(self, **kwargs) -> None: ...
     def __repr__(self) -> str: ...
 
+class Projection:
+    """
+    A running projection of an array along one of its dimensions.
+
+    The projection is written to a sibling array named
+    "<output_key>_<method>_<dimension>", e.g. "raw_max_z", without the projected
+    dimension. Projected frames are written as soon as the projected dimension
+    wraps; projections along the append dimension are written on close.
+
+    Attributes:
+      dimension: Name of the dimension to project along; not one of the last two.
+      method: How frames are combined. Defaults to MAX.
+    """
+
+    dimension: str
+    method: ProjectionMethod
+
+    def __init__(self, **kwargs) -> None: ...
+    def __repr__(self) -> str: ...
+
+class ProjectionMethod:
+    """
+    How frames are combined into a projection.
+
+    Attributes:
+      MAX: Maximum intensity projection
+      MEAN: Mean of the projected frames, rounded to nearest for integer types
+    """
+
+    MAX: ClassVar[ProjectionMethod]  # value = <ProjectionMethod.MAX: 0>
+    MEAN: ClassVar[ProjectionMethod]  # value = <ProjectionMethod.MEAN: 1>
+    __members__: ClassVar[
+        dict[str, ProjectionMethod]
+    ]  # value = {'MAX': <ProjectionMethod.MAX: 0>, 'MEAN': <ProjectionMethod.MEAN: 1>}
+
+    def __eq__(self, other: Any) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __init__(self, value: int) -> None: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: Any) -> bool: ...
+    def __repr__(self) -> str: ...
+    def __setstate__(self, state: int) -> None: ...
+    def __str__(self) -> str: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
 class S3Settings:
     """Settings for connecting to and storing data in S3."""
 
@@ -412,6 +805,35 @@ class StreamSettings:
         max_threads: Maximum number of threads for parallel processing.
         custom_metadata: Optional JSON-formatted custom metadata to include in the dataset.
         overwrite: If True, removes any existing data at store_path before writing.
+        metadata_update_interval_ms: Minimum time between intermediate array metadata
+            updates, in milliseconds. 0 updates on every shard rollover. The final
+            metadata is always written when the stream closes.
+        consolidate_metadata: If True, embed the metadata of every node in the root group
+            (and each HCS plate) on close, so readers can open the hierarchy with one request.
+        checkpoint_interval_ms: Minimum time between checkpoints of partially written shard
+            indices, in milliseconds. 0 disables checkpointing. Use recover_store to make an
+            interrupted acquisition readable. Filesystem only.
+        resume: If True, continue appending to the arrays already at store_path instead of
+            starting over at index 0. Requires overwrite to be False. Filesystem only, and
+            not supported for multiscale arrays.
+        flush_interval_ms: Maximum time appended frames are held only in memory, in
+            milliseconds, before they are flushed as with ZarrStream.flush. 0 flushes only
+            on chunk boundaries. Filesystem only.
+        max_region_buffer_bytes: Memory each array may hold in partly written chunks from
+            ZarrStream.write_region before the least recently written are flushed. 0 means
+            no limit.
+        verify_writes: If True, re-read each shard in the background once it is finalized
+            and check it against its checksums, reporting mismatches as stream errors.
+            Filesystem only.
+        calibrate: If True, spend a fraction of a second at creation measuring compression
+            throughput and write bandwidth to the store. See ZarrStream.get_calibration.
+        frame_rate_hz: Frames expected per second to each array, or 0 if unknown. With
+            calibrate, a warning is logged if this exceeds the estimated maximum.
+        capture: Optional settings for capturing the appends made to the stream, so the
+            workload can be replayed offline.
+        cooperative: Optional settings for writing into a store along with other writers.
+            Requires overwrite to be False. Filesystem only.
+        bandwidth_limit: Optional limit on the bandwidth of writes to the store.
 
     Note:
         For S3 storage with endpoint "s3://my-endpoint.com", bucket "my-bucket", and
@@ -425,6 +847,18 @@ class StreamSettings:
     store_path: str
     max_threads: int
     overwrite: bool
+    metadata_update_interval_ms: int
+    consolidate_metadata: bool
+    checkpoint_interval_ms: int
+    resume: bool
+    flush_interval_ms: int
+    max_region_buffer_bytes: int
+    verify_writes: bool
+    calibrate: bool
+    frame_rate_hz: float
+    capture: Optional[CaptureSettings]
+    cooperative: Optional[CooperativeSettings]
+    bandwidth_limit: Optional[BandwidthLimit]
     plates: List[Plate]
 
     def __init__(self, **kwargs) -> None: ...
@@ -456,14 +890,101 @@ class ZarrStream:
     def append(
         self, data: numpy.ndarray, key: str | None = None
     ) -> None: ...
+    def append_frame(
+        self, data: numpy.ndarray, frame_index: int, key: str | None = None
+    ) -> None:
+        """Append a single frame at an explicit index, possibly out of order."""
+    def append_frame_metadata(
+        self, records: numpy.ndarray, key: str | None = None
+    ) -> None:
+        """Append per-frame metadata records to an array."""
     def skip(self, n_bytes: int) -> None: ...
     def write_custom_metadata(
         self, metadata: str, overwrite: bool = False
     ) -> bool: ...
+    def flush(self) -> None:
+        """Write all data appended so far to the store without closing the stream."""
+    def write_chunk(
+        self,
+        data: numpy.ndarray | bytes,
+        chunk_coords: list[int],
+        key: str | None = None,
+        is_compressed: bool = False,
+    ) -> None:
+        """Write a single, possibly compressed, chunk directly into its shard."""
+    def write_region(
+        self,
+        data: numpy.ndarray,
+        offset: list[int],
+        key: str | None = None,
+    ) -> None:
+        """Write a hyperslab of data, e.g., one tile of a mosaic, at the given offset.
+
+        Where regions overlap, the pixels written first are kept.
+        """
     def is_active(self) -> bool: ...
     def close(self) -> None: ...
     def get_current_memory_usage(self) -> int:
         """Get the current memory usage of the stream in bytes."""
+    def get_statistics(
+        self, key: str | None = None, channel: int | None = None
+    ) -> dict[str, Any]:
+        """Get the pixel statistics of an array, or of one of its channels.
+
+        Returns a dict with the `count`, `sum`, `min`, `max` and `mean` of the
+        pixels appended so far and, for integer data, the `histogram` bin counts
+        spanning [`histogram_min`, `histogram_max`).
+        """
+    def get_preview(
+        self, key: str | None = None, level: int = 0
+    ) -> numpy.ndarray | None:
+        """Get a copy of the most recent frame appended to an array.
+
+        Returns a 2D array in the layout frames were appended in, at the given
+        multiscale level, or None if no frame has been appended yet. The array
+        must have been created with `enable_preview` set.
+        """
+    def get_calibration(self) -> dict[str, Any] | None:
+        """Get the results of the startup calibration.
+
+        Returns a dict with the host's `cores`, the stream's `threads`, the
+        one-thread `compress_bytes_per_second`, the `write_bytes_per_second` to
+        the store, the suggested `compression_threads` and `io_threads`, and the
+        estimated `max_frame_rate_hz`, or None if the stream was created without
+        `calibrate`.
+        """
+
+class ZarrReader:
+    """Reader for an array written by a ZarrStream.
+
+    Shard indices are cached once read, and the chunks of a read are fetched and
+    decoded in parallel.
+
+    Args:
+        store_path: Path to the store, or the key prefix of the store in its bucket.
+        key: Key of the array in the store, or None for an array at the root.
+        s3: Optional S3 settings for the store.
+        max_threads: Maximum number of threads to read and decode chunks with.
+    """
+
+    def __init__(
+        self,
+        store_path: str,
+        key: str | None = None,
+        s3: S3Settings | None = None,
+        max_threads: int = ...,
+    ) -> None: ...
+    @property
+    def data_type(self) -> DataType: ...
+    @property
+    def shape(self) -> list[int]: ...
+    @property
+    def chunk_shape(self) -> list[int]: ...
+    def read_chunk(self, chunk_coords: list[int]) -> numpy.ndarray:
+        """Read and decode a single chunk, including any padding past the edge of the array."""
+    def read_region(self, offset: list[int], shape: list[int]) -> numpy.ndarray:
+        """Read a hyperslab of the array at the given offset."""
+    def close(self) -> None: ...
 
 class ZarrVersion:
     """
@@ -488,3 +1009,6 @@ def get_log_level() -> LogLevel:
 
 def set_log_level(level: LogLevel) -> None:
     """Set the log level for the Zarr API"""
+
+def recover_store(store_path: str) -> None:
+    """Make the shards of an interrupted, checkpointed acquisition readable"""
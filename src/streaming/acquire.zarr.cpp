@@ -1,10 +1,14 @@
 #include "acquire.zarr.h"
+#include "checkpoint.hh"
+#include "geometry.advisor.hh"
 #include "macros.hh"
 #include "zarr.common.hh"
+#include "zarr.reader.hh"
 #include "zarr.stream.hh"
 
-#include <bit>     // bit_ceil
-#include <cstdint> // uint32_t
+#include <algorithm> // copy
+#include <bit>       // bit_ceil
+#include <cstdint>   // uint32_t
 #include <unordered_set>
 #include <vector>
 
@@ -169,6 +173,22 @@ extern "C"
         }
     }
 
+    ZarrStatusCode Zarr_recover_store(const char* store_path)
+    {
+        EXPECT_VALID_ARGUMENT(store_path, "Null pointer: store_path");
+
+        try {
+            if (!zarr::recover_store(store_path)) {
+                return ZarrStatusCode_IOError;
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error recovering store: ", e.what());
+            return ZarrStatusCode_InternalError;
+        }
+
+        return ZarrStatusCode_Success;
+    }
+
     ZarrStatusCode ZarrStreamSettings_create_arrays(
       ZarrStreamSettings* settings,
       size_t array_count)
@@ -237,45 +257,7 @@ extern "C"
         *usage = (1 << 30); // start with 1 GiB for the frame queue
 
         for (size_t i = 0; i < settings->array_count; ++i) {
-            const auto& array = settings->arrays[i];
-            const auto& dims = array.dimensions;
-            const auto& ndims = array.dimension_count;
-
-            const size_t bytes_of_type = zarr::bytes_of_type(array.data_type);
-            const size_t frame_size_bytes = bytes_of_type *
-                                            dims[ndims - 2].array_size_px *
-                                            dims[ndims - 1].array_size_px;
-
-            *usage += frame_size_bytes; // each array has a frame buffer
-
-            size_t array_usage = bytes_of_type * dims[0].chunk_size_px;
-            for (auto j = 1; j < ndims; ++j) {
-                const auto& dim = dims[j];
-
-                // arrays may be ragged, so we need to account for fill values
-                const auto nchunks = zarr::parts_along_dimension(
-                  dim.array_size_px, dim.chunk_size_px);
-                size_t padded_array_size_px = nchunks * dim.chunk_size_px;
-
-                array_usage *= padded_array_size_px;
-            }
-
-            // compression can instantaneously double memory usage in the worst
-            // case, so we account for that here
-            if (array.compression_settings) {
-                array_usage *= 2;
-            }
-
-            if (array.multiscale) {
-                // we can bound the memory usage of multiscale arrays by
-                // observing that each downsampled level is at most half the
-                // size of the previous level, so the total memory usage is at
-                // most twice the size of the full-resolution, i.e.,
-                // sum(1/2^n)_{n=0}^{inf} = 2
-                array_usage *= 2;
-            }
-
-            *usage += array_usage;
+            *usage += zarr::estimate_array_memory_usage(settings->arrays[i]);
         }
 
         return ZarrStatusCode_Success;
@@ -359,6 +341,49 @@ extern "C"
         settings->dimension_count = 0;
     }
 
+    ZarrStatusCode ZarrArraySettings_suggest_geometry(
+      ZarrArraySettings* settings,
+      size_t target_memory_bytes,
+      size_t target_shard_bytes,
+      ZarrReadPattern read_pattern,
+      double frame_rate_hz,
+      ZarrGeometrySuggestion* suggestion)
+    {
+        EXPECT_VALID_ARGUMENT(settings, "Null pointer: settings");
+        EXPECT_VALID_ARGUMENT(settings->dimensions,
+                              "Null pointer: settings->dimensions");
+        EXPECT_VALID_ARGUMENT(suggestion, "Null pointer: suggestion");
+        EXPECT_VALID_ARGUMENT(read_pattern < ZarrReadPatternCount,
+                              "Invalid read pattern: ",
+                              read_pattern);
+        EXPECT_VALID_ARGUMENT(target_memory_bytes > 0,
+                              "Target memory must be nonzero");
+        EXPECT_VALID_ARGUMENT(target_shard_bytes > 0,
+                              "Target shard size must be nonzero");
+        EXPECT_VALID_ARGUMENT(frame_rate_hz >= 0.0,
+                              "Frame rate must be nonnegative: ",
+                              frame_rate_hz);
+
+        try {
+            std::string error;
+            if (!zarr::suggest_geometry(*settings,
+                                        target_memory_bytes,
+                                        target_shard_bytes,
+                                        read_pattern,
+                                        frame_rate_hz,
+                                        *suggestion,
+                                        error)) {
+                LOG_ERROR("Failed to suggest geometry: ", error);
+                return ZarrStatusCode_InvalidArgument;
+            }
+        } catch (const std::exception& exc) {
+            LOG_ERROR("Failed to suggest geometry: ", exc.what());
+            return ZarrStatusCode_InternalError;
+        }
+
+        return ZarrStatusCode_Success;
+    }
+
     ZarrStatusCode ZarrHCSWell_create_image_array(ZarrHCSWell* well,
                                                   size_t image_count)
     {
@@ -644,6 +669,116 @@ extern "C"
         return result;
     }
 
+    ZarrStatusCode ZarrStream_append_frame(struct ZarrStream_s* stream,
+                                           const void* data,
+                                           size_t bytes_in,
+                                           uint64_t frame_index,
+                                           const char* key)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+        EXPECT_VALID_ARGUMENT(data, "Null pointer: data");
+
+        ZarrStatusCode result;
+        try {
+            result = stream->append_frame(key, data, bytes_in, frame_index);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error appending frame: ", e.what());
+            result = ZarrStatusCode_InternalError;
+        }
+
+        return result;
+    }
+
+    ZarrStatusCode ZarrStream_append_frame_metadata(
+      struct ZarrStream_s* stream,
+      const void* data,
+      size_t bytes_in,
+      size_t* bytes_out,
+      const char* key)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+        EXPECT_VALID_ARGUMENT(data, "Null pointer: data");
+        EXPECT_VALID_ARGUMENT(bytes_out, "Null pointer: bytes_out");
+
+        ZarrStatusCode result;
+        try {
+            result =
+              stream->append_frame_metadata(key, data, bytes_in, *bytes_out);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error appending frame metadata: ", e.what());
+            result = ZarrStatusCode_InternalError;
+        }
+
+        return result;
+    }
+
+    ZarrStatusCode ZarrStream_flush(struct ZarrStream_s* stream)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+
+        ZarrStatusCode status;
+        try {
+            status = stream->flush();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error flushing stream: ", e.what());
+            status = ZarrStatusCode_InternalError;
+        }
+
+        return status;
+    }
+
+    ZarrStatusCode ZarrStream_write_chunk(struct ZarrStream_s* stream,
+                                          const char* key,
+                                          const uint64_t* chunk_coords,
+                                          size_t coord_count,
+                                          const void* data,
+                                          size_t bytes_in,
+                                          bool is_compressed)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+        EXPECT_VALID_ARGUMENT(chunk_coords, "Null pointer: chunk_coords");
+        EXPECT_VALID_ARGUMENT(data, "Null pointer: data");
+
+        ZarrStatusCode status;
+        try {
+            status = stream->write_chunk(key,
+                                         { chunk_coords, coord_count },
+                                         data,
+                                         bytes_in,
+                                         is_compressed);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error writing chunk: ", e.what());
+            status = ZarrStatusCode_InternalError;
+        }
+
+        return status;
+    }
+
+    ZarrStatusCode ZarrStream_write_region(struct ZarrStream_s* stream,
+                                           const char* key,
+                                           const uint64_t* offset,
+                                           const uint64_t* shape,
+                                           size_t ndims,
+                                           const void* data,
+                                           size_t bytes_in)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+        EXPECT_VALID_ARGUMENT(offset, "Null pointer: offset");
+        EXPECT_VALID_ARGUMENT(shape, "Null pointer: shape");
+        EXPECT_VALID_ARGUMENT(data, "Null pointer: data");
+
+        ZarrStatusCode status;
+        try {
+            status = stream->write_region(
+              key, { offset, ndims }, { shape, ndims }, data, bytes_in);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error writing region: ", e.what());
+            status = ZarrStatusCode_InternalError;
+        }
+
+        return status;
+    }
+
     ZarrStatusCode ZarrStream_write_custom_metadata(struct ZarrStream_s* stream,
                                                     const char* custom_metadata,
                                                     bool overwrite)
@@ -661,6 +796,57 @@ extern "C"
         return status;
     }
 
+    ZarrStatusCode ZarrStream_get_statistics(const ZarrStream* stream,
+                                             const char* key,
+                                             int64_t channel,
+                                             ZarrArrayStatistics* stats)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+        EXPECT_VALID_ARGUMENT(stats, "Null pointer: stats");
+
+        ZarrStatusCode status;
+        try {
+            status = stream->get_statistics(key, channel, stats);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error getting statistics: ", e.what());
+            status = ZarrStatusCode_InternalError;
+        }
+
+        return status;
+    }
+
+    ZarrStatusCode ZarrStream_get_calibration(const ZarrStream* stream,
+                                              ZarrCalibration* calibration)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+        EXPECT_VALID_ARGUMENT(calibration, "Null pointer: calibration");
+
+        *calibration = stream->calibration();
+
+        return ZarrStatusCode_Success;
+    }
+
+    ZarrStatusCode ZarrStream_get_preview(const ZarrStream* stream,
+                                          const char* key,
+                                          uint16_t level,
+                                          void* data,
+                                          size_t bytes_in,
+                                          ZarrPreviewInfo* info)
+    {
+        EXPECT_VALID_ARGUMENT(stream, "Null pointer: stream");
+        EXPECT_VALID_ARGUMENT(info, "Null pointer: info");
+
+        ZarrStatusCode status;
+        try {
+            status = stream->get_preview(key, level, data, bytes_in, info);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error getting preview: ", e.what());
+            status = ZarrStatusCode_InternalError;
+        }
+
+        return status;
+    }
+
     ZarrStatusCode ZarrStream_get_current_memory_usage(const ZarrStream* stream,
                                                        size_t* usage)
     {
@@ -676,4 +862,105 @@ extern "C"
 
         return ZarrStatusCode_Success;
     }
+
+    ZarrReader* ZarrReader_open(const ZarrReaderSettings* settings)
+    {
+        ZarrReader_s* reader = nullptr;
+
+        try {
+            reader = new ZarrReader_s(settings);
+        } catch (const std::bad_alloc&) {
+            LOG_ERROR("Failed to allocate memory for Zarr reader");
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error opening Zarr reader: ", e.what());
+        }
+
+        return reader;
+    }
+
+    void ZarrReader_close(ZarrReader* reader)
+    {
+        delete reader;
+    }
+
+    ZarrStatusCode ZarrReader_get_array_info(const ZarrReader* reader,
+                                             ZarrDataType* data_type,
+                                             size_t* ndims)
+    {
+        EXPECT_VALID_ARGUMENT(reader, "Null pointer: reader");
+        EXPECT_VALID_ARGUMENT(data_type, "Null pointer: data_type");
+        EXPECT_VALID_ARGUMENT(ndims, "Null pointer: ndims");
+
+        *data_type = reader->data_type();
+        *ndims = reader->shape().size();
+
+        return ZarrStatusCode_Success;
+    }
+
+    ZarrStatusCode ZarrReader_get_shape(const ZarrReader* reader,
+                                        uint64_t* shape,
+                                        uint64_t* chunk_shape,
+                                        size_t ndims)
+    {
+        EXPECT_VALID_ARGUMENT(reader, "Null pointer: reader");
+        EXPECT_VALID_ARGUMENT(shape, "Null pointer: shape");
+        EXPECT_VALID_ARGUMENT(ndims == reader->shape().size(),
+                              "Expected ",
+                              reader->shape().size(),
+                              " dimensions, got ",
+                              ndims);
+
+        std::ranges::copy(reader->shape(), shape);
+        if (chunk_shape != nullptr) {
+            std::ranges::copy(reader->chunk_shape(), chunk_shape);
+        }
+
+        return ZarrStatusCode_Success;
+    }
+
+    ZarrStatusCode ZarrReader_read_chunk(ZarrReader* reader,
+                                         const uint64_t* chunk_coords,
+                                         size_t coord_count,
+                                         void* data,
+                                         size_t bytes_in)
+    {
+        EXPECT_VALID_ARGUMENT(reader, "Null pointer: reader");
+        EXPECT_VALID_ARGUMENT(chunk_coords, "Null pointer: chunk_coords");
+        EXPECT_VALID_ARGUMENT(data, "Null pointer: data");
+
+        ZarrStatusCode status;
+        try {
+            status = reader->read_chunk(
+              { chunk_coords, coord_count }, data, bytes_in);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error reading chunk: ", e.what());
+            status = ZarrStatusCode_InternalError;
+        }
+
+        return status;
+    }
+
+    ZarrStatusCode ZarrReader_read_region(ZarrReader* reader,
+                                          const uint64_t* offset,
+                                          const uint64_t* shape,
+                                          size_t ndims,
+                                          void* data,
+                                          size_t bytes_in)
+    {
+        EXPECT_VALID_ARGUMENT(reader, "Null pointer: reader");
+        EXPECT_VALID_ARGUMENT(offset, "Null pointer: offset");
+        EXPECT_VALID_ARGUMENT(shape, "Null pointer: shape");
+        EXPECT_VALID_ARGUMENT(data, "Null pointer: data");
+
+        ZarrStatusCode status;
+        try {
+            status = reader->read_region(
+              { offset, ndims }, { shape, ndims }, data, bytes_in);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error reading region: ", e.what());
+            status = ZarrStatusCode_InternalError;
+        }
+
+        return status;
+    }
 }
\ No newline at end of file
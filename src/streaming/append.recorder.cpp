@@ -0,0 +1,221 @@
+#include "append.recorder.hh"
+#include "macros.hh"
+
+#include <crc32c/crc32c.h>
+
+namespace {
+// bump when the record layout changes incompatibly
+constexpr int capture_version = 2;
+
+nlohmann::json
+describe_array(const ZarrArraySettings& array)
+{
+    nlohmann::json dimensions = nlohmann::json::array();
+    for (auto i = 0; i < array.dimension_count; ++i) {
+        const auto& dim = array.dimensions[i];
+        dimensions.push_back({
+          { "name", dim.name ? dim.name : "" },
+          { "type", dim.type },
+          { "array_size_px", dim.array_size_px },
+          { "chunk_size_px", dim.chunk_size_px },
+          { "shard_size_chunks", dim.shard_size_chunks },
+          { "unit", dim.unit ? nlohmann::json(dim.unit) : nullptr },
+          { "scale", dim.scale },
+        });
+    }
+
+    nlohmann::json description = {
+        { "output_key",
+          array.output_key ? nlohmann::json(array.output_key) : nullptr },
+        { "data_type", array.data_type },
+        { "dimensions", dimensions },
+        { "multiscale", array.multiscale },
+        { "downsampling_method", array.downsampling_method },
+        { "input_pixel_format", array.input_pixel_format },
+        { "significant_bits", array.significant_bits },
+        { "compute_statistics", array.compute_statistics },
+        { "enable_preview", array.enable_preview },
+        { "chunk_checksums", array.chunk_checksums },
+        { "chunk_order", array.chunk_order },
+        { "compression", nullptr },
+        { "storage_dimension_order", nullptr },
+        { "input_conversion", nullptr },
+        { "frame_reduction", nullptr },
+        { "projection", nullptr },
+        { "frame_metadata", nullptr },
+    };
+
+    if (const auto* compression = array.compression_settings) {
+        description["compression"] = {
+            { "compressor", compression->compressor },
+            { "codec", compression->codec },
+            { "level", compression->level },
+            { "shuffle", compression->shuffle },
+        };
+    }
+    if (array.storage_dimension_order) {
+        description["storage_dimension_order"] =
+          std::vector<size_t>(array.storage_dimension_order,
+                              array.storage_dimension_order +
+                                array.dimension_count);
+    }
+    if (const auto* conversion = array.input_conversion) {
+        description["input_conversion"] = {
+            { "data_type", conversion->data_type },
+            { "scale", conversion->scale },
+            { "offset", conversion->offset },
+            { "right_shift", conversion->right_shift },
+        };
+    }
+    if (const auto* reduction = array.frame_reduction) {
+        description["frame_reduction"] = {
+            { "frame_width", reduction->frame_width },
+            { "frame_height", reduction->frame_height },
+            { "roi_x", reduction->roi_x },
+            { "roi_y", reduction->roi_y },
+            { "binning", reduction->binning },
+            { "binning_method", reduction->binning_method },
+        };
+    }
+    if (const auto* projection = array.projection) {
+        description["projection"] = {
+            { "dimension_name",
+              projection->dimension_name ? projection->dimension_name : "" },
+            { "method", projection->method },
+        };
+    }
+
+    if (const auto* metadata = array.frame_metadata) {
+        nlohmann::json field_names = nullptr;
+        if (metadata->field_names) {
+            field_names = nlohmann::json::array();
+            for (auto i = 0; i < metadata->field_count; ++i) {
+                const auto* name = metadata->field_names[i];
+                field_names.push_back(name ? name : "");
+            }
+        }
+        description["frame_metadata"] = {
+            { "data_type", metadata->data_type },
+            { "field_count", metadata->field_count },
+            { "field_names", field_names },
+            { "records_per_chunk", metadata->records_per_chunk },
+            { "chunks_per_shard", metadata->chunks_per_shard },
+        };
+    }
+
+    return description;
+}
+} // namespace
+
+zarr::AppendRecorder::AppendRecorder(const ZarrCaptureSettings& capture,
+                                     const ZarrStreamSettings& settings)
+  : hash_payloads_(capture.hash_payloads)
+  , payload_sample_interval_(capture.payload_sample_interval)
+  , origin_(Clock::now())
+  , n_records_(0)
+  , payload_bytes_(0)
+{
+    EXPECT(capture.path != nullptr, "Null pointer: capture path");
+    const std::string path(capture.path);
+
+    log_.open(path, std::ios::out | std::ios::trunc);
+    EXPECT(log_.is_open(), "Failed to open capture file ", path);
+
+    std::string payload_file;
+    if (payload_sample_interval_ > 0) {
+        payload_file = path + ".payloads";
+        payloads_.open(payload_file,
+                       std::ios::out | std::ios::trunc | std::ios::binary);
+        EXPECT(payloads_.is_open(),
+               "Failed to open capture file ",
+               payload_file);
+    }
+
+    const nlohmann::json header = {
+        { "version", capture_version },
+        { "settings", describe_settings(settings) },
+        { "hash_payloads", hash_payloads_ },
+        { "payload_sample_interval", payload_sample_interval_ },
+    };
+    log_ << header.dump() << '\n';
+    log_.flush();
+}
+
+void
+zarr::AppendRecorder::record(const char* key,
+                             const void* data,
+                             size_t bytes_in,
+                             size_t bytes_out,
+                             ZarrStatusCode status,
+                             Clock::time_point start,
+                             Clock::time_point end)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+
+    // hashing is done outside the lock, so concurrent producers only
+    // serialize on the writes
+    nlohmann::json entry = {
+        { "t_ns", duration_cast<nanoseconds>(start - origin_).count() },
+        { "latency_ns", duration_cast<nanoseconds>(end - start).count() },
+        { "key", key ? nlohmann::json(key) : nullptr },
+        { "bytes_in", bytes_in },
+        { "bytes_out", bytes_out },
+        { "status", status },
+    };
+    if (data == nullptr) {
+        entry["null_data"] = true;
+    } else if (hash_payloads_) {
+        entry["crc32c"] =
+          crc32c::Crc32c(static_cast<const uint8_t*>(data), bytes_in);
+    }
+
+    std::unique_lock lock(mutex_);
+
+    if (payload_sample_interval_ > 0 && data != nullptr &&
+        n_records_ % payload_sample_interval_ == 0) {
+        entry["payload_offset"] = payload_bytes_;
+        payloads_.write(static_cast<const char*>(data), bytes_in);
+        payload_bytes_ += bytes_in;
+    }
+    ++n_records_;
+
+    log_ << entry.dump() << '\n';
+    if (!log_.good()) {
+        LOG_ERROR("Failed to write to the capture file");
+    }
+}
+
+nlohmann::json
+zarr::AppendRecorder::describe_settings(const ZarrStreamSettings& settings)
+{
+    nlohmann::json arrays = nlohmann::json::array();
+    for (auto i = 0; i < settings.array_count; ++i) {
+        arrays.push_back(describe_array(settings.arrays[i]));
+    }
+
+    nlohmann::json bandwidth_limit = nullptr;
+    if (const auto* limit = settings.bandwidth_limit) {
+        bandwidth_limit = {
+            { "bytes_per_second", limit->bytes_per_second },
+            { "burst_bytes", limit->burst_bytes },
+            { "shared", limit->shared },
+        };
+    }
+
+    return {
+        { "store_path", settings.store_path ? settings.store_path : "" },
+        { "s3", settings.s3_settings != nullptr },
+        { "max_threads", settings.max_threads },
+        { "metadata_update_interval_ms", settings.metadata_update_interval_ms },
+        { "checkpoint_interval_ms", settings.checkpoint_interval_ms },
+        { "consolidate_metadata", settings.consolidate_metadata },
+        { "flush_interval_ms", settings.flush_interval_ms },
+        { "max_region_buffer_bytes", settings.max_region_buffer_bytes },
+        { "verify_writes", settings.verify_writes },
+        { "calibrate", settings.calibrate },
+        { "frame_rate_hz", settings.frame_rate_hz },
+        { "bandwidth_limit", bandwidth_limit },
+        { "arrays", arrays },
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "acquire.zarr.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace zarr {
+/**
+ * @brief Logs the ZarrStream_append calls made to a stream, for replay.
+ * @details The log is a JSON Lines file. Its first line describes the stream
+ * settings; every following line is one append: when it was called relative
+ * to the first, how long it took, the array key, the bytes passed in and
+ * taken, and the status returned. Payloads may be hashed with crc32c, and
+ * every nth payload copied to a sidecar file, "<path>.payloads", at the
+ * offset given in its record.
+ */
+class AppendRecorder
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Open the capture files and write the settings record.
+     * @param capture Where and what to capture.
+     * @param settings The settings of the stream being captured.
+     * @throws std::runtime_error if the capture files can't be opened.
+     */
+    AppendRecorder(const ZarrCaptureSettings& capture,
+                   const ZarrStreamSettings& settings);
+
+    /**
+     * @brief Record one append.
+     * @param key The key passed to the append, or nullptr.
+     * @param data The payload passed to the append, or nullptr.
+     * @param bytes_in The size of the payload.
+     * @param bytes_out The number of bytes the stream took.
+     * @param status The status the append returned.
+     * @param start When the append was called.
+     * @param end When the append returned.
+     */
+    void record(const char* key,
+                const void* data,
+                size_t bytes_in,
+                size_t bytes_out,
+                ZarrStatusCode status,
+                Clock::time_point start,
+                Clock::time_point end);
+
+    /**
+     * @brief Describe stream settings as recorded in the first line of a
+     * capture. HCS settings are not included.
+     * @param settings The stream settings.
+     * @return The description.
+     */
+    static nlohmann::json describe_settings(const ZarrStreamSettings& settings);
+
+  private:
+    std::mutex mutex_;
+    std::ofstream log_;
+    std::ofstream payloads_;
+
+    bool hash_payloads_;
+    uint32_t payload_sample_interval_;
+
+    Clock::time_point origin_;
+    uint64_t n_records_;
+    uint64_t payload_bytes_;
+};
+} // namespace zarr
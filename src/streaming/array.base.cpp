@@ -34,11 +34,13 @@ zarr::ArrayBase::node_path_() const
 bool
 zarr::ArrayBase::make_metadata_sinks_()
 {
-    metadata_sinks_.clear();
-
     try {
         const auto sink_keys = metadata_keys_();
         for (const auto& key : sink_keys) {
+            if (metadata_sinks_.contains(key)) {
+                continue; // reuse sinks from a previous write
+            }
+
             const std::string path = node_path_() + "/" + key;
             std::unique_ptr<Sink> sink =
               config_->bucket_name
@@ -119,6 +121,14 @@ zarr::make_array(std::shared_ptr<ArrayConfig> config,
 
 bool
 zarr::finalize_array(std::unique_ptr<ArrayBase>&& array)
+{
+    std::unordered_map<std::string, std::string> metadata;
+    return finalize_array(std::move(array), metadata);
+}
+
+bool
+zarr::finalize_array(std::unique_ptr<ArrayBase>&& array,
+                     std::unordered_map<std::string, std::string>& metadata)
 {
     if (array == nullptr) {
         LOG_INFO("Array is null. Nothing to finalize.");
@@ -127,6 +137,7 @@ zarr::finalize_array(std::unique_ptr<ArrayBase>&& array)
 
     try {
         bool result = array->close_();
+        metadata.merge(array->final_metadata_);
         return result;
     } catch (const std::exception& exc) {
         LOG_ERROR("Failed to close array: ", exc.what());
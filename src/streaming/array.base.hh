@@ -3,12 +3,15 @@
 #include "array.dimensions.hh"
 #include "blosc.compression.params.hh"
 #include "file.handle.hh"
+#include "frame.metadata.array.hh"
 #include "locked.buffer.hh"
 #include "s3.connection.hh"
+#include "shard.verifier.hh"
 #include "sink.hh"
 #include "thread.pool.hh"
 #include "zarr.types.h"
 
+#include <chrono>
 #include <string>
 
 namespace zarr {
@@ -50,6 +53,59 @@ struct ArrayConfig
     ZarrDataType dtype;
     std::optional<ZarrDownsamplingMethod> downsampling_method;
     uint16_t level_of_detail;
+
+    // minimum time between intermediate metadata rewrites; 0 means rewrite on
+    // every rollover. The final metadata is always written on close.
+    std::chrono::milliseconds metadata_update_interval{ 0 };
+
+    // minimum time between shard index checkpoints; 0 disables checkpointing
+    std::chrono::milliseconds checkpoint_interval{ 0 };
+
+    // continue appending to an array already on disk instead of starting over
+    bool resume{ false };
+
+    // layout of appended frames; packed formats are unpacked into the chunks
+    ZarrPixelFormat pixel_format{ ZarrPixelFormat_Native };
+
+    // bits kept per sample by the packbits codec; 0 stores samples in full
+    uint8_t significant_bits{ 0 };
+
+    // type of appended samples and how they map to dtype; unset if they're
+    // appended as dtype
+    std::optional<ZarrInputConversion> input_conversion;
+
+    // crop window and binning of appended frames; unset if they're appended at
+    // the size of a stored frame
+    std::optional<ZarrFrameReduction> frame_reduction;
+
+    // accumulate pixel statistics of appended frames
+    bool compute_statistics{ false };
+
+    // running projection of appended frames along projection_dimension,
+    // written to the array at projection_key; unset if none
+    std::optional<ZarrProjectionMethod> projection_method;
+    std::string projection_dimension;
+    std::string projection_key;
+
+    // sibling array of per-frame records appended through the stream; unset
+    // if none
+    std::optional<FrameMetadataConfig> frame_metadata;
+
+    // keep the most recently appended frame for live display
+    bool enable_preview{ false };
+
+    // end each encoded chunk with its crc32c, as the last inner codec
+    bool chunk_checksums{ false };
+
+    // physical order of the chunks in each layer of a shard
+    ZarrChunkOrder chunk_order{ ZarrChunkOrder_RowMajor };
+
+    // re-reads shards once they're finalized; unset if writes aren't verified
+    std::shared_ptr<ShardVerifier> shard_verifier;
+
+    // memory held by partly written region chunks before the least recently
+    // written are flushed; 0 means no limit
+    size_t max_region_buffer_bytes{ 0 };
 };
 
 enum class WriteResult
@@ -58,6 +114,9 @@ enum class WriteResult
     PartialWrite,      // incomplete write
     OutOfBounds,       // append exceeded declared array_size_px
     FrameSizeMismatch, // data size is not equal to the expected frame size
+    InvalidChunk,      // chunk data does not match the array's chunk codecs
+    InvalidFrameIndex, // frame index is outside the reorder window or repeated
+    InvalidArgument,   // coordinates don't match the array's dimensions
 };
 
 class ArrayBase
@@ -95,12 +154,107 @@ class ArrayBase
     [[nodiscard]] virtual WriteResult write_frame(LockedBuffer& data,
                                                   size_t& bytes_written) = 0;
 
+    /**
+     * @brief Write a frame to the node at an explicit position along the
+     * non-spatial dimensions, in acquisition order.
+     * @details Frames may arrive out of order within the chunk layer being
+     * filled and the one after it. A frame past that window forces the layer
+     * being filled out, with its missing frames left as the fill value.
+     * @param data The frame to write.
+     * @param frame_id The index the frame would have in an in-order append.
+     * @param bytes_written Set to the number of bytes written on success, or 0
+     * on failure.
+     * @return WriteResult::Ok on success, WriteResult::OutOfBounds if
+     * @p frame_id lies outside the declared array bounds, or
+     * WriteResult::InvalidFrameIndex if it lies in a layer already written or
+     * has already been written.
+     */
+    [[nodiscard]] virtual WriteResult write_frame_at(LockedBuffer& data,
+                                                     uint64_t frame_id,
+                                                     size_t& bytes_written) = 0;
+
+    /**
+     * @brief Write an encoded chunk directly into its shard, bypassing tiling
+     * and compression.
+     * @param chunk_coords Chunk lattice coordinates of the chunk, one for each
+     * dimension in the array metadata.
+     * @param data The chunk data.
+     * @param is_compressed True if @p data is already encoded with the array's
+     * compression codec, false if it holds a raw, full-size chunk.
+     * @return WriteResult::Ok on success, WriteResult::OutOfBounds if
+     * @p chunk_coords lie outside of the array, or WriteResult::InvalidChunk if
+     * @p data does not match the array's codecs or chunk size.
+     */
+    [[nodiscard]] virtual WriteResult write_chunk(
+      std::span<const uint64_t> chunk_coords,
+      ConstByteSpan data,
+      bool is_compressed) = 0;
+
+    /**
+     * @brief Write a hyperslab of data into the array, bypassing the frame
+     * path.
+     * @details Chunks are written once every element in them has been
+     * written, or when evicted to stay under
+     * ArrayConfig::max_region_buffer_bytes. Pixels already written by an
+     * earlier, overlapping region are kept.
+     * @param offset The offset of the region, in pixels, one for each
+     * dimension in the array metadata.
+     * @param shape The shape of the region, in pixels.
+     * @param data The region data, in C order.
+     * @return WriteResult::Ok on success, WriteResult::OutOfBounds if the
+     * region lies outside of the array, WriteResult::FrameSizeMismatch if the
+     * size of @p data doesn't match @p shape, or WriteResult::InvalidChunk if
+     * a chunk could not be written.
+     */
+    [[nodiscard]] virtual WriteResult write_region(
+      std::span<const uint64_t> offset,
+      std::span<const uint64_t> shape,
+      ConstByteSpan data) = 0;
+
+    /**
+     * @brief Get the statistics of the frames appended so far.
+     * @param channel The index along the first channel dimension, or
+     * std::nullopt for the whole array.
+     * @param stats Set to the statistics on success.
+     * @return False if statistics aren't being computed or @p channel is out
+     * of range, true otherwise.
+     */
+    [[nodiscard]] virtual bool statistics(std::optional<uint64_t> channel,
+                                          ZarrArrayStatistics& stats) const = 0;
+
+    /**
+     * @brief Copy out the most recently appended frame, in acquisition order.
+     * @param level The multiscale level, 0 for full resolution.
+     * @param frame Buffer to copy the frame into, or empty to only get
+     * @p info. Must be at least the size of a frame otherwise.
+     * @param info Set to the size and data type of the frame, and its index.
+     * @return False if previews aren't enabled or @p level is out of range,
+     * true otherwise.
+     */
+    [[nodiscard]] virtual bool preview(uint16_t level,
+                                       ByteSpan frame,
+                                       ZarrPreviewInfo& info) const = 0;
+
     /**
      * @brief Query the maximum number of bytes we can append to this array.
      * @return The maximum number of bytes we can append to this array.
      */
     [[nodiscard]] virtual size_t max_bytes() const = 0;
 
+    /**
+     * @brief Query the number of bytes appended to this array so far.
+     * @return The number of bytes appended, including any written before the
+     * array was resumed.
+     */
+    [[nodiscard]] virtual size_t bytes_written() const = 0;
+
+    /**
+     * @brief Write any data held in memory to storage without closing the
+     * node, leaving the shards on disk readable.
+     * @return True if the data was flushed successfully, false otherwise.
+     */
+    [[nodiscard]] virtual bool flush() = 0;
+
   protected:
     std::shared_ptr<ArrayConfig> config_;
     std::shared_ptr<ThreadPool> thread_pool_;
@@ -110,6 +264,10 @@ class ArrayBase
     std::unordered_map<std::string, std::string> metadata_strings_;
     std::unordered_map<std::string, std::unique_ptr<Sink>> metadata_sinks_;
 
+    // metadata of this node and every node below it as written on close, keyed
+    // by node path relative to the store root
+    std::unordered_map<std::string, std::string> final_metadata_;
+
     std::string node_path_() const;
     [[nodiscard]] virtual bool make_metadata_() = 0;
     virtual std::vector<std::string> metadata_keys_() const = 0;
@@ -117,6 +275,9 @@ class ArrayBase
     [[nodiscard]] bool write_metadata_();
 
     friend bool finalize_array(std::unique_ptr<ArrayBase>&& array);
+    friend bool finalize_array(
+      std::unique_ptr<ArrayBase>&& array,
+      std::unordered_map<std::string, std::string>& metadata);
 };
 
 std::unique_ptr<ArrayBase>
@@ -128,4 +289,15 @@ make_array(std::shared_ptr<ArrayConfig> config,
 
 [[nodiscard]] bool
 finalize_array(std::unique_ptr<ArrayBase>&& array);
+
+/**
+ * @brief Finalize @p array and collect the metadata it wrote on close.
+ * @param[in] array The array to finalize.
+ * @param[out] metadata Receives the zarr.json contents of @p array and every
+ * node below it, keyed by node path relative to the store root.
+ * @return True if and only if the array was finalized successfully.
+ */
+[[nodiscard]] bool
+finalize_array(std::unique_ptr<ArrayBase>&& array,
+               std::unordered_map<std::string, std::string>& metadata);
 } // namespace zarr
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "array.hh"
+#include "checkpoint.hh"
 #include "macros.hh"
 #include "sink.hh"
 #include "zarr.common.hh"
@@ -7,7 +8,10 @@
 #include <crc32c/crc32c.h>
 
 #include <algorithm> // std::fill
+#include <chrono>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <future>
 #include <stdexcept>
@@ -15,50 +19,59 @@
 using json = nlohmann::json;
 
 namespace {
-std::string
-sample_type_to_dtype(ZarrDataType t)
-{
-    switch (t) {
-        case ZarrDataType_uint8:
-            return "uint8";
-        case ZarrDataType_uint16:
-            return "uint16";
-        case ZarrDataType_uint32:
-            return "uint32";
-        case ZarrDataType_uint64:
-            return "uint64";
-        case ZarrDataType_int8:
-            return "int8";
-        case ZarrDataType_int16:
-            return "int16";
-        case ZarrDataType_int32:
-            return "int32";
-        case ZarrDataType_int64:
-            return "int64";
-        case ZarrDataType_float32:
-            return "float32";
-        case ZarrDataType_float64:
-            return "float64";
-        default:
-            throw std::runtime_error("Invalid ZarrDataType: " +
-                                     std::to_string(static_cast<int>(t)));
-    }
-}
+// stands in for the append dimension size in the metadata template
+constexpr char append_size_placeholder[] = "__append_size__";
 
-std::string
-shuffle_to_string(uint8_t shuffle)
+/**
+ * @brief Mark [begin, end) of a row as covered, calling @p copy on each part
+ * of it that wasn't already.
+ * @param spans The sorted, disjoint spans of the row covered so far.
+ * @return The number of elements newly covered.
+ */
+template<typename CopyFun>
+uint64_t
+cover_row(std::vector<std::pair<uint64_t, uint64_t>>& spans,
+          uint64_t begin,
+          uint64_t end,
+          CopyFun&& copy)
 {
-    switch (shuffle) {
-        case 0:
-            return "noshuffle";
-        case 1:
-            return "shuffle";
-        case 2:
-            return "bitshuffle";
-        default:
-            throw std::runtime_error("Invalid shuffle value: " +
-                                     std::to_string(shuffle));
+    if (spans.empty()) {
+        copy(begin, end);
+        spans.emplace_back(begin, end);
+        return end - begin;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> merged;
+    merged.reserve(spans.size() + 1);
+
+    auto it = spans.begin();
+    for (; it != spans.end() && it->second < begin; ++it) {
+        merged.push_back(*it);
+    }
+
+    // fill the gaps between the spans that overlap or touch [begin, end), and
+    // merge them into one
+    uint64_t n_covered = 0;
+    uint64_t cursor = begin, lo = begin, hi = end;
+    for (; it != spans.end() && it->first <= end; ++it) {
+        if (it->first > cursor) {
+            copy(cursor, it->first);
+            n_covered += it->first - cursor;
+        }
+        cursor = std::max(cursor, it->second);
+        lo = std::min(lo, it->first);
+        hi = std::max(hi, it->second);
     }
+    if (cursor < end) {
+        copy(cursor, end);
+        n_covered += end - cursor;
+    }
+
+    merged.emplace_back(lo, hi);
+    merged.insert(merged.end(), it, spans.end());
+    spans = std::move(merged);
+
+    return n_covered;
 }
 } // namespace
 
@@ -69,11 +82,29 @@ zarr::Array::Array(std::shared_ptr<ArrayConfig> config,
   : ArrayBase(config, thread_pool, file_handle_pool, s3_connection_pool)
   , max_bytes_(config->dimensions->max_byte_count())
   , bytes_per_frame_(bytes_of_frame(*config->dimensions, config->dtype))
+  , bytes_per_input_frame_(
+      bytes_of_pixels(config->pixel_format,
+                      config->frame_reduction
+                        ? size_t{ config->frame_reduction->frame_width } *
+                            config->frame_reduction->frame_height
+                        : bytes_per_frame_ / bytes_of_type(config->dtype),
+                      config->input_conversion
+                        ? config->input_conversion->data_type
+                        : config->dtype))
   , total_bytes_written_{ 0 }
   , bytes_to_flush_{ 0 }
   , append_chunk_index_{ 0 }
   , is_closing_{ false }
+  , is_partial_flush_{ false }
+  , bytes_at_last_flush_{ 0 }
+  , is_indexed_{ false }
+  , indexed_frames_end_{ 0 }
   , current_layer_{ 0 }
+  , has_direct_chunks_{ false }
+  , direct_append_size_{ 0 }
+  , region_chunk_bytes_{ 0 }
+  , region_write_count_{ 0 }
+  , checkpoint_manifest_offset_{ 0 }
 {
     const size_t n_chunks = config_->dimensions->number_of_chunks_in_memory();
     EXPECT(n_chunks > 0, "Array has zero chunks in memory");
@@ -85,11 +116,13 @@ zarr::Array::Array(std::shared_ptr<ArrayConfig> config,
 
     shard_file_offsets_.resize(number_of_shards, 0);
     shard_tables_.resize(number_of_shards);
+    shard_flushed_ends_.resize(number_of_shards, 0);
 
     for (auto& table : shard_tables_) {
         table.resize(2 * chunks_per_shard);
         std::ranges::fill(table, std::numeric_limits<uint64_t>::max());
     }
+    shard_layer_order_ = dims->shard_layer_chunk_order(config_->chunk_order);
 
     // For 2D arrays, don't include append_chunk_index in the path
     if (config_->dimensions->is_2d()) {
@@ -97,6 +130,36 @@ zarr::Array::Array(std::shared_ptr<ArrayConfig> config,
     } else {
         data_root_ = node_path_() + "/c/" + std::to_string(append_chunk_index_);
     }
+
+    if (config_->compute_statistics) {
+        statistics_.emplace(config_->dtype, config_->significant_bits);
+
+        for (auto i = 0; i < dims->ndims() - 2; ++i) {
+            if (dims->at(i).type == ZarrDimensionType_Channel) {
+                channel_dim_ = i;
+                channel_statistics_.assign(dims->at(i).array_size_px,
+                                           *statistics_);
+                break;
+            }
+        }
+    }
+
+    if (config_->projection_method) {
+        projector_ = std::make_unique<Projector>(config_);
+        projection_array_ =
+          std::make_unique<Array>(projector_->writer_configuration(),
+                                  thread_pool_,
+                                  file_handle_pool_,
+                                  s3_connection_pool_);
+    }
+
+    if (config_->enable_preview) {
+        preview_ = std::make_unique<PreviewBuffer>(bytes_per_frame_);
+    }
+
+    if (config_->resume) {
+        EXPECT(resume_(), "Failed to resume array ", config_->node_key);
+    }
 }
 
 size_t
@@ -106,6 +169,13 @@ zarr::Array::memory_usage() const noexcept
     for (const auto& buf : chunk_buffers_) {
         total += buf.size();
     }
+    for (const auto& [frame_id, frame] : pending_frames_) {
+        total += frame.size();
+    }
+    total += region_chunk_bytes_;
+    if (projector_) {
+        total += projector_->memory_usage() + projection_array_->memory_usage();
+    }
 
     return total;
 }
@@ -116,18 +186,25 @@ zarr::Array::write_frame(LockedBuffer& data, size_t& bytes_written)
     bytes_written = 0;
 
     const auto nbytes_data = data.size();
-    const auto nbytes_frame =
-      bytes_of_frame(*config_->dimensions, config_->dtype);
-
-    if (nbytes_frame != nbytes_data) {
+    if (nbytes_data != bytes_per_input_frame_) {
         LOG_ERROR("Frame size mismatch: expected ",
-                  nbytes_frame,
+                  bytes_per_input_frame_,
                   ", got ",
                   nbytes_data,
                   ". Skipping");
         return WriteResult::FrameSizeMismatch;
     }
 
+    if (has_direct_chunks_) {
+        LOG_ERROR("Cannot append frames to an array written chunk by chunk");
+        return WriteResult::InvalidChunk;
+    }
+
+    if (is_indexed_) {
+        LOG_ERROR("Cannot append frames in order to an array written by index");
+        return WriteResult::InvalidFrameIndex;
+    }
+
     // check that we can append
     if (max_bytes_ > 0 && total_bytes_written_ + nbytes_data > max_bytes_) {
         LOG_ERROR("Unable to write. Data would exceed bounds of array.");
@@ -140,8 +217,10 @@ zarr::Array::write_frame(LockedBuffer& data, size_t& bytes_written)
 
     // split the incoming frame into tiles and write them to the chunk
     // buffers
-    bytes_written = write_frame_to_chunks_(data);
-    CHECK(bytes_written <= nbytes_data);
+    // don't take the frame id from the incoming frame, as the camera may have
+    // dropped frames
+    bytes_written = write_frame_to_chunks_(data, frames_written_());
+    CHECK(bytes_written <= bytes_per_frame_);
 
     LOG_DEBUG(
       "Wrote ", bytes_written, " bytes to LOD ", config_->level_of_detail);
@@ -149,17 +228,329 @@ zarr::Array::write_frame(LockedBuffer& data, size_t& bytes_written)
     total_bytes_written_ += bytes_written;
 
     if (should_flush_()) {
-        CHECK(compress_and_flush_data_());
+        CHECK(complete_layer_());
+    }
 
-        if (should_rollover_()) {
-            rollover_();
-            CHECK(write_metadata_());
+    return bytes_written == bytes_per_frame_ ? WriteResult::Ok
+                                             : WriteResult::PartialWrite;
+}
+
+zarr::WriteResult
+zarr::Array::write_frame_at(LockedBuffer& data,
+                            uint64_t frame_id,
+                            size_t& bytes_written)
+{
+    bytes_written = 0;
+
+    const auto nbytes_data = data.size();
+    if (nbytes_data != bytes_per_input_frame_) {
+        LOG_ERROR("Frame size mismatch: expected ",
+                  bytes_per_input_frame_,
+                  ", got ",
+                  nbytes_data,
+                  ". Skipping");
+        return WriteResult::FrameSizeMismatch;
+    }
+
+    if (has_direct_chunks_) {
+        LOG_ERROR("Cannot append frames to an array written chunk by chunk");
+        return WriteResult::InvalidChunk;
+    }
+
+    if (max_bytes_ > 0 && (frame_id + 1) * bytes_per_frame_ > max_bytes_) {
+        LOG_ERROR("Unable to write frame ",
+                  frame_id,
+                  ". Data would exceed bounds of array.");
+        return WriteResult::OutOfBounds;
+    }
+
+    const auto frames_per_layer = frames_per_layer_();
+    if (!is_indexed_) {
+        // frames appended in order before this one (e.g., on resume) were
+        // placed at the start of the layer
+        is_indexed_ = true;
+        layer_frames_received_.assign(frames_per_layer, false);
+        std::fill_n(layer_frames_received_.begin(),
+                    bytes_to_flush_ / bytes_per_frame_,
+                    true);
+    }
+
+    if (frame_id < layer_start_frame_()) {
+        LOG_ERROR("Frame ",
+                  frame_id,
+                  " belongs to a chunk layer that has already been written");
+        return WriteResult::InvalidFrameIndex;
+    }
+
+    // a frame past the reorder window forces the oldest layer out, with its
+    // missing frames left as the fill value
+    while (frame_id >= layer_start_frame_() + 2 * frames_per_layer) {
+        CHECK(pad_indexed_layer_());
+    }
+
+    const auto layer_start = layer_start_frame_();
+
+    if (frame_id >= layer_start + frames_per_layer
+          ? pending_frames_.contains(frame_id)
+          : layer_frames_received_[frame_id - layer_start]) {
+        LOG_ERROR("Frame ", frame_id, " has already been written");
+        return WriteResult::InvalidFrameIndex;
+    }
+
+    indexed_frames_end_ = std::max(indexed_frames_end_, frame_id + 1);
+
+    // hold on to frames for the next layer until this one is complete
+    if (frame_id >= layer_start + frames_per_layer) {
+        LockedBuffer frame;
+        frame.swap(data);
+        pending_frames_.emplace(frame_id, std::move(frame));
+        bytes_written = nbytes_data;
+        return WriteResult::Ok;
+    }
+
+    CHECK(place_indexed_frame_(data, frame_id));
+    bytes_written = nbytes_data;
+
+    return WriteResult::Ok;
+}
+
+zarr::WriteResult
+zarr::Array::write_chunk(std::span<const uint64_t> chunk_coords,
+                         ConstByteSpan data,
+                         bool is_compressed)
+{
+    std::unique_lock lock(direct_shards_mutex_);
+
+    std::vector<uint64_t> coords;
+    if (const auto result = validate_direct_write_(chunk_coords, coords);
+        result != WriteResult::Ok) {
+        return result;
+    }
+
+    const auto& dims = config_->dimensions;
+    for (auto i = 0; i < coords.size(); ++i) {
+        const auto& dim = dims->at(i);
+        if ((i > 0 || dim.array_size_px > 0) &&
+            coords[i] >= chunks_along_dimension(dim)) {
+            LOG_ERROR("Chunk coordinate ",
+                      coords[i],
+                      " is out of bounds for dimension ",
+                      dim.name);
+            return WriteResult::OutOfBounds;
+        }
+    }
+
+    // the chunk must decode to a full chunk with the array's codecs
+    const auto bytes_of_chunk = dims->bytes_per_chunk();
+    ByteVector chunk(data.begin(), data.end());
+    if (is_compressed) {
+        size_t n_bytes;
+        if (!config_->compression_params) {
+            LOG_ERROR("Array ", config_->node_key, " is not compressed");
+            return WriteResult::InvalidChunk;
+        }
+        if (!blosc_decompressed_size(data, n_bytes) ||
+            n_bytes != bytes_of_packed_chunk_()) {
+            LOG_ERROR("Compressed chunk does not decode to ",
+                      bytes_of_packed_chunk_(),
+                      " bytes");
+            return WriteResult::InvalidChunk;
+        }
+        std::string error;
+        if (!blosc_matches(data,
+                           *config_->compression_params,
+                           compression_type_size_(),
+                           error)) {
+            LOG_ERROR("Compressed chunk does not match the array's codec: ",
+                      error);
+            return WriteResult::InvalidChunk;
+        }
+        if (config_->chunk_checksums) {
+            append_crc32c(chunk);
+        }
+    } else {
+        if (data.size() != bytes_of_chunk) {
+            LOG_ERROR("Chunk size mismatch: expected ",
+                      bytes_of_chunk,
+                      ", got ",
+                      data.size());
+            return WriteResult::InvalidChunk;
+        }
+        if (!encode_chunk_(chunk)) {
+            LOG_ERROR("Failed to encode chunk");
+            return WriteResult::InvalidChunk;
+        }
+    }
+
+    // a whole chunk supersedes any region data held for it
+    if (const auto it = region_chunks_.find(coords);
+        it != region_chunks_.end()) {
+        region_chunk_bytes_ -= it->second.data.size();
+        region_chunks_.erase(it);
+    }
+    evicted_coverage_.erase(coords);
+
+    if (!write_direct_chunk_(coords, chunk, true)) {
+        return WriteResult::InvalidChunk;
+    }
+
+    grow_direct_append_size_((coords[0] + 1) * dims->at(0).chunk_size_px);
+
+    return WriteResult::Ok;
+}
+
+zarr::WriteResult
+zarr::Array::write_region(std::span<const uint64_t> offset,
+                          std::span<const uint64_t> shape,
+                          ConstByteSpan data)
+{
+    std::unique_lock lock(direct_shards_mutex_);
+
+    std::vector<uint64_t> region_offset, region_shape;
+    if (const auto result = validate_direct_write_(offset, region_offset);
+        result != WriteResult::Ok) {
+        return result;
+    }
+    if (const auto result = validate_direct_write_(shape, region_shape);
+        result != WriteResult::Ok) {
+        return result;
+    }
+
+    const auto& dims = config_->dimensions;
+    const auto ndims = dims->ndims();
+    const auto bytes_per_px = bytes_of_type(config_->dtype);
+
+    // the phantom append dimension of a 2D array is a single plane
+    if (dims->is_2d()) {
+        region_shape[0] = 1;
+    }
+
+    size_t n_px = 1;
+    for (auto i = 0; i < ndims; ++i) {
+        const auto& dim = dims->at(i);
+        n_px *= region_shape[i];
+
+        if (region_shape[i] == 0) {
+            LOG_ERROR("Region is empty along dimension ", dim.name);
+            return WriteResult::OutOfBounds;
+        }
+
+        const auto array_size = i == 0 && dim.array_size_px == 0
+                                  ? std::numeric_limits<uint64_t>::max()
+                                  : dim.array_size_px;
+        if (region_offset[i] + region_shape[i] > array_size) {
+            LOG_ERROR("Region [",
+                      region_offset[i],
+                      ", ",
+                      region_offset[i] + region_shape[i],
+                      ") is out of bounds for dimension ",
+                      dim.name);
+            return WriteResult::OutOfBounds;
         }
-        bytes_to_flush_ = 0;
     }
 
-    return bytes_written == data.size() ? WriteResult::Ok
-                                        : WriteResult::PartialWrite;
+    if (data.size() != n_px * bytes_per_px) {
+        LOG_ERROR("Region size mismatch: expected ",
+                  n_px * bytes_per_px,
+                  " bytes, got ",
+                  data.size());
+        return WriteResult::FrameSizeMismatch;
+    }
+
+    // visit every chunk the region overlaps
+    std::vector<uint64_t> first_chunk(ndims), last_chunk(ndims);
+    for (auto i = 0; i < ndims; ++i) {
+        const auto chunk_size = dims->at(i).chunk_size_px;
+        first_chunk[i] = region_offset[i] / chunk_size;
+        last_chunk[i] = (region_offset[i] + region_shape[i] - 1) / chunk_size;
+    }
+
+    std::vector<uint64_t> chunk_coords = first_chunk;
+    while (true) {
+        if (!write_region_to_chunk_(
+              chunk_coords, region_offset, region_shape, data)) {
+            return WriteResult::InvalidChunk;
+        }
+
+        auto i = ndims;
+        while (i > 0 && chunk_coords[i - 1] == last_chunk[i - 1]) {
+            chunk_coords[i - 1] = first_chunk[i - 1];
+            --i;
+        }
+        if (i == 0) {
+            break;
+        }
+        ++chunk_coords[i - 1];
+    }
+
+    has_direct_chunks_ = true;
+
+    if (!evict_region_chunks_()) {
+        return WriteResult::InvalidChunk;
+    }
+
+    grow_direct_append_size_(region_offset[0] + region_shape[0]);
+
+    return WriteResult::Ok;
+}
+
+bool
+zarr::Array::preview(uint16_t level, ByteSpan frame, ZarrPreviewInfo& info) const
+{
+    if (!preview_) {
+        LOG_ERROR("Array ", config_->node_key, " does not keep a preview");
+        return false;
+    }
+
+    if (level != 0) {
+        LOG_ERROR("Array ", config_->node_key, " has no level ", level);
+        return false;
+    }
+
+    const auto& dims = config_->dimensions;
+    info.width = dims->acquisition_frame_cols();
+    info.height = dims->acquisition_frame_rows();
+    info.data_type = config_->dtype;
+
+    const auto frame_id = preview_->read(frame);
+    info.has_frame = frame_id.has_value();
+    info.frame_id = frame_id.value_or(0);
+
+    return true;
+}
+
+bool
+zarr::Array::statistics(std::optional<uint64_t> channel,
+                        ZarrArrayStatistics& stats) const
+{
+    std::unique_lock lock(statistics_mutex_);
+    if (!statistics_) {
+        LOG_ERROR("Array ", config_->node_key, " does not compute statistics");
+        return false;
+    }
+
+    if (!channel) {
+        statistics_->to_zarr(stats);
+        return true;
+    }
+
+    if (!channel_dim_) {
+        LOG_ERROR("Array ", config_->node_key, " has no channel dimension");
+        return false;
+    }
+
+    if (*channel < channel_statistics_.size()) {
+        channel_statistics_[*channel].to_zarr(stats);
+    } else if (*channel_dim_ == 0) {
+        // a channel along the append dimension that hasn't been reached yet
+        PixelStatistics(config_->dtype, config_->significant_bits)
+          .to_zarr(stats);
+    } else {
+        LOG_ERROR("Channel ", *channel, " is out of bounds");
+        return false;
+    }
+
+    return true;
 }
 
 size_t
@@ -168,6 +559,89 @@ zarr::Array::max_bytes() const
     return max_bytes_;
 }
 
+size_t
+zarr::Array::bytes_written() const
+{
+    return total_bytes_written_;
+}
+
+bool
+zarr::Array::flush()
+{
+    // only completed projections are written; partial ones wait for close
+    if (projection_array_ && !projection_array_->flush()) {
+        LOG_ERROR("Failed to flush projection array ", config_->projection_key);
+        return false;
+    }
+
+    if (total_bytes_written_ == bytes_at_last_flush_) {
+        return true; // nothing new since the last flush
+    }
+
+    if (is_s3_array_()) {
+        LOG_ERROR("Flushing is not supported for S3 arrays");
+        return false;
+    }
+
+    if (bytes_to_flush_ > 0) {
+        // the open chunk layer keeps filling after it is flushed, so write a
+        // copy; once full, it is written over this one, or after it if a
+        // checkpoint covers the copy, so that recovery never finds it
+        // overwritten
+        std::vector<ByteVector> open_layer(chunk_buffers_.size());
+        for (auto i = 0; i < chunk_buffers_.size(); ++i) {
+            open_layer[i] =
+              chunk_buffers_[i].with_lock([](const auto& data) { return data; });
+        }
+        const auto file_offsets = shard_file_offsets_;
+        const auto shard_tables = shard_tables_;
+
+        is_partial_flush_ = true;
+        const auto flushed = compress_and_flush_data_();
+        is_partial_flush_ = false;
+
+        for (auto i = 0; i < chunk_buffers_.size(); ++i) {
+            chunk_buffers_[i].assign(std::move(open_layer[i]));
+        }
+        if (config_->checkpoint_interval.count() == 0) {
+            for (auto i = 0; i < shard_file_offsets_.size(); ++i) {
+                const auto index_bytes =
+                  shard_tables_[i].size() * sizeof(uint64_t) + sizeof(uint32_t);
+                shard_flushed_ends_[i] = std::max(
+                  shard_flushed_ends_[i], shard_file_offsets_[i] + index_bytes);
+            }
+            shard_file_offsets_ = file_offsets;
+            shard_tables_ = shard_tables;
+        }
+
+        if (!flushed) {
+            LOG_ERROR("Failed to flush open chunk layer");
+            return false;
+        }
+    } else if (current_layer_ > 0) {
+        // completed layers are on disk, but the open shards have no index yet
+        const auto indexed = config_->checkpoint_interval.count() > 0
+                               ? write_checkpoint_(false)
+                               : write_shard_indices_();
+        if (!indexed) {
+            LOG_ERROR("Failed to write shard indices");
+            return false;
+        }
+    }
+
+    if (!await_metadata_update_()) {
+        LOG_WARNING("Intermediate metadata update failed for array ",
+                    config_->node_key);
+    }
+    if (!write_metadata_()) {
+        LOG_ERROR("Failed to write metadata for array ", config_->node_key);
+        return false;
+    }
+
+    bytes_at_last_flush_ = total_bytes_written_;
+    return true;
+}
+
 std::vector<std::string>
 zarr::Array::metadata_keys_() const
 {
@@ -179,6 +653,27 @@ zarr::Array::make_metadata_()
 {
     metadata_strings_.clear();
 
+    if (metadata_prefix_.empty() && !make_metadata_template_()) {
+        return false;
+    }
+
+    const auto& dims = config_->dimensions;
+    if (dims->is_2d()) {
+        metadata_strings_.emplace("zarr.json", metadata_prefix_);
+        return true;
+    }
+
+    metadata_strings_.emplace("zarr.json",
+                              metadata_prefix_ +
+                                std::to_string(append_dimension_size_()) +
+                                metadata_suffix_);
+
+    return true;
+}
+
+bool
+zarr::Array::make_metadata_template_()
+{
     std::vector<size_t> array_shape, chunk_shape, shard_shape;
     const auto& dims = config_->dimensions;
 
@@ -186,15 +681,7 @@ zarr::Array::make_metadata_()
     const size_t start_dim = dims->is_2d() ? 1 : 0;
 
     if (!dims->is_2d()) {
-        // Compute append dimension size for 3D+ arrays
-        size_t append_size = frames_written_();
-        for (auto i = dims->ndims() - 3; i > 0; --i) {
-            const auto& dim = dims->at(i);
-            const auto& array_size_px = dim.array_size_px;
-            CHECK(array_size_px);
-            append_size = (append_size + array_size_px - 1) / array_size_px;
-        }
-        array_shape.push_back(append_size);
+        array_shape.push_back(0); // replaced by the placeholder below
 
         const auto& final_dim = dims->final_dim();
         chunk_shape.push_back(final_dim.chunk_size_px);
@@ -210,6 +697,9 @@ zarr::Array::make_metadata_()
 
     json metadata;
     metadata["shape"] = array_shape;
+    if (!dims->is_2d()) {
+        metadata["shape"][0] = append_size_placeholder;
+    }
     metadata["chunk_grid"] = json::object({
       { "name", "regular" },
       {
@@ -226,6 +716,13 @@ zarr::Array::make_metadata_()
     });
     metadata["fill_value"] = 0;
     metadata["attributes"] = json::object();
+    if (statistics_ && is_closing_) {
+        metadata["attributes"]["statistics"] = statistics_json_();
+    }
+    if (is_closing_ && frames_written_() % frames_per_plane_() != 0) {
+        // the shape rounds up to whole planes, so record the exact count
+        metadata["attributes"]["frames_written"] = frames_written_();
+    }
     metadata["zarr_format"] = 3;
     metadata["node_type"] = "array";
     metadata["storage_transformers"] = json::array();
@@ -249,8 +746,17 @@ zarr::Array::make_metadata_()
     configuration["chunk_shape"] = chunk_shape;
 
     auto codec = json::object();
-    codec["configuration"] = json::object({ { "endian", "little" } });
-    codec["name"] = "bytes";
+    if (const auto bits = config_->significant_bits; bits > 0) {
+        codec["configuration"] = json::object({
+          { "first_bit", 0 },
+          { "last_bit", bits - 1 },
+          { "padding_encoding", "none" },
+        });
+        codec["name"] = "packbits";
+    } else {
+        codec["configuration"] = json::object({ { "endian", "little" } });
+        codec["name"] = "bytes";
+    }
 
     auto index_codec = json::object();
     index_codec["configuration"] = json::object({ { "endian", "little" } });
@@ -273,7 +779,7 @@ zarr::Array::make_metadata_()
         compression_config["clevel"] = params.clevel;
         compression_config["cname"] = params.codec_id;
         compression_config["shuffle"] = shuffle_to_string(params.shuffle);
-        compression_config["typesize"] = bytes_of_type(config_->dtype);
+        compression_config["typesize"] = compression_type_size_();
 
         auto compression_codec = json::object();
         compression_codec["configuration"] = compression_config;
@@ -281,59 +787,219 @@ zarr::Array::make_metadata_()
         configuration["codecs"].push_back(compression_codec);
     }
 
+    if (config_->chunk_checksums) {
+        configuration["codecs"].push_back(
+          json::object({ { "name", "crc32c" } }));
+    }
+
     sharding_indexed["configuration"] = configuration;
 
     codecs.push_back(sharding_indexed);
 
     metadata["codecs"] = codecs;
 
-    metadata_strings_.emplace("zarr.json", metadata.dump(4));
+    const std::string rendered = metadata.dump(4);
+    if (dims->is_2d()) {
+        metadata_prefix_ = rendered;
+        metadata_suffix_.clear();
+        return true;
+    }
+
+    const std::string placeholder = json(append_size_placeholder).dump();
+    const auto pos = rendered.find(placeholder);
+    if (pos == std::string::npos) {
+        LOG_ERROR("Failed to locate append dimension in metadata template");
+        return false;
+    }
+
+    metadata_prefix_ = rendered.substr(0, pos);
+    metadata_suffix_ = rendered.substr(pos + placeholder.size());
 
     return true;
 }
 
-bool
-zarr::Array::close_()
+void
+zarr::Array::update_metadata_()
 {
-    bool retval = false;
-    is_closing_ = true;
-    try {
-        if (bytes_to_flush_ > 0) {
-            CHECK(compress_and_flush_data_());
-        } else {
-            CHECK(close_impl_());
+    const auto now = std::chrono::steady_clock::now();
+    if (last_metadata_update_ &&
+        now - *last_metadata_update_ < config_->metadata_update_interval) {
+        return; // rate limited, close_() writes the final shape
+    }
+
+    if (metadata_update_.valid()) {
+        if (metadata_update_.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+            return; // previous update still in flight, skip this one
         }
-        close_sinks_();
+        if (!await_metadata_update_()) {
+            LOG_WARNING("Failed to update metadata for array ",
+                        config_->node_key);
+        }
+    }
 
-        if (frames_written_() > 0) {
-            CHECK(write_metadata_());
-            for (auto& [key, sink] : metadata_sinks_) {
-                EXPECT(zarr::finalize_sink(std::move(sink)),
-                       "Failed to finalize metadata sink ",
-                       key);
+    CHECK(make_metadata_());
+    CHECK(make_metadata_sinks_());
+    last_metadata_update_ = now;
+
+    // the sinks outlive the update, since close_() waits for it to finish
+    std::vector<std::pair<Sink*, std::string>> writes;
+    for (auto& [key, metadata] : metadata_strings_) {
+        auto& sink = metadata_sinks_.at(key);
+        CHECK(sink);
+        writes.emplace_back(sink.get(), std::move(metadata));
+    }
+    metadata_strings_.clear();
+
+    auto promise = std::make_shared<std::promise<bool>>();
+    metadata_update_ = promise->get_future();
+
+    auto job = [writes = std::move(writes), promise](std::string& err) {
+        bool success = true;
+        try {
+            for (const auto& [sink, metadata] : writes) {
+                std::span data{ reinterpret_cast<const uint8_t*>(
+                                  metadata.data()),
+                                metadata.size() };
+                success = sink->write(0, data) && success;
+            }
+            if (!success) {
+                err = "Failed to write metadata";
             }
+        } catch (const std::exception& exc) {
+            err = "Failed to write metadata: " + std::string(exc.what());
+            success = false;
+        }
+
+        promise->set_value(success);
+        return success;
+    };
+
+    // keep the write off the frame-processing thread, unless that thread is
+    // the only one in the pool
+    if (thread_pool_->n_threads() == 1 || !thread_pool_->push_job(job)) {
+        std::string err;
+        if (!job(err)) {
+            LOG_ERROR(err);
         }
-        metadata_sinks_.clear();
-        retval = true;
-    } catch (const std::exception& exc) {
-        LOG_ERROR("Failed to finalize array writer: ", exc.what());
     }
+}
 
-    is_closing_ = false;
-    return retval;
+void
+zarr::Array::grow_direct_append_size_(uint64_t size)
+{
+    if (size <= direct_append_size_) {
+        return;
+    }
+
+    // as with appends, the shape is published as the writes reach a new
+    // shard, and no more often than the metadata update interval
+    const auto& dims = config_->dimensions;
+    const auto& append_dim = dims->at(0);
+    const uint64_t shard_extent =
+      uint64_t{ append_dim.chunk_size_px } * append_dim.shard_size_chunks;
+    const auto new_shard =
+      direct_append_size_ == 0 ||
+      (direct_append_size_ - 1) / shard_extent != (size - 1) / shard_extent;
+
+    direct_append_size_ = size;
+    if (new_shard && !dims->is_2d()) {
+        update_metadata_();
+    }
 }
 
 bool
-zarr::Array::close_impl_()
+zarr::Array::await_metadata_update_()
 {
-    if (current_layer_ == 0) {
+    if (!metadata_update_.valid()) {
         return true;
     }
 
-    // write the table
-    const auto& dims = config_->dimensions;
-    const auto n_shards = dims->number_of_shards();
-    std::vector<std::future<void>> futures;
+    try {
+        return metadata_update_.get();
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed to update metadata: ", exc.what());
+    }
+
+    return false;
+}
+
+bool
+zarr::Array::close_()
+{
+    bool retval = false;
+    try {
+        // layers padded out here are written as usual; only the last one
+        // closes its shards
+        if (is_indexed_) {
+            CHECK(close_indexed_frames_());
+        }
+        is_closing_ = true;
+
+        if (projector_) {
+            projector_->finish();
+            write_projections_();
+            CHECK(projection_array_->close_());
+            final_metadata_.merge(projection_array_->final_metadata_);
+        }
+
+        if (bytes_to_flush_ > 0) {
+            CHECK(compress_and_flush_data_());
+        } else {
+            CHECK(close_impl_());
+        }
+        close_sinks_();
+
+        // an intermediate update may still be writing to the metadata sinks
+        if (!await_metadata_update_()) {
+            LOG_WARNING("Intermediate metadata update failed for array ",
+                        config_->node_key);
+        }
+
+        {
+            std::unique_lock lock(direct_shards_mutex_);
+            CHECK(close_direct_shards_());
+        }
+
+        if (frames_written_() > 0 || has_direct_chunks_) {
+            // re-render the template to pick up the final statistics and
+            // the frame count of a partially written plane
+            if (statistics_ || frames_written_() % frames_per_plane_() != 0) {
+                metadata_prefix_.clear();
+            }
+            CHECK(write_metadata_());
+            final_metadata_.emplace(config_->node_key,
+                                    metadata_strings_.at("zarr.json"));
+
+            // all shards now carry their final index
+            remove_checkpoint_();
+            for (auto& [key, sink] : metadata_sinks_) {
+                EXPECT(zarr::finalize_sink(std::move(sink)),
+                       "Failed to finalize metadata sink ",
+                       key);
+            }
+        }
+        metadata_sinks_.clear();
+        retval = true;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed to finalize array writer: ", exc.what());
+    }
+
+    is_closing_ = false;
+    return retval;
+}
+
+bool
+zarr::Array::close_impl_()
+{
+    if (current_layer_ == 0) {
+        return true;
+    }
+
+    // write the table
+    const auto& dims = config_->dimensions;
+    const auto n_shards = dims->number_of_shards();
+    std::vector<std::future<void>> futures;
 
     std::atomic<char> all_successful = 1;
 
@@ -418,6 +1084,236 @@ zarr::Array::is_s3_array_() const
     return config_->bucket_name.has_value();
 }
 
+bool
+zarr::Array::resume_()
+{
+    namespace fs = std::filesystem;
+
+    std::string node_path = node_path_();
+    if (node_path.starts_with("file://")) {
+        node_path = node_path.substr(7);
+    }
+
+    const auto metadata_path = fs::path(node_path) / "zarr.json";
+    if (!fs::is_regular_file(metadata_path)) {
+        return true; // nothing on disk yet, start a new array
+    }
+
+    if (fs::exists(fs::path(node_path) / checkpoint_manifest_name)) {
+        LOG_ERROR("Array at ",
+                  node_path,
+                  " was not closed cleanly. Recover the store before resuming");
+        return false;
+    }
+
+    const auto& dims = config_->dimensions;
+    if (dims->is_2d()) {
+        LOG_ERROR("Cannot append to existing 2D array at ", node_path);
+        return false;
+    }
+
+    json existing;
+    {
+        std::ifstream in(metadata_path);
+        existing = json::parse(in, nullptr, false);
+    }
+
+    if (existing.is_discarded() || !existing.contains("shape") ||
+        existing["shape"].empty() || !existing["shape"][0].is_number()) {
+        LOG_ERROR("Failed to read array metadata at ", metadata_path);
+        return false;
+    }
+    const auto append_size = existing["shape"][0].get<uint64_t>();
+
+    // everything but the size of the append dimension must match
+    if (!make_metadata_template_()) {
+        return false;
+    }
+    auto expected = json::parse(metadata_prefix_ + "0" + metadata_suffix_);
+    if (existing.contains("attributes") &&
+        existing["attributes"].contains("frames_written")) {
+        LOG_ERROR("Existing array at ",
+                  node_path,
+                  " ends in a partially written plane (",
+                  existing["attributes"]["frames_written"].dump(),
+                  " frames written) and cannot be resumed");
+        return false;
+    }
+    existing["shape"][0] = 0;
+    existing.erase("attributes");
+    expected.erase("attributes");
+    if (existing != expected) {
+        LOG_ERROR("Existing array at ",
+                  node_path,
+                  " does not match the configured array");
+        return false;
+    }
+
+    const auto frames_per_plane = frames_per_plane_();
+    total_bytes_written_ = append_size * frames_per_plane * bytes_per_frame_;
+    if (max_bytes_ > 0 && total_bytes_written_ > max_bytes_) {
+        LOG_ERROR("Existing array at ",
+                  node_path,
+                  " is larger than the configured array");
+        return false;
+    }
+
+    const auto& append_dim = dims->final_dim();
+    const uint64_t planes_per_layer = append_dim.chunk_size_px;
+    const uint64_t planes_per_shard =
+      planes_per_layer * append_dim.shard_size_chunks;
+
+    append_chunk_index_ = append_size / planes_per_shard;
+    data_root_ = node_path_() + "/c/" + std::to_string(append_chunk_index_);
+
+    LOG_INFO("Resuming array ",
+             config_->node_key,
+             " at index ",
+             append_size,
+             " of the append dimension");
+
+    // completed shards are left alone; only the last one is reopened
+    const auto planes_in_shard = append_size % planes_per_shard;
+    if (planes_in_shard == 0) {
+        return true;
+    }
+
+    current_layer_ = planes_in_shard / planes_per_layer;
+    const auto planes_in_layer = planes_in_shard % planes_per_layer;
+
+    make_data_paths_();
+
+    const auto chunks_per_shard = dims->chunks_per_shard();
+    const auto chunks_per_layer =
+      chunks_per_shard / dims->chunk_layers_per_shard();
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+
+    std::vector<std::vector<uint64_t>> tables(data_paths_.size());
+    for (auto i = 0; i < data_paths_.size(); ++i) {
+        std::string path = data_paths_[i];
+        if (path.starts_with("file://")) {
+            path = path.substr(7);
+        }
+
+        std::error_code ec;
+        const auto file_size = fs::file_size(path, ec);
+        if (ec || file_size < table_size + sizeof(uint32_t)) {
+            LOG_ERROR("Failed to read shard index from ", path);
+            return false;
+        }
+
+        ByteVector index(table_size + sizeof(uint32_t));
+        std::ifstream shard(path, std::ios::binary);
+        shard.seekg(file_size - index.size());
+        if (!shard.read(reinterpret_cast<char*>(index.data()), index.size())) {
+            LOG_ERROR("Failed to read shard index from ", path);
+            return false;
+        }
+
+        uint32_t checksum;
+        memcpy(&checksum, index.data() + table_size, sizeof(uint32_t));
+        if (crc32c::Crc32c(index.data(), table_size) != checksum) {
+            LOG_ERROR("Shard index of ",
+                      path,
+                      " is corrupt. Recover the store before resuming");
+            return false;
+        }
+
+        tables[i].resize(2 * chunks_per_shard);
+        memcpy(tables[i].data(), index.data(), table_size);
+    }
+
+    // a partially filled chunk layer is read back and written out again
+    if (planes_in_layer > 0 && !reload_chunk_layer_(tables)) {
+        return false;
+    }
+    bytes_to_flush_ = planes_in_layer * frames_per_plane * bytes_per_frame_;
+
+    for (auto i = 0; i < data_paths_.size(); ++i) {
+        auto& table = tables[i];
+
+        uint64_t data_end = 0;
+        for (auto j = 0; j < chunks_per_shard; ++j) {
+            if (table[2 * j + 1] == std::numeric_limits<uint64_t>::max()) {
+                continue;
+            }
+
+            if (j < current_layer_ * chunks_per_layer) {
+                data_end = std::max(data_end, table[2 * j] + table[2 * j + 1]);
+            } else {
+                table[2 * j] = std::numeric_limits<uint64_t>::max();
+                table[2 * j + 1] = std::numeric_limits<uint64_t>::max();
+            }
+        }
+
+        // drop the old index; it is written again when the shard is closed
+        std::string error;
+        if (!truncate_shard_(data_paths_[i], data_end, error)) {
+            LOG_ERROR(error);
+            return false;
+        }
+
+        shard_tables_[i] = std::move(table);
+        shard_file_offsets_[i] = data_end;
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::reload_chunk_layer_(
+  const std::vector<std::vector<uint64_t>>& tables)
+{
+    const auto& dims = config_->dimensions;
+    const auto bytes_per_chunk = dims->bytes_per_chunk();
+    const auto chunks_in_memory = chunk_buffers_.size();
+    const auto chunk_group_offset = current_layer_ * chunks_in_memory;
+
+    for (auto i = 0; i < chunks_in_memory; ++i) {
+        const auto chunk_idx = i + chunk_group_offset;
+        const auto shard_idx = dims->shard_index_for_chunk(chunk_idx);
+        const auto internal_idx = dims->shard_internal_index(chunk_idx);
+        const auto offset = tables[shard_idx][2 * internal_idx];
+        const auto nbytes = tables[shard_idx][2 * internal_idx + 1];
+
+        auto& chunk_buffer = chunk_buffers_[i];
+        if (nbytes == std::numeric_limits<uint64_t>::max()) {
+            chunk_buffer.resize_and_fill(bytes_per_chunk, 0);
+            continue;
+        }
+
+        std::string path = data_paths_[shard_idx];
+        if (path.starts_with("file://")) {
+            path = path.substr(7);
+        }
+
+        ByteVector chunk(nbytes);
+        std::ifstream shard(path, std::ios::binary);
+        shard.seekg(offset);
+        if (!shard.read(reinterpret_cast<char*>(chunk.data()), nbytes)) {
+            LOG_ERROR("Failed to read chunk ", chunk_idx, " from ", path);
+            return false;
+        }
+        if (!decode_chunk_(chunk)) {
+            LOG_ERROR("Failed to decode chunk ", chunk_idx, " from ", path);
+            return false;
+        }
+        chunk_buffer.assign(std::move(chunk));
+
+        if (chunk_buffer.size() != bytes_per_chunk) {
+            LOG_ERROR("Unexpected size of chunk ",
+                      chunk_idx,
+                      " in ",
+                      path,
+                      ": ",
+                      chunk_buffer.size());
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void
 zarr::Array::make_data_paths_()
 {
@@ -490,7 +1386,7 @@ transpose_frame(const uint8_t* src,
 } // namespace
 
 size_t
-zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
+zarr::Array::write_frame_to_chunks_(LockedBuffer& data, uint64_t frame_id)
 {
     // break the frame into tiles and write them to the chunk buffers
     const auto bytes_per_px = bytes_of_type(config_->dtype);
@@ -500,6 +1396,34 @@ zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
     // Take the frame data first
     auto frame = data.take();
 
+    // packed, unconverted or unreduced pixels are decoded straight into the
+    // chunk buffers, unless the frame has to be transposed, projected or
+    // previewed first
+    auto pixel_format = config_->pixel_format;
+    auto conversion = config_->input_conversion;
+    auto reduction = config_->frame_reduction;
+    if ((pixel_format != ZarrPixelFormat_Native || conversion || reduction) &&
+        (dimensions->needs_xy_transposition() || projector_ || preview_)) {
+        ByteVector decoded(bytes_per_frame_);
+        decode_frame(pixel_format,
+                     conversion,
+                     reduction,
+                     config_->dtype,
+                     dimensions->acquisition_frame_rows(),
+                     dimensions->acquisition_frame_cols(),
+                     frame.data(),
+                     decoded.data());
+        frame = std::move(decoded);
+        pixel_format = ZarrPixelFormat_Native;
+        conversion.reset();
+        reduction.reset();
+    }
+    const auto input_type = conversion ? conversion->data_type : config_->dtype;
+
+    if (preview_) {
+        preview_->publish(frame, frame_id);
+    }
+
     // Check if we need to transpose spatial dimensions (Y↔X)
     std::vector<uint8_t> transposed_frame;
     if (dimensions->needs_xy_transposition()) {
@@ -540,13 +1464,14 @@ zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
     const auto n_tiles_x = (frame_cols + tile_cols - 1) / tile_cols;
     const auto n_tiles_y = (frame_rows + tile_rows - 1) / tile_rows;
 
-    // don't take the frame id from the incoming frame, as the camera may have
-    // dropped frames
-    const auto acquisition_frame_id = frames_written_();
-
     // Transpose frame_id from acquisition order to prescribed
     // storage_dimension_order
-    const auto frame_id = dimensions->transpose_frame_id(acquisition_frame_id);
+    frame_id = dimensions->transpose_frame_id(frame_id);
+
+    if (projector_) {
+        projector_->add_frame(frame, frame_id);
+        write_projections_();
+    }
 
     // offset among the chunks in the lattice
     const auto group_offset = dimensions->tile_group_offset(frame_id);
@@ -557,6 +1482,14 @@ zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
     size_t bytes_written = 0;
     const auto n_tiles = n_tiles_x * n_tiles_y;
 
+    // statistics are taken per tile as the pixels land in the chunk buffers,
+    // so the zero padding of ragged chunks is never counted
+    std::vector<PixelStatistics> tile_statistics;
+    if (statistics_) {
+        tile_statistics.assign(
+          n_tiles, PixelStatistics(config_->dtype, config_->significant_bits));
+    }
+
 #pragma omp parallel for reduction(+ : bytes_written)
     for (auto tile = 0; tile < n_tiles; ++tile) {
         auto& chunk_buffer = chunk_buffers_[tile + group_offset];
@@ -570,6 +1503,15 @@ zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
                                                  bytes_per_px,
                                                  bytes_per_row,
                                                  bytes_per_chunk,
+                                                 pixel_format,
+                                                 &conversion,
+                                                 &reduction,
+                                                 input_type,
+                                                 dtype = config_->dtype,
+                                                 stats = tile_statistics.empty()
+                                                           ? nullptr
+                                                           : &tile_statistics
+                                                               [tile],
                                                  &frame](auto& chunk_data) {
             const auto* data_ptr = frame.data();
             const auto data_size = frame.size();
@@ -590,18 +1532,10 @@ zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
                     const auto region_width =
                       std::min(frame_col + tile_cols, frame_cols) - frame_col;
 
-                    const auto region_start =
-                      bytes_per_px * (frame_row * frame_cols + frame_col);
+                    const auto first_px = frame_row * frame_cols + frame_col;
+                    const auto region_start = bytes_per_px * first_px;
                     const auto nbytes = region_width * bytes_per_px;
 
-                    // copy region
-                    EXPECT(region_start + nbytes <= data_size,
-                           "Buffer overflow in framme. Region start: ",
-                           region_start,
-                           " nbytes: ",
-                           nbytes,
-                           " data size: ",
-                           data_size);
                     EXPECT(chunk_pos + nbytes <= bytes_per_chunk,
                            "Buffer overflow in chunk. Chunk pos: ",
                            chunk_pos,
@@ -609,8 +1543,54 @@ zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
                            nbytes,
                            " bytes per chunk: ",
                            bytes_per_chunk);
-                    memcpy(
-                      chunk_start + chunk_pos, data_ptr + region_start, nbytes);
+
+                    if (reduction) {
+                        // crop, decode and bin region; the window was checked
+                        // against the frame size up front
+                        reduce_pixels(*reduction,
+                                      pixel_format,
+                                      conversion,
+                                      dtype,
+                                      data_ptr,
+                                      frame_row,
+                                      frame_col,
+                                      region_width,
+                                      chunk_start + chunk_pos);
+                    } else if (pixel_format != ZarrPixelFormat_Native ||
+                               conversion) {
+                        // unpack and/or convert region
+                        EXPECT(bytes_of_pixels(pixel_format,
+                                               first_px + region_width,
+                                               input_type) <= data_size,
+                               "Buffer overflow in frame. First pixel: ",
+                               first_px,
+                               " pixels: ",
+                               region_width,
+                               " data size: ",
+                               data_size);
+                        decode_pixels(pixel_format,
+                                      conversion,
+                                      dtype,
+                                      data_ptr,
+                                      first_px,
+                                      region_width,
+                                      chunk_start + chunk_pos);
+                    } else {
+                        // copy region
+                        EXPECT(region_start + nbytes <= data_size,
+                               "Buffer overflow in framme. Region start: ",
+                               region_start,
+                               " nbytes: ",
+                               nbytes,
+                               " data size: ",
+                               data_size);
+                        memcpy(chunk_start + chunk_pos,
+                               data_ptr + region_start,
+                               nbytes);
+                    }
+                    if (stats) {
+                        stats->add(chunk_start + chunk_pos, region_width);
+                    }
                     bytes_written += nbytes;
                 }
                 chunk_pos += bytes_per_row;
@@ -622,9 +1602,83 @@ zarr::Array::write_frame_to_chunks_(LockedBuffer& data)
 
     data.assign(std::move(frame));
 
+    if (statistics_) {
+        add_statistics_(frame_id, tile_statistics);
+    }
+
     return bytes_written;
 }
 
+uint64_t
+zarr::Array::channel_of_frame_(uint64_t frame_id) const
+{
+    // frame_id is in storage order, like the dimensions
+    const auto& dims = config_->dimensions;
+    uint64_t frames_per_channel = 1;
+    for (auto i = *channel_dim_ + 1; i < dims->ndims() - 2; ++i) {
+        frames_per_channel *= dims->at(i).array_size_px;
+    }
+
+    const auto channel = frame_id / frames_per_channel;
+    return *channel_dim_ == 0
+             ? channel
+             : channel % dims->at(*channel_dim_).array_size_px;
+}
+
+void
+zarr::Array::add_statistics_(
+  uint64_t frame_id,
+  const std::vector<PixelStatistics>& tile_statistics)
+{
+    PixelStatistics frame_statistics(config_->dtype, config_->significant_bits);
+    for (const auto& stats : tile_statistics) {
+        frame_statistics.merge(stats);
+    }
+
+    std::unique_lock lock(statistics_mutex_);
+    statistics_->merge(frame_statistics);
+
+    if (channel_dim_) {
+        const auto channel = channel_of_frame_(frame_id);
+        if (channel >= channel_statistics_.size()) {
+            channel_statistics_.resize(
+              channel + 1,
+              PixelStatistics(config_->dtype, config_->significant_bits));
+        }
+        channel_statistics_[channel].merge(frame_statistics);
+    }
+}
+
+void
+zarr::Array::write_projections_()
+{
+    LockedBuffer projected;
+    while (projector_->take_frame(projected)) {
+        size_t n_bytes;
+        const auto result = projection_array_->write_frame(projected, n_bytes);
+        EXPECT(result == WriteResult::Ok,
+               "Failed to write frame to projection array ",
+               config_->projection_key);
+    }
+}
+
+nlohmann::json
+zarr::Array::statistics_json_() const
+{
+    std::unique_lock lock(statistics_mutex_);
+    auto stats = statistics_->to_json();
+    if (channel_dim_) {
+        auto channels = json::array();
+        for (const auto& channel : channel_statistics_) {
+            channels.push_back(channel.to_json());
+        }
+        stats["channel_dimension"] = config_->dimensions->at(*channel_dim_).name;
+        stats["channels"] = channels;
+    }
+
+    return stats;
+}
+
 ByteVector
 zarr::Array::consolidate_chunks_(uint32_t shard_index)
 {
@@ -639,36 +1693,46 @@ zarr::Array::consolidate_chunks_(uint32_t shard_index)
     const auto layer_offset = current_layer_ * chunks_per_layer;
     const auto chunk_offset = current_layer_ * chunks_in_mem;
 
+    // chunk buffer holding each chunk of the layer, by layer-relative index
+    constexpr auto missing = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> buffer_indices(chunks_per_layer, missing);
+    for (const auto& idx :
+         dims->chunk_indices_for_shard_layer(shard_index, current_layer_)) {
+        const auto internal_idx = dims->shard_internal_index(idx);
+        buffer_indices[internal_idx - layer_offset] = idx - chunk_offset;
+    }
+
+    // lay the chunks out in the configured order; the table records where
+    // each one lands, so readers are unaffected
     auto& shard_table = shard_tables_[shard_index];
     const auto file_offset = shard_file_offsets_[shard_index];
-    shard_table[2 * layer_offset] = file_offset;
-
-    uint64_t last_chunk_offset = shard_table[2 * layer_offset];
-    uint64_t last_chunk_size = shard_table[2 * layer_offset + 1];
-    size_t shard_size = last_chunk_size;
-
-    for (auto i = 1; i < chunks_per_layer; ++i) {
+    size_t shard_size = 0;
+    for (const auto i : shard_layer_order_) {
         const auto offset_idx = 2 * (layer_offset + i);
         const auto size_idx = offset_idx + 1;
-        if (shard_table[size_idx] == std::numeric_limits<uint64_t>::max()) {
+        if (buffer_indices[i] == missing ||
+            shard_table[size_idx] == std::numeric_limits<uint64_t>::max()) {
             continue;
         }
 
-        shard_table[offset_idx] = last_chunk_offset + last_chunk_size;
-        last_chunk_offset = shard_table[offset_idx];
-        last_chunk_size = shard_table[size_idx];
-        shard_size += last_chunk_size;
+        shard_table[offset_idx] = file_offset + shard_size;
+        shard_size += shard_table[size_idx];
     }
 
     std::vector<uint8_t> shard_layer(shard_size);
 
-    const auto chunk_indices_this_layer =
-      dims->chunk_indices_for_shard_layer(shard_index, current_layer_);
-
     size_t offset = 0;
-    for (const auto& idx : chunk_indices_this_layer) {
+    for (const auto i : shard_layer_order_) {
+        if (buffer_indices[i] == missing) {
+            continue;
+        }
+
         // this clears the chunk data out of the LockedBuffer
-        const auto chunk = chunk_buffers_[idx - chunk_offset].take();
+        const auto chunk = chunk_buffers_[buffer_indices[i]].take();
+        EXPECT(offset + chunk.size() <= shard_size,
+               "Chunk ",
+               i,
+               " overflows the consolidated shard layer");
         std::copy(chunk.begin(), chunk.end(), shard_layer.begin() + offset);
 
         offset += chunk.size();
@@ -711,13 +1775,16 @@ zarr::Array::compress_and_flush_data_()
 
     std::atomic<char> all_successful = 1;
 
-    auto write_table = is_closing_ || should_rollover_();
+    auto write_table = is_closing_ || is_partial_flush_ || should_rollover_();
 
     std::vector<std::future<void>> futures;
 
     // queue jobs to compress all chunks
     const auto bytes_of_raw_chunk = config_->dimensions->bytes_per_chunk();
-    const auto bytes_per_px = bytes_of_type(config_->dtype);
+    const auto dtype = config_->dtype;
+    const auto significant_bits = config_->significant_bits;
+    const auto type_size = compression_type_size_();
+    const auto chunk_checksums = config_->chunk_checksums;
 
     for (auto i = 0; i < chunks_in_memory; ++i) {
         auto promise = std::make_shared<std::promise<void>>();
@@ -728,12 +1795,16 @@ zarr::Array::compress_and_flush_data_()
         const auto internal_idx = dims->shard_internal_index(chunk_idx);
         auto* shard_table = shard_tables_.data() + shard_idx;
 
-        if (config_->compression_params) {
-            const auto compression_params = config_->compression_params.value();
+        if (config_->compression_params || significant_bits > 0 ||
+            chunk_checksums) {
+            const auto compression_params = config_->compression_params;
 
             auto job = [&chunk_buffer = chunk_buffers_[i],
-                        bytes_per_px,
+                        dtype,
+                        significant_bits,
+                        type_size,
                         compression_params,
+                        chunk_checksums,
                         shard_table,
                         shard_idx,
                         chunk_idx,
@@ -743,13 +1814,23 @@ zarr::Array::compress_and_flush_data_()
                 bool success = false;
 
                 try {
-                    if (!chunk_buffer.compress(compression_params,
-                                               bytes_per_px)) {
+                    if (significant_bits > 0) {
+                        chunk_buffer.with_lock([&](ByteVector& data) {
+                            pack_bits(data, dtype, significant_bits);
+                        });
+                    }
+                    if (compression_params &&
+                        !chunk_buffer.compress(*compression_params,
+                                               type_size)) {
                         err = "Failed to compress chunk " +
                               std::to_string(chunk_idx) + " (internal index " +
                               std::to_string(internal_idx) + " of shard " +
                               std::to_string(shard_idx) + ")";
                     }
+                    if (chunk_checksums) {
+                        chunk_buffer.with_lock(
+                          [](ByteVector& data) { append_crc32c(data); });
+                    }
 
                     // update shard table with size
                     shard_table->at(2 * internal_idx + 1) = chunk_buffer.size();
@@ -794,6 +1875,8 @@ zarr::Array::compress_and_flush_data_()
         const std::string data_path = data_paths_[shard_idx];
         auto* file_offset = shard_file_offsets_.data() + shard_idx;
         auto* shard_table = shard_tables_.data() + shard_idx;
+        auto* flushed_end = shard_flushed_ends_.data() + shard_idx;
+        const auto is_partial_flush = is_partial_flush_;
 
         auto promise = std::make_shared<std::promise<void>>();
         futures.emplace_back(promise->get_future());
@@ -803,6 +1886,8 @@ zarr::Array::compress_and_flush_data_()
                     data_path,
                     shard_table,
                     file_offset,
+                    flushed_end,
+                    is_partial_flush,
                     write_table,
                     bucket_name,
                     connection_pool,
@@ -854,6 +1939,14 @@ zarr::Array::compress_and_flush_data_()
                                       "shard " +
                                       std::to_string(shard_idx);
                                 success = false;
+                            } else if (!is_s3 && !is_partial_flush &&
+                                       *file_offset + table.size() <
+                                         *flushed_end) {
+                                // an earlier partial flush ran past the end
+                                // of the finished shard; the index must be
+                                // the last thing in the file
+                                success = truncate_shard_(
+                                  data_path, *file_offset + table.size(), err);
                             }
                         }
                     }
@@ -888,6 +1981,22 @@ zarr::Array::compress_and_flush_data_()
         future.wait();
     }
 
+    // record completed shards unconditionally, so that recovery never rolls
+    // them back to an earlier checkpoint
+    if (all_successful && !is_closing_ &&
+        config_->checkpoint_interval.count() > 0 &&
+        (write_table || checkpoint_due_())) {
+        if (!write_checkpoint_(write_table)) {
+            LOG_WARNING("Failed to checkpoint shard indices for array ",
+                        config_->node_key);
+        }
+    }
+
+    // a partially flushed layer stays open, to be written again once full
+    if (is_partial_flush_) {
+        return static_cast<bool>(all_successful);
+    }
+
     // reset shard tables and file offsets
     if (write_table) {
         for (auto& table : shard_tables_) {
@@ -896,6 +2005,7 @@ zarr::Array::compress_and_flush_data_()
         }
 
         std::fill(shard_file_offsets_.begin(), shard_file_offsets_.end(), 0);
+        std::fill(shard_flushed_ends_.begin(), shard_flushed_ends_.end(), 0);
         current_layer_ = 0;
     } else {
         ++current_layer_;
@@ -907,12 +2017,7 @@ zarr::Array::compress_and_flush_data_()
 bool
 zarr::Array::should_flush_() const
 {
-    const auto& dims = config_->dimensions;
-    size_t frames_before_flush = dims->final_dim().chunk_size_px;
-    for (auto i = 1; i < dims->ndims() - 2; ++i) {
-        frames_before_flush *= dims->at(i).array_size_px;
-    }
-
+    const auto frames_before_flush = frames_per_layer_();
     CHECK(frames_before_flush > 0);
     return frames_written_() % frames_before_flush == 0;
 }
@@ -932,6 +2037,121 @@ zarr::Array::should_rollover_() const
     return frames_written_() % frames_before_flush == 0;
 }
 
+bool
+zarr::Array::complete_layer_()
+{
+    if (!compress_and_flush_data_()) {
+        return false;
+    }
+
+    if (should_rollover_()) {
+        rollover_();
+        update_metadata_();
+    }
+    bytes_to_flush_ = 0;
+
+    if (is_indexed_) {
+        std::fill(layer_frames_received_.begin(),
+                  layer_frames_received_.end(),
+                  false);
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::place_indexed_frame_(LockedBuffer& data, uint64_t frame_id)
+{
+    if (bytes_to_flush_ == 0) {
+        fill_buffers_();
+    }
+
+    const auto n_bytes = write_frame_to_chunks_(data, frame_id);
+    EXPECT(n_bytes == bytes_per_frame_,
+           "Expected to write ",
+           bytes_per_frame_,
+           " bytes for frame ",
+           frame_id,
+           ", wrote ",
+           n_bytes);
+
+    layer_frames_received_[frame_id - layer_start_frame_()] = true;
+    bytes_to_flush_ += n_bytes;
+    total_bytes_written_ += n_bytes;
+
+    if (!should_flush_()) {
+        return true;
+    }
+
+    if (!complete_layer_()) {
+        return false;
+    }
+
+    // the pending frames all belong to the layer that was just started
+    auto pending = std::move(pending_frames_);
+    pending_frames_.clear();
+    for (auto& [id, frame] : pending) {
+        if (!place_indexed_frame_(frame, id)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::pad_indexed_layer_()
+{
+    // frames that never arrived are left as the fill value
+    const auto missing =
+      frames_per_layer_() - bytes_to_flush_ / bytes_per_frame_;
+    if (bytes_to_flush_ == 0) {
+        fill_buffers_();
+    }
+    bytes_to_flush_ += missing * bytes_per_frame_;
+    total_bytes_written_ += missing * bytes_per_frame_;
+
+    if (!complete_layer_()) {
+        return false;
+    }
+
+    // the pending frames all belong to the layer that was just started
+    auto pending = std::move(pending_frames_);
+    pending_frames_.clear();
+    for (auto& [id, frame] : pending) {
+        if (!place_indexed_frame_(frame, id)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::close_indexed_frames_()
+{
+    // pad out the layer if later frames are waiting on it
+    while (!pending_frames_.empty()) {
+        if (!pad_indexed_layer_()) {
+            return false;
+        }
+    }
+
+    // the array extends to the highest frame index received
+    if (const auto frames_end = indexed_frames_end_;
+        frames_end > frames_written_()) {
+        const auto missing = frames_end - frames_written_();
+        bytes_to_flush_ += missing * bytes_per_frame_;
+        total_bytes_written_ += missing * bytes_per_frame_;
+
+        if (should_flush_()) {
+            return complete_layer_();
+        }
+    }
+
+    return true;
+}
+
 void
 zarr::Array::rollover_()
 {
@@ -955,12 +2175,678 @@ zarr::Array::close_sinks_()
     for (auto& [path, sink] : data_sinks_) {
         EXPECT(
           finalize_sink(std::move(sink)), "Failed to finalize sink at ", path);
+        verify_shard_(path);
     }
     data_sinks_.clear();
 }
 
-size_t
+void
+zarr::Array::verify_shard_(const std::string& path) const
+{
+    if (const auto& verifier = config_->shard_verifier;
+        verifier && !is_s3_array_()) {
+        verifier->enqueue(path,
+                          config_->dimensions->chunks_per_shard(),
+                          config_->chunk_checksums);
+    }
+}
+
+size_t
 zarr::Array::frames_written_() const
 {
     return total_bytes_written_ / bytes_per_frame_;
 }
+
+size_t
+zarr::Array::frames_per_layer_() const
+{
+    return config_->dimensions->frames_per_chunk_layer();
+}
+
+size_t
+zarr::Array::frames_per_plane_() const
+{
+    const auto& dims = config_->dimensions;
+
+    size_t frames_per_plane = 1;
+    for (auto i = 1; i < dims->ndims() - 2; ++i) {
+        frames_per_plane *= dims->at(i).array_size_px;
+    }
+
+    return frames_per_plane;
+}
+
+uint64_t
+zarr::Array::layer_start_frame_() const
+{
+    return (total_bytes_written_ - bytes_to_flush_) / bytes_per_frame_;
+}
+
+size_t
+zarr::Array::append_dimension_size_() const
+{
+    const auto& dims = config_->dimensions;
+
+    if (has_direct_chunks_) {
+        const auto& append_dim = dims->at(0);
+        return append_dim.array_size_px > 0
+                 ? std::min<size_t>(direct_append_size_,
+                                    append_dim.array_size_px)
+                 : direct_append_size_;
+    }
+
+    size_t append_size = frames_written_();
+    for (auto i = dims->ndims() - 3; i > 0; --i) {
+        const auto& dim = dims->at(i);
+        const auto& array_size_px = dim.array_size_px;
+        CHECK(array_size_px);
+        append_size = (append_size + array_size_px - 1) / array_size_px;
+    }
+
+    return append_size;
+}
+
+zarr::WriteResult
+zarr::Array::validate_direct_write_(std::span<const uint64_t> coords,
+                                    std::vector<uint64_t>& storage_coords) const
+{
+    if (total_bytes_written_ > 0 || is_indexed_) {
+        LOG_ERROR("Cannot write directly to an array with frames");
+        return WriteResult::InvalidChunk;
+    }
+
+    const auto& dims = config_->dimensions;
+    const auto ndims = dims->ndims();
+
+    // 2D arrays carry a phantom append dimension that the caller doesn't see
+    const size_t start_dim = dims->is_2d() ? 1 : 0;
+    if (coords.size() != ndims - start_dim) {
+        LOG_ERROR(
+          "Expected ", ndims - start_dim, " coordinates, got ", coords.size());
+        return WriteResult::InvalidArgument;
+    }
+
+    storage_coords.assign(ndims, 0);
+    std::ranges::copy(coords, storage_coords.begin() + start_dim);
+
+    return WriteResult::Ok;
+}
+
+bool
+zarr::Array::write_direct_chunk_(const std::vector<uint64_t>& coords,
+                                 ConstByteSpan chunk,
+                                 bool is_complete)
+{
+    std::string path;
+    uint32_t internal_index;
+    auto* shard = direct_shard_for_chunk_(coords, path, internal_index);
+    if (shard == nullptr) {
+        return false;
+    }
+
+    // chunks are appended in arrival order; rewriting a chunk leaves the old
+    // copy unreferenced
+    if (!shard->sink->write(shard->file_offset, chunk)) {
+        LOG_ERROR("Failed to write chunk to ", path);
+        return false;
+    }
+
+    shard->table[2 * internal_index] = shard->file_offset;
+    shard->table[2 * internal_index + 1] = chunk.size();
+    shard->file_offset += chunk.size();
+    has_direct_chunks_ = true;
+
+    if (is_complete && !shard->complete[internal_index]) {
+        shard->complete[internal_index] = true;
+        ++shard->chunks_complete;
+    }
+
+    if (shard->chunks_complete == shard->chunks_expected) {
+        if (!finalize_direct_shard_(path, *shard)) {
+            return false;
+        }
+        direct_shards_.erase(path);
+        completed_direct_shards_.insert(path);
+    }
+
+    return true;
+}
+
+std::string
+zarr::Array::direct_chunk_path_(const std::vector<uint64_t>& coords,
+                                uint32_t& internal_index) const
+{
+    const auto& dims = config_->dimensions;
+    const auto ndims = dims->ndims();
+
+    // flatten the coordinates into a chunk index local to the current row of
+    // shards along the append dimension, as the frame path does
+    const auto shard_planes = dims->at(0).shard_size_chunks;
+    uint64_t chunk_index = 0, stride = 1;
+    for (auto i = ndims - 1; i > 0; --i) {
+        chunk_index += coords[i] * stride;
+        stride *= chunks_along_dimension(dims->at(i));
+    }
+    chunk_index += (coords[0] % shard_planes) * stride;
+
+    const auto shard_index = dims->shard_index_for_chunk(chunk_index);
+    internal_index = dims->shard_internal_index(chunk_index);
+
+    const auto shard_row = coords[0] / shard_planes;
+    const auto root = dims->is_2d()
+                        ? node_path_() + "/c"
+                        : node_path_() + "/c/" + std::to_string(shard_row);
+    return construct_data_paths(root, *dims, shards_along_dimension)[shard_index];
+}
+
+bool
+zarr::Array::is_direct_chunk_complete_(const std::vector<uint64_t>& coords) const
+{
+    uint32_t internal_index;
+    const auto path = direct_chunk_path_(coords, internal_index);
+    if (completed_direct_shards_.contains(path)) {
+        return true;
+    }
+
+    const auto it = direct_shards_.find(path);
+    return it != direct_shards_.end() && it->second.complete[internal_index];
+}
+
+zarr::Array::DirectShard*
+zarr::Array::direct_shard_for_chunk_(const std::vector<uint64_t>& coords,
+                                     std::string& path,
+                                     uint32_t& internal_index)
+{
+    const auto& dims = config_->dimensions;
+    const auto ndims = dims->ndims();
+
+    path = direct_chunk_path_(coords, internal_index);
+    if (completed_direct_shards_.contains(path)) {
+        LOG_ERROR("Shard ", path, " is complete and cannot be written to");
+        return nullptr;
+    }
+
+    auto& shard = direct_shards_[path];
+    if (shard.sink != nullptr) {
+        return &shard;
+    }
+
+    shard.sink =
+      is_s3_array_()
+        ? make_s3_sink(*config_->bucket_name, path, s3_connection_pool_)
+        : make_file_sink(path, file_handle_pool_);
+    if (shard.sink == nullptr) {
+        LOG_ERROR("Failed to create sink for ", path);
+        direct_shards_.erase(path);
+        return nullptr;
+    }
+
+    const auto chunks_per_shard = dims->chunks_per_shard();
+    shard.table.resize(2 * chunks_per_shard,
+                       std::numeric_limits<uint64_t>::max());
+    shard.complete.resize(chunks_per_shard, false);
+
+    // shards on the array's upper edges hold fewer chunks
+    shard.chunks_expected = 1;
+    for (auto i = 0; i < ndims; ++i) {
+        const auto& dim = dims->at(i);
+        const auto shard_size = dim.shard_size_chunks;
+        uint64_t n_chunks = shard_size;
+        if (i > 0 || dim.array_size_px > 0) {
+            const auto first = coords[i] / shard_size * shard_size;
+            n_chunks =
+              std::min<uint64_t>(shard_size, chunks_along_dimension(dim) - first);
+        }
+        shard.chunks_expected *= n_chunks;
+    }
+
+    return &shard;
+}
+
+zarr::Array::RegionChunk*
+zarr::Array::region_chunk_(const std::vector<uint64_t>& coords)
+{
+    if (const auto it = region_chunks_.find(coords);
+        it != region_chunks_.end()) {
+        return &it->second;
+    }
+
+    const auto& dims = config_->dimensions;
+    const auto bytes_of_chunk = dims->bytes_per_chunk();
+    const auto bytes_per_px = bytes_of_type(config_->dtype);
+
+    RegionChunk chunk;
+    chunk.data.resize(bytes_of_chunk, 0);
+    chunk.covered.resize(bytes_of_chunk / bytes_per_px /
+                         dims->at(dims->ndims() - 1).chunk_size_px);
+
+    // chunks on the array's upper edges are partly out of bounds
+    chunk.n_expected = 1;
+    for (auto i = 0; i < dims->ndims(); ++i) {
+        const auto& dim = dims->at(i);
+        uint64_t extent = dim.chunk_size_px;
+        if (dim.array_size_px > 0) {
+            extent = std::min<uint64_t>(
+              extent, dim.array_size_px - coords[i] * dim.chunk_size_px);
+        }
+        chunk.n_expected *= extent;
+    }
+
+    // pick up where an earlier write to this chunk left off
+    std::string path;
+    uint32_t internal_index;
+    auto* shard = direct_shard_for_chunk_(coords, path, internal_index);
+    if (shard == nullptr) {
+        return nullptr;
+    }
+
+    const auto nbytes = shard->table[2 * internal_index + 1];
+    if (nbytes != std::numeric_limits<uint64_t>::max()) {
+        if (!read_direct_chunk_(
+              path, shard->table[2 * internal_index], nbytes, chunk.data)) {
+            return nullptr;
+        }
+
+        const auto it = evicted_coverage_.find(coords);
+        EXPECT(it != evicted_coverage_.end(),
+               "No coverage recorded for evicted chunk in ",
+               path);
+        chunk.covered = std::move(it->second);
+        for (const auto& row : chunk.covered) {
+            for (const auto& [begin, end] : row) {
+                chunk.n_covered += end - begin;
+            }
+        }
+        evicted_coverage_.erase(it);
+    }
+
+    region_chunk_bytes_ += chunk.data.size();
+    return &region_chunks_.emplace(coords, std::move(chunk)).first->second;
+}
+
+bool
+zarr::Array::read_direct_chunk_(const std::string& path,
+                                uint64_t offset,
+                                uint64_t nbytes,
+                                ByteVector& data) const
+{
+    if (is_s3_array_()) {
+        LOG_ERROR("Cannot revisit chunk in ", path, " after it was written");
+        return false;
+    }
+
+    auto fs_path = path;
+    if (fs_path.starts_with("file://")) {
+        fs_path = fs_path.substr(7);
+    }
+
+    std::ifstream ifs(fs_path, std::ios::binary);
+    ByteVector encoded(nbytes);
+    ifs.seekg(static_cast<std::streamoff>(offset));
+    if (!ifs.read(reinterpret_cast<char*>(encoded.data()),
+                  static_cast<std::streamsize>(nbytes))) {
+        LOG_ERROR("Failed to read back chunk from ", path);
+        return false;
+    }
+
+    if (!decode_chunk_(encoded)) {
+        LOG_ERROR("Failed to decode chunk from ", path);
+        return false;
+    }
+    data = std::move(encoded);
+
+    return true;
+}
+
+size_t
+zarr::Array::bytes_of_packed_chunk_() const
+{
+    const auto bytes_of_chunk = config_->dimensions->bytes_per_chunk();
+    const auto bits = config_->significant_bits;
+    if (bits == 0) {
+        return bytes_of_chunk;
+    }
+
+    const auto n_elements = bytes_of_chunk / bytes_of_type(config_->dtype);
+    return (n_elements * bits + 7) / 8;
+}
+
+size_t
+zarr::Array::compression_type_size_() const
+{
+    // packed samples no longer line up with bytes, so there's nothing to
+    // shuffle by
+    return config_->significant_bits > 0 ? 1 : bytes_of_type(config_->dtype);
+}
+
+bool
+zarr::Array::encode_chunk_(ByteVector& chunk) const
+{
+    if (config_->significant_bits > 0) {
+        pack_bits(chunk, config_->dtype, config_->significant_bits);
+    }
+
+    if (config_->compression_params &&
+        !compress_in_place(
+          chunk, *config_->compression_params, compression_type_size_())) {
+        return false;
+    }
+
+    if (config_->chunk_checksums) {
+        append_crc32c(chunk);
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::decode_chunk_(ByteVector& chunk) const
+{
+    if (config_->chunk_checksums && !strip_crc32c(chunk)) {
+        LOG_ERROR("Chunk checksum mismatch");
+        return false;
+    }
+
+    if (config_->compression_params) {
+        LockedBuffer buffer(std::move(chunk));
+        if (!buffer.decompress(bytes_of_packed_chunk_())) {
+            return false;
+        }
+        chunk = buffer.take();
+    }
+
+    const auto bytes_of_chunk = config_->dimensions->bytes_per_chunk();
+    if (config_->significant_bits > 0) {
+        return unpack_bits(chunk,
+                           config_->dtype,
+                           config_->significant_bits,
+                           bytes_of_chunk / bytes_of_type(config_->dtype));
+    }
+
+    return chunk.size() == bytes_of_chunk;
+}
+
+bool
+zarr::Array::write_region_to_chunk_(const std::vector<uint64_t>& chunk_coords,
+                                    const std::vector<uint64_t>& region_offset,
+                                    const std::vector<uint64_t>& region_shape,
+                                    ConstByteSpan data)
+{
+    // overlapping regions keep the pixels written first, so a complete chunk
+    // is never rewritten
+    if (!region_chunks_.contains(chunk_coords) &&
+        is_direct_chunk_complete_(chunk_coords)) {
+        return true;
+    }
+
+    auto* chunk = region_chunk_(chunk_coords);
+    if (chunk == nullptr) {
+        return false;
+    }
+
+    const auto& dims = config_->dimensions;
+    const auto ndims = dims->ndims();
+    const auto bytes_per_px = bytes_of_type(config_->dtype);
+
+    // the part of the region that falls in this chunk, in array coordinates
+    std::vector<uint64_t> lo(ndims), hi(ndims);
+    std::vector<uint64_t> region_strides(ndims, 1), chunk_strides(ndims, 1);
+    for (auto i = 0; i < ndims; ++i) {
+        const auto chunk_size = dims->at(i).chunk_size_px;
+        const auto chunk_start = chunk_coords[i] * chunk_size;
+        lo[i] = std::max(region_offset[i], chunk_start);
+        hi[i] = std::min(region_offset[i] + region_shape[i],
+                         chunk_start + chunk_size);
+    }
+    for (auto i = ndims - 1; i > 0; --i) {
+        region_strides[i - 1] = region_strides[i] * region_shape[i];
+        chunk_strides[i - 1] = chunk_strides[i] * dims->at(i).chunk_size_px;
+    }
+
+    // copy one contiguous row along the last dimension at a time, skipping
+    // the parts of it already written
+    const auto row_size = dims->at(ndims - 1).chunk_size_px;
+    const auto row_px = hi.back() - lo.back();
+    std::vector<uint64_t> pos = lo;
+    while (true) {
+        uint64_t src = 0, dst = 0;
+        for (auto i = 0; i < ndims; ++i) {
+            src += (pos[i] - region_offset[i]) * region_strides[i];
+            dst += (pos[i] - chunk_coords[i] * dims->at(i).chunk_size_px) *
+                   chunk_strides[i];
+        }
+
+        const auto row_begin = dst % row_size;
+        chunk->n_covered += cover_row(
+          chunk->covered[dst / row_size],
+          row_begin,
+          row_begin + row_px,
+          [&](uint64_t begin, uint64_t end) {
+              memcpy(chunk->data.data() +
+                       (dst - row_begin + begin) * bytes_per_px,
+                     data.data() + (src - row_begin + begin) * bytes_per_px,
+                     (end - begin) * bytes_per_px);
+          });
+
+        auto i = ndims - 1;
+        while (i > 0 && pos[i - 1] + 1 == hi[i - 1]) {
+            pos[i - 1] = lo[i - 1];
+            --i;
+        }
+        if (i == 0) {
+            break;
+        }
+        ++pos[i - 1];
+    }
+
+    chunk->last_write = ++region_write_count_;
+
+    if (chunk->n_covered == chunk->n_expected) {
+        return flush_region_chunk_(region_chunks_.find(chunk_coords), true);
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::flush_region_chunk_(
+  std::map<std::vector<uint64_t>, RegionChunk>::iterator it,
+  bool is_complete)
+{
+    auto coords = it->first;
+    auto chunk = std::move(it->second);
+    region_chunks_.erase(it);
+    region_chunk_bytes_ -= chunk.data.size();
+
+    if (!encode_chunk_(chunk.data)) {
+        LOG_ERROR("Failed to encode chunk");
+        return false;
+    }
+
+    if (!is_complete) {
+        evicted_coverage_.emplace(coords, std::move(chunk.covered));
+    }
+
+    return write_direct_chunk_(coords, chunk.data, is_complete);
+}
+
+bool
+zarr::Array::evict_region_chunks_()
+{
+    const auto max_bytes = config_->max_region_buffer_bytes;
+    while (max_bytes > 0 && region_chunk_bytes_ > max_bytes &&
+           !region_chunks_.empty()) {
+        // write out the chunk that has gone longest without a write
+        const auto lru = std::ranges::min_element(
+          region_chunks_, {}, [](const auto& kv) {
+              return kv.second.last_write;
+          });
+        if (!flush_region_chunk_(lru, false)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::finalize_direct_shard_(const std::string& path,
+                                    DirectShard& shard)
+{
+    if (!shard.sink->write(shard.file_offset, make_shard_index(shard.table))) {
+        LOG_ERROR("Failed to write shard index to ", path);
+        return false;
+    }
+
+    if (!finalize_sink(std::move(shard.sink))) {
+        LOG_ERROR("Failed to finalize sink at ", path);
+        return false;
+    }
+    verify_shard_(path);
+
+    return true;
+}
+
+bool
+zarr::Array::close_direct_shards_()
+{
+    // partly written chunks are written as they are, and shards missing
+    // chunks are closed as they are; the gaps read back as the fill value
+    bool success = true;
+    while (!region_chunks_.empty()) {
+        success = flush_region_chunk_(region_chunks_.begin(), false) && success;
+    }
+    evicted_coverage_.clear();
+
+    for (auto& [path, shard] : direct_shards_) {
+        success = finalize_direct_shard_(path, shard) && success;
+        completed_direct_shards_.insert(path);
+    }
+    direct_shards_.clear();
+
+    return success;
+}
+
+bool
+zarr::Array::checkpoint_due_() const
+{
+    return !last_checkpoint_ || std::chrono::steady_clock::now() -
+                                    *last_checkpoint_ >=
+                                  config_->checkpoint_interval;
+}
+
+bool
+zarr::Array::truncate_shard_(std::string path,
+                             size_t size,
+                             std::string& error)
+{
+    if (path.starts_with("file://")) {
+        path = path.substr(7);
+    }
+
+    std::error_code ec;
+    std::filesystem::resize_file(path, size, ec);
+    if (ec) {
+        error = "Failed to truncate shard " + path + ": " + ec.message();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::write_shard_indices_()
+{
+    // make the partial shards readable as is; the next layer is written over
+    // these indices
+    for (auto i = 0; i < data_paths_.size(); ++i) {
+        const auto& data_path = data_paths_[i];
+        const auto it = data_sinks_.find(data_path);
+        if (it == data_sinks_.end() || it->second == nullptr) {
+            LOG_ERROR("No open sink for shard ", data_path);
+            return false;
+        }
+
+        if (!it->second->write(shard_file_offsets_[i],
+                               make_shard_index(shard_tables_[i]))) {
+            LOG_ERROR("Failed to write shard index to ", data_path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+zarr::Array::write_checkpoint_(bool tables_written)
+{
+    if (!tables_written && !write_shard_indices_()) {
+        return false;
+    }
+
+    const auto node_path = node_path_();
+
+    std::vector<ShardCheckpoint> shards;
+    for (auto i = 0; i < data_paths_.size(); ++i) {
+        const auto& data_path = data_paths_[i];
+        const auto& table = shard_tables_[i];
+        const auto data_end = shard_file_offsets_[i];
+
+        shards.push_back({
+          .path = data_path.substr(node_path.size() + 1),
+          .data_end = data_end,
+          .table = table,
+        });
+    }
+
+    if (checkpoint_sink_ == nullptr) {
+        // don't append to a manifest left over from an earlier acquisition
+        remove_checkpoint_();
+        checkpoint_sink_ = make_file_sink(
+          node_path + "/" + checkpoint_manifest_name, file_handle_pool_);
+        EXPECT(checkpoint_sink_, "Failed to create checkpoint manifest");
+
+        // recovery patches the shape, but needs a zarr.json to patch
+        if (!write_metadata_()) {
+            LOG_ERROR("Failed to write metadata for checkpoint");
+            return false;
+        }
+    }
+
+    const auto record = make_checkpoint_record(
+      config_->dimensions->is_2d() ? no_append_dimension
+                                   : append_dimension_size_(),
+      shards);
+    if (!checkpoint_sink_->write(checkpoint_manifest_offset_, record)) {
+        LOG_ERROR("Failed to append to checkpoint manifest");
+        return false;
+    }
+
+    checkpoint_manifest_offset_ += record.size();
+    last_checkpoint_ = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+void
+zarr::Array::remove_checkpoint_()
+{
+    if (is_s3_array_() || config_->checkpoint_interval.count() == 0) {
+        return;
+    }
+
+    if (checkpoint_sink_ != nullptr &&
+        !finalize_sink(std::move(checkpoint_sink_))) {
+        LOG_WARNING("Failed to finalize checkpoint manifest");
+    }
+    checkpoint_sink_.reset();
+    checkpoint_manifest_offset_ = 0;
+
+    std::string path = node_path_() + "/" + checkpoint_manifest_name;
+    if (path.starts_with("file://")) {
+        path = path.substr(7);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
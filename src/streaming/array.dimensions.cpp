@@ -2,6 +2,8 @@
 #include "macros.hh"
 #include "zarr.common.hh"
 
+#include <algorithm>
+#include <numeric>
 #include <tuple>
 #include <unordered_map>
 
@@ -342,6 +344,17 @@ ArrayDimensions::chunk_layers_per_shard() const
     return dims_[0].shard_size_chunks;
 }
 
+uint64_t
+ArrayDimensions::frames_per_chunk_layer() const
+{
+    uint64_t frames_per_layer = final_dim().chunk_size_px;
+    for (auto i = 1; i < ndims() - 2; ++i) {
+        frames_per_layer *= dims_[i].array_size_px;
+    }
+
+    return frames_per_layer;
+}
+
 uint32_t
 ArrayDimensions::shard_index_for_chunk(uint32_t chunk_index) const
 {
@@ -379,6 +392,70 @@ ArrayDimensions::shard_internal_index(uint32_t chunk_index) const
     return shard_internal_indices_.at(chunk_index);
 }
 
+std::vector<uint32_t>
+ArrayDimensions::shard_layer_chunk_order(ZarrChunkOrder order) const
+{
+    EXPECT(order < ZarrChunkOrderCount, "Invalid chunk order: ", order);
+
+    // shard extents, in chunks, of every dimension in the layer
+    std::vector<uint32_t> extents;
+    for (auto i = 1; i < ndims(); ++i) {
+        extents.push_back(dims_[i].shard_size_chunks);
+    }
+
+    const auto chunks_per_layer = chunks_per_shard_ / chunk_layers_per_shard();
+    const auto tiles_per_plane = extents[extents.size() - 2] * extents.back();
+    const auto tile_planes = chunks_per_layer / tiles_per_plane;
+
+    std::vector<uint32_t> indices(chunks_per_layer);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::vector<uint64_t> keys(chunks_per_layer);
+    for (uint32_t index = 0; index < chunks_per_layer; ++index) {
+        switch (order) {
+            case ZarrChunkOrder_TileMajor: {
+                // the YX tile varies slowest, so every chunk of a tile is
+                // stored together
+                const auto tile = index % tiles_per_plane;
+                const auto plane = index / tiles_per_plane;
+                keys[index] = static_cast<uint64_t>(tile) * tile_planes + plane;
+                break;
+            }
+            case ZarrChunkOrder_Morton: {
+                std::vector<uint32_t> coords(extents.size());
+                auto remainder = index;
+                for (auto d = extents.size(); d > 0; --d) {
+                    coords[d - 1] = remainder % extents[d - 1];
+                    remainder /= extents[d - 1];
+                }
+
+                // interleave the bits of each coordinate, the last dimension
+                // least significant, skipping bits a dimension doesn't need
+                uint64_t key = 0;
+                uint32_t key_bit = 0;
+                for (auto bit = 0; bit < 32; ++bit) {
+                    for (auto d = extents.size(); d > 0; --d) {
+                        if (((extents[d - 1] - 1) >> bit) == 0) {
+                            continue;
+                        }
+                        key |= static_cast<uint64_t>((coords[d - 1] >> bit) & 1)
+                               << key_bit++;
+                    }
+                }
+                keys[index] = key;
+                break;
+            }
+            default: // row-major, as the chunks are indexed
+                keys[index] = index;
+                break;
+        }
+    }
+
+    std::ranges::sort(indices, {}, [&keys](uint32_t i) { return keys[i]; });
+
+    return indices;
+}
+
 uint32_t
 ArrayDimensions::shard_index_for_chunk_(uint32_t chunk_index) const
 {
@@ -157,6 +157,12 @@ class ArrayDimensions
      */
     uint32_t chunk_layers_per_shard() const;
 
+    /**
+     * @brief Get the number of frames in a single chunk layer.
+     * @return The number of frames to append before a chunk layer is full.
+     */
+    uint64_t frames_per_chunk_layer() const;
+
     /**
      * @brief Get the shard index for a given chunk index, given array
      * dimensions.
@@ -189,6 +195,17 @@ class ArrayDimensions
      */
     uint32_t shard_internal_index(uint32_t chunk_index) const;
 
+    /**
+     * @brief Get the order in which the chunks of a shard layer are laid out
+     * in the shard file.
+     * @details A layer spans every dimension but the first, one chunk deep.
+     * Chunks are identified by their internal index less that of the first
+     * chunk in the layer, which is the same for every layer.
+     * @param order The physical order of chunks within the layer.
+     * @return The layer-relative internal index of each chunk, in file order.
+     */
+    std::vector<uint32_t> shard_layer_chunk_order(ZarrChunkOrder order) const;
+
     /**
      * @brief Remap a frame ID from acquisition order into the storage
      *        dimension order.
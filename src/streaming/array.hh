@@ -5,9 +5,20 @@
 #include "definitions.hh"
 #include "file.sink.hh"
 #include "locked.buffer.hh"
+#include "preview.buffer.hh"
+#include "projector.hh"
 #include "s3.connection.hh"
+#include "statistics.hh"
 #include "thread.pool.hh"
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+
 namespace zarr {
 class MultiscaleArray;
 
@@ -23,7 +34,23 @@ class Array : public ArrayBase
 
     [[nodiscard]] WriteResult write_frame(LockedBuffer&,
                                           size_t& bytes_written) override;
+    [[nodiscard]] WriteResult write_frame_at(LockedBuffer& data,
+                                             uint64_t frame_id,
+                                             size_t& bytes_written) override;
+    [[nodiscard]] WriteResult write_chunk(std::span<const uint64_t> chunk_coords,
+                                          ConstByteSpan data,
+                                          bool is_compressed) override;
+    [[nodiscard]] WriteResult write_region(std::span<const uint64_t> offset,
+                                           std::span<const uint64_t> shape,
+                                           ConstByteSpan data) override;
+    [[nodiscard]] bool statistics(std::optional<uint64_t> channel,
+                                  ZarrArrayStatistics& stats) const override;
+    [[nodiscard]] bool preview(uint16_t level,
+                               ByteSpan frame,
+                               ZarrPreviewInfo& info) const override;
     size_t max_bytes() const override;
+    size_t bytes_written() const override;
+    [[nodiscard]] bool flush() override;
 
   protected:
     std::vector<LockedBuffer> chunk_buffers_;
@@ -33,23 +60,111 @@ class Array : public ArrayBase
 
     const uint64_t max_bytes_;       // max number of bytes that can be written
     const uint64_t bytes_per_frame_; // number of bytes per frame
+    const uint64_t bytes_per_input_frame_; // as appended, e.g., packed
     uint64_t total_bytes_written_;   // total bytes written to the array
     uint64_t bytes_to_flush_; // bytes written to the array since last flush
     uint32_t append_chunk_index_;
     std::string data_root_;
     bool is_closing_;
+    bool is_partial_flush_;
+    uint64_t bytes_at_last_flush_; // total_bytes_written_ at the last flush()
+
+    // indexed appends fill the current chunk layer in any order; frames for
+    // the next layer wait in pending_frames_ until the current one is flushed
+    bool is_indexed_;
+    std::vector<bool> layer_frames_received_;
+    std::map<uint64_t, LockedBuffer> pending_frames_;
+    uint64_t indexed_frames_end_; // one past the highest frame index received
 
     uint32_t current_layer_;
     std::vector<size_t> shard_file_offsets_;
     std::vector<std::vector<uint64_t>> shard_tables_;
 
+    // end of the furthest partial flush into each shard; a shard that ends
+    // up shorter is truncated when its index is written
+    std::vector<size_t> shard_flushed_ends_;
+
+    // layer-relative internal indices of the chunks in a shard layer, in the
+    // order they're written to the shard file
+    std::vector<uint32_t> shard_layer_order_;
+
+    // zarr.json is rendered once; only the append dimension size between
+    // these two halves changes as the array grows
+    std::string metadata_prefix_;
+    std::string metadata_suffix_;
+    std::optional<std::chrono::steady_clock::time_point> last_metadata_update_;
+    std::future<bool> metadata_update_;
+
+    // shards filled through write_chunk() and write_region(), keyed by path;
+    // chunks are appended in arrival order and the index is written once
+    // every chunk in the shard is complete
+    struct DirectShard
+    {
+        std::unique_ptr<Sink> sink;
+        uint64_t file_offset{ 0 };
+        std::vector<uint64_t> table;
+        std::vector<bool> complete;
+        uint64_t chunks_expected{ 0 };
+        uint64_t chunks_complete{ 0 };
+    };
+    std::mutex direct_shards_mutex_;
+    std::unordered_map<std::string, DirectShard> direct_shards_;
+    std::unordered_set<std::string> completed_direct_shards_;
+    std::atomic<bool> has_direct_chunks_;
+    uint64_t direct_append_size_; // extent written along the append dimension
+
+    // raw chunks that write_region() has only partly filled, keyed by chunk
+    // lattice coordinates; for each row of a chunk along its last dimension,
+    // the sorted, disjoint [begin, end) spans written so far
+    using RowCoverage =
+      std::vector<std::vector<std::pair<uint64_t, uint64_t>>>;
+    struct RegionChunk
+    {
+        ByteVector data;
+        RowCoverage covered;
+        uint64_t n_covered{ 0 };
+        uint64_t n_expected{ 0 }; // elements within the array bounds
+        uint64_t last_write{ 0 };
+    };
+    std::map<std::vector<uint64_t>, RegionChunk> region_chunks_;
+    std::map<std::vector<uint64_t>, RowCoverage> evicted_coverage_;
+    size_t region_chunk_bytes_;
+    uint64_t region_write_count_;
+
+    // pixel statistics of appended frames, for the whole array and for each
+    // index along the first channel dimension
+    mutable std::mutex statistics_mutex_;
+    std::optional<PixelStatistics> statistics_;
+    std::vector<PixelStatistics> channel_statistics_;
+    std::optional<size_t> channel_dim_; // in storage order
+
+    // running projection of appended frames and the sibling array it is
+    // written to
+    std::unique_ptr<Projector> projector_;
+    std::unique_ptr<Array> projection_array_;
+
+    // the most recently appended frame, for live display
+    std::unique_ptr<PreviewBuffer> preview_;
+
+    std::unique_ptr<Sink> checkpoint_sink_;
+    size_t checkpoint_manifest_offset_;
+    std::optional<std::chrono::steady_clock::time_point> last_checkpoint_;
+
     std::vector<std::string> metadata_keys_() const override;
     bool make_metadata_() override;
+    [[nodiscard]] bool make_metadata_template_();
+    void update_metadata_();
+    [[nodiscard]] bool await_metadata_update_();
+    void grow_direct_append_size_(uint64_t size);
     [[nodiscard]] bool close_() override;
     [[nodiscard]] bool close_impl_();
 
     bool is_s3_array_() const;
 
+    [[nodiscard]] bool resume_();
+    [[nodiscard]] bool reload_chunk_layer_(
+      const std::vector<std::vector<uint64_t>>& tables);
+
     void make_data_paths_();
     [[nodiscard]] std::unique_ptr<Sink> make_data_sink_(std::string_view path);
     void fill_buffers_();
@@ -57,14 +172,73 @@ class Array : public ArrayBase
     bool should_flush_() const;
     bool should_rollover_() const;
 
-    size_t write_frame_to_chunks_(LockedBuffer& data);
+    size_t write_frame_to_chunks_(LockedBuffer& data, uint64_t frame_id);
+    [[nodiscard]] bool complete_layer_();
+    [[nodiscard]] bool place_indexed_frame_(LockedBuffer& data,
+                                            uint64_t frame_id);
+    [[nodiscard]] bool pad_indexed_layer_();
+    [[nodiscard]] bool close_indexed_frames_();
 
     [[nodiscard]] ByteVector consolidate_chunks_(uint32_t shard_index);
     [[nodiscard]] bool compress_and_flush_data_();
     void rollover_();
     void close_sinks_();
+    void verify_shard_(const std::string& path) const;
 
     size_t frames_written_() const;
+    size_t frames_per_layer_() const;
+    size_t frames_per_plane_() const;
+    uint64_t layer_start_frame_() const;
+    size_t append_dimension_size_() const;
+
+    [[nodiscard]] WriteResult validate_direct_write_(
+      std::span<const uint64_t> coords,
+      std::vector<uint64_t>& storage_coords) const;
+    [[nodiscard]] bool write_direct_chunk_(const std::vector<uint64_t>& coords,
+                                           ConstByteSpan chunk,
+                                           bool is_complete);
+    std::string direct_chunk_path_(const std::vector<uint64_t>& coords,
+                                   uint32_t& internal_index) const;
+    bool is_direct_chunk_complete_(const std::vector<uint64_t>& coords) const;
+    DirectShard* direct_shard_for_chunk_(const std::vector<uint64_t>& coords,
+                                         std::string& path,
+                                         uint32_t& internal_index);
+    RegionChunk* region_chunk_(const std::vector<uint64_t>& coords);
+    size_t bytes_of_packed_chunk_() const;
+    size_t compression_type_size_() const;
+    [[nodiscard]] bool encode_chunk_(ByteVector& chunk) const;
+    [[nodiscard]] bool decode_chunk_(ByteVector& chunk) const;
+    [[nodiscard]] bool read_direct_chunk_(const std::string& path,
+                                          uint64_t offset,
+                                          uint64_t nbytes,
+                                          ByteVector& data) const;
+    [[nodiscard]] bool write_region_to_chunk_(
+      const std::vector<uint64_t>& chunk_coords,
+      const std::vector<uint64_t>& region_offset,
+      const std::vector<uint64_t>& region_shape,
+      ConstByteSpan data);
+    [[nodiscard]] bool flush_region_chunk_(
+      std::map<std::vector<uint64_t>, RegionChunk>::iterator it,
+      bool is_complete);
+    [[nodiscard]] bool evict_region_chunks_();
+    [[nodiscard]] bool finalize_direct_shard_(const std::string& path,
+                                              DirectShard& shard);
+    [[nodiscard]] bool close_direct_shards_();
+
+    uint64_t channel_of_frame_(uint64_t frame_id) const;
+    void add_statistics_(uint64_t frame_id,
+                         const std::vector<PixelStatistics>& tile_statistics);
+    nlohmann::json statistics_json_() const;
+
+    void write_projections_();
+
+    bool checkpoint_due_() const;
+    [[nodiscard]] bool write_shard_indices_();
+    [[nodiscard]] static bool truncate_shard_(std::string path,
+                                              size_t size,
+                                              std::string& error);
+    [[nodiscard]] bool write_checkpoint_(bool tables_written);
+    void remove_checkpoint_();
 
     friend class MultiscaleArray;
 };
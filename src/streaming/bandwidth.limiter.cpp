@@ -0,0 +1,126 @@
+#include "bandwidth.limiter.hh"
+#include "macros.hh"
+
+#include <algorithm>
+#include <thread>
+
+zarr::TokenBucket::TokenBucket(uint64_t bytes_per_second, uint64_t burst_bytes)
+  : bytes_per_second_(static_cast<double>(bytes_per_second))
+  , burst_bytes_(static_cast<double>(burst_bytes))
+  , tokens_(static_cast<double>(burst_bytes))
+  , last_refill_(Clock::now())
+  , next_ticket_(0)
+  , now_serving_(0)
+{
+    EXPECT(bytes_per_second > 0, "Bandwidth limit must be positive");
+    EXPECT(burst_bytes > 0, "Burst size must be positive");
+}
+
+std::shared_ptr<zarr::TokenBucket>
+zarr::TokenBucket::shared(uint64_t bytes_per_second, uint64_t burst_bytes)
+{
+    static std::mutex mutex;
+    static std::weak_ptr<TokenBucket> instance;
+
+    std::unique_lock lock(mutex);
+    if (auto bucket = instance.lock()) {
+        if (bucket->bytes_per_second() != bytes_per_second ||
+            bucket->burst_bytes() != burst_bytes) {
+            LOG_WARNING("Sharing the process-wide bandwidth limit of ",
+                        bucket->bytes_per_second(),
+                        " B/s with a burst of ",
+                        bucket->burst_bytes(),
+                        " B, not the ",
+                        bytes_per_second,
+                        " B/s asked for");
+        }
+        return bucket;
+    }
+
+    auto bucket = std::make_shared<TokenBucket>(bytes_per_second, burst_bytes);
+    instance = bucket;
+
+    return bucket;
+}
+
+void
+zarr::TokenBucket::acquire(size_t bytes, bool borrow)
+{
+    auto remaining = static_cast<double>(bytes);
+    while (remaining > 0.0) {
+        const auto slice = std::min(remaining, burst_bytes_);
+
+        // each slice takes its turn, so writers from different streams
+        // interleave
+        std::unique_lock lock(mutex_);
+        const auto ticket = next_ticket_++;
+        cv_.wait(lock, [this, ticket] { return now_serving_ == ticket; });
+
+        // borrowing may leave the bucket up to a burst in debt
+        const auto needed = borrow ? slice - burst_bytes_ : slice;
+        refill_(Clock::now());
+        while (tokens_ < needed) {
+            const std::chrono::duration<double> wait(
+              (needed - tokens_) / bytes_per_second_);
+
+            // keep our turn, but let others queue up behind us
+            lock.unlock();
+            std::this_thread::sleep_for(wait);
+            lock.lock();
+
+            refill_(Clock::now());
+        }
+        tokens_ -= slice;
+        remaining -= slice;
+
+        ++now_serving_;
+        lock.unlock();
+        cv_.notify_all();
+    }
+}
+
+uint64_t
+zarr::TokenBucket::bytes_per_second() const noexcept
+{
+    return static_cast<uint64_t>(bytes_per_second_);
+}
+
+uint64_t
+zarr::TokenBucket::burst_bytes() const noexcept
+{
+    return static_cast<uint64_t>(burst_bytes_);
+}
+
+void
+zarr::TokenBucket::refill_(Clock::time_point now)
+{
+    const std::chrono::duration<double> elapsed = now - last_refill_;
+    tokens_ =
+      std::min(burst_bytes_, tokens_ + elapsed.count() * bytes_per_second_);
+    last_refill_ = now;
+}
+
+zarr::BandwidthLimiter::BandwidthLimiter(std::shared_ptr<TokenBucket> bucket)
+  : bucket_(std::move(bucket))
+  , under_pressure_(false)
+{
+    EXPECT(bucket_ != nullptr, "Null pointer: bucket");
+}
+
+void
+zarr::BandwidthLimiter::acquire(size_t bytes)
+{
+    bucket_->acquire(bytes, under_pressure_.load());
+}
+
+void
+zarr::BandwidthLimiter::set_under_pressure(bool under_pressure) noexcept
+{
+    under_pressure_ = under_pressure;
+}
+
+uint64_t
+zarr::BandwidthLimiter::bytes_per_second() const noexcept
+{
+    return bucket_->bytes_per_second();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace zarr {
+/**
+ * @brief A token bucket shared by the writers of one or more streams.
+ * @details Tokens are bytes. The bucket refills at a fixed rate up to its
+ * burst size. Writers are served in the order they ask, in slices of at most
+ * the burst size, so a large write can't starve smaller ones from other
+ * streams.
+ */
+class TokenBucket
+{
+  public:
+    /**
+     * @brief Create a token bucket, initially full.
+     * @param bytes_per_second The sustained rate.
+     * @param burst_bytes The capacity of the bucket.
+     * @throws std::runtime_error if either is zero.
+     */
+    TokenBucket(uint64_t bytes_per_second, uint64_t burst_bytes);
+
+    /**
+     * @brief Get the process-wide bucket, creating it with these parameters
+     * if no stream holds it.
+     * @details While the bucket is held, later callers share it as it is,
+     * whatever parameters they ask for.
+     */
+    static std::shared_ptr<TokenBucket> shared(uint64_t bytes_per_second,
+                                               uint64_t burst_bytes);
+
+    /**
+     * @brief Take @p bytes worth of tokens, waiting for them to refill if
+     * needed.
+     * @param bytes The number of bytes about to be written.
+     * @param borrow If true, take the tokens right away, going into debt by up
+     * to the burst size. Later writers wait for the debt to be repaid.
+     */
+    void acquire(size_t bytes, bool borrow);
+
+    uint64_t bytes_per_second() const noexcept;
+    uint64_t burst_bytes() const noexcept;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    const double bytes_per_second_;
+    const double burst_bytes_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    double tokens_;
+    Clock::time_point last_refill_;
+
+    // writers are served in ticket order
+    uint64_t next_ticket_;
+    uint64_t now_serving_;
+
+    void refill_(Clock::time_point now);
+};
+
+/**
+ * @brief Limits the bandwidth of one stream's writes to storage.
+ * @details Writes may borrow from the bucket while the stream is under
+ * pressure, i.e., while its frame queue is filling up, so that the limit
+ * smooths flushes without stalling acquisition.
+ */
+class BandwidthLimiter
+{
+  public:
+    explicit BandwidthLimiter(std::shared_ptr<TokenBucket> bucket);
+
+    /**
+     * @brief Wait until @p bytes may be written.
+     * @param bytes The number of bytes about to be written.
+     */
+    void acquire(size_t bytes);
+
+    /**
+     * @brief Set whether the stream is under pressure, allowing writes to
+     * borrow.
+     */
+    void set_under_pressure(bool under_pressure) noexcept;
+
+    /** @brief Get the sustained rate of the bucket, in bytes per second. */
+    uint64_t bytes_per_second() const noexcept;
+
+  private:
+    std::shared_ptr<TokenBucket> bucket_;
+    std::atomic<bool> under_pressure_;
+};
+} // namespace zarr
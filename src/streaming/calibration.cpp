@@ -0,0 +1,254 @@
+#include "calibration.hh"
+#include "macros.hh"
+#include "sink.hh"
+#include "zarr.common.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// together, the measurements stay well under a second
+constexpr auto compression_budget = std::chrono::milliseconds(300);
+constexpr auto write_budget = std::chrono::milliseconds(300);
+
+// about the size of a chunk, so per-call overheads are amortized as they are
+// while streaming
+constexpr size_t sample_bytes = 4 << 20;
+constexpr size_t max_write_bytes = 64 << 20;
+
+// a gradient with a few bits of noise, roughly as compressible as a frame
+// from a camera
+template<typename T>
+void
+fill_synthetic_as(ByteVector& buffer)
+{
+    auto* px = reinterpret_cast<T*>(buffer.data());
+    const auto n_px = buffer.size() / sizeof(T);
+
+    uint32_t state = 1;
+    for (auto i = 0; i < n_px; ++i) {
+        state = state * 1664525u + 1013904223u;
+        px[i] = static_cast<T>((i % 4096) / 32 + (state >> 28));
+    }
+}
+
+void
+fill_synthetic(ZarrDataType type, ByteVector& buffer)
+{
+    switch (type) {
+        case ZarrDataType_uint8:
+            return fill_synthetic_as<uint8_t>(buffer);
+        case ZarrDataType_uint16:
+            return fill_synthetic_as<uint16_t>(buffer);
+        case ZarrDataType_uint32:
+            return fill_synthetic_as<uint32_t>(buffer);
+        case ZarrDataType_uint64:
+            return fill_synthetic_as<uint64_t>(buffer);
+        case ZarrDataType_int8:
+            return fill_synthetic_as<int8_t>(buffer);
+        case ZarrDataType_int16:
+            return fill_synthetic_as<int16_t>(buffer);
+        case ZarrDataType_int32:
+            return fill_synthetic_as<int32_t>(buffer);
+        case ZarrDataType_int64:
+            return fill_synthetic_as<int64_t>(buffer);
+        case ZarrDataType_float32:
+            return fill_synthetic_as<float>(buffer);
+        case ZarrDataType_float64:
+            return fill_synthetic_as<double>(buffer);
+        default:
+            throw std::invalid_argument("Invalid data type: " +
+                                        std::to_string(type));
+    }
+}
+
+double
+seconds(Clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+// bytes compressed per second on one thread
+double
+measure_compression(const zarr::CalibrationArray& array,
+                    Clock::duration budget)
+{
+    const auto type_size = zarr::bytes_of_type(array.data_type);
+
+    ByteVector sample(sample_bytes / type_size * type_size);
+    fill_synthetic(array.data_type, sample);
+
+    ByteVector data;
+    size_t bytes = 0;
+    Clock::duration elapsed{ 0 };
+    do {
+        data = sample;
+
+        const auto start = Clock::now();
+        const bool ok =
+          zarr::compress_in_place(data, *array.compression_params, type_size);
+        elapsed += Clock::now() - start;
+        if (!ok) {
+            return 0.0;
+        }
+        bytes += sample.size();
+    } while (elapsed < budget);
+
+    return bytes / seconds(elapsed);
+}
+
+// bytes written and flushed per second to a scratch file in the store
+double
+measure_writes(const std::string& store_path,
+               std::shared_ptr<zarr::FileHandlePool> file_handle_pool)
+{
+    const auto path = (fs::path(store_path) / ".calibration").string();
+
+    auto sink = zarr::make_file_sink(path, file_handle_pool);
+    if (sink == nullptr) {
+        LOG_WARNING("Failed to open ", path, " to calibrate writes");
+        return 0.0;
+    }
+
+    ByteVector block(sample_bytes);
+    fill_synthetic(ZarrDataType_uint8, block);
+
+    size_t offset = 0;
+    const auto start = Clock::now();
+    while (offset < max_write_bytes && Clock::now() - start < write_budget) {
+        if (!sink->write(offset, block)) {
+            LOG_WARNING("Failed to write ", path, " to calibrate writes");
+            break;
+        }
+        offset += block.size();
+    }
+    const bool finalized = zarr::finalize_sink(std::move(sink));
+    const auto elapsed = Clock::now() - start;
+
+    std::error_code ec;
+    fs::remove(path, ec);
+
+    if (!finalized || offset == 0) {
+        return 0.0;
+    }
+
+    return offset / seconds(elapsed);
+}
+} // namespace
+
+ZarrCalibration
+zarr::calibrate(const std::vector<CalibrationArray>& arrays,
+                const std::string& store_path,
+                std::shared_ptr<FileHandlePool> file_handle_pool,
+                uint32_t n_threads,
+                double frame_rate_hz)
+{
+    ZarrCalibration result{};
+    result.calibrated = true;
+    result.cores = std::thread::hardware_concurrency();
+    result.threads = std::max(n_threads, 1u);
+
+    const auto n_compressed =
+      std::ranges::count_if(arrays, [](const CalibrationArray& array) {
+          return array.compression_params.has_value();
+      });
+
+    // the bytes stored for one frame appended to every array, counting
+    // multiscale arrays twice as the memory estimate does, and the time one
+    // thread takes to compress them
+    double frame_bytes = 0.0, compressed_bytes = 0.0, compress_seconds = 0.0;
+    for (const auto& array : arrays) {
+        const double bytes = array.frame_bytes * (array.multiscale ? 2 : 1);
+        frame_bytes += bytes;
+
+        if (array.compression_params) {
+            const auto rate =
+              measure_compression(array, compression_budget / n_compressed);
+            if (rate > 0.0) {
+                compressed_bytes += bytes;
+                compress_seconds += bytes / rate;
+            }
+        }
+    }
+    if (compress_seconds > 0.0) {
+        result.compress_bytes_per_second = compressed_bytes / compress_seconds;
+    }
+
+    // writes are measured uncompressed, as a worst case, and around the
+    // bandwidth limit, which would stretch the measurement far past its
+    // budget; the limit caps the result instead
+    double write_seconds = 0.0;
+    if (!store_path.empty()) {
+        const auto* limiter =
+          file_handle_pool ? file_handle_pool->bandwidth_limiter() : nullptr;
+        result.write_bytes_per_second = measure_writes(
+          store_path,
+          limiter ? std::make_shared<FileHandlePool>() : file_handle_pool);
+        if (limiter && result.write_bytes_per_second > 0.0) {
+            result.write_bytes_per_second =
+              std::min(result.write_bytes_per_second,
+                       static_cast<double>(limiter->bytes_per_second()));
+        }
+        if (result.write_bytes_per_second > 0.0) {
+            write_seconds = frame_bytes / result.write_bytes_per_second;
+        }
+    }
+
+    // split the pool in proportion to the work, keeping a thread for each
+    // kind when there's more than one
+    const auto n = result.threads;
+    if (compress_seconds == 0.0) {
+        result.compression_threads = 0;
+        result.io_threads = n;
+    } else {
+        const auto share = std::lround(
+          n * compress_seconds / (compress_seconds + write_seconds));
+        result.compression_threads = static_cast<uint32_t>(
+          std::clamp<long>(share, 1, std::max<long>(n - 1, 1)));
+        result.io_threads = std::max(n - result.compression_threads, 1u);
+    }
+
+    // every thread can compress or write, but writes share the bandwidth of
+    // the store
+    const auto busy_seconds = compress_seconds + write_seconds;
+    if (busy_seconds > 0.0) {
+        result.max_frame_rate_hz = n / busy_seconds;
+    }
+    if (write_seconds > 0.0) {
+        result.max_frame_rate_hz =
+          std::min(result.max_frame_rate_hz, 1.0 / write_seconds);
+    }
+
+    LOG_DEBUG("Calibrated ",
+              n,
+              " threads on ",
+              result.cores,
+              " cores: ",
+              result.compress_bytes_per_second,
+              " B/s compression per thread, ",
+              result.write_bytes_per_second,
+              " B/s writes, up to ",
+              result.max_frame_rate_hz,
+              " frames/s");
+
+    if (frame_rate_hz > 0.0 && result.max_frame_rate_hz > 0.0 &&
+        frame_rate_hz > result.max_frame_rate_hz) {
+        LOG_WARNING("A frame rate of ",
+                    frame_rate_hz,
+                    " Hz may not be sustainable: calibration estimates ",
+                    result.max_frame_rate_hz,
+                    " Hz with ",
+                    n,
+                    " threads");
+    }
+
+    return result;
+}
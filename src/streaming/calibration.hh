@@ -0,0 +1,50 @@
+#pragma once
+
+#include "blosc.compression.params.hh"
+#include "file.handle.hh"
+#include "zarr.types.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace zarr {
+/**
+ * @brief What the calibration needs to know about an array: how much it
+ * stores per frame and how it compresses.
+ */
+struct CalibrationArray
+{
+    ZarrDataType data_type;
+    size_t frame_bytes; // bytes of a frame as stored
+    std::optional<BloscCompressionParams> compression_params;
+    bool multiscale;
+};
+
+/**
+ * @brief Measure what the host can sustain and split the stream's threads
+ * between compression and writes accordingly.
+ * @details Blosc throughput is measured on one thread, on synthetic frames of
+ * each compressed array's data type and codec. Write bandwidth is measured by
+ * writing and flushing a scratch file in @p store_path, which is removed
+ * afterwards, bypassing any bandwidth limit on @p file_handle_pool; the
+ * measured rate is then capped at the limit. Each measurement stops after a
+ * fraction of a second.
+ * @param arrays The arrays in the stream.
+ * @param store_path The store directory, or empty to skip measuring writes,
+ * e.g., for S3 stores.
+ * @param file_handle_pool The pool to open the scratch file with.
+ * @param n_threads The number of threads in the stream's pool.
+ * @param frame_rate_hz Frames expected per second to each array, or 0 if
+ * unknown. A warning is logged if it exceeds the estimated maximum.
+ * @return The measurements and the suggested thread split.
+ */
+ZarrCalibration
+calibrate(const std::vector<CalibrationArray>& arrays,
+          const std::string& store_path,
+          std::shared_ptr<FileHandlePool> file_handle_pool,
+          uint32_t n_threads,
+          double frame_rate_hz);
+} // namespace zarr
@@ -0,0 +1,339 @@
+#include "checkpoint.hh"
+#include "macros.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr uint32_t checkpoint_magic = 0x4b435a41; // "AZCK"
+
+template<typename T>
+void
+append_value(ByteVector& bytes, const T& value)
+{
+    const auto* ptr = reinterpret_cast<const uint8_t*>(&value);
+    bytes.insert(bytes.end(), ptr, ptr + sizeof(T));
+}
+
+class RecordReader
+{
+  public:
+    RecordReader(const uint8_t* data, size_t size)
+      : data_(data)
+      , size_(size)
+      , pos_(0)
+    {
+    }
+
+    template<typename T>
+    [[nodiscard]] bool read(T& value)
+    {
+        if (size_ - pos_ < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    [[nodiscard]] bool read(std::string& value, size_t n)
+    {
+        if (size_ - pos_ < n) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data_ + pos_), n);
+        pos_ += n;
+        return true;
+    }
+
+    [[nodiscard]] bool read(std::vector<uint64_t>& values, size_t n)
+    {
+        if ((size_ - pos_) / sizeof(uint64_t) < n) {
+            return false;
+        }
+        values.resize(n);
+        memcpy(values.data(), data_ + pos_, n * sizeof(uint64_t));
+        pos_ += n * sizeof(uint64_t);
+        return true;
+    }
+
+    bool done() const { return pos_ == size_; }
+
+  private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+};
+
+struct CheckpointState
+{
+    uint64_t append_size;
+    std::unordered_map<std::string, zarr::ShardCheckpoint> shards;
+};
+
+/**
+ * @brief Replay the manifest, keeping the latest checkpoint of each shard.
+ * @note Stops at the first truncated or corrupt record, e.g., one that was
+ * being appended when the writer died.
+ */
+std::optional<CheckpointState>
+read_manifest(const ByteVector& manifest)
+{
+    std::optional<CheckpointState> state;
+
+    size_t offset = 0;
+    while (offset < manifest.size()) {
+        RecordReader header(manifest.data() + offset, manifest.size() - offset);
+
+        uint32_t magic, body_size;
+        if (!header.read(magic) || !header.read(body_size) ||
+            magic != checkpoint_magic) {
+            break;
+        }
+
+        const size_t record_size =
+          2 * sizeof(uint32_t) + body_size + sizeof(uint32_t);
+        if (manifest.size() - offset < record_size) {
+            break;
+        }
+
+        const auto* record = manifest.data() + offset;
+        uint32_t checksum;
+        memcpy(&checksum, record + record_size - sizeof(uint32_t), 4);
+        if (crc32c::Crc32c(record, record_size - sizeof(uint32_t)) !=
+            checksum) {
+            break;
+        }
+
+        RecordReader body(record + 2 * sizeof(uint32_t), body_size);
+        CheckpointState checkpoint;
+        uint32_t n_shards;
+        if (!body.read(checkpoint.append_size) || !body.read(n_shards)) {
+            break;
+        }
+
+        bool valid = true;
+        for (auto i = 0; i < n_shards && valid; ++i) {
+            zarr::ShardCheckpoint shard;
+            uint32_t path_size, n_entries;
+            valid = body.read(path_size) && body.read(shard.path, path_size) &&
+                    body.read(shard.data_end) && body.read(n_entries) &&
+                    body.read(shard.table, n_entries);
+            if (valid) {
+                checkpoint.shards.insert_or_assign(shard.path,
+                                                   std::move(shard));
+            }
+        }
+
+        if (!valid || !body.done()) {
+            break;
+        }
+
+        if (!state) {
+            state = std::move(checkpoint);
+        } else {
+            state->append_size = checkpoint.append_size;
+            for (auto& [path, shard] : checkpoint.shards) {
+                state->shards.insert_or_assign(path, std::move(shard));
+            }
+        }
+
+        offset += record_size;
+    }
+
+    return state;
+}
+
+bool
+recover_shard(const fs::path& shard_path, const zarr::ShardCheckpoint& shard)
+{
+    std::error_code ec;
+    const auto file_size = fs::file_size(shard_path, ec);
+    if (ec) {
+        LOG_ERROR("Failed to stat shard ", shard_path, ": ", ec.message());
+        return false;
+    }
+
+    if (file_size < shard.data_end) {
+        LOG_ERROR("Shard ",
+                  shard_path,
+                  " is shorter than its checkpoint: ",
+                  file_size,
+                  " < ",
+                  shard.data_end);
+        return false;
+    }
+
+    fs::resize_file(shard_path, shard.data_end, ec);
+    if (ec) {
+        LOG_ERROR("Failed to truncate shard ", shard_path, ": ", ec.message());
+        return false;
+    }
+
+    const auto index = zarr::make_shard_index(shard.table);
+    std::ofstream out(shard_path, std::ios::binary | std::ios::app);
+    out.write(reinterpret_cast<const char*>(index.data()), index.size());
+    if (!out) {
+        LOG_ERROR("Failed to write index to shard ", shard_path);
+        return false;
+    }
+
+    return true;
+}
+
+bool
+update_append_size(const fs::path& metadata_path, uint64_t append_size)
+{
+    if (append_size == zarr::no_append_dimension) {
+        return true;
+    }
+
+    std::ifstream in(metadata_path);
+    auto metadata = nlohmann::json::parse(in, nullptr, false);
+    in.close();
+
+    if (metadata.is_discarded() || !metadata.contains("shape") ||
+        metadata["shape"].empty()) {
+        LOG_ERROR("Failed to read array metadata at ", metadata_path);
+        return false;
+    }
+
+    metadata["shape"][0] = append_size;
+
+    std::ofstream out(metadata_path, std::ios::trunc);
+    out << metadata.dump(4);
+    if (!out) {
+        LOG_ERROR("Failed to write array metadata at ", metadata_path);
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+ByteVector
+zarr::make_shard_index(const std::vector<uint64_t>& table)
+{
+    const size_t table_size = table.size() * sizeof(uint64_t);
+    ByteVector index(table_size + sizeof(uint32_t));
+
+    memcpy(index.data(), table.data(), table_size);
+    const uint32_t checksum = crc32c::Crc32c(index.data(), table_size);
+    memcpy(index.data() + table_size, &checksum, sizeof(uint32_t));
+
+    return index;
+}
+
+ByteVector
+zarr::make_checkpoint_record(uint64_t append_size,
+                             const std::vector<ShardCheckpoint>& shards)
+{
+    ByteVector record;
+    append_value(record, checkpoint_magic);
+    append_value(record, uint32_t{ 0 }); // body size, filled in below
+
+    append_value(record, append_size);
+    append_value(record, static_cast<uint32_t>(shards.size()));
+    for (const auto& shard : shards) {
+        append_value(record, static_cast<uint32_t>(shard.path.size()));
+        record.insert(record.end(), shard.path.begin(), shard.path.end());
+        append_value(record, shard.data_end);
+        append_value(record, static_cast<uint32_t>(shard.table.size()));
+
+        const auto* table = reinterpret_cast<const uint8_t*>(shard.table.data());
+        record.insert(
+          record.end(), table, table + shard.table.size() * sizeof(uint64_t));
+    }
+
+    const auto body_size =
+      static_cast<uint32_t>(record.size() - 2 * sizeof(uint32_t));
+    memcpy(record.data() + sizeof(uint32_t), &body_size, sizeof(uint32_t));
+
+    append_value(record, crc32c::Crc32c(record.data(), record.size()));
+
+    return record;
+}
+
+bool
+zarr::recover_array(std::string_view array_path)
+{
+    if (array_path.starts_with("file://")) {
+        array_path = array_path.substr(7);
+    }
+
+    const fs::path array_root(array_path);
+    const auto manifest_path = array_root / checkpoint_manifest_name;
+    if (!fs::is_regular_file(manifest_path)) {
+        LOG_ERROR("No checkpoint manifest found at ", manifest_path);
+        return false;
+    }
+
+    ByteVector manifest;
+    {
+        std::ifstream in(manifest_path, std::ios::binary);
+        manifest.assign(std::istreambuf_iterator<char>(in),
+                        std::istreambuf_iterator<char>());
+    }
+
+    const auto state = read_manifest(manifest);
+    if (!state) {
+        LOG_ERROR("No valid checkpoint in manifest ", manifest_path);
+        return false;
+    }
+
+    bool success = true;
+    for (const auto& [path, shard] : state->shards) {
+        success = recover_shard(array_root / path, shard) && success;
+    }
+
+    success =
+      update_append_size(array_root / "zarr.json", state->append_size) &&
+      success;
+
+    if (success) {
+        std::error_code ec;
+        fs::remove(manifest_path, ec);
+    }
+
+    return success;
+}
+
+bool
+zarr::recover_store(std::string_view store_path)
+{
+    if (store_path.starts_with("file://")) {
+        store_path = store_path.substr(7);
+    }
+
+    const fs::path store_root(store_path);
+    if (!fs::is_directory(store_root)) {
+        LOG_ERROR("Store path is not a directory: ", store_root);
+        return false;
+    }
+
+    // collect first, recovery removes the manifests as it goes
+    std::vector<fs::path> array_paths;
+    for (const auto& entry : fs::recursive_directory_iterator(store_root)) {
+        if (entry.is_regular_file() &&
+            entry.path().filename() == checkpoint_manifest_name) {
+            array_paths.push_back(entry.path().parent_path());
+        }
+    }
+
+    bool success = true;
+    for (const auto& path : array_paths) {
+        LOG_INFO("Recovering array at ", path);
+        success = recover_array(path.string()) && success;
+    }
+
+    return success;
+}
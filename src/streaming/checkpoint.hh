@@ -0,0 +1,67 @@
+#pragma once
+
+#include "definitions.hh"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace zarr {
+// name of the append-only checkpoint manifest written next to an array's
+// zarr.json while checkpointing is enabled
+inline constexpr char checkpoint_manifest_name[] = "acquire.checkpoint";
+
+// append dimension size recorded for arrays without an append dimension
+inline constexpr uint64_t no_append_dimension =
+  std::numeric_limits<uint64_t>::max();
+
+struct ShardCheckpoint
+{
+    std::string path; // relative to the array node
+    uint64_t data_end;
+    std::vector<uint64_t> table;
+};
+
+/**
+ * @brief Serialize a shard index table, followed by its crc32c checksum.
+ * @param table The (offset, nbytes) pairs of each chunk in the shard.
+ * @return The bytes of the index as they appear at the end of a shard.
+ */
+[[nodiscard]] ByteVector
+make_shard_index(const std::vector<uint64_t>& table);
+
+/**
+ * @brief Serialize a checkpoint record for the checkpoint manifest.
+ * @param append_size The size of the append dimension at the checkpoint, or
+ * no_append_dimension.
+ * @param shards The state of each open shard at the checkpoint.
+ * @return The checksummed record, to be appended to the manifest.
+ */
+[[nodiscard]] ByteVector
+make_checkpoint_record(uint64_t append_size,
+                       const std::vector<ShardCheckpoint>& shards);
+
+/**
+ * @brief Make the shards of an interrupted array readable from its checkpoint
+ * manifest.
+ * @details Each shard named in the manifest is truncated to the end of the
+ * data covered by its latest checkpoint and the checkpointed index is appended.
+ * The append dimension in zarr.json is set to the checkpointed size and the
+ * manifest is removed. Data written after the last checkpoint is discarded.
+ * @param array_path Filesystem path to the array node.
+ * @return True if and only if every shard in the manifest was recovered.
+ */
+[[nodiscard]] bool
+recover_array(std::string_view array_path);
+
+/**
+ * @brief Recover every array under @p store_path that has a checkpoint
+ * manifest.
+ * @param store_path Filesystem path to the root of the store.
+ * @return True if and only if every checkpointed array was recovered.
+ */
+[[nodiscard]] bool
+recover_store(std::string_view store_path);
+} // namespace zarr
@@ -0,0 +1,296 @@
+#include "cooperative.store.hh"
+#include "macros.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+// how often the coordinator looks for the other writers' manifests
+constexpr auto poll_interval = std::chrono::milliseconds(50);
+
+const std::string manifest_extension = ".json";
+
+bool
+is_valid_writer_id(const std::string& id)
+{
+    return !id.empty() && id != "." && id != ".." &&
+           id.find_first_of("/\\") == std::string::npos;
+}
+
+// append the elements of `from` whose `key` isn't in `into` yet
+void
+union_by(nlohmann::json& into, const nlohmann::json& from, const char* key)
+{
+    for (const auto& element : from) {
+        const auto it = std::ranges::find_if(
+          into, [&](const auto& e) { return e[key] == element[key]; });
+        if (it == into.end()) {
+            into.push_back(element);
+        }
+    }
+}
+
+bool
+merge_plate(const std::string& path,
+            nlohmann::json& into,
+            const nlohmann::json& from,
+            std::string& error)
+{
+    if (into["rows"] != from["rows"] || into["columns"] != from["columns"]) {
+        error = "Plate '" + path + "' has different rows or columns in "
+                "different writers";
+        return false;
+    }
+
+    union_by(into["wells"], from["wells"], "path");
+    into["field_count"] =
+      std::max(into["field_count"].get<uint32_t>(),
+               from["field_count"].get<uint32_t>());
+
+    if (!from.contains("acquisitions")) {
+        return true;
+    }
+    if (!into.contains("acquisitions")) {
+        into["acquisitions"] = from["acquisitions"];
+        return true;
+    }
+
+    auto& acquisitions = into["acquisitions"];
+    for (const auto& acquisition : from["acquisitions"]) {
+        const auto it = std::ranges::find_if(acquisitions, [&](const auto& a) {
+            return a["id"] == acquisition["id"];
+        });
+        if (it == acquisitions.end()) {
+            acquisitions.push_back(acquisition);
+        } else {
+            (*it)["maximumfieldcount"] =
+              std::max((*it)["maximumfieldcount"].get<uint32_t>(),
+                       acquisition["maximumfieldcount"].get<uint32_t>());
+        }
+    }
+
+    return true;
+}
+
+bool
+merge_group(const std::string& path,
+            nlohmann::json& into,
+            const nlohmann::json& from,
+            std::string& error)
+{
+    const auto& into_ome = into["attributes"].value("ome", nlohmann::json());
+    const auto& from_ome = from["attributes"].value("ome", nlohmann::json());
+
+    const bool into_plate = into_ome.contains("plate");
+    const bool into_well = into_ome.contains("well");
+    if (into_plate != from_ome.contains("plate") ||
+        into_well != from_ome.contains("well")) {
+        error = "Group '" + path + "' has a different type in different "
+                "writers";
+        return false;
+    }
+
+    if (into_plate) {
+        return merge_plate(path,
+                           into["attributes"]["ome"]["plate"],
+                           from_ome["plate"],
+                           error);
+    }
+    if (into_well) {
+        union_by(into["attributes"]["ome"]["well"]["images"],
+                 from_ome["well"]["images"],
+                 "path");
+        return true;
+    }
+
+    if (into != from) {
+        error = "Group '" + path + "' has different metadata in different "
+                "writers";
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<fs::path>
+list_manifests(const fs::path& directory, const std::string& own_id)
+{
+    std::vector<fs::path> manifests;
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        const auto& path = entry.path();
+        if (path.extension() == manifest_extension &&
+            path.stem() != own_id) {
+            manifests.push_back(path);
+        }
+    }
+    std::ranges::sort(manifests);
+
+    return manifests;
+}
+} // namespace
+
+zarr::CooperativeStore::CooperativeStore(
+  const std::string& store_path,
+  const ZarrCooperativeSettings& settings)
+  : root_(fs::path(store_path) / ".writers")
+  , writer_count_(settings.writer_count)
+  , is_coordinator_(settings.coordinator)
+  , timeout_(settings.timeout_ms)
+{
+    EXPECT(settings.writer_id != nullptr, "Null pointer: writer_id");
+    writer_id_ = settings.writer_id;
+    EXPECT(is_valid_writer_id(writer_id_), "Invalid writer id: ", writer_id_);
+    EXPECT(writer_count_ > 0, "Writer count must be positive");
+
+    std::error_code ec;
+    fs::create_directories(root_ / "claims", ec);
+    EXPECT(!ec, "Failed to create ", root_ / "claims", ": ", ec.message());
+    fs::create_directories(root_ / "manifests", ec);
+    EXPECT(!ec, "Failed to create ", root_ / "manifests", ": ", ec.message());
+}
+
+bool
+zarr::CooperativeStore::is_coordinator() const noexcept
+{
+    return is_coordinator_;
+}
+
+bool
+zarr::CooperativeStore::claim(const std::string& key, std::string& error)
+{
+    const auto directory = root_ / "claims" / key;
+    const auto path = directory / ".claim";
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        error = "Failed to create " + directory.string() + ": " + ec.message();
+        return false;
+    }
+
+    // exclusive creation is atomic, even over NFS
+    if (FILE* file = std::fopen(path.string().c_str(), "wx")) {
+        const bool written =
+          std::fwrite(writer_id_.data(), 1, writer_id_.size(), file) ==
+          writer_id_.size();
+        if (std::fclose(file) == 0 && written) {
+            return true;
+        }
+        error = "Failed to write " + path.string();
+        return false;
+    }
+
+    std::ifstream claim(path);
+    std::string owner;
+    std::getline(claim, owner);
+    if (owner == writer_id_) {
+        return true;
+    }
+
+    error = "Array '" + key + "' is claimed by writer '" + owner + "'";
+    return false;
+}
+
+bool
+zarr::CooperativeStore::publish(const GroupMetadata& groups,
+                                const ArrayMetadata& arrays,
+                                std::string& error)
+{
+    const nlohmann::json manifest = {
+        { "writer", writer_id_ },
+        { "groups", groups },
+        { "arrays", arrays },
+    };
+
+    // write under a temporary name so the coordinator never reads a partial
+    // manifest
+    const auto path = root_ / "manifests" / (writer_id_ + manifest_extension);
+    const auto tmp_path = fs::path(path.string() + ".tmp");
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        file << manifest.dump();
+        if (!file.good()) {
+            error = "Failed to write " + tmp_path.string();
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        error = "Failed to publish " + path.string() + ": " + ec.message();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+zarr::CooperativeStore::merge(GroupMetadata& groups,
+                              ArrayMetadata& arrays,
+                              std::string& error)
+{
+    const auto directory = root_ / "manifests";
+    const size_t n_expected = writer_count_ - 1;
+    const auto deadline = std::chrono::steady_clock::now() + timeout_;
+
+    auto manifests = list_manifests(directory, writer_id_);
+    while (manifests.size() < n_expected) {
+        if (timeout_.count() > 0 &&
+            std::chrono::steady_clock::now() >= deadline) {
+            LOG_WARNING("Timed out waiting for writers to finish: ",
+                        manifests.size(),
+                        " of ",
+                        n_expected,
+                        " published their metadata");
+            break;
+        }
+        std::this_thread::sleep_for(poll_interval);
+        manifests = list_manifests(directory, writer_id_);
+    }
+
+    for (const auto& path : manifests) {
+        std::ifstream file(path);
+        const auto manifest = nlohmann::json::parse(file, nullptr, false);
+        if (manifest.is_discarded()) {
+            error = "Failed to read manifest " + path.string();
+            return false;
+        }
+
+        for (const auto& [key, metadata] : manifest["arrays"].items()) {
+            if (arrays.contains(key)) {
+                error = "Array '" + key + "' was written by more than one "
+                        "writer";
+                return false;
+            }
+            arrays.emplace(key, metadata.get<std::string>());
+        }
+
+        for (const auto& [key, metadata] : manifest["groups"].items()) {
+            if (auto it = groups.find(key); it == groups.end()) {
+                groups.emplace(key, metadata);
+            } else if (!merge_group(key, it->second, metadata, error)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void
+zarr::CooperativeStore::clean_up()
+{
+    std::error_code ec;
+    fs::remove_all(root_, ec);
+    if (ec) {
+        LOG_WARNING("Failed to remove ", root_, ": ", ec.message());
+    }
+}
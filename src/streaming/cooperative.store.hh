@@ -0,0 +1,91 @@
+#pragma once
+
+#include "zarr.types.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace zarr {
+/**
+ * @brief Coordinates several writers, possibly in different processes or on
+ * different hosts sharing a filesystem, streaming disjoint arrays into one
+ * store.
+ * @details Coordination goes through a ".writers" directory in the store.
+ * Each writer claims the array nodes it writes by creating a lock file for
+ * each, exclusively, under ".writers/claims". On close, every writer but the
+ * coordinator publishes the metadata of its groups and arrays to a manifest
+ * under ".writers/manifests". The coordinator waits for the others'
+ * manifests, merges them with its own metadata, writes the hierarchy, and
+ * removes the ".writers" directory.
+ */
+class CooperativeStore
+{
+  public:
+    using GroupMetadata = std::unordered_map<std::string, nlohmann::json>;
+    using ArrayMetadata = std::unordered_map<std::string, std::string>;
+
+    /**
+     * @brief Join the writers of a store.
+     * @param store_path The store directory.
+     * @param settings This writer's settings.
+     * @throws std::runtime_error if the settings are invalid or the
+     * coordination directory can't be created.
+     */
+    CooperativeStore(const std::string& store_path,
+                     const ZarrCooperativeSettings& settings);
+
+    /** @brief Whether this writer merges the hierarchy metadata on close. */
+    bool is_coordinator() const noexcept;
+
+    /**
+     * @brief Claim an array node for this writer.
+     * @param key The path of the array node relative to the store root.
+     * @param[out] error Set if the node is claimed by another writer.
+     * @return True if this writer now holds the node, false otherwise.
+     */
+    [[nodiscard]] bool claim(const std::string& key, std::string& error);
+
+    /**
+     * @brief Publish this writer's group and array metadata for the
+     * coordinator.
+     * @param groups Group metadata keyed by path relative to the store root.
+     * @param arrays Array metadata keyed by path relative to the store root.
+     * @param[out] error Set if the manifest can't be written.
+     * @return True if the manifest was published, false otherwise.
+     */
+    [[nodiscard]] bool publish(const GroupMetadata& groups,
+                               const ArrayMetadata& arrays,
+                               std::string& error);
+
+    /**
+     * @brief Wait for the other writers' manifests and merge them into the
+     * coordinator's metadata.
+     * @details Generic groups must agree. Plates are merged if their rows and
+     * columns agree, taking the union of their wells and acquisitions; wells
+     * take the union of their fields of view. If the other writers don't all
+     * publish within the timeout, the manifests found so far are merged and
+     * a warning is logged.
+     * @param[in, out] groups Group metadata keyed by path.
+     * @param[in, out] arrays Array metadata keyed by path.
+     * @param[out] error Set if a manifest can't be read or merged.
+     * @return True if the manifests were merged, false otherwise.
+     */
+    [[nodiscard]] bool merge(GroupMetadata& groups,
+                             ArrayMetadata& arrays,
+                             std::string& error);
+
+    /** @brief Remove the coordination directory. Coordinator only. */
+    void clean_up();
+
+  private:
+    std::filesystem::path root_;
+    std::string writer_id_;
+    uint32_t writer_count_;
+    bool is_coordinator_;
+    std::chrono::milliseconds timeout_;
+};
+} // namespace zarr
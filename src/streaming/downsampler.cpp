@@ -586,6 +586,14 @@ zarr::Downsampler::make_writer_configurations_(
           prev_config->dtype,
           prev_config->downsampling_method,
           prev_config->level_of_detail + 1);
+        down_config->metadata_update_interval =
+          prev_config->metadata_update_interval;
+        down_config->checkpoint_interval = prev_config->checkpoint_interval;
+        down_config->significant_bits = prev_config->significant_bits;
+        down_config->enable_preview = prev_config->enable_preview;
+        down_config->chunk_checksums = prev_config->chunk_checksums;
+        down_config->chunk_order = prev_config->chunk_order;
+        down_config->shard_verifier = prev_config->shard_verifier;
 
         writer_configurations_.emplace(down_config->level_of_detail,
                                        down_config);
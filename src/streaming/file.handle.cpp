@@ -62,3 +62,16 @@ zarr::FileHandlePool::return_handle(std::unique_ptr<FileHandle>&& handle)
     // handle will be destroyed when going out of scope
     flush_file(handle->get());
 }
+
+void
+zarr::FileHandlePool::set_bandwidth_limiter(
+  std::shared_ptr<BandwidthLimiter> limiter)
+{
+    bandwidth_limiter_ = std::move(limiter);
+}
+
+zarr::BandwidthLimiter*
+zarr::FileHandlePool::bandwidth_limiter() const noexcept
+{
+    return bandwidth_limiter_.get();
+}
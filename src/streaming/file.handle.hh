@@ -1,5 +1,7 @@
 #pragma once
 
+#include "bandwidth.limiter.hh"
+
 #include <condition_variable>
 #include <memory> // for std::unique_ptr
 #include <mutex>
@@ -65,10 +67,22 @@ class FileHandlePool
      */
     void return_handle(std::unique_ptr<FileHandle>&& handle);
 
+    /**
+     * @brief Limit the bandwidth of writes made through this pool.
+     * @note Set before any writes are made.
+     * @param limiter The limiter, or nullptr for no limit.
+     */
+    void set_bandwidth_limiter(std::shared_ptr<BandwidthLimiter> limiter);
+
+    /** @brief Get the bandwidth limiter, or nullptr if there is none. */
+    BandwidthLimiter* bandwidth_limiter() const noexcept;
+
   private:
     const uint64_t max_active_handles_;
     std::atomic<uint64_t> n_active_handles_;
     std::mutex mutex_;
     std::condition_variable cv_;
+
+    std::shared_ptr<BandwidthLimiter> bandwidth_limiter_;
 };
 } // namespace zarr
\ No newline at end of file
@@ -37,6 +37,11 @@ zarr::FileSink::write(size_t offset, ConstByteSpan data)
         return true;
     }
 
+    // wait for bandwidth before taking a handle others could be using
+    if (auto* limiter = file_handle_pool_->bandwidth_limiter()) {
+        limiter->acquire(data.size());
+    }
+
     auto handle = file_handle_pool_->get_handle(filename_, flags_);
     if (handle == nullptr) {
         LOG_ERROR("Failed to get file handle for ", filename_);
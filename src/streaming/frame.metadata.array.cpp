@@ -0,0 +1,416 @@
+#include "frame.metadata.array.hh"
+#include "checkpoint.hh"
+#include "macros.hh"
+#include "sink.hh"
+#include "zarr.common.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using json = nlohmann::json;
+
+namespace {
+std::string
+node_path(const zarr::FrameMetadataConfig& config)
+{
+    return config.store_root + "/" + config.node_key;
+}
+
+size_t
+bytes_of_record(const zarr::FrameMetadataConfig& config)
+{
+    return zarr::bytes_of_type(config.dtype) * config.field_count;
+}
+
+std::unique_ptr<zarr::Sink>
+make_sink(const zarr::FrameMetadataConfig& config,
+          const std::string& path,
+          std::shared_ptr<zarr::FileHandlePool> file_handle_pool,
+          std::shared_ptr<zarr::S3ConnectionPool> s3_connection_pool)
+{
+    return config.bucket_name
+             ? zarr::make_s3_sink(*config.bucket_name, path, s3_connection_pool)
+             : zarr::make_file_sink(path, file_handle_pool);
+}
+
+bool
+write_object(const zarr::FrameMetadataConfig& config,
+             const std::string& path,
+             ConstByteSpan data,
+             std::shared_ptr<zarr::FileHandlePool> file_handle_pool,
+             std::shared_ptr<zarr::S3ConnectionPool> s3_connection_pool,
+             std::string& error)
+{
+    try {
+        auto sink =
+          make_sink(config, path, file_handle_pool, s3_connection_pool);
+        if (sink && sink->write(0, data) &&
+            zarr::finalize_sink(std::move(sink))) {
+            return true;
+        }
+    } catch (const std::exception& exc) {
+        error = "Failed to write " + path + ": " + exc.what();
+        return false;
+    }
+
+    error = "Failed to write " + path;
+    return false;
+}
+} // namespace
+
+zarr::FrameMetadataArray::FrameMetadataArray(
+  FrameMetadataConfig config,
+  std::shared_ptr<ThreadPool> thread_pool,
+  std::shared_ptr<FileHandlePool> file_handle_pool,
+  std::shared_ptr<S3ConnectionPool> s3_connection_pool)
+  : state_(std::make_shared<State>())
+  , thread_pool_(std::move(thread_pool))
+  , records_in_shard_(0)
+  , shard_index_(0)
+  , record_count_(0)
+{
+    CHECK(thread_pool_);
+    EXPECT(s3_connection_pool != nullptr || file_handle_pool != nullptr,
+           "Either S3 connection pool or file handle pool must be provided.");
+    EXPECT(!config.node_key.empty(), "Frame metadata key must not be empty");
+    EXPECT(config.field_count > 0, "Field count must be positive");
+    EXPECT(config.records_per_chunk > 0, "Records per chunk must be positive");
+    EXPECT(config.chunks_per_shard > 0, "Chunks per shard must be positive");
+    EXPECT(config.field_names.empty() ||
+             config.field_names.size() == config.field_count,
+           "Expected ",
+           config.field_count,
+           " field names, got ",
+           config.field_names.size());
+
+    state_->config = std::move(config);
+    state_->file_handle_pool = std::move(file_handle_pool);
+    state_->s3_connection_pool = std::move(s3_connection_pool);
+
+    shard_buffer_.resize(records_per_shard_() * bytes_per_record(), 0);
+
+    // readers see an empty array until the first shard is written
+    std::string error;
+    EXPECT(write_metadata_(*state_, 0, error), error);
+}
+
+const std::string&
+zarr::FrameMetadataArray::node_key() const noexcept
+{
+    return state_->config.node_key;
+}
+
+size_t
+zarr::FrameMetadataArray::bytes_per_record() const noexcept
+{
+    return bytes_of_record(state_->config);
+}
+
+uint64_t
+zarr::FrameMetadataArray::record_count() const
+{
+    std::unique_lock lock(mutex_);
+    return record_count_;
+}
+
+size_t
+zarr::FrameMetadataArray::memory_usage() const noexcept
+{
+    std::unique_lock lock(mutex_);
+    return shard_buffer_.size();
+}
+
+bool
+zarr::FrameMetadataArray::append(ConstByteSpan records, std::string& error)
+{
+    const auto bytes_of_record = bytes_per_record();
+    if (records.size() % bytes_of_record != 0) {
+        error = "Expected a whole number of " +
+                std::to_string(bytes_of_record) + "-byte records, got " +
+                std::to_string(records.size()) + " bytes";
+        return false;
+    }
+
+    std::unique_lock lock(mutex_);
+    if (!check_jobs_(error)) {
+        return false;
+    }
+
+    const auto records_per_shard = records_per_shard_();
+    size_t offset = 0;
+    while (offset < records.size()) {
+        const auto n_records =
+          std::min<uint64_t>(records_per_shard - records_in_shard_,
+                             (records.size() - offset) / bytes_of_record);
+        const auto n_bytes = n_records * bytes_of_record;
+
+        memcpy(shard_buffer_.data() + records_in_shard_ * bytes_of_record,
+               records.data() + offset,
+               n_bytes);
+        offset += n_bytes;
+        records_in_shard_ += n_records;
+        record_count_ += n_records;
+
+        if (records_in_shard_ == records_per_shard && !flush_shard_(error)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+zarr::FrameMetadataArray::close(std::string& metadata, std::string& error)
+{
+    std::unique_lock lock(mutex_);
+    if (!check_jobs_(error)) {
+        return false;
+    }
+
+    if (records_in_shard_ > 0 &&
+        !write_shard_(
+          *state_, shard_buffer_, records_in_shard_, shard_index_, error)) {
+        return false;
+    }
+
+    if (!write_metadata_(*state_, record_count_, error)) {
+        return false;
+    }
+
+    metadata = make_metadata_(state_->config, record_count_);
+    return true;
+}
+
+uint64_t
+zarr::FrameMetadataArray::records_per_shard_() const noexcept
+{
+    const auto& config = state_->config;
+    return uint64_t{ config.records_per_chunk } * config.chunks_per_shard;
+}
+
+bool
+zarr::FrameMetadataArray::flush_shard_(std::string& error)
+{
+    auto records = std::make_shared<ByteVector>(std::move(shard_buffer_));
+    const auto n_records = records_in_shard_;
+    const auto shard_index = shard_index_;
+    const auto records_end = record_count_;
+
+    shard_buffer_.assign(records->size(), 0);
+    records_in_shard_ = 0;
+    ++shard_index_;
+
+    auto job = [state = state_, records, n_records, shard_index, records_end](
+                 std::string& err) {
+        if (write_shard_(*state, *records, n_records, shard_index, err) &&
+            write_metadata_(*state, records_end, err)) {
+            return true;
+        }
+
+        // otherwise only the pool's error handler would hear of it, and the
+        // array would close with a hole in it
+        std::unique_lock lock(state->job_error_mutex);
+        if (!state->job_failed) {
+            state->job_error = err;
+            state->job_failed = true;
+        }
+        return false;
+    };
+
+    // the pool no longer takes jobs once the stream is closing
+    if (thread_pool_->push_job(job)) {
+        return true;
+    }
+    return job(error);
+}
+
+bool
+zarr::FrameMetadataArray::check_jobs_(std::string& error) const
+{
+    if (!state_->job_failed) {
+        return true;
+    }
+
+    std::unique_lock lock(state_->job_error_mutex);
+    error = "Failed to write a full shard of frame metadata: " +
+            state_->job_error;
+    return false;
+}
+
+std::string
+zarr::FrameMetadataArray::make_metadata_(const FrameMetadataConfig& config,
+                                         uint64_t n_records)
+{
+    const uint64_t records_per_shard =
+      uint64_t{ config.records_per_chunk } * config.chunks_per_shard;
+
+    auto shape = json::array({ n_records });
+    auto chunk_shape = json::array({ config.records_per_chunk });
+    auto shard_shape = json::array({ records_per_shard });
+    auto dimension_names = json::array({ "frame" });
+    if (config.field_count > 1) {
+        shape.push_back(config.field_count);
+        chunk_shape.push_back(config.field_count);
+        shard_shape.push_back(config.field_count);
+        dimension_names.push_back("field");
+    }
+
+    json metadata;
+    metadata["shape"] = shape;
+    metadata["chunk_grid"] = json::object({
+      { "name", "regular" },
+      {
+        "configuration",
+        json::object({ { "chunk_shape", shard_shape } }),
+      },
+    });
+    metadata["chunk_key_encoding"] = json::object({
+      { "name", "default" },
+      {
+        "configuration",
+        json::object({ { "separator", "/" } }),
+      },
+    });
+    metadata["fill_value"] = 0;
+    metadata["attributes"] = json::object();
+    if (!config.field_names.empty()) {
+        metadata["attributes"]["fields"] = config.field_names;
+    }
+    metadata["zarr_format"] = 3;
+    metadata["node_type"] = "array";
+    metadata["storage_transformers"] = json::array();
+    metadata["data_type"] = sample_type_to_dtype(config.dtype);
+    metadata["dimension_names"] = dimension_names;
+
+    auto codecs = json::array({
+      json::object({
+        { "name", "bytes" },
+        { "configuration", json::object({ { "endian", "little" } }) },
+      }),
+    });
+    if (config.compression_params) {
+        const auto& params = *config.compression_params;
+        codecs.push_back(json::object({
+          { "name", "blosc" },
+          {
+            "configuration",
+            json::object({
+              { "blocksize", 0 },
+              { "clevel", params.clevel },
+              { "cname", params.codec_id },
+              { "shuffle", shuffle_to_string(params.shuffle) },
+              { "typesize", bytes_of_type(config.dtype) },
+            }),
+          },
+        }));
+    }
+
+    metadata["codecs"] = json::array({
+      json::object({
+        { "name", "sharding_indexed" },
+        {
+          "configuration",
+          json::object({
+            { "chunk_shape", chunk_shape },
+            { "codecs", codecs },
+            { "index_codecs",
+              json::array({
+                json::object({
+                  { "name", "bytes" },
+                  { "configuration", json::object({ { "endian", "little" } }) },
+                }),
+                json::object({ { "name", "crc32c" } }),
+              }) },
+            { "index_location", "end" },
+          }),
+        },
+      }),
+    });
+
+    return metadata.dump(4);
+}
+
+bool
+zarr::FrameMetadataArray::write_metadata_(State& state,
+                                          uint64_t n_records,
+                                          std::string& error)
+{
+    std::unique_lock lock(state.metadata_mutex);
+
+    // shards may finish out of order; never shrink the array
+    if (n_records < state.records_in_metadata) {
+        return true;
+    }
+
+    const auto metadata = make_metadata_(state.config, n_records);
+    const ConstByteSpan data(reinterpret_cast<const uint8_t*>(metadata.data()),
+                             metadata.size());
+    if (!write_object(state.config,
+                      node_path(state.config) + "/zarr.json",
+                      data,
+                      state.file_handle_pool,
+                      state.s3_connection_pool,
+                      error)) {
+        return false;
+    }
+
+    state.records_in_metadata = n_records;
+    return true;
+}
+
+bool
+zarr::FrameMetadataArray::write_shard_(State& state,
+                                       const ByteVector& records,
+                                       uint64_t n_records,
+                                       uint32_t shard_index,
+                                       std::string& error)
+{
+    const auto& config = state.config;
+    const size_t bytes_per_chunk =
+      size_t{ config.records_per_chunk } * bytes_of_record(config);
+    const auto n_chunks =
+      (n_records + config.records_per_chunk - 1) / config.records_per_chunk;
+
+    // chunks past the last record are left out of the shard
+    std::vector<uint64_t> table(2 * config.chunks_per_shard,
+                                std::numeric_limits<uint64_t>::max());
+
+    ByteVector shard;
+    for (auto i = 0; i < n_chunks; ++i) {
+        const auto begin = records.begin() + i * bytes_per_chunk;
+        ByteVector chunk(begin, begin + bytes_per_chunk);
+
+        if (config.compression_params &&
+            !compress_in_place(chunk,
+                               *config.compression_params,
+                               bytes_of_type(config.dtype))) {
+            error = "Failed to compress frame metadata chunk " +
+                    std::to_string(i) + " of shard " +
+                    std::to_string(shard_index);
+            return false;
+        }
+
+        table[2 * i] = shard.size();
+        table[2 * i + 1] = chunk.size();
+        shard.insert(shard.end(), chunk.begin(), chunk.end());
+    }
+
+    const auto index = make_shard_index(table);
+    shard.insert(shard.end(), index.begin(), index.end());
+
+    std::string path =
+      node_path(config) + "/c/" + std::to_string(shard_index);
+    if (config.field_count > 1) {
+        path += "/0";
+    }
+
+    return write_object(config,
+                        path,
+                        shard,
+                        state.file_handle_pool,
+                        state.s3_connection_pool,
+                        error);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "blosc.compression.params.hh"
+#include "definitions.hh"
+#include "file.handle.hh"
+#include "s3.connection.hh"
+#include "thread.pool.hh"
+#include "zarr.types.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace zarr {
+struct FrameMetadataConfig
+{
+    std::string store_root;
+    std::string node_key;
+    std::optional<std::string> bucket_name;
+    std::optional<BloscCompressionParams> compression_params;
+
+    ZarrDataType dtype{ ZarrDataType_float64 };
+    uint32_t field_count{ 1 };
+    uint32_t records_per_chunk{ 0 };
+    uint32_t chunks_per_shard{ 0 };
+
+    // one name per field, or empty for unnamed fields
+    std::vector<std::string> field_names;
+};
+
+/**
+ * @brief A compact array of fixed-size per-frame records, e.g., timestamps
+ * and stage positions, written next to the array whose frames they describe.
+ * @details The array is 1D if a record has one field and 2D, records by
+ * fields, otherwise. Records are buffered a shard at a time. Full shards are
+ * encoded and written on the thread pool, and the last, partial shard is
+ * written on close.
+ */
+class FrameMetadataArray
+{
+  public:
+    FrameMetadataArray(FrameMetadataConfig config,
+                       std::shared_ptr<ThreadPool> thread_pool,
+                       std::shared_ptr<FileHandlePool> file_handle_pool,
+                       std::shared_ptr<S3ConnectionPool> s3_connection_pool);
+
+    /** @brief Get the key of the array, relative to the store root. */
+    const std::string& node_key() const noexcept;
+
+    /** @brief Get the size of a single record, in bytes. */
+    size_t bytes_per_record() const noexcept;
+
+    /** @brief Get the number of records appended so far. */
+    uint64_t record_count() const;
+
+    /** @brief Get the memory held by buffered records, in bytes. */
+    size_t memory_usage() const noexcept;
+
+    /**
+     * @brief Append whole records.
+     * @param records The records, back to back.
+     * @param error Set to a diagnostic message on failure.
+     * @return False if @p records isn't a whole number of records, or if a
+     * full shard, of these records or earlier ones, could not be written,
+     * true otherwise.
+     */
+    [[nodiscard]] bool append(ConstByteSpan records, std::string& error);
+
+    /**
+     * @brief Write the records still buffered and the final metadata.
+     * @param metadata Set to the array's zarr.json contents on success.
+     * @param error Set to a diagnostic message on failure.
+     * @return True if and only if everything was written.
+     */
+    [[nodiscard]] bool close(std::string& metadata, std::string& error);
+
+  private:
+    // shared with the jobs that write full shards, which may outlive us if
+    // the stream is torn down early
+    struct State
+    {
+        FrameMetadataConfig config;
+        std::shared_ptr<FileHandlePool> file_handle_pool;
+        std::shared_ptr<S3ConnectionPool> s3_connection_pool;
+
+        std::mutex metadata_mutex;
+        uint64_t records_in_metadata{ 0 };
+
+        // the first failure of a full-shard job, reported by the next
+        // append() or close()
+        std::atomic<bool> job_failed{ false };
+        std::mutex job_error_mutex;
+        std::string job_error;
+    };
+
+    std::shared_ptr<State> state_;
+    std::shared_ptr<ThreadPool> thread_pool_;
+
+    mutable std::mutex mutex_;
+    ByteVector shard_buffer_;
+    uint64_t records_in_shard_;
+    uint32_t shard_index_;
+    uint64_t record_count_;
+
+    uint64_t records_per_shard_() const noexcept;
+    [[nodiscard]] bool flush_shard_(std::string& error);
+    [[nodiscard]] bool check_jobs_(std::string& error) const;
+
+    static std::string make_metadata_(const FrameMetadataConfig& config,
+                                      uint64_t n_records);
+    [[nodiscard]] static bool write_metadata_(State& state,
+                                              uint64_t n_records,
+                                              std::string& error);
+    [[nodiscard]] static bool write_shard_(State& state,
+                                           const ByteVector& records,
+                                           uint64_t n_records,
+                                           uint32_t shard_index,
+                                           std::string& error);
+};
+} // namespace zarr
@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <stdexcept>
+#include <thread>
 
 zarr::FrameQueue::FrameQueue(size_t num_frames, size_t avg_frame_size)
   : buffer_(num_frames + 1)   // one extra slot to distinguish full/empty
@@ -19,27 +20,44 @@ zarr::FrameQueue::FrameQueue(size_t num_frames, size_t avg_frame_size)
 }
 
 bool
-zarr::FrameQueue::push(LockedBuffer& frame, const std::string& key)
+zarr::FrameQueue::push(LockedBuffer& frame,
+                       const std::string& key,
+                       std::optional<uint64_t> frame_id)
 {
-    std::unique_lock lock(mutex_);
+    // producers claim a slot without locking, so they don't contend with each
+    // other or with the consumer; the slot is published once it is filled
     size_t write_pos = write_pos_.load(std::memory_order_relaxed);
+    size_t next_pos;
+    do {
+        next_pos = (write_pos + 1) % capacity_;
+        if (next_pos == read_pos_.load(std::memory_order_acquire)) {
+            return false; // Queue is full
+        }
+    } while (!write_pos_.compare_exchange_weak(write_pos,
+                                               next_pos,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_relaxed));
 
-    size_t next_pos = (write_pos + 1) % capacity_;
-    if (next_pos == read_pos_.load(std::memory_order_acquire)) {
-        return false; // Queue is full
-    }
-
-    buffer_[write_pos].key = key;
-    buffer_[write_pos].data.swap(frame);
-    buffer_[write_pos].ready.store(true, std::memory_order_release);
-
-    write_pos_.store(next_pos, std::memory_order_release);
+    auto& slot = buffer_[write_pos];
+    slot.key = key;
+    slot.frame_id = frame_id;
+    slot.data.swap(frame);
+    slot.ready.store(true, std::memory_order_release);
 
     return true;
 }
 
 bool
 zarr::FrameQueue::pop(LockedBuffer& frame, std::string& key)
+{
+    std::optional<uint64_t> frame_id;
+    return pop(frame, key, frame_id);
+}
+
+bool
+zarr::FrameQueue::pop(LockedBuffer& frame,
+                      std::string& key,
+                      std::optional<uint64_t>& frame_id)
 {
     std::unique_lock lock(mutex_);
     size_t read_pos = read_pos_.load(std::memory_order_relaxed);
@@ -53,6 +71,7 @@ zarr::FrameQueue::pop(LockedBuffer& frame, std::string& key)
     }
 
     key = buffer_[read_pos].key;
+    frame_id = buffer_[read_pos].frame_id;
     frame.swap(buffer_[read_pos].data);
     buffer_[read_pos].ready.store(false, std::memory_order_release);
 
@@ -105,6 +124,12 @@ zarr::FrameQueue::full() const
     return (next_write == read);
 }
 
+size_t
+zarr::FrameQueue::max_size() const
+{
+    return capacity_ - 1; // one slot is always empty
+}
+
 bool
 zarr::FrameQueue::empty() const
 {
@@ -116,10 +141,33 @@ zarr::FrameQueue::empty() const
     return (read == write);
 }
 
+bool
+zarr::FrameQueue::front_ready() const
+{
+    const size_t read = read_pos_.load(std::memory_order_acquire);
+    const size_t write = write_pos_.load(std::memory_order_acquire);
+
+    return read != write && buffer_[read].ready.load(std::memory_order_acquire);
+}
+
 void
 zarr::FrameQueue::clear()
 {
     std::unique_lock lock(mutex_);
-    read_pos_.store(write_pos_.load(std::memory_order_acquire),
-                    std::memory_order_release);
+
+    const size_t write_pos = write_pos_.load(std::memory_order_acquire);
+    size_t read_pos = read_pos_.load(std::memory_order_relaxed);
+    while (read_pos != write_pos) {
+        // a claimed slot is filled without blocking, so this wait is short
+        auto& slot = buffer_[read_pos];
+        while (!slot.ready.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        slot.data.clear();
+        slot.ready.store(false, std::memory_order_release);
+
+        read_pos = (read_pos + 1) % capacity_;
+        read_pos_.store(read_pos, std::memory_order_release);
+    }
 }
\ No newline at end of file
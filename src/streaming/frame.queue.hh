@@ -7,6 +7,7 @@
 #include <condition_variable>
 #include <cstddef>
 #include <mutex>
+#include <optional>
 #include <queue>
 
 namespace zarr {
@@ -16,13 +17,28 @@ class FrameQueue
     explicit FrameQueue(size_t num_frames, size_t avg_frame_size);
     ~FrameQueue() = default;
 
-    bool push(LockedBuffer& frame, const std::string& key);
+    bool push(LockedBuffer& frame,
+              const std::string& key,
+              std::optional<uint64_t> frame_id = std::nullopt);
     bool pop(LockedBuffer& frame, std::string& key);
+    bool pop(LockedBuffer& frame,
+             std::string& key,
+             std::optional<uint64_t>& frame_id);
 
     size_t size() const;
+    size_t max_size() const;
     size_t bytes_used() const;
     bool full() const;
     bool empty() const;
+
+    /** @brief True if the next frame has been filled in and can be popped. */
+    bool front_ready() const;
+
+    /**
+     * @brief Drop every queued frame.
+     * @details Waits for producers still filling their slots, so that no
+     * stale frame can be popped once the slots are reused.
+     */
     void clear();
 
   private:
@@ -30,6 +46,7 @@ class FrameQueue
     {
         std::string key;
         LockedBuffer data;
+        std::optional<uint64_t> frame_id; // set for indexed appends
         std::atomic<bool> ready{ false };
     };
 
@@ -40,6 +57,6 @@ class FrameQueue
     std::atomic<size_t> write_pos_{ 0 };
     std::atomic<size_t> read_pos_{ 0 };
 
-    std::mutex mutex_;
+    std::mutex mutex_; // serializes pop() and clear(); push() is lock-free
 };
 } // namespace zarr
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "geometry.advisor.hh"
+#include "array.dimensions.hh"
+#include "macros.hh"
+#include "zarr.common.hh"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+// raw chunk size to aim for: large enough to amortize the cost of a
+// compression or write job, small enough that partial reads stay cheap
+constexpr size_t target_chunk_bytes = 4 << 20;
+
+// edge, in pixels, of the YX tiles suggested for tiled reads
+constexpr uint32_t tile_edge_px = 256;
+
+uint64_t
+product(const std::vector<uint32_t>& values, size_t first = 0)
+{
+    uint64_t result = 1;
+    for (auto i = first; i < values.size(); ++i) {
+        result *= values[i];
+    }
+    return result;
+}
+
+uint32_t
+halve(uint32_t value)
+{
+    return (value + 1) / 2;
+}
+
+// Shape a chunk for the read pattern, every dimension but the first, within
+// a budget of max_px pixels. Returns the edge of a cubic chunk for volumes.
+uint32_t
+shape_inner_chunk(const std::vector<ZarrDimension>& dims,
+                  ZarrReadPattern pattern,
+                  uint64_t max_px,
+                  std::vector<uint32_t>& chunk)
+{
+    const auto n = dims.size();
+    const auto y = n - 2, x = n - 1;
+
+    switch (pattern) {
+        case ZarrReadPattern_Frames:
+            // whole frames, in bands of rows if a frame is too large
+            for (auto i = 1; i < y; ++i) {
+                chunk[i] = 1;
+            }
+            chunk[y] = dims[y].array_size_px;
+            chunk[x] = dims[x].array_size_px;
+            while (product(chunk, 1) > max_px && chunk[y] > 1) {
+                chunk[y] = halve(chunk[y]);
+            }
+            while (product(chunk, 1) > max_px && chunk[x] > 1) {
+                chunk[x] = halve(chunk[x]);
+            }
+            return 1;
+        case ZarrReadPattern_Tiles:
+            // small tiles, deep through every dimension but channels
+            for (auto i = 1; i < y; ++i) {
+                chunk[i] = dims[i].type == ZarrDimensionType_Channel
+                             ? 1
+                             : dims[i].array_size_px;
+            }
+            chunk[y] = std::min(dims[y].array_size_px, tile_edge_px);
+            chunk[x] = std::min(dims[x].array_size_px, tile_edge_px);
+            while (product(chunk, 1) > max_px) {
+                // give up depth before tile size
+                size_t deepest = 1;
+                for (auto i = 2; i < y; ++i) {
+                    deepest = chunk[i] > chunk[deepest] ? i : deepest;
+                }
+
+                if (deepest < y && chunk[deepest] > 1) {
+                    chunk[deepest] = halve(chunk[deepest]);
+                } else if (chunk[y] > 1 || chunk[x] > 1) {
+                    auto& side = chunk[y] >= chunk[x] ? chunk[y] : chunk[x];
+                    side = halve(side);
+                } else {
+                    break;
+                }
+            }
+            return 1;
+        default: {
+            // cubes in the spatial dimensions, one deep in the others
+            size_t n_spatial = 0;
+            for (const auto& dim : dims) {
+                n_spatial += dim.type == ZarrDimensionType_Space ? 1 : 0;
+            }
+
+            uint64_t edge = 1;
+            while (true) {
+                uint64_t volume = 1;
+                for (auto i = 0; i < n_spatial; ++i) {
+                    volume *= 2 * edge;
+                }
+                if (volume > max_px) {
+                    break;
+                }
+                edge *= 2;
+            }
+
+            for (auto i = 1; i < n; ++i) {
+                chunk[i] = dims[i].type == ZarrDimensionType_Space
+                             ? std::min<uint64_t>(dims[i].array_size_px, edge)
+                             : 1;
+            }
+            return static_cast<uint32_t>(edge);
+        }
+    }
+}
+
+// Group chunks into shards of at most max_chunks, filling the dimensions in
+// order, or growing them in turn for volumes.
+void
+shape_shard(const std::vector<ZarrDimension>& dims,
+            ZarrReadPattern pattern,
+            uint64_t max_chunks,
+            std::vector<uint32_t>& shard)
+{
+    const auto n = dims.size();
+
+    // an unbounded append dimension can grow as far as the budget allows
+    std::vector<uint32_t> caps(n);
+    for (auto i = 0; i < n; ++i) {
+        caps[i] = dims[i].array_size_px == 0
+                    ? std::numeric_limits<uint32_t>::max()
+                    : zarr::chunks_along_dimension(dims[i]);
+    }
+
+    std::vector<size_t> order;
+    if (pattern == ZarrReadPattern_Tiles) {
+        // deep before wide
+        for (auto i = 0; i < n; ++i) {
+            order.push_back(i);
+        }
+    } else {
+        // wide before deep
+        for (auto i = n; i > 0; --i) {
+            order.push_back(i - 1);
+        }
+    }
+
+    std::ranges::fill(shard, 1);
+
+    if (pattern == ZarrReadPattern_Volumes) {
+        bool grew = true;
+        while (grew) {
+            grew = false;
+            for (const auto i : order) {
+                const auto next = std::min<uint64_t>(2 * shard[i], caps[i]);
+                if (next > shard[i] &&
+                    product(shard) / shard[i] * next <= max_chunks) {
+                    shard[i] = static_cast<uint32_t>(next);
+                    grew = true;
+                }
+            }
+        }
+        return;
+    }
+
+    for (const auto i : order) {
+        const auto others = product(shard) / shard[i];
+        shard[i] = static_cast<uint32_t>(
+          std::clamp<uint64_t>(max_chunks / others, 1, caps[i]));
+    }
+}
+} // namespace
+
+size_t
+zarr::estimate_array_memory_usage(const ZarrArraySettings& settings)
+{
+    const auto* dims = settings.dimensions;
+    const auto ndims = settings.dimension_count;
+
+    const size_t bytes_of_type = zarr::bytes_of_type(settings.data_type);
+    const size_t frame_size_bytes = bytes_of_type *
+                                    dims[ndims - 2].array_size_px *
+                                    dims[ndims - 1].array_size_px;
+
+    size_t array_usage = bytes_of_type * dims[0].chunk_size_px;
+    for (auto j = 1; j < ndims; ++j) {
+        const auto& dim = dims[j];
+
+        // arrays may be ragged, so we need to account for fill values
+        const auto nchunks =
+          zarr::parts_along_dimension(dim.array_size_px, dim.chunk_size_px);
+        size_t padded_array_size_px = nchunks * dim.chunk_size_px;
+
+        array_usage *= padded_array_size_px;
+    }
+
+    // compression can instantaneously double memory usage in the worst case,
+    // so we account for that here
+    if (settings.compression_settings) {
+        array_usage *= 2;
+    }
+
+    if (settings.multiscale) {
+        // we can bound the memory usage of multiscale arrays by observing that
+        // each downsampled level is at most half the size of the previous
+        // level, so the total memory usage is at most twice the size of the
+        // full-resolution, i.e., sum(1/2^n)_{n=0}^{inf} = 2
+        array_usage *= 2;
+    }
+
+    // each array has a frame buffer
+    return frame_size_bytes + array_usage;
+}
+
+bool
+zarr::suggest_geometry(ZarrArraySettings& settings,
+                       size_t target_memory_bytes,
+                       size_t target_shard_bytes,
+                       ZarrReadPattern read_pattern,
+                       double frame_rate_hz,
+                       ZarrGeometrySuggestion& suggestion,
+                       std::string& error)
+{
+    if (settings.dimensions == nullptr || settings.dimension_count < 2) {
+        error = "Array must have at least two dimensions";
+        return false;
+    }
+    if (settings.data_type >= ZarrDataTypeCount) {
+        error = "Invalid data type: " + std::to_string(settings.data_type);
+        return false;
+    }
+
+    // as in ArrayDimensions, 2D arrays get a singleton append dimension
+    std::vector<ZarrDimension> dims;
+    if (settings.dimension_count == 2) {
+        dims.emplace_back("", ZarrDimensionType_Other, 1, 1, 1);
+    }
+    for (auto i = 0; i < settings.dimension_count; ++i) {
+        const auto& dim = settings.dimensions[i];
+        dims.emplace_back("", dim.type, dim.array_size_px, 1, 1);
+    }
+
+    const auto n = dims.size();
+    for (auto i = 1; i < n; ++i) {
+        if (dims[i].array_size_px == 0) {
+            error = "Array size must be nonzero for dimension " +
+                    std::to_string(i - (n - settings.dimension_count));
+            return false;
+        }
+    }
+    if (dims[n - 2].type != ZarrDimensionType_Space ||
+        dims[n - 1].type != ZarrDimensionType_Space) {
+        error = "The last two dimensions must be spatial";
+        return false;
+    }
+
+    const auto bytes_of_type = zarr::bytes_of_type(settings.data_type);
+    const size_t factor = (settings.compression_settings ? 2 : 1) *
+                          (settings.multiscale ? 2 : 1);
+
+    // a chunk must fit in memory with room to compress it
+    const uint64_t max_chunk_px = std::max<uint64_t>(
+      1,
+      std::min(target_chunk_bytes, target_memory_bytes / factor) /
+        bytes_of_type);
+
+    std::vector<uint32_t> chunk(n, 1);
+    const auto edge =
+      shape_inner_chunk(dims, read_pattern, max_chunk_px, chunk);
+
+    // deepen the chunks along the append dimension with what's left of the
+    // budget, or to the edge of a cube if the append dimension is spatial
+    uint64_t depth;
+    if (read_pattern == ZarrReadPattern_Volumes) {
+        depth = dims[0].type == ZarrDimensionType_Space ? edge : 1;
+    } else {
+        depth = std::max<uint64_t>(1, max_chunk_px / product(chunk, 1));
+    }
+    if (dims[0].array_size_px > 0) {
+        depth = std::min<uint64_t>(depth, dims[0].array_size_px);
+    }
+
+    // a layer of chunks, padded at the array's edges, must fit in memory
+    uint64_t layer_px = 1;
+    for (auto i = 1; i < n; ++i) {
+        const auto nchunks =
+          zarr::parts_along_dimension(dims[i].array_size_px, chunk[i]);
+        layer_px *= static_cast<uint64_t>(nchunks) * chunk[i];
+    }
+    const uint64_t frame_bytes = bytes_of_type * dims[n - 2].array_size_px *
+                                 dims[n - 1].array_size_px;
+    const uint64_t bytes_per_plane = factor * bytes_of_type * layer_px;
+    const auto max_depth = target_memory_bytes > frame_bytes
+                             ? (target_memory_bytes - frame_bytes) /
+                                 bytes_per_plane
+                             : 0;
+    if (max_depth == 0) {
+        LOG_WARNING("A layer of chunks one pixel deep needs ",
+                    bytes_per_plane + frame_bytes,
+                    " bytes, more than the target of ",
+                    target_memory_bytes);
+    }
+    chunk[0] = static_cast<uint32_t>(
+      std::clamp<uint64_t>(max_depth, 1, std::max<uint64_t>(depth, 1)));
+
+    const uint64_t chunk_bytes = bytes_of_type * product(chunk);
+    std::vector<uint32_t> shard(n, 1);
+    for (auto i = 0; i < n; ++i) {
+        dims[i].chunk_size_px = chunk[i];
+    }
+    shape_shard(dims,
+                read_pattern,
+                std::max<uint64_t>(1, target_shard_bytes / chunk_bytes),
+                shard);
+
+    // write the geometry back, less any singleton dimension
+    const auto offset = n - settings.dimension_count;
+    for (auto i = offset; i < n; ++i) {
+        auto& dim = settings.dimensions[i - offset];
+        dim.chunk_size_px = chunk[i];
+        dim.shard_size_chunks = shard[i];
+        dims[i].shard_size_chunks = shard[i];
+    }
+    dims[0].shard_size_chunks = shard[0];
+
+    // one layer of chunks is flushed at a time, and every shard it touches is
+    // a new file once the layers in a shard are full
+    uint64_t frames_per_flush = chunk[0];
+    for (auto i = 1; i < n - 2; ++i) {
+        frames_per_flush *= dims[i].array_size_px;
+    }
+
+    uint64_t shards_per_layer = 1;
+    for (auto i = 1; i < n; ++i) {
+        shards_per_layer *= zarr::shards_along_dimension(dims[i]);
+    }
+
+    suggestion.memory_bytes = estimate_array_memory_usage(settings);
+    suggestion.chunk_bytes = chunk_bytes;
+    suggestion.shard_bytes = chunk_bytes * product(shard);
+    suggestion.frames_per_flush = frames_per_flush;
+    suggestion.seconds_per_flush = 0.0;
+    suggestion.files_per_hour = 0.0;
+    if (frame_rate_hz > 0.0) {
+        suggestion.seconds_per_flush = frames_per_flush / frame_rate_hz;
+
+        const auto frames_per_shard = frames_per_flush * shard[0];
+        suggestion.files_per_hour =
+          3600.0 * frame_rate_hz * shards_per_layer / frames_per_shard;
+    }
+
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "zarr.types.h"
+
+#include <string>
+
+namespace zarr {
+/**
+ * @brief Estimate the memory an array holds while streaming: its frame buffer
+ * and one layer of chunks, doubled if compressed and again if multiscale.
+ * @param settings The array settings. Dimensions must be set.
+ * @return The estimated memory usage, in bytes.
+ */
+size_t
+estimate_array_memory_usage(const ZarrArraySettings& settings);
+
+/**
+ * @brief Choose chunk and shard sizes for an array and predict how it will
+ * stream.
+ * @param[in, out] settings The array settings, whose dimensions' chunk and
+ * shard sizes are overwritten.
+ * @param target_memory_bytes Memory the array may use while streaming.
+ * @param target_shard_bytes Uncompressed size of a shard to aim for.
+ * @param read_pattern How the array will mostly be read.
+ * @param frame_rate_hz Frames appended per second, or 0 if unknown.
+ * @param[out] suggestion The predicted behaviour of the chosen geometry.
+ * @param[out] error A description of the problem, on failure.
+ * @return True on success, false if the settings can't describe an array.
+ */
+[[nodiscard]] bool
+suggest_geometry(ZarrArraySettings& settings,
+                 size_t target_memory_bytes,
+                 size_t target_shard_bytes,
+                 ZarrReadPattern read_pattern,
+                 double frame_rate_hz,
+                 ZarrGeometrySuggestion& suggestion,
+                 std::string& error);
+} // namespace zarr
@@ -138,4 +138,26 @@ zarr::LockedBuffer::compress(const zarr::BloscCompressionParams& params,
     compressed_data.resize(n_bytes_compressed);
     data_ = compressed_data;
     return true;
-}
\ No newline at end of file
+}
+bool
+zarr::LockedBuffer::decompress(size_t n_bytes)
+{
+    std::unique_lock lock(mutex_);
+    if (data_.empty()) {
+        LOG_WARNING("Buffer is empty, not decompressing.");
+        return false;
+    }
+
+    std::vector<uint8_t> decompressed_data(n_bytes);
+    const auto n_bytes_decompressed = blosc_decompress_ctx(
+      data_.data(), decompressed_data.data(), decompressed_data.size(), 1);
+
+    if (n_bytes_decompressed != static_cast<int>(n_bytes)) {
+        LOG_ERROR("blosc_decompress_ctx failed with code ",
+                  n_bytes_decompressed);
+        return false;
+    }
+
+    data_ = std::move(decompressed_data);
+    return true;
+}
@@ -97,5 +97,12 @@ class LockedBuffer
      */
     [[nodiscard]] bool compress(const zarr::BloscCompressionParams& params,
                                 size_t type_size);
+
+    /**
+     * @brief Decompress the Blosc-compressed buffer in place.
+     * @param n_bytes Expected size of the decompressed data, in bytes.
+     * @return true if decompression was successful, false otherwise.
+     */
+    [[nodiscard]] bool decompress(size_t n_bytes);
 };
 } // namespace zarr
\ No newline at end of file
@@ -59,6 +59,39 @@ zarr::MultiscaleArray::write_frame(LockedBuffer& data, size_t& bytes_written)
 {
     bytes_written = 0;
 
+    // the downsampler works on stored pixels, so decode appended frames once
+    // up front rather than in the full-resolution array
+    const auto pixel_format = config_->pixel_format;
+    const auto& conversion = config_->input_conversion;
+    const auto& reduction = config_->frame_reduction;
+    if (downsampler_ &&
+        (pixel_format != ZarrPixelFormat_Native || conversion || reduction)) {
+        const auto& dims = config_->dimensions;
+        const auto rows = dims->acquisition_frame_rows();
+        const auto cols = dims->acquisition_frame_cols();
+        const auto input_type =
+          conversion ? conversion->data_type : config_->dtype;
+        const auto input_px =
+          reduction ? size_t{ reduction->frame_width } * reduction->frame_height
+                    : size_t{ rows } * cols;
+        if (data.size() != bytes_of_pixels(pixel_format, input_px, input_type)) {
+            LOG_ERROR("Frame size mismatch: got ", data.size(), " bytes");
+            return WriteResult::FrameSizeMismatch;
+        }
+
+        ByteVector decoded(bytes_per_frame_);
+        const auto input = data.take();
+        decode_frame(pixel_format,
+                     conversion,
+                     reduction,
+                     config_->dtype,
+                     rows,
+                     cols,
+                     input.data(),
+                     decoded.data());
+        data.assign(std::move(decoded));
+    }
+
     size_t n_bytes;
     if (const auto result = arrays_[0]->write_frame(data, n_bytes);
         result != WriteResult::Ok) {
@@ -70,12 +103,92 @@ zarr::MultiscaleArray::write_frame(LockedBuffer& data, size_t& bytes_written)
     return WriteResult::Ok;
 }
 
+zarr::WriteResult
+zarr::MultiscaleArray::write_frame_at(LockedBuffer& data,
+                                      uint64_t frame_id,
+                                      size_t& bytes_written)
+{
+    bytes_written = 0;
+
+    // the downsampler averages frames in the order they arrive
+    if (downsampler_) {
+        LOG_ERROR("Cannot write frames by index to a downsampled array");
+        return WriteResult::InvalidFrameIndex;
+    }
+
+    return arrays_[0]->write_frame_at(data, frame_id, bytes_written);
+}
+
+zarr::WriteResult
+zarr::MultiscaleArray::write_chunk(std::span<const uint64_t> chunk_coords,
+                                   ConstByteSpan data,
+                                   bool is_compressed)
+{
+    // the downsampler works on whole frames
+    if (downsampler_) {
+        LOG_ERROR("Cannot write chunks directly to a downsampled array");
+        return WriteResult::InvalidChunk;
+    }
+
+    return arrays_[0]->write_chunk(chunk_coords, data, is_compressed);
+}
+
+zarr::WriteResult
+zarr::MultiscaleArray::write_region(std::span<const uint64_t> offset,
+                                    std::span<const uint64_t> shape,
+                                    ConstByteSpan data)
+{
+    if (downsampler_) {
+        LOG_ERROR("Cannot write regions directly to a downsampled array");
+        return WriteResult::InvalidChunk;
+    }
+
+    return arrays_[0]->write_region(offset, shape, data);
+}
+
+bool
+zarr::MultiscaleArray::statistics(std::optional<uint64_t> channel,
+                                  ZarrArrayStatistics& stats) const
+{
+    return arrays_[0]->statistics(channel, stats);
+}
+
+bool
+zarr::MultiscaleArray::preview(uint16_t level,
+                               ByteSpan frame,
+                               ZarrPreviewInfo& info) const
+{
+    if (level >= arrays_.size()) {
+        LOG_ERROR("Level ", level, " is out of bounds");
+        return false;
+    }
+
+    return arrays_[level]->preview(0, frame, info);
+}
+
 size_t
 zarr::MultiscaleArray::max_bytes() const
 {
     return arrays_[0]->max_bytes();
 }
 
+size_t
+zarr::MultiscaleArray::bytes_written() const
+{
+    return arrays_[0]->bytes_written();
+}
+
+bool
+zarr::MultiscaleArray::flush()
+{
+    bool success = true;
+    for (auto& array : arrays_) {
+        success = array->flush() && success;
+    }
+
+    return success;
+}
+
 std::vector<std::string>
 zarr::MultiscaleArray::metadata_keys_() const
 {
@@ -111,12 +224,15 @@ zarr::MultiscaleArray::close_()
             LOG_ERROR("Error closing group: failed to finalize sub-array");
             return false;
         }
+        final_metadata_.merge(array->final_metadata_);
     }
 
     if (!write_metadata_()) {
         LOG_ERROR("Error closing group: failed to write metadata");
         return false;
     }
+    final_metadata_.emplace(config_->node_key,
+                            metadata_strings_.at("zarr.json"));
 
     for (auto& [key, sink] : metadata_sinks_) {
         EXPECT(zarr::finalize_sink(std::move(sink)),
@@ -271,14 +387,37 @@ zarr::MultiscaleArray::make_multiscales_metadata_() const
 std::shared_ptr<zarr::ArrayConfig>
 zarr::MultiscaleArray::make_base_array_config_() const
 {
-    return std::make_shared<ArrayConfig>(config_->store_root,
-                                         config_->node_key + "/0",
-                                         config_->bucket_name,
-                                         config_->compression_params,
-                                         config_->dimensions,
-                                         config_->dtype,
-                                         std::nullopt,
-                                         0);
+    auto config = std::make_shared<ArrayConfig>(config_->store_root,
+                                                config_->node_key + "/0",
+                                                config_->bucket_name,
+                                                config_->compression_params,
+                                                config_->dimensions,
+                                                config_->dtype,
+                                                std::nullopt,
+                                                0);
+    config->metadata_update_interval = config_->metadata_update_interval;
+    config->checkpoint_interval = config_->checkpoint_interval;
+    config->resume = config_->resume;
+
+    // with a downsampler, appended frames are decoded before they reach any
+    // of the arrays
+    if (!config_->downsampling_method) {
+        config->pixel_format = config_->pixel_format;
+        config->input_conversion = config_->input_conversion;
+        config->frame_reduction = config_->frame_reduction;
+    }
+    config->significant_bits = config_->significant_bits;
+    config->compute_statistics = config_->compute_statistics;
+    config->projection_method = config_->projection_method;
+    config->projection_dimension = config_->projection_dimension;
+    config->projection_key = config_->projection_key;
+    config->enable_preview = config_->enable_preview;
+    config->chunk_checksums = config_->chunk_checksums;
+    config->chunk_order = config_->chunk_order;
+    config->shard_verifier = config_->shard_verifier;
+    config->max_region_buffer_bytes = config_->max_region_buffer_bytes;
+
+    return config;
 }
 
 zarr::WriteResult
@@ -22,7 +22,23 @@ class MultiscaleArray : public ArrayBase
 
     [[nodiscard]] WriteResult write_frame(LockedBuffer& data,
                                           size_t& bytes_written) override;
+    [[nodiscard]] WriteResult write_frame_at(LockedBuffer& data,
+                                             uint64_t frame_id,
+                                             size_t& bytes_written) override;
+    [[nodiscard]] WriteResult write_chunk(std::span<const uint64_t> chunk_coords,
+                                          ConstByteSpan data,
+                                          bool is_compressed) override;
+    [[nodiscard]] WriteResult write_region(std::span<const uint64_t> offset,
+                                           std::span<const uint64_t> shape,
+                                           ConstByteSpan data) override;
+    [[nodiscard]] bool statistics(std::optional<uint64_t> channel,
+                                  ZarrArrayStatistics& stats) const override;
+    [[nodiscard]] bool preview(uint16_t level,
+                               ByteSpan frame,
+                               ZarrPreviewInfo& info) const override;
     size_t max_bytes() const override;
+    size_t bytes_written() const override;
+    [[nodiscard]] bool flush() override;
 
   protected:
     std::unique_ptr<Downsampler> downsampler_;
@@ -1,10 +1,14 @@
 #include "definitions.hh"
 #include "macros.hh"
 
+#include <algorithm>
 #include <string_view>
+#include <vector>
 
+#include <climits>
 #include <cstring>
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/resource.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -23,6 +27,14 @@ make_flags()
     return flags;
 }
 
+void*
+make_read_flags()
+{
+    auto* flags = new int;
+    *flags = O_RDONLY;
+    return flags;
+}
+
 void
 destroy_flags(void* flags)
 {
@@ -82,6 +94,57 @@ seek_and_write(void* handle, size_t offset, ConstByteSpan data)
     return retries < max_retries;
 }
 
+bool
+seek_and_read(void* handle, size_t offset, std::span<ByteSpan> buffers)
+{
+    CHECK(handle);
+    const auto* fd = static_cast<int*>(handle);
+
+    // one preadv fills a contiguous run of buffers, e.g., adjacent chunks
+    std::vector<iovec> iov(buffers.size());
+    for (auto i = 0; i < buffers.size(); ++i) {
+        iov[i].iov_base = buffers[i].data();
+        iov[i].iov_len = buffers[i].size();
+    }
+
+    size_t first = 0;
+    while (true) {
+        while (first < iov.size() && iov[first].iov_len == 0) {
+            ++first;
+        }
+        if (first == iov.size()) {
+            break;
+        }
+
+        const auto count = std::min<size_t>(iov.size() - first, IOV_MAX);
+        const ssize_t n_read = preadv(*fd, iov.data() + first, count, offset);
+        if (n_read < 0) {
+            const auto err = get_last_error_as_string();
+            throw std::runtime_error("Failed to read from file: " + err);
+        }
+        if (n_read == 0) {
+            return false; // end of file
+        }
+        offset += n_read;
+
+        // advance past what was read, which may end partway into a buffer
+        size_t remaining = n_read;
+        while (remaining > 0) {
+            auto& v = iov[first];
+            if (remaining < v.iov_len) {
+                v.iov_base = static_cast<char*>(v.iov_base) + remaining;
+                v.iov_len -= remaining;
+                break;
+            }
+            remaining -= v.iov_len;
+            v.iov_len = 0;
+            ++first;
+        }
+    }
+
+    return true;
+}
+
 bool
 flush_file(void* handle)
 {
@@ -105,4 +168,16 @@ destroy_handle(void* handle)
         }
         delete fd;
     }
-}
\ No newline at end of file
+}
+bool
+lower_thread_priority()
+{
+#if defined(__linux__)
+    // Linux keeps a nice value per thread, so this leaves the others alone
+    return setpriority(PRIO_PROCESS, 0, 10) == 0;
+#elif defined(__APPLE__)
+    return pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0) == 0;
+#else
+    return false;
+#endif
+}
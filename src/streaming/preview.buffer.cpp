@@ -0,0 +1,66 @@
+#include "preview.buffer.hh"
+#include "macros.hh"
+
+#include <cstring>
+
+zarr::PreviewBuffer::PreviewBuffer(size_t frame_bytes)
+  : back_(0)
+  , middle_(1)
+  , front_(2)
+{
+    for (auto& slot : slots_) {
+        slot.data.resize(frame_bytes);
+    }
+}
+
+void
+zarr::PreviewBuffer::publish(ConstByteSpan frame, uint64_t frame_id)
+{
+    auto& slot = slots_[back_];
+    EXPECT(frame.size() == slot.data.size(),
+           "Preview frame size mismatch: expected ",
+           slot.data.size(),
+           ", got ",
+           frame.size());
+
+    std::memcpy(slot.data.data(), frame.data(), frame.size());
+    slot.frame_id = frame_id;
+
+    // hand the filled slot to readers and take back whichever slot they
+    // aren't holding
+    back_ = middle_.exchange(back_ | fresh_bit_, std::memory_order_acq_rel) &
+            index_mask_;
+}
+
+std::optional<uint64_t>
+zarr::PreviewBuffer::read(ByteSpan frame)
+{
+    std::unique_lock lock(reader_mutex_);
+
+    if (middle_.load(std::memory_order_acquire) & fresh_bit_) {
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) &
+                 index_mask_;
+    }
+
+    const auto& slot = slots_[front_];
+    if (!slot.frame_id) {
+        return std::nullopt;
+    }
+
+    if (!frame.empty()) {
+        EXPECT(frame.size() >= slot.data.size(),
+               "Preview buffer too small: expected at least ",
+               slot.data.size(),
+               " bytes, got ",
+               frame.size());
+        std::memcpy(frame.data(), slot.data.data(), slot.data.size());
+    }
+
+    return slot.frame_id;
+}
+
+size_t
+zarr::PreviewBuffer::frame_bytes() const noexcept
+{
+    return slots_[0].data.size();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "definitions.hh"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+
+namespace zarr {
+/**
+ * @brief Triple buffer holding the most recent frame written to an array, for
+ * display while the array is being written.
+ * @details A single writer publishes frames into a back slot and swaps it
+ * with the middle slot in one atomic exchange, so it never waits on readers.
+ * Readers swap the middle slot to the front when it holds a newer frame and
+ * copy out of the front slot, which the writer never touches.
+ */
+class PreviewBuffer
+{
+  public:
+    explicit PreviewBuffer(size_t frame_bytes);
+
+    /**
+     * @brief Publish a frame, replacing any frame not yet read.
+     * @note Only one thread may publish.
+     * @param frame The frame, of frame_bytes() bytes.
+     * @param frame_id The index of the frame in the array.
+     */
+    void publish(ConstByteSpan frame, uint64_t frame_id);
+
+    /**
+     * @brief Copy out the most recently published frame.
+     * @param[out] frame Buffer of at least frame_bytes() bytes, or empty to
+     * only query the index of the most recent frame.
+     * @return The index of the frame, or nullopt if none has been published.
+     */
+    std::optional<uint64_t> read(ByteSpan frame);
+
+    size_t frame_bytes() const noexcept;
+
+  private:
+    static constexpr uint8_t index_mask_ = 0x3;
+    static constexpr uint8_t fresh_bit_ = 0x4; // middle holds an unread frame
+
+    struct Slot
+    {
+        ByteVector data;
+        std::optional<uint64_t> frame_id;
+    };
+
+    std::array<Slot, 3> slots_;
+    uint8_t back_;                // owned by the writer
+    std::atomic<uint8_t> middle_; // slot index, with fresh_bit_
+    uint8_t front_;               // owned by readers, under reader_mutex_
+    std::mutex reader_mutex_;
+};
+} // namespace zarr
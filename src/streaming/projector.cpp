@@ -0,0 +1,238 @@
+#include "projector.hh"
+#include "macros.hh"
+#include "zarr.common.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+template<typename T>
+void
+max_into(uint8_t* acc, const uint8_t* frame, size_t n)
+{
+    // both buffers are whole frames, so they're aligned for T; a plain loop
+    // over contiguous elements is left to the compiler to vectorize
+    auto* out = reinterpret_cast<T*>(acc);
+    const auto* in = reinterpret_cast<const T*>(frame);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = std::max(out[i], in[i]);
+    }
+}
+
+template<typename T>
+void
+sum_into(uint8_t* acc, const uint8_t* frame, size_t n)
+{
+    auto* out = reinterpret_cast<double*>(acc);
+    const auto* in = reinterpret_cast<const T*>(frame);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] += static_cast<double>(in[i]);
+    }
+}
+
+std::string
+projection_method_to_string(ZarrProjectionMethod method)
+{
+    switch (method) {
+        case ZarrProjectionMethod_Max:
+            return "max";
+        case ZarrProjectionMethod_Mean:
+            return "mean";
+        default:
+            return "unknown";
+    }
+}
+} // namespace
+
+zarr::Projector::Projector(std::shared_ptr<ArrayConfig> config)
+  : dtype_(config->dtype)
+  , inner_frames_(1)
+  , extent_(0)
+  , next_frame_id_(0)
+  , finished_(false)
+{
+    EXPECT(config->projection_method, "No projection method set");
+    method_ = *config->projection_method;
+    EXPECT(method_ < ZarrProjectionMethodCount,
+           "Invalid projection method: ",
+           method_);
+
+    const auto& dims = config->dimensions;
+    const auto ndims = dims->ndims();
+    px_per_frame_ = static_cast<size_t>(dims->width_dim().array_size_px) *
+                    dims->height_dim().array_size_px;
+
+    // the dimensions are in storage order, like the frame ids we'll be given
+    std::optional<size_t> axis;
+    for (auto i = 0; i < ndims - 2; ++i) {
+        if (dims->at(i).name == config->projection_dimension) {
+            axis = i;
+            break;
+        }
+    }
+    EXPECT(axis && !dims->is_2d(),
+           "Cannot project along '",
+           config->projection_dimension,
+           "': not a non-frame dimension of the array");
+
+    extent_ = dims->at(*axis).array_size_px;
+    for (auto i = *axis + 1; i < ndims - 2; ++i) {
+        inner_frames_ *= dims->at(i).array_size_px;
+    }
+
+    std::vector<ZarrDimension> projected_dims;
+    for (auto i = 0; i < ndims; ++i) {
+        if (i != *axis) {
+            projected_dims.push_back(dims->at(i));
+        }
+    }
+
+    writer_configuration_ = std::make_shared<ArrayConfig>(
+      config->store_root,
+      config->projection_key,
+      config->bucket_name,
+      config->compression_params,
+      std::make_shared<ArrayDimensions>(std::move(projected_dims), dtype_),
+      dtype_,
+      std::nullopt,
+      0);
+    writer_configuration_->metadata_update_interval =
+      config->metadata_update_interval;
+    writer_configuration_->checkpoint_interval = config->checkpoint_interval;
+    writer_configuration_->significant_bits = config->significant_bits;
+    writer_configuration_->chunk_checksums = config->chunk_checksums;
+    writer_configuration_->chunk_order = config->chunk_order;
+    writer_configuration_->shard_verifier = config->shard_verifier;
+
+    LOG_DEBUG("Projecting array ",
+              config->node_key,
+              " along '",
+              config->projection_dimension,
+              "' by ",
+              projection_method_to_string(method_),
+              " into ",
+              config->projection_key);
+}
+
+void
+zarr::Projector::add_frame(ConstByteSpan frame, uint64_t frame_id)
+{
+    EXPECT(frame.size() == px_per_frame_ * bytes_of_type(dtype_),
+           "Frame size mismatch: got ",
+           frame.size(),
+           " bytes");
+
+    const auto step = frame_id / inner_frames_;
+    const auto outer = extent_ > 0 ? step / extent_ : 0;
+    const auto projected_id = outer * inner_frames_ + frame_id % inner_frames_;
+    EXPECT(projected_id >= next_frame_id_,
+           "Frame ",
+           frame_id,
+           " belongs to a projection that has already been written");
+
+    accumulate_(projections_[projected_id], frame);
+}
+
+bool
+zarr::Projector::take_frame(LockedBuffer& frame)
+{
+    const auto it = projections_.find(next_frame_id_);
+    if (it == projections_.end()) {
+        return false;
+    }
+
+    if (!finished_ && (extent_ == 0 || it->second.count < extent_)) {
+        return false;
+    }
+
+    frame.assign(finalize_(it->second));
+    projections_.erase(it);
+    ++next_frame_id_;
+
+    return true;
+}
+
+void
+zarr::Projector::finish()
+{
+    finished_ = true;
+    if (projections_.empty()) {
+        return;
+    }
+
+    // frames never appended project to zeros, as they read from the array
+    const auto last = projections_.rbegin()->first;
+    for (auto id = next_frame_id_; id < last; ++id) {
+        projections_.try_emplace(id);
+    }
+}
+
+const std::shared_ptr<zarr::ArrayConfig>&
+zarr::Projector::writer_configuration() const
+{
+    return writer_configuration_;
+}
+
+size_t
+zarr::Projector::memory_usage() const noexcept
+{
+    size_t total = 0;
+    for (const auto& [id, projection] : projections_) {
+        total += projection.accumulator.size();
+    }
+
+    return total;
+}
+
+void
+zarr::Projector::accumulate_(Projection& projection, ConstByteSpan frame) const
+{
+    if (method_ == ZarrProjectionMethod_Max) {
+        if (projection.count == 0) {
+            projection.accumulator.assign(frame.begin(), frame.end());
+        } else {
+            visit_type(dtype_, [&](auto tag) {
+                max_into<decltype(tag)>(
+                  projection.accumulator.data(), frame.data(), px_per_frame_);
+            });
+        }
+    } else {
+        if (projection.count == 0) {
+            projection.accumulator.assign(px_per_frame_ * sizeof(double), 0);
+        }
+        visit_type(dtype_, [&](auto tag) {
+            sum_into<decltype(tag)>(
+              projection.accumulator.data(), frame.data(), px_per_frame_);
+        });
+    }
+
+    ++projection.count;
+}
+
+ByteVector
+zarr::Projector::finalize_(const Projection& projection) const
+{
+    ByteVector frame(px_per_frame_ * bytes_of_type(dtype_), 0);
+    if (projection.count == 0) {
+        return frame;
+    }
+
+    if (method_ == ZarrProjectionMethod_Max) {
+        return projection.accumulator;
+    }
+
+    const ZarrInputConversion mean{
+        .data_type = ZarrDataType_float64,
+        .scale = 1.0 / projection.count,
+        .offset = 0.0,
+        .right_shift = 0,
+    };
+    convert_samples(projection.accumulator.data(),
+                    frame.data(),
+                    px_per_frame_,
+                    dtype_,
+                    mean);
+
+    return frame;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "array.base.hh"
+#include "definitions.hh"
+#include "locked.buffer.hh"
+
+#include <map>
+#include <memory>
+
+namespace zarr {
+/**
+ * @brief Running max or mean projection of an array's frames along one of
+ * its non-frame dimensions.
+ * @details Frames are projected in storage order. Each projected frame is
+ * complete once every index along the projected dimension has been added,
+ * and is handed out in order of its position in the projection array.
+ */
+class Projector
+{
+  public:
+    /**
+     * @brief Create a projector for the array described by @p config.
+     * @param config The configuration of the projected array, with
+     * projection_method set.
+     * @throw std::runtime_error if the projection dimension is not one of
+     * the array's non-frame dimensions.
+     */
+    explicit Projector(std::shared_ptr<ArrayConfig> config);
+
+    /**
+     * @brief Fold a frame into its projection.
+     * @param frame A stored frame, in storage order.
+     * @param frame_id The storage-order index of the frame.
+     */
+    void add_frame(ConstByteSpan frame, uint64_t frame_id);
+
+    /**
+     * @brief Take the next projected frame, if it is complete.
+     * @param[out] frame The projected frame.
+     * @return True if a projected frame was taken, false otherwise.
+     */
+    bool take_frame(LockedBuffer& frame);
+
+    /**
+     * @brief Mark every partial projection as complete, e.g., at the end of
+     * an acquisition or for projections along the append dimension.
+     */
+    void finish();
+
+    const std::shared_ptr<ArrayConfig>& writer_configuration() const;
+
+    size_t memory_usage() const noexcept;
+
+  private:
+    struct Projection
+    {
+        ByteVector accumulator; // dtype for max, double for mean
+        uint32_t count{ 0 };
+    };
+
+    ZarrProjectionMethod method_;
+    ZarrDataType dtype_;
+    size_t px_per_frame_;
+
+    uint64_t inner_frames_; // frames between steps along the dimension
+    uint32_t extent_;       // size of the dimension, 0 if unbounded
+
+    std::map<uint64_t, Projection> projections_; // by projected frame id
+    uint64_t next_frame_id_;
+    bool finished_;
+
+    std::shared_ptr<ArrayConfig> writer_configuration_;
+
+    void accumulate_(Projection& projection, ConstByteSpan frame) const;
+    ByteVector finalize_(const Projection& projection) const;
+};
+} // namespace zarr
@@ -4,6 +4,8 @@
 #include <miniocpp/client.h>
 #include <miniocpp/utils.h>
 
+#include <algorithm>
+#include <cstring>
 #include <list>
 #include <regex>
 #include <sstream>
@@ -87,6 +89,67 @@ zarr::S3Connection::object_exists(std::string_view bucket_name,
     return static_cast<bool>(response);
 }
 
+bool
+zarr::S3Connection::object_size(std::string_view bucket_name,
+                                std::string_view object_name,
+                                size_t& size)
+{
+    minio::s3::StatObjectArgs args;
+    args.bucket = bucket_name;
+    args.object = object_name;
+
+    auto response = impl_->client->StatObject(args);
+    if (!response) {
+        return false;
+    }
+
+    size = response.size;
+    return true;
+}
+
+bool
+zarr::S3Connection::get_object(std::string_view bucket_name,
+                               std::string_view object_name,
+                               size_t offset,
+                               std::span<uint8_t> data)
+{
+    EXPECT(!bucket_name.empty(), "Bucket name must not be empty.");
+    EXPECT(!object_name.empty(), "Object name must not be empty.");
+
+    if (data.empty()) {
+        return true;
+    }
+
+    size_t length = data.size();
+    size_t bytes_read = 0;
+
+    minio::s3::GetObjectArgs args;
+    args.bucket = bucket_name;
+    args.object = object_name;
+    args.offset = &offset;
+    args.length = &length;
+    args.datafunc = [&data, &bytes_read](minio::http::DataFunctionArgs args) {
+        const auto n =
+          std::min(args.datachunk.size(), data.size() - bytes_read);
+        memcpy(data.data() + bytes_read, args.datachunk.data(), n);
+        bytes_read += n;
+        return true;
+    };
+
+    auto response = impl_->client->GetObject(args);
+    if (!response) {
+        LOG_ERROR("Failed to get object ",
+                  object_name,
+                  " from bucket ",
+                  bucket_name,
+                  ": ",
+                  response.Error().String());
+        return false;
+    }
+
+    return bytes_read == data.size();
+}
+
 std::string
 zarr::S3Connection::put_object(std::string_view bucket_name,
                                std::string_view object_name,
@@ -303,3 +366,16 @@ zarr::S3ConnectionPool::return_connection(std::unique_ptr<S3Connection>&& conn)
     connections_.push_back(std::move(conn));
     cv_.notify_one();
 }
+
+void
+zarr::S3ConnectionPool::set_bandwidth_limiter(
+  std::shared_ptr<BandwidthLimiter> limiter)
+{
+    bandwidth_limiter_ = std::move(limiter);
+}
+
+zarr::BandwidthLimiter*
+zarr::S3ConnectionPool::bandwidth_limiter() const noexcept
+{
+    return bandwidth_limiter_.get();
+}
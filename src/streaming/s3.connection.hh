@@ -1,5 +1,7 @@
 #pragma once
 
+#include "bandwidth.limiter.hh"
+
 #include <condition_variable>
 #include <list>
 #include <memory>
@@ -50,6 +52,33 @@ class S3Connection
     bool object_exists(std::string_view bucket_name,
                        std::string_view object_name);
 
+    /**
+     * @brief Get the size of an object.
+     * @param bucket_name The name of the bucket containing the object.
+     * @param object_name The name of the object.
+     * @param[out] size The size of the object, in bytes.
+     * @returns True if the object exists, otherwise false.
+     */
+    [[nodiscard]] bool object_size(std::string_view bucket_name,
+                                   std::string_view object_name,
+                                   size_t& size);
+
+    /**
+     * @brief Get a range of bytes of an object.
+     * @param bucket_name The name of the bucket containing the object.
+     * @param object_name The name of the object.
+     * @param offset The offset of the range in the object, in bytes.
+     * @param[out] data Buffer to read the range into. Its size is the length
+     * of the range.
+     * @returns True if the whole range was read, otherwise false.
+     * @throws std::runtime_error if the bucket name is empty or the object
+     * name is empty.
+     */
+    [[nodiscard]] bool get_object(std::string_view bucket_name,
+                                  std::string_view object_name,
+                                  size_t offset,
+                                  std::span<uint8_t> data);
+
     /**
      * @brief Put an object.
      * @param bucket_name The name of the bucket to put the object in.
@@ -131,11 +160,23 @@ class S3ConnectionPool
     std::unique_ptr<S3Connection> get_connection();
     void return_connection(std::unique_ptr<S3Connection>&& conn);
 
+    /**
+     * @brief Limit the bandwidth of writes made through this pool.
+     * @note Set before any writes are made.
+     * @param limiter The limiter, or nullptr for no limit.
+     */
+    void set_bandwidth_limiter(std::shared_ptr<BandwidthLimiter> limiter);
+
+    /** @brief Get the bandwidth limiter, or nullptr if there is none. */
+    BandwidthLimiter* bandwidth_limiter() const noexcept;
+
   private:
     std::vector<std::unique_ptr<S3Connection>> connections_;
     std::mutex connections_mutex_;
     std::condition_variable cv_;
 
     std::atomic<bool> is_accepting_connections_{ true };
+
+    std::shared_ptr<BandwidthLimiter> bandwidth_limiter_;
 };
 } // namespace zarr
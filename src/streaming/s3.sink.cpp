@@ -96,6 +96,10 @@ zarr::S3Sink::put_object_()
         return false;
     }
 
+    if (auto* limiter = connection_pool_->bandwidth_limiter()) {
+        limiter->acquire(nbytes_buffered_);
+    }
+
     auto connection = connection_pool_->get_connection();
     std::span data(reinterpret_cast<uint8_t*>(part_buffer_.data()),
                    nbytes_buffered_);
@@ -149,6 +153,10 @@ zarr::S3Sink::flush_part_()
         create_multipart_upload_();
     }
 
+    if (auto* limiter = connection_pool_->bandwidth_limiter()) {
+        limiter->acquire(nbytes_buffered_);
+    }
+
     auto connection = connection_pool_->get_connection();
 
     bool retval = false;
@@ -0,0 +1,211 @@
+#include "shard.verifier.hh"
+#include "definitions.hh"
+#include "file.handle.hh"
+#include "macros.hh"
+#include "zarr.common.hh"
+
+#include <crc32c/crc32c.h>
+
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+void*
+make_read_flags();
+
+void
+destroy_flags(void*);
+
+bool
+seek_and_read(void* handle, size_t offset, std::span<ByteSpan> buffers);
+
+bool
+lower_thread_priority();
+
+namespace {
+bool
+read_at(void* handle, size_t offset, ByteVector& data)
+{
+    ByteSpan buffer(data);
+    return seek_and_read(handle, offset, std::span(&buffer, 1));
+}
+} // namespace
+
+zarr::ShardVerifier::ShardVerifier(ErrorCallback&& err)
+  : error_handler_(std::move(err))
+  , finishing_(false)
+  , n_verified_(0)
+  , n_failed_(0)
+{
+    thread_ = std::thread([this] { run_(); });
+}
+
+zarr::ShardVerifier::~ShardVerifier() noexcept
+{
+    finish();
+}
+
+void
+zarr::ShardVerifier::enqueue(std::string_view path,
+                             uint64_t chunks_per_shard,
+                             bool chunk_checksums)
+{
+    if (path.starts_with("file://")) {
+        path.remove_prefix(7);
+    }
+
+    {
+        std::unique_lock lock(mutex_);
+        if (finishing_) {
+            return;
+        }
+        shards_.push_back(
+          { std::string(path), chunks_per_shard, chunk_checksums });
+    }
+    cv_.notify_one();
+}
+
+void
+zarr::ShardVerifier::finish()
+{
+    {
+        std::unique_lock lock(mutex_);
+        finishing_ = true;
+    }
+    cv_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+size_t
+zarr::ShardVerifier::shards_verified(size_t& n_failed) const
+{
+    std::unique_lock lock(mutex_);
+    n_failed = n_failed_;
+    return n_verified_;
+}
+
+bool
+zarr::ShardVerifier::verify(const std::string& path,
+                            uint64_t chunks_per_shard,
+                            bool chunk_checksums,
+                            std::string& error)
+{
+    std::error_code ec;
+    const auto shard_size = fs::file_size(path, ec);
+    if (ec) {
+        error = "Cannot read shard " + path + ": " + ec.message();
+        return false;
+    }
+
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+    ByteVector index(table_size + sizeof(uint32_t));
+    if (shard_size < index.size()) {
+        error = "Shard " + path + " is too small to hold its index";
+        return false;
+    }
+
+    const std::unique_ptr<void, decltype(&destroy_flags)> flags(
+      make_read_flags(), destroy_flags);
+    try {
+        FileHandle handle(path, flags.get());
+
+        const auto data_end = shard_size - index.size();
+        if (!read_at(handle.get(), data_end, index)) {
+            error = "Failed to read the index of shard " + path;
+            return false;
+        }
+
+        uint32_t checksum;
+        memcpy(&checksum, index.data() + table_size, sizeof(checksum));
+        if (crc32c::Crc32c(index.data(), table_size) != checksum) {
+            error = "Index checksum mismatch in shard " + path;
+            return false;
+        }
+
+        std::vector<uint64_t> table(2 * chunks_per_shard);
+        memcpy(table.data(), index.data(), table_size);
+
+        ByteVector chunk;
+        for (auto i = 0; i < chunks_per_shard; ++i) {
+            const auto offset = table[2 * i];
+            const auto nbytes = table[2 * i + 1];
+            if (nbytes == std::numeric_limits<uint64_t>::max()) {
+                continue; // never written
+            }
+
+            if (offset > data_end || nbytes > data_end - offset) {
+                error = "Chunk " + std::to_string(i) + " of shard " + path +
+                        " lies outside the shard";
+                return false;
+            }
+
+            if (!chunk_checksums) {
+                continue;
+            }
+
+            chunk.resize(nbytes);
+            if (!read_at(handle.get(), offset, chunk)) {
+                error = "Failed to read chunk " + std::to_string(i) +
+                        " of shard " + path;
+                return false;
+            }
+
+            if (!strip_crc32c(chunk)) {
+                error = "Checksum mismatch in chunk " + std::to_string(i) +
+                        " of shard " + path;
+                return false;
+            }
+        }
+    } catch (const std::exception& exc) {
+        error = "Failed to verify shard " + path + ": " + exc.what();
+        return false;
+    }
+
+    return true;
+}
+
+void
+zarr::ShardVerifier::run_()
+{
+    if (!lower_thread_priority()) {
+        LOG_DEBUG("Failed to lower the priority of the shard verifier");
+    }
+
+    while (true) {
+        Shard shard;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return finishing_ || !shards_.empty(); });
+            if (shards_.empty()) {
+                return; // finishing, and nothing left to verify
+            }
+
+            shard = std::move(shards_.front());
+            shards_.pop_front();
+        }
+
+        std::string error;
+        const auto success = verify(
+          shard.path, shard.chunks_per_shard, shard.chunk_checksums, error);
+
+        {
+            std::unique_lock lock(mutex_);
+            ++n_verified_;
+            n_failed_ += success ? 0 : 1;
+        }
+
+        if (!success) {
+            LOG_ERROR(error);
+            if (error_handler_) {
+                error_handler_(error);
+            }
+        }
+    }
+}
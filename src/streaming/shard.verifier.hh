@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace zarr {
+/**
+ * @brief Re-reads finalized shards in the background and checks them against
+ * their checksums.
+ * @details Each shard's index is checked against its crc32c and, for arrays
+ * written with chunk checksums, each chunk against the crc32c appended to it.
+ * Shards are verified one at a time on a single thread running at reduced
+ * priority, so verification doesn't compete with the writers.
+ */
+class ShardVerifier
+{
+  public:
+    using ErrorCallback = std::function<void(const std::string&)>;
+
+    // The error handler `err` is called with a description of each shard
+    // that fails verification.
+    explicit ShardVerifier(ErrorCallback&& err);
+    ~ShardVerifier() noexcept;
+
+    /**
+     * @brief Queue a finalized shard for verification.
+     * @param path The filesystem path to the shard.
+     * @param chunks_per_shard The number of chunks in the shard's index.
+     * @param chunk_checksums True if each chunk ends with its crc32c.
+     */
+    void enqueue(std::string_view path,
+                 uint64_t chunks_per_shard,
+                 bool chunk_checksums);
+
+    /**
+     * @brief Verify every shard queued so far, then stop the background
+     * thread. Shards queued afterwards are ignored.
+     */
+    void finish();
+
+    /**
+     * @brief Get the number of shards verified so far.
+     * @param[out] n_failed The number of those shards that failed.
+     * @return The number of shards verified, failed or not.
+     */
+    size_t shards_verified(size_t& n_failed) const;
+
+    /**
+     * @brief Verify a single shard.
+     * @param path The filesystem path to the shard.
+     * @param chunks_per_shard The number of chunks in the shard's index.
+     * @param chunk_checksums True if each chunk ends with its crc32c.
+     * @param[out] error A description of the first mismatch, on failure.
+     * @return True if the shard matches its checksums, false otherwise.
+     */
+    [[nodiscard]] static bool verify(const std::string& path,
+                                     uint64_t chunks_per_shard,
+                                     bool chunk_checksums,
+                                     std::string& error);
+
+  private:
+    struct Shard
+    {
+        std::string path;
+        uint64_t chunks_per_shard;
+        bool chunk_checksums;
+    };
+
+    ErrorCallback error_handler_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Shard> shards_;
+    bool finishing_;
+    size_t n_verified_;
+    size_t n_failed_;
+
+    std::thread thread_;
+
+    void run_();
+};
+} // namespace zarr
@@ -0,0 +1,191 @@
+#include "macros.hh"
+#include "statistics.hh"
+#include "zarr.common.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+zarr::PixelStatistics::PixelStatistics(ZarrDataType type,
+                                       uint8_t significant_bits)
+  : type_(type)
+  , histogram_shift_(0)
+  , histogram_min_(0)
+  , histogram_bins_(0)
+  , count_(0)
+  , min_(std::numeric_limits<double>::infinity())
+  , max_(-std::numeric_limits<double>::infinity())
+  , sum_(0)
+  , histogram_{}
+{
+    switch (type) {
+        case ZarrDataType_float32:
+        case ZarrDataType_float64:
+            return; // no histogram
+        case ZarrDataType_int8:
+        case ZarrDataType_int16:
+        case ZarrDataType_int32:
+        case ZarrDataType_int64:
+            histogram_min_ = -std::ldexp(1.0, 8 * bytes_of_type(type) - 1);
+            break;
+        default:
+            break;
+    }
+
+    const auto range_bits =
+      significant_bits > 0 ? significant_bits : 8 * bytes_of_type(type);
+    constexpr auto max_bin_bits = std::countr_zero(size_t{ ZARR_HISTOGRAM_BINS });
+    const auto bin_bits = std::min<size_t>(range_bits, max_bin_bits);
+
+    histogram_bins_ = size_t{ 1 } << bin_bits;
+    histogram_shift_ = range_bits - bin_bits;
+}
+
+void
+zarr::PixelStatistics::add(const uint8_t* pixels, size_t n_px)
+{
+    switch (type_) {
+        case ZarrDataType_uint8:
+            return add_(reinterpret_cast<const uint8_t*>(pixels), n_px);
+        case ZarrDataType_uint16:
+            return add_(reinterpret_cast<const uint16_t*>(pixels), n_px);
+        case ZarrDataType_uint32:
+            return add_(reinterpret_cast<const uint32_t*>(pixels), n_px);
+        case ZarrDataType_uint64:
+            return add_(reinterpret_cast<const uint64_t*>(pixels), n_px);
+        case ZarrDataType_int8:
+            return add_(reinterpret_cast<const int8_t*>(pixels), n_px);
+        case ZarrDataType_int16:
+            return add_(reinterpret_cast<const int16_t*>(pixels), n_px);
+        case ZarrDataType_int32:
+            return add_(reinterpret_cast<const int32_t*>(pixels), n_px);
+        case ZarrDataType_int64:
+            return add_(reinterpret_cast<const int64_t*>(pixels), n_px);
+        case ZarrDataType_float32:
+            return add_(reinterpret_cast<const float*>(pixels), n_px);
+        case ZarrDataType_float64:
+            return add_(reinterpret_cast<const double*>(pixels), n_px);
+        default:
+            throw std::invalid_argument("Invalid data type: " +
+                                        std::to_string(type_));
+    }
+}
+
+template<typename T>
+void
+zarr::PixelStatistics::add_(const T* pixels, size_t n_px)
+{
+    if (n_px == 0) {
+        return;
+    }
+
+    // narrow integers sum exactly; wide ones and floats go through double
+    using Sum = std::conditional_t<
+      std::is_floating_point_v<T> || sizeof(T) == 8,
+      double,
+      std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    // the chunk buffer may not be aligned for T
+    constexpr size_t block = 256;
+    T values[block];
+
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::lowest();
+    Sum sum = 0;
+
+    for (size_t i = 0; i < n_px; i += block) {
+        const auto m = std::min(block, n_px - i);
+        memcpy(values, pixels + i, m * sizeof(T));
+
+        for (size_t j = 0; j < m; ++j) {
+            lo = std::min(lo, values[j]);
+            hi = std::max(hi, values[j]);
+            sum += values[j];
+        }
+
+        if constexpr (std::is_integral_v<T>) {
+            // offset binary, so the most negative value lands in bin 0
+            using U = std::make_unsigned_t<T>;
+            constexpr U bias = std::is_signed_v<T>
+                                 ? U{ 1 } << (8 * sizeof(T) - 1)
+                                 : U{ 0 };
+            const auto last_bin = histogram_bins_ - 1;
+            for (size_t j = 0; j < m; ++j) {
+                const auto bin = static_cast<U>(static_cast<U>(values[j]) ^
+                                                bias) >>
+                                 histogram_shift_;
+                ++histogram_[std::min<size_t>(bin, last_bin)];
+            }
+        }
+    }
+
+    count_ += n_px;
+    min_ = std::min(min_, static_cast<double>(lo));
+    max_ = std::max(max_, static_cast<double>(hi));
+    sum_ += static_cast<double>(sum);
+}
+
+void
+zarr::PixelStatistics::merge(const PixelStatistics& other)
+{
+    EXPECT(other.type_ == type_, "Cannot merge statistics of another type");
+
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+    for (auto i = 0; i < histogram_bins_; ++i) {
+        histogram_[i] += other.histogram_[i];
+    }
+}
+
+void
+zarr::PixelStatistics::to_zarr(ZarrArrayStatistics& stats) const
+{
+    stats.count = count_;
+    stats.min = count_ > 0 ? min_ : 0;
+    stats.max = count_ > 0 ? max_ : 0;
+    stats.sum = sum_;
+    stats.histogram_min = histogram_min_;
+    stats.histogram_max =
+      histogram_min_ + std::ldexp(double(histogram_bins_), histogram_shift_);
+    stats.histogram_bins = histogram_bins_;
+    std::copy(histogram_.begin(), histogram_.end(), stats.histogram);
+}
+
+nlohmann::json
+zarr::PixelStatistics::to_json() const
+{
+    nlohmann::json stats = {
+        { "count", count_ },
+        { "sum", sum_ },
+    };
+
+    if (count_ > 0) {
+        stats["min"] = min_;
+        stats["max"] = max_;
+        stats["mean"] = sum_ / static_cast<double>(count_);
+    } else {
+        stats["min"] = nullptr;
+        stats["max"] = nullptr;
+        stats["mean"] = nullptr;
+    }
+
+    if (histogram_bins_ > 0) {
+        stats["histogram"] = {
+            { "min", histogram_min_ },
+            { "max",
+              histogram_min_ +
+                std::ldexp(double(histogram_bins_), histogram_shift_) },
+            { "counts",
+              std::vector<uint64_t>(histogram_.begin(),
+                                    histogram_.begin() + histogram_bins_) },
+        };
+    }
+
+    return stats;
+}
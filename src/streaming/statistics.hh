@@ -0,0 +1,57 @@
+#pragma once
+
+#include "zarr.types.h"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace zarr {
+/**
+ * @brief Running count, extrema, sum and coarse histogram of pixel values.
+ * @details Integer histograms cover the whole range of the data type, or the
+ * range of the significant bits when they're set, in ZARR_HISTOGRAM_BINS
+ * equal, power-of-two-wide bins. Floating point data has no histogram, since
+ * its range isn't known up front.
+ */
+class PixelStatistics
+{
+  public:
+    PixelStatistics(ZarrDataType type, uint8_t significant_bits);
+
+    /**
+     * @brief Accumulate a run of pixels.
+     * @param pixels The pixels, of the data type these statistics were made
+     * for.
+     * @param n_px The number of pixels.
+     */
+    void add(const uint8_t* pixels, size_t n_px);
+
+    /**
+     * @brief Fold another set of statistics for the same data type into this
+     * one.
+     * @param other The statistics to fold in.
+     */
+    void merge(const PixelStatistics& other);
+
+    void to_zarr(ZarrArrayStatistics& stats) const;
+    nlohmann::json to_json() const;
+
+  private:
+    ZarrDataType type_;
+    uint8_t histogram_shift_;   // bits dropped from a pixel to get its bin
+    double histogram_min_;      // the value of the first bin's lower edge
+    size_t histogram_bins_;     // fewer than ZARR_HISTOGRAM_BINS for narrow data
+
+    uint64_t count_;
+    double min_;
+    double max_;
+    double sum_;
+    std::array<uint64_t, ZARR_HISTOGRAM_BINS> histogram_;
+
+    template<typename T>
+    void add_(const T* pixels, size_t n_px);
+};
+} // namespace zarr
@@ -2,9 +2,13 @@
 
 #include <algorithm>
 
+namespace {
+// the pool whose worker is running on this thread, if any
+thread_local const zarr::ThreadPool* current_pool = nullptr;
+} // namespace
+
 zarr::ThreadPool::ThreadPool(unsigned int n_threads, ErrorCallback&& err)
   : error_handler_{ std::move(err) }
-  , main_thread_id_(std::this_thread::get_id())
 {
     // hardware_concurrency() can return 0 if not computable
     const auto max_threads = std::max(std::thread::hardware_concurrency(), 1u);
@@ -34,8 +38,8 @@ bool
 zarr::ThreadPool::push_job(Task&& job)
 {
     std::unique_lock lock(jobs_mutex_);
-    // only allow pushing jobs from the main thread
-    if (!accepting_jobs || std::this_thread::get_id() != main_thread_id_) {
+    // don't allow workers to push jobs they might then wait on
+    if (!accepting_jobs || current_pool == this) {
         return false;
     }
 
@@ -84,6 +88,8 @@ zarr::ThreadPool::should_stop_() const noexcept
 void
 zarr::ThreadPool::process_tasks_()
 {
+    current_pool = this;
+
     while (true) {
         std::unique_lock lock(jobs_mutex_);
         jobs_cv_.wait(lock, [&] { return should_stop_() || !jobs_.empty(); });
@@ -25,6 +25,9 @@ class ThreadPool
 
     /**
      * @brief Push a job onto the job queue.
+     * @details Jobs may be pushed from any thread except the pool's own
+     * workers, which would otherwise risk waiting on jobs that no free worker
+     * can pick up. Callers on a worker thread should run the job inline.
      *
      * @param job The job to push onto the queue.
      * @return true if the job was successfully pushed onto the queue, false
@@ -48,8 +51,6 @@ class ThreadPool
   private:
     ErrorCallback error_handler_;
 
-    std::thread::id main_thread_id_;
-
     std::vector<std::thread> threads_;
 
     std::atomic<bool> accepting_jobs{ true };
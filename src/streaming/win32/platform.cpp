@@ -42,6 +42,14 @@ make_flags()
     return flags;
 }
 
+void*
+make_read_flags()
+{
+    auto* flags = new DWORD;
+    *flags = FILE_FLAG_OVERLAPPED | FILE_ATTRIBUTE_READONLY;
+    return flags;
+}
+
 void
 destroy_flags(void* flags)
 {
@@ -58,13 +66,18 @@ get_max_active_handles()
 void*
 init_handle(const std::string& filename, void* flags)
 {
+    // read-only flags open an existing file for reading, shared with writers
+    const auto file_flags = *static_cast<DWORD*>(flags);
+    const bool read_only = file_flags & FILE_ATTRIBUTE_READONLY;
+
     auto* fd = new HANDLE;
     *fd = CreateFileA(filename.c_str(),
-                      GENERIC_WRITE,
-                      0, // No sharing
+                      read_only ? GENERIC_READ : GENERIC_WRITE,
+                      read_only ? FILE_SHARE_READ | FILE_SHARE_WRITE
+                                : 0, // No sharing
                       nullptr,
-                      OPEN_ALWAYS,
-                      *static_cast<DWORD*>(flags),
+                      read_only ? OPEN_EXISTING : OPEN_ALWAYS,
+                      file_flags & ~FILE_ATTRIBUTE_READONLY,
                       nullptr);
 
     if (*fd == INVALID_HANDLE_VALUE) {
@@ -117,6 +130,45 @@ seek_and_write(void* handle, size_t offset, ConstByteSpan data)
     return retries < max_retries;
 }
 
+bool
+seek_and_read(void* handle, size_t offset, std::span<ByteSpan> buffers)
+{
+    CHECK(handle);
+    const auto* fd = static_cast<HANDLE*>(handle);
+
+    OVERLAPPED overlapped = { 0 };
+    overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+    bool success = true;
+    for (auto buffer : buffers) {
+        auto* cur = reinterpret_cast<char*>(buffer.data());
+        auto* end = cur + buffer.size();
+
+        while (success && cur < end) {
+            DWORD n_read = 0;
+            const auto remaining = static_cast<DWORD>(end - cur); // may truncate
+            overlapped.Pointer = reinterpret_cast<void*>(offset);
+            if (!ReadFile(*fd, cur, remaining, nullptr, &overlapped) &&
+                GetLastError() != ERROR_IO_PENDING) {
+                LOG_ERROR("Failed to read from file: ",
+                          get_last_error_as_string());
+                success = false;
+            } else if (!GetOverlappedResult(*fd, &overlapped, &n_read, TRUE)) {
+                LOG_ERROR("Failed to get overlapped result: ",
+                          get_last_error_as_string());
+                success = false;
+            } else if (n_read == 0) {
+                success = false; // end of file
+            }
+            offset += n_read;
+            cur += n_read;
+        }
+    }
+
+    CloseHandle(overlapped.hEvent);
+    return success;
+}
+
 bool
 flush_file(void* handle)
 {
@@ -138,4 +190,10 @@ destroy_handle(void* handle)
         }
         delete fd;
     }
-}
\ No newline at end of file
+}
+bool
+lower_thread_priority()
+{
+    return SetThreadPriority(GetCurrentThread(),
+                             THREAD_PRIORITY_BELOW_NORMAL) != 0;
+}
@@ -2,9 +2,18 @@
 #include "zarr.common.hh"
 
 #include <blosc.h>
+#include <crc32c/crc32c.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <regex>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace fs = std::filesystem;
 
@@ -67,6 +76,52 @@ zarr::bytes_of_type(ZarrDataType data_type)
     }
 }
 
+std::string
+zarr::sample_type_to_dtype(ZarrDataType t)
+{
+    switch (t) {
+        case ZarrDataType_uint8:
+            return "uint8";
+        case ZarrDataType_uint16:
+            return "uint16";
+        case ZarrDataType_uint32:
+            return "uint32";
+        case ZarrDataType_uint64:
+            return "uint64";
+        case ZarrDataType_int8:
+            return "int8";
+        case ZarrDataType_int16:
+            return "int16";
+        case ZarrDataType_int32:
+            return "int32";
+        case ZarrDataType_int64:
+            return "int64";
+        case ZarrDataType_float32:
+            return "float32";
+        case ZarrDataType_float64:
+            return "float64";
+        default:
+            throw std::runtime_error("Invalid ZarrDataType: " +
+                                     std::to_string(static_cast<int>(t)));
+    }
+}
+
+std::string
+zarr::shuffle_to_string(uint8_t shuffle)
+{
+    switch (shuffle) {
+        case 0:
+            return "noshuffle";
+        case 1:
+            return "shuffle";
+        case 2:
+            return "bitshuffle";
+        default:
+            throw std::runtime_error("Invalid shuffle value: " +
+                                     std::to_string(shuffle));
+    }
+}
+
 size_t
 zarr::bytes_of_frame(const ArrayDimensions& dims, ZarrDataType type)
 {
@@ -135,6 +190,675 @@ zarr::compress_in_place(ByteVector& data,
     return true;
 }
 
+namespace {
+// pixel groups of the packed formats, each unpacked on its own so the loop over
+// whole groups vectorizes
+struct Mono10p
+{
+    static constexpr size_t group_px = 4, group_bytes = 5;
+
+    static void unpack(const uint8_t* in, uint16_t* out)
+    {
+        out[0] = in[0] | (in[1] & 0x03) << 8;
+        out[1] = in[1] >> 2 | (in[2] & 0x0f) << 6;
+        out[2] = in[2] >> 4 | (in[3] & 0x3f) << 4;
+        out[3] = in[3] >> 6 | in[4] << 2;
+    }
+};
+
+struct Mono12p
+{
+    static constexpr size_t group_px = 2, group_bytes = 3;
+
+    static void unpack(const uint8_t* in, uint16_t* out)
+    {
+        out[0] = in[0] | (in[1] & 0x0f) << 8;
+        out[1] = in[1] >> 4 | in[2] << 4;
+    }
+};
+
+struct Mono12Packed
+{
+    static constexpr size_t group_px = 2, group_bytes = 3;
+
+    static void unpack(const uint8_t* in, uint16_t* out)
+    {
+        out[0] = in[0] << 4 | (in[1] & 0x0f);
+        out[1] = in[2] << 4 | in[1] >> 4;
+    }
+};
+
+template<typename Format>
+void
+unpack_run(const uint8_t* packed, size_t first_px, size_t n_px, uint16_t* out)
+{
+    constexpr auto G = Format::group_px;
+    constexpr auto B = Format::group_bytes;
+
+    const auto* in = packed + first_px / G * B;
+    uint16_t group[G];
+
+    // a run starting partway into a group
+    if (const auto skip = first_px % G; skip > 0 && n_px > 0) {
+        Format::unpack(in, group);
+        const auto n = std::min(G - skip, n_px);
+        std::copy_n(group + skip, n, out);
+        in += B;
+        out += n;
+        n_px -= n;
+    }
+
+    const auto n_groups = n_px / G;
+    for (size_t i = 0; i < n_groups; ++i) {
+        Format::unpack(in + i * B, out + i * G);
+    }
+
+    // a run ending partway into a group
+    if (const auto rest = n_px % G; rest > 0) {
+        Format::unpack(in + n_groups * B, group);
+        std::copy_n(group, rest, out + n_groups * G);
+    }
+}
+
+// eight packbits samples of Bits bits fill exactly Bits bytes, so each group
+// is packed on its own with constant shifts, and the loop over whole groups
+// vectorizes like the camera formats above
+template<typename T, size_t Bits>
+struct PackedGroup
+{
+    static constexpr size_t group_px = 8, group_bytes = Bits;
+    static constexpr size_t n_words = (group_px * Bits + 63) / 64;
+    static constexpr uint64_t mask = (uint64_t{ 1 } << Bits) - 1;
+
+    template<size_t J>
+    static void pack_sample(const T* in, uint64_t* words)
+    {
+        constexpr auto word = J * Bits / 64, shift = J * Bits % 64;
+        const uint64_t value = in[J] & mask;
+        words[word] |= value << shift;
+        if constexpr (shift + Bits > 64) {
+            words[word + 1] |= value >> (64 - shift);
+        }
+    }
+
+    template<size_t J>
+    static void unpack_sample(const uint64_t* words, T* out)
+    {
+        constexpr auto word = J * Bits / 64, shift = J * Bits % 64;
+        uint64_t value = words[word] >> shift;
+        if constexpr (shift + Bits > 64) {
+            value |= words[word + 1] << (64 - shift);
+        }
+        out[J] = static_cast<T>(value & mask);
+    }
+
+    static void pack(const T* in, uint8_t* out)
+    {
+        uint64_t words[n_words] = {};
+        [&]<size_t... J>(std::index_sequence<J...>) {
+            (pack_sample<J>(in, words), ...);
+        }(std::make_index_sequence<group_px>{});
+        memcpy(out, words, group_bytes);
+    }
+
+    static void unpack(const uint8_t* in, T* out)
+    {
+        uint64_t words[n_words] = {};
+        memcpy(words, in, group_bytes);
+        [&]<size_t... J>(std::index_sequence<J...>) {
+            (unpack_sample<J>(words, out), ...);
+        }(std::make_index_sequence<group_px>{});
+    }
+};
+
+template<typename T, size_t Bits>
+void
+pack_bits_run(const T* in, size_t n, uint8_t* out)
+{
+    using Group = PackedGroup<T, Bits>;
+    constexpr auto G = Group::group_px;
+    constexpr auto B = Group::group_bytes;
+
+    const auto n_groups = n / G;
+    for (size_t i = 0; i < n_groups; ++i) {
+        Group::pack(in + i * G, out + i * B);
+    }
+
+    // a stream ending partway into a group, zero-padded
+    if (const auto rest = n % G; rest > 0) {
+        T group[G] = {};
+        uint8_t bytes[B];
+        std::copy_n(in + n_groups * G, rest, group);
+        Group::pack(group, bytes);
+        std::copy_n(bytes, (rest * Bits + 7) / 8, out + n_groups * B);
+    }
+}
+
+template<typename T, size_t Bits>
+void
+unpack_bits_run(const uint8_t* in, size_t n, T* out)
+{
+    using Group = PackedGroup<T, Bits>;
+    constexpr auto G = Group::group_px;
+    constexpr auto B = Group::group_bytes;
+
+    const auto n_groups = n / G;
+    for (size_t i = 0; i < n_groups; ++i) {
+        Group::unpack(in + i * B, out + i * G);
+    }
+
+    if (const auto rest = n % G; rest > 0) {
+        uint8_t bytes[B] = {};
+        T group[G];
+        std::copy_n(in + n_groups * B, (rest * Bits + 7) / 8, bytes);
+        Group::unpack(bytes, group);
+        std::copy_n(group, rest, out + n_groups * G);
+    }
+}
+
+// one kernel per bit width, indexed by bits - 1
+template<typename T, size_t... I>
+constexpr auto
+make_pack_runs(std::index_sequence<I...>)
+{
+    return std::array{ &pack_bits_run<T, I + 1>... };
+}
+
+template<typename T, size_t... I>
+constexpr auto
+make_unpack_runs(std::index_sequence<I...>)
+{
+    return std::array{ &unpack_bits_run<T, I + 1>... };
+}
+
+template<typename T>
+void
+check_bits(uint8_t bits)
+{
+    if (bits == 0 || bits > 8 * sizeof(T)) {
+        throw std::invalid_argument("Invalid number of significant bits: " +
+                                    std::to_string(bits));
+    }
+}
+
+template<typename T>
+ByteVector
+pack_elements(const ByteVector& data, uint8_t bits)
+{
+    static constexpr auto runs =
+      make_pack_runs<T>(std::make_index_sequence<8 * sizeof(T)>{});
+    check_bits<T>(bits);
+
+    const auto n = data.size() / sizeof(T);
+    ByteVector packed((n * bits + 7) / 8);
+    runs[bits - 1](reinterpret_cast<const T*>(data.data()), n, packed.data());
+
+    return packed;
+}
+
+template<typename T>
+ByteVector
+unpack_elements(const ByteVector& data, uint8_t bits, size_t n)
+{
+    static constexpr auto runs =
+      make_unpack_runs<T>(std::make_index_sequence<8 * sizeof(T)>{});
+    check_bits<T>(bits);
+
+    ByteVector unpacked(n * sizeof(T));
+    runs[bits - 1](data.data(), n, reinterpret_cast<T*>(unpacked.data()));
+
+    return unpacked;
+}
+
+template<typename Out>
+Out
+saturate(double value)
+{
+    if constexpr (std::is_floating_point_v<Out>) {
+        return static_cast<Out>(value);
+    } else {
+        // compare in double, where the bounds of 64-bit types round outward
+        constexpr auto lo = static_cast<double>(std::numeric_limits<Out>::min());
+        constexpr auto hi = static_cast<double>(std::numeric_limits<Out>::max());
+        if (!(value > lo)) { // also catches NaN
+            return value != value ? Out{ 0 } : std::numeric_limits<Out>::min();
+        }
+        if (value >= hi) {
+            return std::numeric_limits<Out>::max();
+        }
+        return static_cast<Out>(std::nearbyint(value));
+    }
+}
+
+template<typename In, typename Out>
+void
+convert_run(const uint8_t* in_bytes,
+            uint8_t* out_bytes,
+            size_t n,
+            const ZarrInputConversion& conversion)
+{
+    // the input may start anywhere in a frame and the output anywhere in a
+    // chunk, so go through aligned stack blocks
+    constexpr size_t block = 256;
+    In in[block];
+    Out out[block];
+
+    const auto shift = conversion.right_shift;
+    const auto scale = conversion.scale;
+    const auto offset = conversion.offset;
+    const bool shift_only = scale == 1.0 && offset == 0.0;
+
+    for (size_t i = 0; i < n; i += block) {
+        const auto m = std::min(block, n - i);
+        memcpy(in, in_bytes + i * sizeof(In), m * sizeof(In));
+
+        if constexpr (std::is_integral_v<In> && std::is_integral_v<Out>) {
+            if (shift_only) {
+                // integer to integer needs no floating point at all
+                for (size_t j = 0; j < m; ++j) {
+                    const auto value = in[j] >> shift;
+                    out[j] = std::cmp_less(value,
+                                           std::numeric_limits<Out>::min())
+                               ? std::numeric_limits<Out>::min()
+                             : std::cmp_greater(value,
+                                                std::numeric_limits<Out>::max())
+                               ? std::numeric_limits<Out>::max()
+                               : static_cast<Out>(value);
+                }
+                memcpy(out_bytes + i * sizeof(Out), out, m * sizeof(Out));
+                continue;
+            }
+        }
+
+        for (size_t j = 0; j < m; ++j) {
+            double value;
+            if constexpr (std::is_integral_v<In>) {
+                value = static_cast<double>(in[j] >> shift);
+            } else {
+                value = static_cast<double>(in[j]);
+            }
+            out[j] = saturate<Out>(value * scale + offset);
+        }
+        memcpy(out_bytes + i * sizeof(Out), out, m * sizeof(Out));
+    }
+}
+
+// adds each run of factor neighbouring samples in a row to its output pixel;
+// a nonzero Factor fixes the run length so that the inner loop unrolls
+template<uint32_t Factor, typename T, typename Acc>
+void
+bin_row(const T* in, size_t m, uint32_t factor, Acc* acc)
+{
+    const uint32_t f = Factor > 0 ? Factor : factor;
+    for (size_t j = 0; j < m; ++j) {
+        Acc sum{ 0 };
+        for (uint32_t q = 0; q < f; ++q) {
+            sum += in[j * f + q];
+        }
+        acc[j] += sum;
+    }
+}
+
+template<typename T>
+void
+bin_run(const uint8_t* rows,
+        size_t n_px,
+        uint32_t factor,
+        ZarrBinningMethod method,
+        uint8_t* out_bytes)
+{
+    // integers accumulate exactly, in the widest type of their signedness
+    using Acc = std::conditional_t<
+      std::is_floating_point_v<T>,
+      double,
+      std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    constexpr size_t block = 256;
+    Acc acc[block];
+    T out[block];
+
+    // the rows were decoded into an aligned scratch buffer, so read in place
+    const auto* in = reinterpret_cast<const T*>(rows);
+    const auto row_px = n_px * factor;
+    const auto n_binned = static_cast<double>(factor) * factor;
+
+    for (size_t i = 0; i < n_px; i += block) {
+        const auto m = std::min(block, n_px - i);
+        std::fill_n(acc, m, Acc{ 0 });
+
+        for (auto k = 0; k < factor; ++k) {
+            const auto* row = in + k * row_px + i * factor;
+            switch (factor) {
+                case 2:
+                    bin_row<2>(row, m, factor, acc);
+                    break;
+                case 4:
+                    bin_row<4>(row, m, factor, acc);
+                    break;
+                default:
+                    bin_row<0>(row, m, factor, acc);
+                    break;
+            }
+        }
+
+        for (size_t j = 0; j < m; ++j) {
+            const auto value = static_cast<double>(acc[j]);
+            out[j] = saturate<T>(method == ZarrBinningMethod_Mean
+                                   ? value / n_binned
+                                   : value);
+        }
+        memcpy(out_bytes + i * sizeof(T), out, m * sizeof(T));
+    }
+}
+} // namespace
+
+void
+zarr::pack_bits(ByteVector& data, ZarrDataType type, uint8_t bits)
+{
+    switch (type) {
+        case ZarrDataType_uint8:
+            data = pack_elements<uint8_t>(data, bits);
+            break;
+        case ZarrDataType_uint16:
+            data = pack_elements<uint16_t>(data, bits);
+            break;
+        case ZarrDataType_uint32:
+            data = pack_elements<uint32_t>(data, bits);
+            break;
+        default:
+            throw std::invalid_argument("Cannot pack bits of data type " +
+                                        std::to_string(type));
+    }
+}
+
+bool
+zarr::unpack_bits(ByteVector& data,
+                  ZarrDataType type,
+                  uint8_t bits,
+                  size_t n_elements)
+{
+    if (data.size() != (n_elements * bits + 7) / 8) {
+        return false;
+    }
+
+    switch (type) {
+        case ZarrDataType_uint8:
+            data = unpack_elements<uint8_t>(data, bits, n_elements);
+            break;
+        case ZarrDataType_uint16:
+            data = unpack_elements<uint16_t>(data, bits, n_elements);
+            break;
+        case ZarrDataType_uint32:
+            data = unpack_elements<uint32_t>(data, bits, n_elements);
+            break;
+        default:
+            throw std::invalid_argument("Cannot unpack bits of data type " +
+                                        std::to_string(type));
+    }
+
+    return true;
+}
+
+size_t
+zarr::bytes_of_pixels(ZarrPixelFormat format,
+                      size_t n_px,
+                      ZarrDataType data_type)
+{
+    switch (format) {
+        case ZarrPixelFormat_Native:
+            return n_px * bytes_of_type(data_type);
+        case ZarrPixelFormat_Mono10p:
+            return (n_px + 3) / 4 * 5;
+        case ZarrPixelFormat_Mono12p:
+        case ZarrPixelFormat_Mono12Packed:
+            return (n_px + 1) / 2 * 3;
+        default:
+            throw std::invalid_argument("Invalid pixel format: " +
+                                        std::to_string(format));
+    }
+}
+
+void
+zarr::unpack_pixels(ZarrPixelFormat format,
+                    const uint8_t* packed,
+                    size_t first_px,
+                    size_t n_px,
+                    uint16_t* out)
+{
+    switch (format) {
+        case ZarrPixelFormat_Mono10p:
+            unpack_run<Mono10p>(packed, first_px, n_px, out);
+            break;
+        case ZarrPixelFormat_Mono12p:
+            unpack_run<Mono12p>(packed, first_px, n_px, out);
+            break;
+        case ZarrPixelFormat_Mono12Packed:
+            unpack_run<Mono12Packed>(packed, first_px, n_px, out);
+            break;
+        default:
+            throw std::invalid_argument("Not a packed pixel format: " +
+                                        std::to_string(format));
+    }
+}
+
+void
+zarr::convert_samples(const uint8_t* in,
+                      uint8_t* out,
+                      size_t n,
+                      ZarrDataType out_type,
+                      const ZarrInputConversion& conversion)
+{
+    visit_type(conversion.data_type, [&]<typename In>(In) {
+        visit_type(out_type, [&]<typename Out>(Out) {
+            convert_run<In, Out>(in, out, n, conversion);
+        });
+    });
+}
+
+void
+zarr::decode_pixels(ZarrPixelFormat format,
+                    const std::optional<ZarrInputConversion>& conversion,
+                    ZarrDataType type,
+                    const uint8_t* frame,
+                    size_t first_px,
+                    size_t n_px,
+                    uint8_t* out)
+{
+    if (!conversion) {
+        if (format == ZarrPixelFormat_Native) {
+            const auto bytes_per_px = bytes_of_type(type);
+            memcpy(out, frame + first_px * bytes_per_px, n_px * bytes_per_px);
+        } else {
+            unpack_pixels(
+              format, frame, first_px, n_px, reinterpret_cast<uint16_t*>(out));
+        }
+        return;
+    }
+
+    if (format == ZarrPixelFormat_Native) {
+        convert_samples(frame + first_px * bytes_of_type(conversion->data_type),
+                        out,
+                        n_px,
+                        type,
+                        *conversion);
+        return;
+    }
+
+    // unpack a row at a time into a scratch buffer, then convert
+    thread_local std::vector<uint16_t> unpacked;
+    unpacked.resize(n_px);
+    unpack_pixels(format, frame, first_px, n_px, unpacked.data());
+    convert_samples(reinterpret_cast<const uint8_t*>(unpacked.data()),
+                    out,
+                    n_px,
+                    type,
+                    *conversion);
+}
+
+void
+zarr::reduce_pixels(const ZarrFrameReduction& reduction,
+                    ZarrPixelFormat format,
+                    const std::optional<ZarrInputConversion>& conversion,
+                    ZarrDataType type,
+                    const uint8_t* frame,
+                    size_t row,
+                    size_t first_col,
+                    size_t n_px,
+                    uint8_t* out)
+{
+    const auto factor = reduction.binning;
+    const auto first_px = (reduction.roi_y + row * factor) *
+                            size_t{ reduction.frame_width } +
+                          reduction.roi_x + first_col * factor;
+    if (factor == 1) {
+        decode_pixels(format, conversion, type, frame, first_px, n_px, out);
+        return;
+    }
+
+    // decode the rows being binned together, then bin them
+    const auto bytes_per_row = n_px * factor * bytes_of_type(type);
+    thread_local ByteVector rows;
+    rows.resize(factor * bytes_per_row);
+    for (auto k = 0; k < factor; ++k) {
+        decode_pixels(format,
+                      conversion,
+                      type,
+                      frame,
+                      first_px + k * size_t{ reduction.frame_width },
+                      n_px * factor,
+                      rows.data() + k * bytes_per_row);
+    }
+
+    visit_type(type, [&]<typename T>(T) {
+        bin_run<T>(rows.data(), n_px, factor, reduction.binning_method, out);
+    });
+}
+
+void
+zarr::decode_frame(ZarrPixelFormat format,
+                   const std::optional<ZarrInputConversion>& conversion,
+                   const std::optional<ZarrFrameReduction>& reduction,
+                   ZarrDataType type,
+                   size_t rows,
+                   size_t cols,
+                   const uint8_t* frame,
+                   uint8_t* out)
+{
+    const auto bytes_per_row = cols * bytes_of_type(type);
+    for (size_t row = 0; row < rows; ++row) {
+        if (reduction) {
+            reduce_pixels(*reduction,
+                          format,
+                          conversion,
+                          type,
+                          frame,
+                          row,
+                          0,
+                          cols,
+                          out + row * bytes_per_row);
+        } else {
+            decode_pixels(format,
+                          conversion,
+                          type,
+                          frame,
+                          row * cols,
+                          cols,
+                          out + row * bytes_per_row);
+        }
+    }
+}
+
+bool
+zarr::blosc_decompressed_size(ConstByteSpan data, size_t& n_bytes)
+{
+    n_bytes = 0;
+    return !data.empty() &&
+           blosc_cbuffer_validate(data.data(), data.size(), &n_bytes) == 0;
+}
+
+bool
+zarr::blosc_matches(ConstByteSpan data,
+                    const BloscCompressionParams& params,
+                    size_t type_size,
+                    std::string& error)
+{
+    size_t buffer_type_size;
+    int flags;
+    blosc_cbuffer_metainfo(data.data(), &buffer_type_size, &flags);
+
+    // a buffer Blosc stored as is decodes the same under any parameters
+    if (flags & BLOSC_MEMCPYED) {
+        return true;
+    }
+
+    char* complib = nullptr;
+    char* version = nullptr;
+    if (blosc_get_complib_info(params.codec_id.c_str(), &complib, &version) <
+        0) {
+        error = "Unknown Blosc codec " + params.codec_id;
+        return false;
+    }
+    const std::string expected_complib(complib);
+    free(complib);
+    free(version);
+
+    if (const std::string buffer_complib(blosc_cbuffer_complib(data.data()));
+        buffer_complib != expected_complib) {
+        error = "Expected a chunk compressed with " + expected_complib +
+                ", got " + buffer_complib;
+        return false;
+    }
+
+    int shuffle = BLOSC_NOSHUFFLE;
+    if (flags & BLOSC_DOSHUFFLE) {
+        shuffle = BLOSC_SHUFFLE;
+    } else if (flags & BLOSC_DOBITSHUFFLE) {
+        shuffle = BLOSC_BITSHUFFLE;
+    }
+    if (shuffle != params.shuffle) {
+        error = "Expected a chunk with shuffle " +
+                std::to_string(params.shuffle) + ", got " +
+                std::to_string(shuffle);
+        return false;
+    }
+
+    if (buffer_type_size != type_size) {
+        error = "Expected a chunk with type size " + std::to_string(type_size) +
+                ", got " + std::to_string(buffer_type_size);
+        return false;
+    }
+
+    return true;
+}
+
+void
+zarr::append_crc32c(ByteVector& data)
+{
+    // the library picks the hardware CRC32C instruction when there is one
+    const uint32_t checksum = crc32c::Crc32c(data.data(), data.size());
+    const auto size = data.size();
+    data.resize(size + sizeof(checksum));
+    memcpy(data.data() + size, &checksum, sizeof(checksum));
+}
+
+bool
+zarr::strip_crc32c(ByteVector& data)
+{
+    if (data.size() < sizeof(uint32_t)) {
+        return false;
+    }
+
+    const auto size = data.size() - sizeof(uint32_t);
+    uint32_t checksum;
+    memcpy(&checksum, data.data() + size, sizeof(checksum));
+    if (crc32c::Crc32c(data.data(), size) != checksum) {
+        return false;
+    }
+
+    data.resize(size);
+    return true;
+}
+
 std::string
 zarr::regularize_key(const char* key)
 {
@@ -6,6 +6,9 @@
 #include "definitions.hh"
 #include "blosc.compression.params.hh"
 
+#include <stdexcept>
+#include <string>
+
 namespace zarr {
 /**
  * @brief Trim whitespace from a string.
@@ -34,6 +37,25 @@ is_empty_string(std::string_view s, std::string_view err_on_empty);
 size_t
 bytes_of_type(ZarrDataType data_type);
 
+/**
+ * @brief Get the Zarr V3 name of a data type, e.g., "uint16".
+ * @param t The data type.
+ * @return The name of the data type.
+ * @throw std::runtime_error if the data type is not recognized.
+ */
+std::string
+sample_type_to_dtype(ZarrDataType t);
+
+/**
+ * @brief Get the name of a Blosc shuffle mode, as it appears in the blosc
+ * codec configuration.
+ * @param shuffle The shuffle mode, 0, 1, or 2.
+ * @return The name of the shuffle mode.
+ * @throw std::runtime_error if the shuffle mode is not recognized.
+ */
+std::string
+shuffle_to_string(uint8_t shuffle);
+
 /**
  * @brief Get the number of bytes for a frame with the given dimensions and
  * data type.
@@ -45,6 +67,140 @@ bytes_of_type(ZarrDataType data_type);
 size_t
 bytes_of_frame(const ArrayDimensions& dims, ZarrDataType type);
 
+/**
+ * @brief Get the number of bytes @p n_px pixels take up in the given pixel
+ * format, including padding in a trailing, partial pixel group.
+ * @param format The pixel format.
+ * @param n_px The number of pixels.
+ * @param data_type The data type, for ZarrPixelFormat_Native.
+ * @return The number of bytes.
+ * @throw std::invalid_argument if the pixel format is not recognized.
+ */
+size_t
+bytes_of_pixels(ZarrPixelFormat format, size_t n_px, ZarrDataType data_type);
+
+/**
+ * @brief Unpack a run of pixels from a packed pixel stream to 16-bit pixels.
+ * @param format The packed pixel format.
+ * @param packed The start of the packed pixel stream.
+ * @param first_px The index in the stream of the first pixel to unpack.
+ * @param n_px The number of pixels to unpack.
+ * @param out Receives the @p n_px unpacked pixels.
+ * @throw std::invalid_argument if @p format is not a packed format.
+ */
+void
+unpack_pixels(ZarrPixelFormat format,
+              const uint8_t* packed,
+              size_t first_px,
+              size_t n_px,
+              uint16_t* out);
+
+/**
+ * @brief Convert samples to another data type, as (x >> right_shift) * scale
+ * + offset, rounded to nearest and saturated to @p out_type.
+ * @param in The samples to convert, of type @p conversion.data_type.
+ * @param out Receives the @p n converted samples.
+ * @param n The number of samples.
+ * @param out_type The data type to convert to.
+ * @param conversion The input data type, shift, scale and offset.
+ * @throw std::invalid_argument if either data type is not recognized.
+ */
+void
+convert_samples(const uint8_t* in,
+                uint8_t* out,
+                size_t n,
+                ZarrDataType out_type,
+                const ZarrInputConversion& conversion);
+
+/**
+ * @brief Decode a run of pixels of an appended frame into @p type, unpacking
+ * and converting them as needed.
+ * @param format The pixel format of the frame.
+ * @param conversion The conversion from the appended data type, if any.
+ * @param type The data type of the decoded pixels.
+ * @param frame The start of the frame.
+ * @param first_px The index in the frame of the first pixel to decode.
+ * @param n_px The number of pixels to decode.
+ * @param out Receives the @p n_px decoded pixels.
+ */
+void
+decode_pixels(ZarrPixelFormat format,
+              const std::optional<ZarrInputConversion>& conversion,
+              ZarrDataType type,
+              const uint8_t* frame,
+              size_t first_px,
+              size_t n_px,
+              uint8_t* out);
+
+/**
+ * @brief Crop, decode and bin a run of pixels of a stored frame row out of an
+ * appended frame.
+ * @param reduction The crop window and binning factor.
+ * @param format The pixel format of the frame.
+ * @param conversion The conversion from the appended data type, if any.
+ * @param type The data type of the decoded pixels.
+ * @param frame The start of the appended frame.
+ * @param row The row of the stored frame.
+ * @param first_col The column of the stored frame to start at.
+ * @param n_px The number of stored pixels to produce.
+ * @param out Receives the @p n_px pixels.
+ */
+void
+reduce_pixels(const ZarrFrameReduction& reduction,
+              ZarrPixelFormat format,
+              const std::optional<ZarrInputConversion>& conversion,
+              ZarrDataType type,
+              const uint8_t* frame,
+              size_t row,
+              size_t first_col,
+              size_t n_px,
+              uint8_t* out);
+
+/**
+ * @brief Decode a whole appended frame into a stored frame of @p rows x
+ * @p cols pixels of @p type.
+ * @param format The pixel format of the frame.
+ * @param conversion The conversion from the appended data type, if any.
+ * @param reduction The crop window and binning factor, if any.
+ * @param type The data type of the decoded pixels.
+ * @param rows The number of rows in the stored frame.
+ * @param cols The number of columns in the stored frame.
+ * @param frame The start of the appended frame.
+ * @param out Receives the stored frame.
+ */
+void
+decode_frame(ZarrPixelFormat format,
+             const std::optional<ZarrInputConversion>& conversion,
+             const std::optional<ZarrFrameReduction>& reduction,
+             ZarrDataType type,
+             size_t rows,
+             size_t cols,
+             const uint8_t* frame,
+             uint8_t* out);
+
+/**
+ * @brief Pack the low @p bits bits of each element of @p data into a little
+ * endian bit stream, as the packbits codec does.
+ * @param data The elements to pack. Replaced by the packed bytes.
+ * @param type The data type of the elements. Must be uint8, uint16, or uint32.
+ * @param bits The number of bits to keep per element. Higher bits are dropped.
+ * @throw std::invalid_argument if @p type is not supported.
+ */
+void
+pack_bits(ByteVector& data, ZarrDataType type, uint8_t bits);
+
+/**
+ * @brief Unpack a little endian bit stream of @p bits bits per element.
+ * @param data The packed bytes. Replaced by the unpacked elements.
+ * @param type The data type of the elements. Must be uint8, uint16, or uint32.
+ * @param bits The number of bits per element in the stream.
+ * @param n_elements The number of elements to unpack.
+ * @return True if @p data holds @p n_elements elements, false otherwise.
+ * @throw std::invalid_argument if @p type is not supported.
+ */
+[[nodiscard]] bool
+unpack_bits(ByteVector& data, ZarrDataType type, uint8_t bits, size_t n_elements);
+
 /**
  * @brief Get the number of chunks along a dimension.
  * @param array_size Size of the array along the dimension, in pixels.
@@ -86,6 +242,49 @@ compress_in_place(ByteVector& data,
                   const BloscCompressionParams& params,
                   size_t type_size);
 
+/**
+ * @brief Check that @p data is a valid Blosc buffer and get its size once
+ * decompressed.
+ * @param data The compressed buffer.
+ * @param[out] n_bytes The size of the decompressed data, in bytes.
+ * @return true if @p data is a valid Blosc buffer, false otherwise.
+ */
+bool
+blosc_decompressed_size(ConstByteSpan data, size_t& n_bytes);
+
+/**
+ * @brief Check that the Blosc buffer @p data was encoded as compress_in_place
+ * would encode it with @p params and @p type_size, so that it is described by
+ * the metadata written for those parameters.
+ * @param data A valid Blosc buffer.
+ * @param params Compression parameters.
+ * @param type_size Size of the elements the data is shuffled by.
+ * @param[out] error A description of the mismatch, if there is one.
+ * @return true if @p data matches, or is stored uncompressed, false otherwise.
+ */
+bool
+blosc_matches(ConstByteSpan data,
+              const BloscCompressionParams& params,
+              size_t type_size,
+              std::string& error);
+
+/**
+ * @brief Append the CRC32C checksum of @p data to it, as the crc32c codec
+ * does.
+ * @param data The encoded chunk. Grows by 4 bytes.
+ */
+void
+append_crc32c(ByteVector& data);
+
+/**
+ * @brief Check and remove the CRC32C checksum appended by the crc32c codec.
+ * @param data The encoded chunk, checksum last. Shrinks by 4 bytes on success.
+ * @return True if the last 4 bytes of @p data are the checksum of the bytes
+ * before them, false otherwise.
+ */
+[[nodiscard]] bool
+strip_crc32c(ByteVector& data);
+
 /**
  * @brief Regularize a Zarr key by removing leading, trailing, and consecutive
  * slashes.
@@ -105,4 +304,42 @@ regularize_key(const char* key);
  */
 std::string
 regularize_key(std::string_view key);
+
+/**
+ * @brief Call @p f with a value of the C++ type matching a Zarr data type,
+ * e.g., `visit_type(type, [&]<typename T>(T) { ... })`.
+ * @param type The data type.
+ * @param f The function to call.
+ * @throw std::invalid_argument if @p type is not a valid data type.
+ */
+template<typename F>
+void
+visit_type(ZarrDataType type, F&& f)
+{
+    switch (type) {
+        case ZarrDataType_uint8:
+            return f(uint8_t{});
+        case ZarrDataType_uint16:
+            return f(uint16_t{});
+        case ZarrDataType_uint32:
+            return f(uint32_t{});
+        case ZarrDataType_uint64:
+            return f(uint64_t{});
+        case ZarrDataType_int8:
+            return f(int8_t{});
+        case ZarrDataType_int16:
+            return f(int16_t{});
+        case ZarrDataType_int32:
+            return f(int32_t{});
+        case ZarrDataType_int64:
+            return f(int64_t{});
+        case ZarrDataType_float32:
+            return f(float{});
+        case ZarrDataType_float64:
+            return f(double{});
+        default:
+            throw std::invalid_argument("Invalid data type: " +
+                                        std::to_string(type));
+    }
+}
 } // namespace zarr
\ No newline at end of file
@@ -0,0 +1,725 @@
+#include "zarr.reader.hh"
+#include "file.handle.hh"
+#include "locked.buffer.hh"
+#include "macros.hh"
+#include "zarr.common.hh"
+
+#include <crc32c/crc32c.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <limits>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+void*
+make_read_flags();
+
+void
+destroy_flags(void*);
+
+bool
+seek_and_read(void* handle, size_t offset, std::span<ByteSpan> buffers);
+
+namespace {
+// chunks stored back to back are read together, up to this many bytes at once
+constexpr size_t max_bytes_per_read = 16 << 20;
+
+ZarrDataType
+dtype_to_sample_type(const std::string& dtype)
+{
+    if (dtype == "uint8") {
+        return ZarrDataType_uint8;
+    } else if (dtype == "uint16") {
+        return ZarrDataType_uint16;
+    } else if (dtype == "uint32") {
+        return ZarrDataType_uint32;
+    } else if (dtype == "uint64") {
+        return ZarrDataType_uint64;
+    } else if (dtype == "int8") {
+        return ZarrDataType_int8;
+    } else if (dtype == "int16") {
+        return ZarrDataType_int16;
+    } else if (dtype == "int32") {
+        return ZarrDataType_int32;
+    } else if (dtype == "int64") {
+        return ZarrDataType_int64;
+    } else if (dtype == "float32") {
+        return ZarrDataType_float32;
+    } else if (dtype == "float64") {
+        return ZarrDataType_float64;
+    }
+
+    throw std::runtime_error("Unsupported data type: '" + dtype + "'");
+}
+} // namespace
+
+ZarrReader_s::ZarrReader_s(const ZarrReaderSettings* settings)
+  : read_flags_(nullptr)
+  , dtype_(ZarrDataType_uint8)
+  , significant_bits_(0)
+  , is_compressed_(false)
+  , has_checksums_(false)
+  , separator_("/")
+  , chunks_in_shard_(0)
+  , bytes_per_chunk_(0)
+{
+    EXPECT(settings, "Null pointer: settings");
+    EXPECT(settings->store_path != nullptr, "Null pointer: store_path");
+
+    array_path_ = zarr::trim(settings->store_path);
+    EXPECT(!array_path_.empty(), "Store path is empty");
+    if (const auto key = zarr::regularize_key(settings->array_key);
+        !key.empty()) {
+        array_path_ += "/" + key;
+    }
+
+    if (const auto* s3 = settings->s3_settings) {
+        s3_settings_ = zarr::S3Settings{
+            .endpoint = zarr::trim(s3->endpoint),
+            .bucket_name = zarr::trim(s3->bucket_name),
+        };
+        if (s3->region != nullptr) {
+            s3_settings_->region = zarr::trim(s3->region);
+        }
+        s3_connection_pool_ = std::make_shared<zarr::S3ConnectionPool>(
+          std::thread::hardware_concurrency(), *s3_settings_);
+    } else {
+        read_flags_ = make_read_flags();
+    }
+
+    auto max_threads = settings->max_threads == 0
+                         ? std::thread::hardware_concurrency()
+                         : settings->max_threads;
+    if (max_threads == 0) {
+        LOG_WARNING("Unable to determine hardware concurrency, using 1 thread");
+        max_threads = 1;
+    }
+    thread_pool_ = std::make_shared<zarr::ThreadPool>(
+      max_threads, [](const std::string& err) { LOG_ERROR(err); });
+
+    try {
+        const auto metadata_key = array_path_ + "/zarr.json";
+        size_t metadata_size;
+        EXPECT(object_size_(metadata_key, metadata_size),
+               "No array found at ",
+               array_path_);
+
+        ByteVector metadata(metadata_size);
+        ByteSpan buffer(metadata);
+        EXPECT(read_object_(metadata_key, 0, std::span(&buffer, 1)),
+               "Failed to read ",
+               metadata_key);
+
+        parse_metadata_(
+          nlohmann::json::parse(metadata.begin(), metadata.end()));
+    } catch (...) {
+        if (read_flags_ != nullptr) {
+            destroy_flags(read_flags_);
+        }
+        throw;
+    }
+}
+
+ZarrReader_s::~ZarrReader_s()
+{
+    thread_pool_->await_stop();
+    if (read_flags_ != nullptr) {
+        destroy_flags(read_flags_);
+        read_flags_ = nullptr;
+    }
+}
+
+ZarrDataType
+ZarrReader_s::data_type() const
+{
+    return dtype_;
+}
+
+const std::vector<uint64_t>&
+ZarrReader_s::shape() const
+{
+    return shape_;
+}
+
+const std::vector<uint64_t>&
+ZarrReader_s::chunk_shape() const
+{
+    return chunk_shape_;
+}
+
+ZarrStatusCode
+ZarrReader_s::read_chunk(std::span<const uint64_t> chunk_coords,
+                         void* data,
+                         size_t bytes_in)
+{
+    if (chunk_coords.size() != shape_.size()) {
+        LOG_ERROR("Expected ",
+                  shape_.size(),
+                  " chunk coordinates, got ",
+                  chunk_coords.size());
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    for (auto i = 0; i < chunk_coords.size(); ++i) {
+        if (chunk_coords[i] >= chunk_grid_[i]) {
+            LOG_ERROR("Chunk coordinate ",
+                      chunk_coords[i],
+                      " is out of bounds for dimension ",
+                      i);
+            return ZarrStatusCode_InvalidIndex;
+        }
+    }
+
+    if (bytes_in < bytes_per_chunk_) {
+        LOG_ERROR("Buffer too small for chunk: expected at least ",
+                  bytes_per_chunk_,
+                  " bytes, got ",
+                  bytes_in);
+        return ZarrStatusCode_Overflow;
+    }
+
+    auto* out = static_cast<uint8_t*>(data);
+    const std::vector<std::vector<uint64_t>> coords{ { chunk_coords.begin(),
+                                                       chunk_coords.end() } };
+    if (!read_chunks_(coords, [out](size_t, ConstByteSpan chunk) {
+            memcpy(out, chunk.data(), chunk.size());
+        })) {
+        return ZarrStatusCode_IOError;
+    }
+
+    return ZarrStatusCode_Success;
+}
+
+ZarrStatusCode
+ZarrReader_s::read_region(std::span<const uint64_t> offset,
+                          std::span<const uint64_t> shape,
+                          void* data,
+                          size_t bytes_in)
+{
+    const auto ndims = shape_.size();
+    if (offset.size() != ndims || shape.size() != ndims) {
+        LOG_ERROR("Expected ", ndims, " dimensions for region");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    const auto bytes_per_px = zarr::bytes_of_type(dtype_);
+    size_t bytes_of_region = bytes_per_px;
+    for (auto i = 0; i < ndims; ++i) {
+        if (offset[i] + shape[i] > shape_[i]) {
+            LOG_ERROR("Region is out of bounds for dimension ", i);
+            return ZarrStatusCode_InvalidIndex;
+        }
+        bytes_of_region *= shape[i];
+    }
+
+    if (bytes_of_region == 0) {
+        return ZarrStatusCode_Success;
+    }
+
+    if (bytes_in < bytes_of_region) {
+        LOG_ERROR("Buffer too small for region: expected at least ",
+                  bytes_of_region,
+                  " bytes, got ",
+                  bytes_in);
+        return ZarrStatusCode_Overflow;
+    }
+
+    // every chunk overlapping the region, in C order
+    std::vector<uint64_t> lo(ndims), hi(ndims);
+    for (auto i = 0; i < ndims; ++i) {
+        lo[i] = offset[i] / chunk_shape_[i];
+        hi[i] = (offset[i] + shape[i] - 1) / chunk_shape_[i];
+    }
+
+    std::vector<std::vector<uint64_t>> chunk_coords;
+    for (auto coords = lo;;) {
+        chunk_coords.push_back(coords);
+
+        auto d = static_cast<int>(ndims) - 1;
+        while (d >= 0 && coords[d] == hi[d]) {
+            coords[d] = lo[d];
+            --d;
+        }
+        if (d < 0) {
+            break;
+        }
+        ++coords[d];
+    }
+
+    std::vector<size_t> region_strides(ndims, 1), chunk_strides(ndims, 1);
+    for (auto i = static_cast<int>(ndims) - 2; i >= 0; --i) {
+        region_strides[i] = region_strides[i + 1] * shape[i + 1];
+        chunk_strides[i] = chunk_strides[i + 1] * chunk_shape_[i + 1];
+    }
+
+    // each chunk fills its own part of the region, so chunks can be copied in
+    // as they are decoded
+    auto* out = static_cast<uint8_t*>(data);
+    const auto copy_chunk = [&](size_t chunk, ConstByteSpan bytes) {
+        const auto& coords = chunk_coords[chunk];
+
+        // the part of the chunk inside the region, in array coordinates
+        std::vector<uint64_t> from(ndims), to(ndims);
+        for (auto i = 0; i < ndims; ++i) {
+            const auto origin = coords[i] * chunk_shape_[i];
+            from[i] = std::max(offset[i], origin);
+            to[i] = std::min(offset[i] + shape[i], origin + chunk_shape_[i]);
+        }
+
+        const auto row_bytes = (to[ndims - 1] - from[ndims - 1]) * bytes_per_px;
+        for (auto pos = from;;) {
+            size_t chunk_px = 0, region_px = 0;
+            for (auto i = 0; i < ndims; ++i) {
+                chunk_px +=
+                  (pos[i] - coords[i] * chunk_shape_[i]) * chunk_strides[i];
+                region_px += (pos[i] - offset[i]) * region_strides[i];
+            }
+            memcpy(out + region_px * bytes_per_px,
+                   bytes.data() + chunk_px * bytes_per_px,
+                   row_bytes);
+
+            auto d = static_cast<int>(ndims) - 2;
+            while (d >= 0 && pos[d] + 1 == to[d]) {
+                pos[d] = from[d];
+                --d;
+            }
+            if (d < 0) {
+                break;
+            }
+            ++pos[d];
+        }
+    };
+
+    if (!read_chunks_(chunk_coords, copy_chunk)) {
+        return ZarrStatusCode_IOError;
+    }
+
+    return ZarrStatusCode_Success;
+}
+
+void
+ZarrReader_s::parse_metadata_(const nlohmann::json& metadata)
+{
+    EXPECT(metadata.value("zarr_format", 0) == 3,
+           "Not a Zarr v3 node: ",
+           array_path_);
+    EXPECT(metadata.value("node_type", "") == "array",
+           "Not a Zarr array: ",
+           array_path_);
+
+    shape_ = metadata.at("shape").get<std::vector<uint64_t>>();
+    const auto ndims = shape_.size();
+    EXPECT(ndims > 0, "Array has no dimensions");
+
+    const auto& grid = metadata.at("chunk_grid");
+    EXPECT(grid.at("name") == "regular",
+           "Unsupported chunk grid: ",
+           grid.at("name").dump());
+    const auto shard_shape =
+      grid.at("configuration").at("chunk_shape").get<std::vector<uint64_t>>();
+    EXPECT(shard_shape.size() == ndims, "Shard shape doesn't match array");
+
+    if (metadata.contains("chunk_key_encoding")) {
+        const auto& encoding = metadata.at("chunk_key_encoding");
+        EXPECT(encoding.at("name") == "default",
+               "Unsupported chunk key encoding: ",
+               encoding.at("name").dump());
+        separator_ = encoding.value("configuration", nlohmann::json::object())
+                       .value("separator", "/");
+    }
+
+    dtype_ = dtype_to_sample_type(metadata.at("data_type").get<std::string>());
+
+    const auto& codecs = metadata.at("codecs");
+    EXPECT(codecs.size() == 1 && codecs[0].at("name") == "sharding_indexed",
+           "Only arrays stored with a single sharding_indexed codec are "
+           "supported");
+
+    const auto& sharding = codecs[0].at("configuration");
+    chunk_shape_ = sharding.at("chunk_shape").get<std::vector<uint64_t>>();
+    EXPECT(chunk_shape_.size() == ndims, "Chunk shape doesn't match array");
+
+    EXPECT(sharding.value("index_location", "end") == "end",
+           "Only shard indices at the end of the shard are supported");
+    const auto& index_codecs = sharding.at("index_codecs");
+    EXPECT(index_codecs.size() == 2 && index_codecs[0].at("name") == "bytes" &&
+             index_codecs[1].at("name") == "crc32c",
+           "Only shard indices checked with crc32c are supported");
+
+    auto inner_codecs = sharding.at("codecs");
+    if (!inner_codecs.empty() && inner_codecs.back().at("name") == "crc32c") {
+        has_checksums_ = true;
+        inner_codecs.erase(inner_codecs.size() - 1);
+    }
+    EXPECT(!inner_codecs.empty() && inner_codecs.size() <= 2,
+           "Unsupported chunk codecs: ",
+           inner_codecs.dump());
+
+    const auto& array_to_bytes = inner_codecs[0];
+    const auto codec_config =
+      array_to_bytes.value("configuration", nlohmann::json::object());
+    if (array_to_bytes.at("name") == "packbits") {
+        EXPECT(codec_config.value("first_bit", 0) == 0,
+               "Only packbits codecs starting at bit 0 are supported");
+        const auto last_bit = codec_config.value(
+          "last_bit", 8 * zarr::bytes_of_type(dtype_) - 1);
+        significant_bits_ = static_cast<uint8_t>(last_bit + 1);
+    } else {
+        EXPECT(array_to_bytes.at("name") == "bytes",
+               "Unsupported codec: ",
+               array_to_bytes.at("name").dump());
+        EXPECT(codec_config.value("endian", "little") == "little",
+               "Only little endian data is supported");
+    }
+
+    if (inner_codecs.size() == 2) {
+        EXPECT(inner_codecs[1].at("name") == "blosc",
+               "Unsupported codec: ",
+               inner_codecs[1].at("name").dump());
+        is_compressed_ = true;
+    }
+
+    chunks_per_shard_.resize(ndims);
+    chunk_grid_.resize(ndims);
+    chunks_in_shard_ = 1;
+    bytes_per_chunk_ = zarr::bytes_of_type(dtype_);
+    for (auto i = 0; i < ndims; ++i) {
+        EXPECT(chunk_shape_[i] > 0 && shard_shape[i] % chunk_shape_[i] == 0,
+               "Shard shape is not a multiple of the chunk shape");
+        chunks_per_shard_[i] = shard_shape[i] / chunk_shape_[i];
+        chunk_grid_[i] = (shape_[i] + chunk_shape_[i] - 1) / chunk_shape_[i];
+        chunks_in_shard_ *= chunks_per_shard_[i];
+        bytes_per_chunk_ *= chunk_shape_[i];
+    }
+}
+
+bool
+ZarrReader_s::object_size_(const std::string& key, size_t& size)
+{
+    if (!s3_connection_pool_) {
+        std::error_code ec;
+        size = fs::file_size(key, ec);
+        return !ec;
+    }
+
+    auto connection = s3_connection_pool_->get_connection();
+    EXPECT(connection, "Failed to get an S3 connection");
+
+    const auto exists =
+      connection->object_size(s3_settings_->bucket_name, key, size);
+    s3_connection_pool_->return_connection(std::move(connection));
+
+    return exists;
+}
+
+bool
+ZarrReader_s::read_object_(const std::string& key,
+                           size_t offset,
+                           std::span<ByteSpan> buffers)
+{
+    if (!s3_connection_pool_) {
+        zarr::FileHandle handle(key, read_flags_);
+        return seek_and_read(handle.get(), offset, buffers);
+    }
+
+    // a single ranged request covers every buffer
+    ByteVector joined;
+    ByteSpan target = buffers.front();
+    if (buffers.size() > 1) {
+        size_t n_bytes = 0;
+        for (const auto& buffer : buffers) {
+            n_bytes += buffer.size();
+        }
+        joined.resize(n_bytes);
+        target = joined;
+    }
+
+    auto connection = s3_connection_pool_->get_connection();
+    EXPECT(connection, "Failed to get an S3 connection");
+
+    const auto success =
+      connection->get_object(s3_settings_->bucket_name, key, offset, target);
+    s3_connection_pool_->return_connection(std::move(connection));
+
+    if (success && buffers.size() > 1) {
+        const auto* cur = joined.data();
+        for (auto& buffer : buffers) {
+            memcpy(buffer.data(), cur, buffer.size());
+            cur += buffer.size();
+        }
+    }
+
+    return success;
+}
+
+std::string
+ZarrReader_s::shard_key_(std::span<const uint64_t> chunk_coords) const
+{
+    std::string key = array_path_ + "/c";
+    for (auto i = 0; i < chunk_coords.size(); ++i) {
+        key +=
+          separator_ + std::to_string(chunk_coords[i] / chunks_per_shard_[i]);
+    }
+
+    return key;
+}
+
+uint64_t
+ZarrReader_s::shard_internal_index_(
+  std::span<const uint64_t> chunk_coords) const
+{
+    uint64_t index = 0;
+    for (auto i = 0; i < chunk_coords.size(); ++i) {
+        index = index * chunks_per_shard_[i] +
+                chunk_coords[i] % chunks_per_shard_[i];
+    }
+
+    return index;
+}
+
+std::shared_ptr<const std::vector<uint64_t>>
+ZarrReader_s::shard_index_(const std::string& key)
+{
+    {
+        std::unique_lock lock(shard_indices_mutex_);
+        if (const auto it = shard_indices_.find(key);
+            it != shard_indices_.end()) {
+            return it->second;
+        }
+    }
+
+    size_t shard_size;
+    if (!object_size_(key, shard_size)) {
+        return nullptr; // not written (yet)
+    }
+
+    const size_t table_size = 2 * chunks_in_shard_ * sizeof(uint64_t);
+    ByteVector index(table_size + sizeof(uint32_t));
+    EXPECT(shard_size >= index.size(), "Shard ", key, " has no index");
+
+    ByteSpan buffer(index);
+    EXPECT(read_object_(key, shard_size - index.size(), std::span(&buffer, 1)),
+           "Failed to read the index of shard ",
+           key);
+
+    uint32_t checksum;
+    memcpy(&checksum, index.data() + table_size, sizeof(uint32_t));
+    EXPECT(crc32c::Crc32c(index.data(), table_size) == checksum,
+           "Shard index of ",
+           key,
+           " is corrupt or not yet written");
+
+    auto table = std::make_shared<std::vector<uint64_t>>(2 * chunks_in_shard_);
+    memcpy(table->data(), index.data(), table_size);
+
+    const auto data_end = shard_size - index.size();
+    for (auto i = 0; i < chunks_in_shard_; ++i) {
+        const auto offset = (*table)[2 * i];
+        const auto nbytes = (*table)[2 * i + 1];
+        EXPECT(nbytes == std::numeric_limits<uint64_t>::max() ||
+                 (offset <= data_end && nbytes <= data_end - offset),
+               "Chunk ",
+               i,
+               " of shard ",
+               key,
+               " lies outside the shard");
+    }
+
+    std::unique_lock lock(shard_indices_mutex_);
+    return shard_indices_.emplace(key, std::move(table)).first->second;
+}
+
+bool
+ZarrReader_s::read_chunks_(
+  const std::vector<std::vector<uint64_t>>& chunk_coords,
+  const ChunkCallback& callback)
+{
+    // group the chunks by shard
+    std::vector<std::string> shard_keys;
+    std::unordered_map<std::string, size_t> shard_of_key;
+    std::vector<size_t> chunk_shards(chunk_coords.size());
+    for (auto i = 0; i < chunk_coords.size(); ++i) {
+        const auto [it, inserted] =
+          shard_of_key.emplace(shard_key_(chunk_coords[i]), shard_keys.size());
+        if (inserted) {
+            shard_keys.push_back(it->first);
+        }
+        chunk_shards[i] = it->second;
+    }
+
+    std::vector<std::shared_ptr<const std::vector<uint64_t>>> indices(
+      shard_keys.size());
+    if (!run_jobs_(shard_keys.size(), [&](size_t i, std::string&) {
+            indices[i] = shard_index_(shard_keys[i]);
+            return true;
+        })) {
+        return false;
+    }
+
+    struct Extent
+    {
+        size_t chunk;
+        uint64_t offset;
+        uint64_t nbytes;
+    };
+    struct Run
+    {
+        size_t shard;
+        std::vector<Extent> extents;
+        uint64_t nbytes{ 0 };
+    };
+
+    std::vector<std::vector<Extent>> shard_extents(shard_keys.size());
+    std::vector<size_t> missing_chunks;
+    for (auto i = 0; i < chunk_coords.size(); ++i) {
+        const auto& index = indices[chunk_shards[i]];
+        const auto j = shard_internal_index_(chunk_coords[i]);
+        if (!index ||
+            (*index)[2 * j + 1] == std::numeric_limits<uint64_t>::max()) {
+            missing_chunks.push_back(i);
+            continue;
+        }
+        shard_extents[chunk_shards[i]].push_back(
+          { i, (*index)[2 * j], (*index)[2 * j + 1] });
+    }
+
+    // chunks stored back to back are read with a single call
+    std::vector<Run> runs;
+    for (auto s = 0; s < shard_extents.size(); ++s) {
+        auto& extents = shard_extents[s];
+        std::ranges::sort(extents, {}, &Extent::offset);
+
+        for (const auto& extent : extents) {
+            if (!runs.empty() && runs.back().shard == s) {
+                auto& run = runs.back();
+                const auto& last = run.extents.back();
+                if (last.offset + last.nbytes == extent.offset &&
+                    run.nbytes + extent.nbytes <= max_bytes_per_read) {
+                    run.extents.push_back(extent);
+                    run.nbytes += extent.nbytes;
+                    continue;
+                }
+            }
+            runs.push_back({ s, { extent }, extent.nbytes });
+        }
+    }
+
+    // chunks that were never written hold the fill value
+    if (!missing_chunks.empty()) {
+        const ByteVector fill(bytes_per_chunk_, 0);
+        for (const auto i : missing_chunks) {
+            callback(i, fill);
+        }
+    }
+
+    return run_jobs_(runs.size(), [&](size_t r, std::string& err) {
+        const auto& run = runs[r];
+        const auto& key = shard_keys[run.shard];
+
+        std::vector<ByteVector> chunks(run.extents.size());
+        std::vector<ByteSpan> buffers(run.extents.size());
+        for (auto k = 0; k < chunks.size(); ++k) {
+            chunks[k].resize(run.extents[k].nbytes);
+            buffers[k] = chunks[k];
+        }
+
+        if (!read_object_(key, run.extents.front().offset, buffers)) {
+            err = "Failed to read chunks from " + key;
+            return false;
+        }
+
+        for (auto k = 0; k < chunks.size(); ++k) {
+            if (!decode_chunk_(chunks[k])) {
+                err = "Failed to decode a chunk of " + key;
+                return false;
+            }
+            callback(run.extents[k].chunk, chunks[k]);
+        }
+
+        return true;
+    });
+}
+
+bool
+ZarrReader_s::decode_chunk_(ByteVector& chunk) const
+{
+    if (has_checksums_ && !zarr::strip_crc32c(chunk)) {
+        LOG_ERROR("Chunk checksum mismatch");
+        return false;
+    }
+
+    if (is_compressed_) {
+        size_t n_bytes;
+        if (!zarr::blosc_decompressed_size(chunk, n_bytes)) {
+            return false;
+        }
+
+        zarr::LockedBuffer buffer(std::move(chunk));
+        if (!buffer.decompress(n_bytes)) {
+            return false;
+        }
+        chunk = buffer.take();
+    }
+
+    if (significant_bits_ > 0) {
+        const auto n_elements = bytes_per_chunk_ / zarr::bytes_of_type(dtype_);
+        return zarr::unpack_bits(chunk, dtype_, significant_bits_, n_elements);
+    }
+
+    return chunk.size() == bytes_per_chunk_;
+}
+
+bool
+ZarrReader_s::run_jobs_(size_t n_jobs,
+                        const std::function<bool(size_t, std::string&)>& job)
+{
+    std::atomic<char> all_successful = 1;
+
+    const auto run = [&](size_t i, std::string& err) {
+        bool success = false;
+        try {
+            success = job(i, err);
+        } catch (const std::exception& exc) {
+            err = exc.what();
+        }
+        all_successful.fetch_and(success);
+        return success;
+    };
+
+    // a single job isn't worth the round trip through the pool
+    if (n_jobs == 1) {
+        if (std::string err; !run(0, err)) {
+            LOG_ERROR(err);
+        }
+        return all_successful;
+    }
+
+    std::vector<std::future<void>> futures;
+    for (auto i = 0; i < n_jobs; ++i) {
+        auto promise = std::make_shared<std::promise<void>>();
+        futures.emplace_back(promise->get_future());
+
+        auto task = [i, promise, &run](std::string& err) {
+            const auto success = run(i, err);
+            promise->set_value();
+            return success;
+        };
+
+        if (!thread_pool_->push_job(task)) {
+            if (std::string err; !task(err)) {
+                LOG_ERROR(err);
+            }
+        }
+    }
+
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    return all_successful;
+}
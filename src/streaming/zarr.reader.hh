@@ -0,0 +1,104 @@
+#pragma once
+
+#include "acquire.zarr.h"
+#include "definitions.hh"
+#include "s3.connection.hh"
+#include "thread.pool.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ZarrReader_s
+{
+  public:
+    explicit ZarrReader_s(const ZarrReaderSettings* settings);
+    ~ZarrReader_s();
+
+    ZarrDataType data_type() const;
+    const std::vector<uint64_t>& shape() const;
+    const std::vector<uint64_t>& chunk_shape() const;
+
+    /**
+     * @brief Read and decode a single chunk.
+     * @param chunk_coords The coordinates of the chunk in the chunk grid.
+     * @param data Buffer to decode the chunk into.
+     * @param bytes_in The size of @p data in bytes.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode read_chunk(std::span<const uint64_t> chunk_coords,
+                              void* data,
+                              size_t bytes_in);
+
+    /**
+     * @brief Read a hyperslab of the array.
+     * @param offset The offset of the region, in pixels.
+     * @param shape The shape of the region, in pixels.
+     * @param data Buffer to read the region into, in C order.
+     * @param bytes_in The size of @p data in bytes.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode read_region(std::span<const uint64_t> offset,
+                               std::span<const uint64_t> shape,
+                               void* data,
+                               size_t bytes_in);
+
+  private:
+    // called with the index of a requested chunk and its decoded bytes
+    using ChunkCallback = std::function<void(size_t, ConstByteSpan)>;
+
+    std::string array_path_; // filesystem path or S3 key of the array node
+    std::optional<zarr::S3Settings> s3_settings_;
+
+    std::shared_ptr<zarr::ThreadPool> thread_pool_;
+    std::shared_ptr<zarr::S3ConnectionPool> s3_connection_pool_;
+    void* read_flags_;
+
+    ZarrDataType dtype_;
+    uint8_t significant_bits_; // 0 unless chunks are encoded with packbits
+    bool is_compressed_;       // Blosc after the array-to-bytes codec
+    bool has_checksums_;       // crc32c last, after any compression
+    std::string separator_;    // chunk key separator
+
+    std::vector<uint64_t> shape_;
+    std::vector<uint64_t> chunk_shape_;
+    std::vector<uint64_t> chunks_per_shard_; // along each dimension
+    std::vector<uint64_t> chunk_grid_;       // chunks along each dimension
+    uint64_t chunks_in_shard_;
+    size_t bytes_per_chunk_;
+
+    // (offset, nbytes) pairs of every shard read so far, keyed by object key;
+    // shards that don't exist yet aren't cached, so they're looked up again
+    std::mutex shard_indices_mutex_;
+    std::unordered_map<std::string,
+                       std::shared_ptr<const std::vector<uint64_t>>>
+      shard_indices_;
+
+    void parse_metadata_(const nlohmann::json& metadata);
+
+    [[nodiscard]] bool object_size_(const std::string& key, size_t& size);
+    [[nodiscard]] bool read_object_(const std::string& key,
+                                    size_t offset,
+                                    std::span<ByteSpan> buffers);
+
+    std::string shard_key_(std::span<const uint64_t> chunk_coords) const;
+    uint64_t shard_internal_index_(
+      std::span<const uint64_t> chunk_coords) const;
+    std::shared_ptr<const std::vector<uint64_t>> shard_index_(
+      const std::string& key);
+
+    [[nodiscard]] bool read_chunks_(
+      const std::vector<std::vector<uint64_t>>& chunk_coords,
+      const ChunkCallback& callback);
+    [[nodiscard]] bool decode_chunk_(ByteVector& chunk) const;
+    [[nodiscard]] bool run_jobs_(
+      size_t n_jobs,
+      const std::function<bool(size_t, std::string&)>& job);
+};
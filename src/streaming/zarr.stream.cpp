@@ -8,6 +8,7 @@
 #include <blosc.h>
 
 #include <bit> // bit_ceil
+#include <cmath>
 #include <filesystem>
 #include <regex>
 #include <stack>
@@ -313,14 +314,59 @@ make_array_config(const ZarrArraySettings* settings,
         downsampling_method = settings->downsampling_method;
     }
 
-    return std::make_shared<zarr::ArrayConfig>(store_root,
-                                               key,
-                                               bucket_name,
-                                               compression_params,
-                                               dimensions,
-                                               settings->data_type,
-                                               downsampling_method,
-                                               0);
+    auto config = std::make_shared<zarr::ArrayConfig>(store_root,
+                                                      key,
+                                                      bucket_name,
+                                                      compression_params,
+                                                      dimensions,
+                                                      settings->data_type,
+                                                      downsampling_method,
+                                                      0);
+    config->pixel_format = settings->input_pixel_format;
+    config->significant_bits = settings->significant_bits;
+    if (const auto* conversion = settings->input_conversion) {
+        config->input_conversion = *conversion;
+        if (conversion->scale == 0.0) {
+            config->input_conversion->scale = 1.0;
+        }
+    }
+    if (const auto* reduction = settings->frame_reduction) {
+        config->frame_reduction = *reduction;
+        config->frame_reduction->binning = std::max(reduction->binning, 1u);
+    }
+    config->compute_statistics = settings->compute_statistics;
+    config->enable_preview = settings->enable_preview;
+    config->chunk_checksums = settings->chunk_checksums;
+    config->chunk_order = settings->chunk_order;
+    if (const auto* projection = settings->projection) {
+        static const char* method_names[] = { "max", "mean" };
+        config->projection_method = projection->method;
+        config->projection_dimension = projection->dimension_name;
+        config->projection_key = key + "_" + method_names[projection->method] +
+                                 "_" + config->projection_dimension;
+    }
+    if (const auto* frame_metadata = settings->frame_metadata) {
+        auto& sidecar = config->frame_metadata.emplace();
+        sidecar.store_root = store_root;
+        sidecar.node_key = key + "_frame_metadata";
+        sidecar.bucket_name = bucket_name;
+        sidecar.compression_params = compression_params;
+        sidecar.dtype = frame_metadata->data_type;
+        sidecar.field_count = frame_metadata->field_count;
+        sidecar.records_per_chunk = frame_metadata->records_per_chunk > 0
+                                      ? frame_metadata->records_per_chunk
+                                      : 4096;
+        sidecar.chunks_per_shard = frame_metadata->chunks_per_shard > 0
+                                     ? frame_metadata->chunks_per_shard
+                                     : 16;
+        if (frame_metadata->field_names != nullptr) {
+            sidecar.field_names.assign(frame_metadata->field_names,
+                                       frame_metadata->field_names +
+                                         frame_metadata->field_count);
+        }
+    }
+
+    return config;
 }
 
 [[nodiscard]] bool
@@ -425,6 +471,165 @@ validate_array_settings(const ZarrArraySettings* settings,
         return false;
     }
 
+    if (settings->chunk_order >= ZarrChunkOrderCount) {
+        error = "Invalid chunk order: " + std::to_string(settings->chunk_order);
+        return false;
+    }
+
+    if (const auto* reduction = settings->frame_reduction) {
+        if (reduction->binning_method >= ZarrBinningMethodCount) {
+            error = "Invalid binning method: " +
+                    std::to_string(reduction->binning_method);
+            return false;
+        }
+
+        const auto binning = std::max(reduction->binning, 1u);
+        const auto& width = settings->dimensions[ndims - 1];
+        const auto& height = settings->dimensions[ndims - 2];
+        if (uint64_t{ reduction->roi_x } + uint64_t{ width.array_size_px } *
+                                             binning >
+            reduction->frame_width) {
+            error = "Crop window of width " +
+                    std::to_string(width.array_size_px * binning) +
+                    " at x=" + std::to_string(reduction->roi_x) +
+                    " exceeds frame width " +
+                    std::to_string(reduction->frame_width);
+            return false;
+        }
+        if (uint64_t{ reduction->roi_y } + uint64_t{ height.array_size_px } *
+                                             binning >
+            reduction->frame_height) {
+            error = "Crop window of height " +
+                    std::to_string(height.array_size_px * binning) +
+                    " at y=" + std::to_string(reduction->roi_y) +
+                    " exceeds frame height " +
+                    std::to_string(reduction->frame_height);
+            return false;
+        }
+    }
+
+    if (settings->input_pixel_format >= ZarrPixelFormatCount) {
+        error = "Invalid pixel format: " +
+                std::to_string(settings->input_pixel_format);
+        return false;
+    }
+
+    const auto* conversion = settings->input_conversion;
+    const auto input_type =
+      conversion ? conversion->data_type : settings->data_type;
+    if (conversion) {
+        if (input_type >= ZarrDataTypeCount) {
+            error = "Invalid input data type: " + std::to_string(input_type);
+            return false;
+        }
+
+        if (!std::isfinite(conversion->scale) ||
+            !std::isfinite(conversion->offset)) {
+            error = "Input scale and offset must be finite";
+            return false;
+        }
+
+        if (conversion->right_shift > 0 &&
+            (input_type == ZarrDataType_float32 ||
+             input_type == ZarrDataType_float64 ||
+             conversion->right_shift >= 8 * zarr::bytes_of_type(input_type))) {
+            error = "Invalid right shift for input data type: " +
+                    std::to_string(conversion->right_shift);
+            return false;
+        }
+    }
+
+    if (settings->input_pixel_format != ZarrPixelFormat_Native &&
+        input_type != ZarrDataType_uint16) {
+        error = "Packed pixel formats require input data type uint16";
+        return false;
+    }
+
+    if (const auto* projection = settings->projection) {
+        if (projection->method >= ZarrProjectionMethodCount) {
+            error = "Invalid projection method: " +
+                    std::to_string(projection->method);
+            return false;
+        }
+
+        if (key.empty()) {
+            error = "Projections require an array with an output key";
+            return false;
+        }
+
+        if (projection->dimension_name == nullptr) {
+            error = "Null pointer: projection dimension name";
+            return false;
+        }
+
+        const std::string_view dimension_name(projection->dimension_name);
+        bool found = false;
+        for (auto i = 0; i + 2 < ndims && !found; ++i) {
+            const auto* name = settings->dimensions[i].name;
+            found = name != nullptr && dimension_name == name;
+        }
+        if (!found) {
+            error = "Projection dimension '" + std::string(dimension_name) +
+                    "' is not one of the array's non-frame dimensions";
+            return false;
+        }
+
+        // the dimension name becomes part of the projection array's key
+        if (dimension_name.find('/') != std::string_view::npos) {
+            error = "Projection dimension name must not contain '/'";
+            return false;
+        }
+        if (!is_valid_zarr_key(std::string(dimension_name), error)) {
+            error = "Invalid projection dimension name: '" +
+                    std::string(dimension_name) + "': " + error;
+            return false;
+        }
+    }
+
+    if (const auto bits = settings->significant_bits; bits > 0) {
+        if (settings->data_type != ZarrDataType_uint8 &&
+            settings->data_type != ZarrDataType_uint16 &&
+            settings->data_type != ZarrDataType_uint32) {
+            error = "Significant bits require an unsigned integer data type";
+            return false;
+        }
+
+        if (bits >= 8 * zarr::bytes_of_type(settings->data_type)) {
+            error = "Significant bits must be fewer than the bits per "
+                    "sample: got " +
+                    std::to_string(bits);
+            return false;
+        }
+    }
+
+    if (const auto* frame_metadata = settings->frame_metadata) {
+        if (key.empty()) {
+            error = "Frame metadata requires an array with an output key";
+            return false;
+        }
+
+        if (frame_metadata->data_type >= ZarrDataTypeCount) {
+            error = "Invalid frame metadata data type: " +
+                    std::to_string(frame_metadata->data_type);
+            return false;
+        }
+
+        if (frame_metadata->field_count == 0) {
+            error = "Frame metadata field count must be positive";
+            return false;
+        }
+
+        if (const auto* names = frame_metadata->field_names) {
+            for (auto i = 0; i < frame_metadata->field_count; ++i) {
+                if (names[i] == nullptr) {
+                    error = "Null pointer: frame metadata field name " +
+                            std::to_string(i);
+                    return false;
+                }
+            }
+        }
+    }
+
     return true;
 }
 
@@ -667,6 +872,21 @@ check_array_structure(std::vector<std::shared_ptr<zarr::ArrayConfig>> arrays,
     tree->type = DatasetNodeType::Directory;
     tree->children = {};
 
+    // projections and frame metadata are written as arrays of their own,
+    // next to their source
+    for (auto i = 0, n = static_cast<int>(arrays.size()); i < n; ++i) {
+        if (arrays[i]->projection_method) {
+            auto projection = std::make_shared<zarr::ArrayConfig>();
+            projection->node_key = arrays[i]->projection_key;
+            arrays.push_back(projection);
+        }
+        if (arrays[i]->frame_metadata) {
+            auto frame_metadata = std::make_shared<zarr::ArrayConfig>();
+            frame_metadata->node_key = arrays[i]->frame_metadata->node_key;
+            arrays.push_back(frame_metadata);
+        }
+    }
+
     std::unordered_set<std::string> seen_keys;
 
     // check that if the root node is not multiscale, there are no other arrays
@@ -825,6 +1045,57 @@ dimension_type_to_string(ZarrDimensionType type)
             return "(unknown)";
     }
 }
+
+/**
+ * @brief Build the inline consolidated metadata for the group at
+ * @p group_path from the metadata of every group and array below it.
+ * @param group_path Path of the consolidating group relative to the store root.
+ * @param groups Group metadata, keyed by path relative to the store root.
+ * @param arrays Serialized array metadata, keyed by path relative to the store
+ * root.
+ * @return The value of the group's `consolidated_metadata` field.
+ */
+nlohmann::json
+make_consolidated_metadata(
+  const std::string& group_path,
+  const std::unordered_map<std::string, nlohmann::json>& groups,
+  const std::unordered_map<std::string, std::string>& arrays)
+{
+    const std::string prefix = group_path.empty() ? "" : group_path + "/";
+
+    nlohmann::json metadata = nlohmann::json::object();
+    for (const auto& [path, group] : groups) {
+        if (path != group_path && path.starts_with(prefix)) {
+            metadata[path.substr(prefix.size())] = group;
+        }
+    }
+
+    for (const auto& [path, array] : arrays) {
+        if (path == group_path || !path.starts_with(prefix)) {
+            continue;
+        }
+
+        auto array_metadata = nlohmann::json::parse(array, nullptr, false);
+        if (array_metadata.is_discarded()) {
+            LOG_WARNING("Skipping unparseable metadata for '", path, "'");
+            continue;
+        }
+        metadata[path.substr(prefix.size())] = std::move(array_metadata);
+    }
+
+    return {
+        { "kind", "inline" },
+        { "must_understand", false },
+        { "metadata", metadata },
+    };
+}
+
+bool
+is_plate_metadata(const nlohmann::json& group)
+{
+    const auto& attributes = group["attributes"];
+    return attributes.contains("ome") && attributes["ome"].contains("plate");
+}
 } // namespace
 
 /* ZarrStream_s implementation */
@@ -847,6 +1118,25 @@ ZarrStream::append(const char* key_,
                    const void* data_,
                    size_t bytes_in,
                    size_t& bytes_out)
+{
+    if (!recorder_) {
+        return append_(key_, data_, bytes_in, bytes_out);
+    }
+
+    const auto start = zarr::AppendRecorder::Clock::now();
+    const auto status = append_(key_, data_, bytes_in, bytes_out);
+    const auto end = zarr::AppendRecorder::Clock::now();
+
+    recorder_->record(key_, data_, bytes_in, bytes_out, status, start, end);
+
+    return status;
+}
+
+ZarrStatusCode
+ZarrStream_s::append_(const char* key_,
+                      const void* data_,
+                      size_t bytes_in,
+                      size_t& bytes_out)
 {
     if (!error_.empty()) {
         LOG_ERROR("Cannot append data: ", error_);
@@ -874,6 +1164,15 @@ ZarrStream::append(const char* key_,
     }
 
     auto& output = array_it->second;
+    std::unique_lock array_lock(*output.mutex);
+
+    if (output.is_indexed) {
+        LOG_ERROR("Cannot append frames in order to array '",
+                  key,
+                  "', which is written by index");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
     if (output.max_bytes > 0 &&
         output.bytes_written + bytes_in > output.max_bytes) {
         LOG_ERROR("Incoming byte count ",
@@ -909,16 +1208,11 @@ ZarrStream::append(const char* key_,
 
             // ready to enqueue the frame buffer
             if (frame_buffer_offset == bytes_of_frame) {
-                std::unique_lock lock(frame_queue_mutex_);
-                while (!frame_queue_->push(frame_buffer, key) &&
-                       process_frames_) {
-                    frame_queue_not_full_cv_.wait(lock);
-                }
+                const auto queued =
+                  enqueue_frame_(frame_buffer, key, std::nullopt);
                 frame_buffer.resize(bytes_of_frame);
 
-                if (process_frames_) {
-                    frame_queue_not_empty_cv_.notify_one();
-                } else {
+                if (!queued) {
                     LOG_DEBUG("Stopping frame processing");
                     break;
                 }
@@ -933,14 +1227,7 @@ ZarrStream::append(const char* key_,
             zarr::LockedBuffer frame;
             frame.assign({ data, bytes_of_frame });
 
-            std::unique_lock lock(frame_queue_mutex_);
-            while (!frame_queue_->push(frame, key) && process_frames_) {
-                frame_queue_not_full_cv_.wait(lock);
-            }
-
-            if (process_frames_) {
-                frame_queue_not_empty_cv_.notify_one();
-            } else {
+            if (!enqueue_frame_(frame, key, std::nullopt)) {
                 LOG_DEBUG("Stopping frame processing");
                 break;
             }
@@ -958,6 +1245,413 @@ ZarrStream::append(const char* key_,
     return ZarrStatusCode_Success;
 }
 
+ZarrStatusCode
+ZarrStream_s::flush()
+{
+    if (!error_.empty()) {
+        LOG_ERROR("Cannot flush: ", error_);
+        return ZarrStatusCode_InternalError;
+    }
+
+    if (is_s3_acquisition_()) {
+        LOG_ERROR("Flushing is not supported for S3 stores");
+        return ZarrStatusCode_NotYetImplemented;
+    }
+
+    std::unique_lock lock(frame_queue_mutex_);
+    flush_requested_ = true;
+    frame_queue_not_empty_cv_.notify_one();
+
+    while (flush_requested_ && process_frames_ && error_.empty()) {
+        flush_finished_cv_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    if (flush_requested_) {
+        flush_requested_ = false;
+        LOG_ERROR("Frame processing stopped before the flush completed");
+        return ZarrStatusCode_InternalError;
+    }
+
+    return flush_succeeded_ ? ZarrStatusCode_Success : ZarrStatusCode_IOError;
+}
+
+ZarrStatusCode
+ZarrStream_s::append_frame(const char* key_,
+                           const void* data_,
+                           size_t bytes_in,
+                           uint64_t frame_index)
+{
+    if (!error_.empty()) {
+        LOG_ERROR("Cannot append data: ", error_);
+        return ZarrStatusCode_InternalError;
+    }
+
+    std::string key;
+    if (key_ == nullptr && output_arrays_.size() == 1) {
+        key = output_arrays_.begin()->first;
+    } else {
+        key = zarr::regularize_key(key_);
+    }
+
+    const auto array_it = output_arrays_.find(key);
+    if (array_it == output_arrays_.end()) {
+        return ZarrStatusCode_KeyNotFound;
+    }
+
+    auto& output = array_it->second;
+    if (!output.accepts_frame_index) {
+        LOG_ERROR("Cannot append frames by index to downsampled array '",
+                  key,
+                  "'");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    // copy the frame before taking the array lock, so producers only
+    // contend while the window is checked and the frame is queued
+    const size_t bytes_of_frame = output.frame_buffer.size();
+    if (bytes_in != bytes_of_frame) {
+        LOG_ERROR(
+          "Expected a frame of ", bytes_of_frame, " bytes, got ", bytes_in);
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    zarr::LockedBuffer frame;
+    frame.assign({ static_cast<const uint8_t*>(data_), bytes_of_frame });
+
+    // frames reach the array in queue order, so the window is updated and the
+    // frame queued under one lock
+    std::unique_lock array_lock(*output.mutex);
+
+    if (output.frame_buffer_offset > 0) {
+        LOG_ERROR("Cannot append a frame by index to array '",
+                  key,
+                  "' while a partial frame is buffered");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    if (output.max_bytes > 0 &&
+        (frame_index + 1) * bytes_of_frame > output.max_bytes) {
+        LOG_ERROR("Frame index ",
+                  frame_index,
+                  " is out of bounds for array '",
+                  key,
+                  "'");
+        return ZarrStatusCode_WriteOutOfBounds;
+    }
+
+    if (const auto status = advance_frame_window_(output, frame_index);
+        status != ZarrStatusCode_Success) {
+        return status;
+    }
+
+    if (!enqueue_frame_(frame, key, frame_index)) {
+        LOG_DEBUG("Stopping frame processing");
+        return ZarrStatusCode_InternalError;
+    }
+    output.bytes_written += bytes_of_frame;
+
+    return ZarrStatusCode_Success;
+}
+
+ZarrStatusCode
+ZarrStream_s::advance_frame_window_(ZarrOutputArray& output,
+                                    uint64_t frame_index)
+{
+    const auto frames_per_layer = output.frames_per_layer;
+    auto& received = output.frames_received;
+
+    if (!output.is_indexed) {
+        // frames appended in order so far fill the start of the open layer
+        const auto frames_written =
+          output.bytes_written / output.frame_buffer.size();
+        output.is_indexed = true;
+        output.layer_start =
+          frames_written - frames_written % frames_per_layer;
+        for (auto i = output.layer_start; i < frames_written; ++i) {
+            received.insert(i);
+        }
+    }
+
+    if (frame_index < output.layer_start) {
+        LOG_ERROR("Frame ",
+                  frame_index,
+                  " belongs to a chunk layer of array '",
+                  output.output_key,
+                  "' that has already been written");
+        return ZarrStatusCode_InvalidIndex;
+    }
+    if (received.contains(frame_index)) {
+        LOG_ERROR("Frame ",
+                  frame_index,
+                  " has already been appended to array '",
+                  output.output_key,
+                  "'");
+        return ZarrStatusCode_InvalidIndex;
+    }
+
+    // close every layer whose frames have all arrived
+    const auto close_full_layers = [&] {
+        auto layer_end = received.lower_bound(output.layer_start +
+                                              frames_per_layer);
+        while (static_cast<uint64_t>(std::distance(
+                 received.begin(), layer_end)) == frames_per_layer) {
+            received.erase(received.begin(), layer_end);
+            output.layer_start += frames_per_layer;
+            layer_end =
+              received.lower_bound(output.layer_start + frames_per_layer);
+        }
+    };
+
+    // a frame past the window forces the open layer out, missing frames and
+    // all; this is what the array does when it sees the frame
+    while (frame_index >= output.layer_start + 2 * frames_per_layer) {
+        output.layer_start += frames_per_layer;
+        received.erase(received.begin(),
+                       received.lower_bound(output.layer_start));
+        close_full_layers();
+    }
+
+    received.insert(frame_index);
+    close_full_layers();
+
+    return ZarrStatusCode_Success;
+}
+
+ZarrStatusCode
+ZarrStream_s::append_frame_metadata(const char* key_,
+                                    const void* data_,
+                                    size_t bytes_in,
+                                    size_t& bytes_out)
+{
+    bytes_out = 0;
+
+    if (!error_.empty()) {
+        LOG_ERROR("Cannot append frame metadata: ", error_);
+        return ZarrStatusCode_InternalError;
+    }
+
+    std::string key;
+    if (key_ == nullptr && output_arrays_.size() == 1) {
+        key = output_arrays_.begin()->first;
+    } else {
+        key = zarr::regularize_key(key_);
+    }
+
+    const auto array_it = output_arrays_.find(key);
+    if (array_it == output_arrays_.end()) {
+        return ZarrStatusCode_KeyNotFound;
+    }
+
+    // records don't go through the frame queue; the frame metadata array
+    // buffers them itself and hands full shards to the thread pool
+    auto& frame_metadata = array_it->second.frame_metadata;
+    if (frame_metadata == nullptr) {
+        LOG_ERROR("Array '", key, "' has no frame metadata");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    if (bytes_in % frame_metadata->bytes_per_record() != 0) {
+        LOG_ERROR("Expected a whole number of ",
+                  frame_metadata->bytes_per_record(),
+                  "-byte records, got ",
+                  bytes_in,
+                  " bytes");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    std::string error;
+    if (!frame_metadata->append(
+          { static_cast<const uint8_t*>(data_), bytes_in }, error)) {
+        LOG_ERROR("Failed to append frame metadata to array '",
+                  key,
+                  "': ",
+                  error);
+        return ZarrStatusCode_IOError;
+    }
+
+    bytes_out = bytes_in;
+    return ZarrStatusCode_Success;
+}
+
+ZarrStatusCode
+ZarrStream_s::write_chunk(const char* key_,
+                          std::span<const uint64_t> chunk_coords,
+                          const void* data_,
+                          size_t bytes_in,
+                          bool is_compressed)
+{
+    if (!error_.empty()) {
+        LOG_ERROR("Cannot write chunk: ", error_);
+        return ZarrStatusCode_InternalError;
+    }
+
+    std::string key;
+    if (key_ == nullptr && output_arrays_.size() == 1) {
+        key = output_arrays_.begin()->first;
+    } else {
+        key = zarr::regularize_key(key_);
+    }
+
+    const auto array_it = output_arrays_.find(key);
+    if (array_it == output_arrays_.end()) {
+        return ZarrStatusCode_KeyNotFound;
+    }
+
+    // frames may still be waiting in the frame buffer or the queue
+    auto& output = array_it->second;
+    std::unique_lock array_lock(*output.mutex);
+    if (output.bytes_written > 0 || output.frame_buffer_offset > 0) {
+        LOG_ERROR("Cannot write chunks directly to array '",
+                  key,
+                  "': frames have already been appended");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    const ConstByteSpan data(static_cast<const uint8_t*>(data_), bytes_in);
+    switch (output.array->write_chunk(chunk_coords, data, is_compressed)) {
+        case zarr::WriteResult::Ok:
+            return ZarrStatusCode_Success;
+        case zarr::WriteResult::OutOfBounds:
+            return ZarrStatusCode_WriteOutOfBounds;
+        case zarr::WriteResult::InvalidArgument:
+        default:
+            return ZarrStatusCode_InvalidArgument;
+    }
+}
+
+ZarrStatusCode
+ZarrStream_s::write_region(const char* key_,
+                           std::span<const uint64_t> offset,
+                           std::span<const uint64_t> shape,
+                           const void* data_,
+                           size_t bytes_in)
+{
+    if (!error_.empty()) {
+        LOG_ERROR("Cannot write region: ", error_);
+        return ZarrStatusCode_InternalError;
+    }
+
+    std::string key;
+    if (key_ == nullptr && output_arrays_.size() == 1) {
+        key = output_arrays_.begin()->first;
+    } else {
+        key = zarr::regularize_key(key_);
+    }
+
+    const auto array_it = output_arrays_.find(key);
+    if (array_it == output_arrays_.end()) {
+        return ZarrStatusCode_KeyNotFound;
+    }
+
+    auto& output = array_it->second;
+    std::unique_lock array_lock(*output.mutex);
+    if (output.bytes_written > 0 || output.frame_buffer_offset > 0) {
+        LOG_ERROR("Cannot write regions directly to array '",
+                  key,
+                  "': frames have already been appended");
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    const ConstByteSpan data(static_cast<const uint8_t*>(data_), bytes_in);
+    switch (output.array->write_region(offset, shape, data)) {
+        case zarr::WriteResult::Ok:
+            return ZarrStatusCode_Success;
+        case zarr::WriteResult::OutOfBounds:
+            return ZarrStatusCode_WriteOutOfBounds;
+        case zarr::WriteResult::InvalidArgument:
+        default:
+            return ZarrStatusCode_InvalidArgument;
+    }
+}
+
+ZarrStatusCode
+ZarrStream_s::get_statistics(const char* key_,
+                             int64_t channel,
+                             ZarrArrayStatistics* stats) const
+{
+    std::string key;
+    if (key_ == nullptr && output_arrays_.size() == 1) {
+        key = output_arrays_.begin()->first;
+    } else {
+        key = zarr::regularize_key(key_);
+    }
+
+    const auto array_it = output_arrays_.find(key);
+    if (array_it == output_arrays_.end()) {
+        return ZarrStatusCode_KeyNotFound;
+    }
+
+    if (channel < -1) {
+        LOG_ERROR("Invalid channel index: ", channel);
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    std::optional<uint64_t> channel_index;
+    if (channel >= 0) {
+        channel_index = channel;
+    }
+
+    if (!array_it->second.array->statistics(channel_index, *stats)) {
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    return ZarrStatusCode_Success;
+}
+
+ZarrStatusCode
+ZarrStream_s::get_preview(const char* key_,
+                          uint16_t level,
+                          void* data,
+                          size_t bytes_in,
+                          ZarrPreviewInfo* info) const
+{
+    std::string key;
+    if (key_ == nullptr && output_arrays_.size() == 1) {
+        key = output_arrays_.begin()->first;
+    } else {
+        key = zarr::regularize_key(key_);
+    }
+
+    const auto array_it = output_arrays_.find(key);
+    if (array_it == output_arrays_.end()) {
+        return ZarrStatusCode_KeyNotFound;
+    }
+
+    const auto& array = array_it->second.array;
+    if (!array->preview(level, {}, *info)) {
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    if (data == nullptr) {
+        return ZarrStatusCode_Success;
+    }
+
+    // the frame size is fixed per level, so it can be checked up front
+    const size_t bytes_of_preview = static_cast<size_t>(info->width) *
+                                    info->height *
+                                    zarr::bytes_of_type(info->data_type);
+    if (bytes_in < bytes_of_preview) {
+        LOG_ERROR("Preview buffer too small: expected at least ",
+                  bytes_of_preview,
+                  " bytes, got ",
+                  bytes_in);
+        return ZarrStatusCode_Overflow;
+    }
+
+    if (!array->preview(
+          level, { static_cast<uint8_t*>(data), bytes_of_preview }, *info)) {
+        return ZarrStatusCode_InvalidArgument;
+    }
+
+    return ZarrStatusCode_Success;
+}
+
+const ZarrCalibration&
+ZarrStream_s::calibration() const noexcept
+{
+    return calibration_;
+}
+
 ZarrStatusCode
 ZarrStream_s::write_custom_metadata(std::string_view custom_metadata,
                                     bool overwrite)
@@ -1018,6 +1712,9 @@ ZarrStream_s::get_memory_usage() const noexcept
         const auto frame_buffer_size = output.frame_buffer.size();
         const auto array_memory_usage = output.array->memory_usage();
         usage += (frame_buffer_size + array_memory_usage);
+        if (output.frame_metadata) {
+            usage += output.frame_metadata->memory_usage();
+        }
     }
 
     return usage;
@@ -1064,6 +1761,58 @@ ZarrStream_s::validate_settings_(const struct ZarrStreamSettings_s* settings)
         return false;
     }
 
+    if (settings->resume) {
+        if (settings->overwrite) {
+            error_ = "Cannot resume appending to a store being overwritten";
+            return false;
+        }
+
+        if (settings->s3_settings != nullptr) {
+            error_ = "Resuming is only supported for filesystem stores";
+            return false;
+        }
+    }
+
+    if (!std::isfinite(settings->frame_rate_hz) ||
+        settings->frame_rate_hz < 0.0) {
+        error_ =
+          "Invalid frame rate: " + std::to_string(settings->frame_rate_hz);
+        return false;
+    }
+
+    if (settings->capture != nullptr) {
+        if (settings->capture->path == nullptr) {
+            error_ = "Null pointer: capture path";
+            return false;
+        }
+        if (std::string_view(settings->capture->path).empty()) {
+            error_ = "Capture path is empty";
+            return false;
+        }
+    }
+
+    if (settings->cooperative != nullptr) {
+        if (settings->s3_settings != nullptr) {
+            error_ = "Cooperative writing is only supported for filesystem "
+                     "stores";
+            return false;
+        }
+        if (settings->overwrite) {
+            error_ = "Cannot overwrite a store shared with other writers";
+            return false;
+        }
+        if (settings->cooperative->writer_id == nullptr) {
+            error_ = "Null pointer: writer_id";
+            return false;
+        }
+    }
+
+    if (settings->bandwidth_limit != nullptr &&
+        settings->bandwidth_limit->bytes_per_second == 0) {
+        error_ = "Bandwidth limit must be positive";
+        return false;
+    }
+
     // validate the arrays individually
     for (auto i = 0; i < settings->array_count; ++i) {
         const auto& array_settings = settings->arrays[i];
@@ -1199,11 +1948,51 @@ ZarrStream_s::configure_array_(const ZarrArraySettings* settings,
     if (config == nullptr) {
         return false;
     }
+    config->metadata_update_interval = metadata_update_interval_;
+    config->checkpoint_interval = checkpoint_interval_;
+    config->max_region_buffer_bytes = max_region_buffer_bytes_;
+    config->shard_verifier = shard_verifier_;
+
+    if (resume_) {
+        if (config->downsampling_method) {
+            set_error_("Resuming multiscale arrays is not supported");
+            return false;
+        }
+        if (config->projection_method) {
+            set_error_("Resuming arrays with projections is not supported");
+            return false;
+        }
+        if (config->frame_metadata) {
+            set_error_("Resuming arrays with frame metadata is not supported");
+            return false;
+        }
+        config->resume = true;
+    }
+
+    if (cooperative_store_) {
+        if (!cooperative_store_->claim(config->node_key, error_)) {
+            return false;
+        }
+        if (config->projection_method &&
+            !cooperative_store_->claim(config->projection_key, error_)) {
+            return false;
+        }
+        if (config->frame_metadata &&
+            !cooperative_store_->claim(config->frame_metadata->node_key,
+                                       error_)) {
+            return false;
+        }
+    }
 
     ZarrOutputArray output_node{
         .output_key = config->node_key,
         .frame_buffer_offset = 0,
         .bytes_written = 0,
+        .is_indexed = false,
+        .accepts_frame_index = !config->downsampling_method.has_value(),
+        .frames_per_layer = config->dimensions->frames_per_chunk_layer(),
+        .layer_start = 0,
+        .mutex = std::make_unique<std::mutex>(),
     };
     try {
         output_node.array = zarr::make_array(config,
@@ -1220,17 +2009,52 @@ ZarrStream_s::configure_array_(const ZarrArraySettings* settings,
         return false;
     }
 
-    output_node.max_bytes = output_node.array->max_bytes();
+    if (config->frame_metadata) {
+        try {
+            output_node.frame_metadata =
+              std::make_unique<zarr::FrameMetadataArray>(
+                *config->frame_metadata,
+                thread_pool_,
+                file_handle_pool_,
+                s3_connection_pool_);
+        } catch (const std::exception& exc) {
+            set_error_("Failed to create frame metadata array: " +
+                       std::string(exc.what()));
+            return false;
+        }
+    }
 
-    // initialize frame buffer
+    // initialize frame buffer; packed or unconverted frames travel through
+    // the queue as they are and are only decoded by the array
     const auto& dims = config->dimensions;
-    const auto frame_size_bytes = dims->width_dim().array_size_px *
-                                  dims->height_dim().array_size_px *
-                                  zarr::bytes_of_type(settings->data_type);
+    const size_t px_per_frame =
+      dims->width_dim().array_size_px * dims->height_dim().array_size_px;
+    const auto& reduction = config->frame_reduction;
+    const auto frame_size_bytes = zarr::bytes_of_pixels(
+      config->pixel_format,
+      reduction ? size_t{ reduction->frame_width } * reduction->frame_height
+                : px_per_frame,
+      config->input_conversion ? config->input_conversion->data_type
+                               : settings->data_type);
+
+    // the byte counts seen by the caller are of appended, not stored, frames
+    const auto stored_frame_bytes =
+      px_per_frame * zarr::bytes_of_type(settings->data_type);
+    output_node.max_bytes = output_node.array->max_bytes() /
+                            stored_frame_bytes * frame_size_bytes;
+    output_node.bytes_written = output_node.array->bytes_written() /
+                                stored_frame_bytes * frame_size_bytes;
 
     output_node.frame_buffer.resize_and_fill(frame_size_bytes, 0);
     output_arrays_.emplace(output_node.output_key, std::move(output_node));
 
+    calibration_arrays_.push_back({
+      .data_type = settings->data_type,
+      .frame_bytes = stored_frame_bytes,
+      .compression_params = config->compression_params,
+      .multiscale = config->downsampling_method.has_value(),
+    });
+
     return true;
 }
 
@@ -1355,6 +2179,35 @@ ZarrStream_s::commit_settings_(const struct ZarrStreamSettings_s* settings)
 
     std::optional<std::string> bucket_name;
     s3_settings_ = make_s3_settings(settings->s3_settings);
+    metadata_update_interval_ =
+      std::chrono::milliseconds(settings->metadata_update_interval_ms);
+    consolidate_metadata_ = settings->consolidate_metadata;
+    resume_ = settings->resume;
+    max_region_buffer_bytes_ = settings->max_region_buffer_bytes;
+
+    flush_interval_ = std::chrono::milliseconds(settings->flush_interval_ms);
+    if (s3_settings_ && flush_interval_.count() > 0) {
+        LOG_WARNING("Flushing is not supported for S3 stores, ignoring");
+        flush_interval_ = std::chrono::milliseconds(0);
+    }
+    last_flush_ = std::chrono::steady_clock::now();
+
+    checkpoint_interval_ =
+      std::chrono::milliseconds(settings->checkpoint_interval_ms);
+    if (s3_settings_ && checkpoint_interval_.count() > 0) {
+        LOG_WARNING("Checkpointing is not supported for S3 stores, ignoring");
+        checkpoint_interval_ = std::chrono::milliseconds(0);
+    }
+
+    if (settings->verify_writes) {
+        if (s3_settings_) {
+            LOG_WARNING(
+              "Write verification is not supported for S3 stores, ignoring");
+        } else {
+            shard_verifier_ = std::make_shared<zarr::ShardVerifier>(
+              [this](const std::string& err) { this->set_error_(err); });
+        }
+    }
 
     // create the data store
     if (!create_store_(settings->overwrite)) {
@@ -1362,6 +2215,47 @@ ZarrStream_s::commit_settings_(const struct ZarrStreamSettings_s* settings)
         return false;
     }
 
+    // limit writes from the start, so a calibration measures what the
+    // stream will get
+    if (const auto* limit = settings->bandwidth_limit) {
+        const auto burst_bytes =
+          limit->burst_bytes > 0
+            ? limit->burst_bytes
+            : std::max<uint64_t>(limit->bytes_per_second / 10, 1);
+
+        try {
+            auto bucket = limit->shared
+                            ? zarr::TokenBucket::shared(
+                                limit->bytes_per_second, burst_bytes)
+                            : std::make_shared<zarr::TokenBucket>(
+                                limit->bytes_per_second, burst_bytes);
+            bandwidth_limiter_ =
+              std::make_shared<zarr::BandwidthLimiter>(std::move(bucket));
+        } catch (const std::exception& exc) {
+            set_error_("Failed to limit bandwidth: " + std::string(exc.what()));
+            return false;
+        }
+
+        if (file_handle_pool_) {
+            file_handle_pool_->set_bandwidth_limiter(bandwidth_limiter_);
+        }
+        if (s3_connection_pool_) {
+            s3_connection_pool_->set_bandwidth_limiter(bandwidth_limiter_);
+        }
+    }
+
+    // join the other writers of the store before claiming any arrays
+    if (settings->cooperative != nullptr) {
+        try {
+            cooperative_store_ = std::make_unique<zarr::CooperativeStore>(
+              store_path_, *settings->cooperative);
+        } catch (const std::exception& exc) {
+            set_error_("Failed to join the writers of the store: " +
+                       std::string(exc.what()));
+            return false;
+        }
+    }
+
     // configure flat arrays
     for (auto i = 0; i < settings->array_count; ++i) {
         const auto& array_settings = settings->arrays[i];
@@ -1378,6 +2272,26 @@ ZarrStream_s::commit_settings_(const struct ZarrStreamSettings_s* settings)
         return false;
     }
 
+    if (settings->calibrate) {
+        calibration_ = zarr::calibrate(calibration_arrays_,
+                                       s3_settings_ ? "" : store_path_,
+                                       file_handle_pool_,
+                                       thread_pool_->n_threads(),
+                                       settings->frame_rate_hz);
+    }
+    calibration_arrays_.clear();
+
+    if (settings->capture != nullptr) {
+        try {
+            recorder_ = std::make_unique<zarr::AppendRecorder>(
+              *settings->capture, *settings);
+        } catch (const std::exception& exc) {
+            set_error_("Failed to start capturing appends: " +
+                       std::string(exc.what()));
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -1445,10 +2359,12 @@ ZarrStream_s::create_store_(bool overwrite)
             }
         }
 
-        // create the store path
+        // create the store path; another writer of the store may beat us
+        // to it
         {
             std::error_code ec;
-            if (!fs::create_directories(store_path_, ec)) {
+            if (!fs::create_directories(store_path_, ec) &&
+                !fs::is_directory(store_path_)) {
                 set_error_("Failed to create store path '" + store_path_ +
                            "': " + ec.message());
                 return false;
@@ -1474,8 +2390,8 @@ ZarrStream_s::write_intermediate_metadata_()
       { "attributes", nlohmann::json::object() },
     });
     const std::string metadata_key = "zarr.json";
-    std::string metadata_str;
 
+    std::unordered_map<std::string, nlohmann::json> groups_metadata;
     for (const auto& parent_group_key : intermediate_group_paths_) {
         const std::string relative_path =
           (parent_group_key.empty() ? "" : parent_group_key);
@@ -1492,7 +2408,7 @@ ZarrStream_s::write_intermediate_metadata_()
                 { "plate", plate.to_json() },
             };
 
-            metadata_str = plate_metadata.dump(4);
+            groups_metadata.emplace(relative_path, std::move(plate_metadata));
         } else if (auto wit = wells_.find(relative_path); // is it a well?
                    wit != wells_.end()) {
             const auto& well = wit->second;
@@ -1505,8 +2421,38 @@ ZarrStream_s::write_intermediate_metadata_()
                 { "well", well.to_json() },
             };
 
-            metadata_str = well_metadata.dump(4);
+            groups_metadata.emplace(relative_path, std::move(well_metadata));
         } else { // generic group
+            groups_metadata.emplace(relative_path, group_metadata);
+        }
+    }
+
+    // the other writers of a shared store hand their metadata to the
+    // coordinator, which writes the hierarchy for all of them
+    auto array_metadata = array_metadata_;
+    if (cooperative_store_ && !cooperative_store_->is_coordinator()) {
+        if (!cooperative_store_->publish(
+              groups_metadata, array_metadata, error_)) {
+            set_error_("Failed to publish metadata: " + error_);
+            return false;
+        }
+        return true;
+    }
+    if (cooperative_store_ &&
+        !cooperative_store_->merge(groups_metadata, array_metadata, error_)) {
+        set_error_("Failed to merge metadata: " + error_);
+        return false;
+    }
+
+    for (const auto& [relative_path, group_metadata] : groups_metadata) {
+        std::string metadata_str;
+        if (consolidate_metadata_ &&
+            (relative_path.empty() || is_plate_metadata(group_metadata))) {
+            nlohmann::json metadata(group_metadata);
+            metadata["consolidated_metadata"] = make_consolidated_metadata(
+              relative_path, groups_metadata, array_metadata);
+            metadata_str = metadata.dump(4);
+        } else {
             metadata_str = group_metadata.dump(4);
         }
 
@@ -1527,11 +2473,46 @@ ZarrStream_s::write_intermediate_metadata_()
         if (!metadata_sink->write(0, metadata_span) ||
             !zarr::finalize_sink(std::move(metadata_sink))) {
             set_error_("Failed to write intermediate metadata for group '" +
-                       parent_group_key + "'");
+                       relative_path + "'");
             return false;
         }
     }
 
+    if (cooperative_store_) {
+        cooperative_store_->clean_up();
+    }
+
+    return true;
+}
+
+bool
+ZarrStream_s::enqueue_frame_(zarr::LockedBuffer& frame,
+                             const std::string& key,
+                             std::optional<uint64_t> frame_id)
+{
+    // pushing is lock-free; only wait on the lock when the queue is full
+    if (!frame_queue_->push(frame, key, frame_id)) {
+        if (bandwidth_limiter_) {
+            bandwidth_limiter_->set_under_pressure(true);
+        }
+
+        std::unique_lock lock(frame_queue_mutex_);
+        while (!frame_queue_->push(frame, key, frame_id) && process_frames_) {
+            frame_queue_not_full_cv_.wait(lock);
+        }
+    }
+
+    if (!process_frames_) {
+        return false;
+    }
+
+    // take the lock so the wakeup can't slip in between the consumer checking
+    // the queue and going to sleep
+    {
+        std::unique_lock lock(frame_queue_mutex_);
+    }
+    frame_queue_not_empty_cv_.notify_one();
+
     return true;
 }
 
@@ -1596,10 +2577,18 @@ ZarrStream_s::process_frame_queue_()
     std::string output_key;
 
     zarr::LockedBuffer frame;
+    std::optional<uint64_t> frame_id;
     while (process_frames_ || !frame_queue_->empty()) {
+        // an explicit flush covers everything queued before it was requested
+        const auto flush_now = flush_requested_ && frame_queue_->empty();
+        if (flush_now || flush_due_()) {
+            flush_arrays_(flush_now);
+        }
+
         {
             std::unique_lock lock(frame_queue_mutex_);
-            while (frame_queue_->empty() && process_frames_) {
+            while (frame_queue_->empty() && process_frames_ &&
+                   !flush_requested_ && !flush_due_()) {
                 frame_queue_not_empty_cv_.wait_for(
                   lock, std::chrono::milliseconds(100));
             }
@@ -1617,10 +2606,23 @@ ZarrStream_s::process_frame_queue_()
             }
         }
 
-        if (!frame_queue_->pop(frame, output_key)) {
+        if (!frame_queue_->pop(frame, output_key, frame_id)) {
+            // a producer has claimed the next slot but not filled it yet; it
+            // notifies once it has
+            std::unique_lock lock(frame_queue_mutex_);
+            frame_queue_not_empty_cv_.wait_for(
+              lock, std::chrono::milliseconds(100), [this] {
+                  return frame_queue_->front_ready();
+              });
             continue;
         }
 
+        // let writes borrow bandwidth while frames back up
+        if (bandwidth_limiter_) {
+            bandwidth_limiter_->set_under_pressure(
+              4 * frame_queue_->size() >= 3 * frame_queue_->max_size());
+        }
+
         if (auto it = output_arrays_.find(output_key);
             it == output_arrays_.end()) {
             // If we have gotten here, something has gone seriously wrong
@@ -1632,9 +2634,15 @@ ZarrStream_s::process_frame_queue_()
             auto& output_node = it->second;
 
             size_t n_bytes;
+            auto& array = output_node.array;
             if (const auto result =
-                  output_node.array->write_frame(frame, n_bytes);
-                result != zarr::WriteResult::Ok) {
+                  frame_id ? array->write_frame_at(frame, *frame_id, n_bytes)
+                           : array->write_frame(frame, n_bytes);
+                result == zarr::WriteResult::InvalidFrameIndex) {
+                // indices are checked on append, so this is a bug; drop the
+                // frame rather than the stream
+                LOG_ERROR("Dropping frame for key: ", output_key);
+            } else if (result != zarr::WriteResult::Ok) {
                 // TODO (aliddell): retry on WriteResult::PartialWrite
                 set_error_("Failed to write frame to writer for key: " +
                            output_key);
@@ -1685,6 +2693,40 @@ ZarrStream_s::finalize_frame_queue_()
                                   [this] { return frame_queue_->empty(); });
 }
 
+bool
+ZarrStream_s::flush_due_() const
+{
+    return flush_interval_.count() > 0 &&
+           std::chrono::steady_clock::now() - last_flush_ >= flush_interval_;
+}
+
+void
+ZarrStream_s::flush_arrays_(bool requested)
+{
+    bool success = true;
+    for (auto& [key, output] : output_arrays_) {
+        try {
+            if (!output.array->flush()) {
+                LOG_ERROR("Failed to flush array '", key, "'");
+                success = false;
+            }
+        } catch (const std::exception& exc) {
+            LOG_ERROR("Failed to flush array '", key, "': ", exc.what());
+            success = false;
+        }
+    }
+    last_flush_ = std::chrono::steady_clock::now();
+
+    if (requested) {
+        std::unique_lock lock(frame_queue_mutex_);
+        flush_succeeded_ = success;
+        flush_requested_ = false;
+        flush_finished_cv_.notify_all();
+    } else if (!success) {
+        LOG_WARNING("Timed flush failed, data remains in memory");
+    }
+}
+
 bool
 finalize_stream(struct ZarrStream_s* stream)
 {
@@ -1707,13 +2749,35 @@ finalize_stream(struct ZarrStream_s* stream)
     }
 
     for (auto& [key, output] : stream->output_arrays_) {
-        if (!zarr::finalize_array(std::move(output.array))) {
+        if (!zarr::finalize_array(std::move(output.array),
+                                  stream->array_metadata_)) {
             LOG_ERROR(
               "Error finalizing Zarr stream. Failed to finalize array '",
               key,
               "'");
             return false;
         }
+
+        // the thread pool has stopped, so the last shard is written here
+        if (auto& frame_metadata = output.frame_metadata) {
+            std::string metadata, error;
+            if (!frame_metadata->close(metadata, error)) {
+                LOG_ERROR("Error finalizing Zarr stream. Failed to write frame "
+                          "metadata of array '",
+                          key,
+                          "': ",
+                          error);
+                return false;
+            }
+            stream->array_metadata_[frame_metadata->node_key()] = metadata;
+        }
+    }
+
+    // every shard is final now; wait for the last of them to be verified
+    size_t n_failed = 0;
+    if (stream->shard_verifier_) {
+        stream->shard_verifier_->finish();
+        stream->shard_verifier_->shards_verified(n_failed);
     }
 
     if (!stream->write_intermediate_metadata_()) {
@@ -1721,5 +2785,13 @@ finalize_stream(struct ZarrStream_s* stream)
         return false;
     }
 
+    // most shards are only finalized above, too late to fail an append
+    if (n_failed > 0) {
+        LOG_ERROR("Error finalizing Zarr stream. ",
+                  n_failed,
+                  " shard(s) failed verification");
+        return false;
+    }
+
     return true;
 }
@@ -1,25 +1,33 @@
 #pragma once
 
+#include "append.recorder.hh"
 #include "array.hh"
 #include "array.dimensions.hh"
+#include "bandwidth.limiter.hh"
+#include "calibration.hh"
+#include "cooperative.store.hh"
 #include "definitions.hh"
 #include "downsampler.hh"
 #include "file.handle.hh"
+#include "frame.metadata.array.hh"
 #include "frame.queue.hh"
 #include "locked.buffer.hh"
 #include "multiscale.array.hh"
 #include "plate.hh"
 #include "s3.connection.hh"
+#include "shard.verifier.hh"
 #include "sink.hh"
 #include "thread.pool.hh"
 
 #include <nlohmann/json.hpp>
 
+#include <chrono>
 #include <condition_variable>
 #include <cstddef> // size_t
 #include <memory>  // unique_ptr
 #include <mutex>
 #include <optional>
+#include <set>
 #include <span>
 #include <string_view>
 #include <unordered_map>
@@ -43,6 +51,35 @@ struct ZarrStream_s
                           size_t bytes_in,
                           size_t& bytes_out);
 
+    /**
+     * @brief Append a single frame at an explicit index along the non-spatial
+     * dimensions.
+     * @param key The key of the array to append to.
+     * @param data_ Pointer to the frame data.
+     * @param bytes_in The number of bytes in the frame.
+     * @param frame_index The index the frame would have in an in-order append.
+     * @return ZarrStatusCode_Success on successful append, or an error code on
+     * failure.
+     */
+    ZarrStatusCode append_frame(const char* key,
+                                const void* data_,
+                                size_t bytes_in,
+                                uint64_t frame_index);
+
+    /**
+     * @brief Append per-frame metadata records to an array.
+     * @param key The key of the array the records describe.
+     * @param data_ Pointer to the records.
+     * @param bytes_in The number of bytes of records.
+     * @param bytes_out The number of bytes appended.
+     * @return ZarrStatusCode_Success on successful append, or an error code on
+     * failure.
+     */
+    ZarrStatusCode append_frame_metadata(const char* key,
+                                         const void* data_,
+                                         size_t bytes_in,
+                                         size_t& bytes_out);
+
     /**
      * @brief Write custom metadata to the stream.
      * @param custom_metadata JSON-formatted custom metadata to write.
@@ -53,6 +90,80 @@ struct ZarrStream_s
     ZarrStatusCode write_custom_metadata(std::string_view custom_metadata,
                                          bool overwrite);
 
+    /**
+     * @brief Write all frames appended so far to storage, leaving the stream
+     * open.
+     * @details Blocks until the frame queue has drained and every array has
+     * written its open chunk layer and shard indices.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode flush();
+
+    /**
+     * @brief Write an encoded chunk directly to an array, bypassing the frame
+     * queue.
+     * @param key The key of the array to write to.
+     * @param chunk_coords Chunk lattice coordinates of the chunk.
+     * @param data_ Pointer to the chunk data.
+     * @param bytes_in The number of bytes of chunk data.
+     * @param is_compressed True if the chunk is already compressed with the
+     * array's codec.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode write_chunk(const char* key,
+                               std::span<const uint64_t> chunk_coords,
+                               const void* data_,
+                               size_t bytes_in,
+                               bool is_compressed);
+
+    /**
+     * @brief Write a hyperslab of data directly to an array, bypassing the
+     * frame queue.
+     * @param key The key of the array to write to.
+     * @param offset The offset of the region, in pixels.
+     * @param shape The shape of the region, in pixels.
+     * @param data_ Pointer to the region data, in C order.
+     * @param bytes_in The number of bytes of region data.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode write_region(const char* key,
+                                std::span<const uint64_t> offset,
+                                std::span<const uint64_t> shape,
+                                const void* data_,
+                                size_t bytes_in);
+
+    /**
+     * @brief Get the pixel statistics of an array, or of one of its channels.
+     * @param key The key of the array.
+     * @param channel The channel index, or -1 for the whole array.
+     * @param[out] stats The statistics.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode get_statistics(const char* key,
+                                  int64_t channel,
+                                  ZarrArrayStatistics* stats) const;
+
+    /**
+     * @brief Copy out the most recent frame appended to an array.
+     * @param key The key of the array.
+     * @param level The multiscale level, 0 for full resolution.
+     * @param data Buffer to copy the frame into, or nullptr for only @p info.
+     * @param bytes_in The size of @p data in bytes.
+     * @param[out] info The size and data type of the frame, and its index.
+     * @return ZarrStatusCode_Success on success, or an error code on failure.
+     */
+    ZarrStatusCode get_preview(const char* key,
+                               uint16_t level,
+                               void* data,
+                               size_t bytes_in,
+                               ZarrPreviewInfo* info) const;
+
+    /**
+     * @brief Get the results of the startup calibration.
+     * @return The calibration, with calibrated false if none was run.
+     */
+    const ZarrCalibration& calibration() const noexcept;
+
     /**
      * @brief Get the current memory usage of the stream.
      * @return The current memory usage in bytes.
@@ -66,14 +177,60 @@ struct ZarrStream_s
         zarr::LockedBuffer frame_buffer;
         size_t frame_buffer_offset;
         std::unique_ptr<zarr::ArrayBase> array;
+        std::unique_ptr<zarr::FrameMetadataArray> frame_metadata;
         size_t max_bytes;
         size_t bytes_written;
+
+        // mirrors the array's reorder window for frames appended by index, so
+        // a bad index fails the call that made it instead of the consumer
+        bool is_indexed;
+        bool accepts_frame_index; // false if frames must arrive in order
+        uint64_t frames_per_layer;
+        uint64_t layer_start;                // first frame of the open layer
+        std::set<uint64_t> frames_received; // at or after layer_start
+
+        // guards the frame buffer, byte counts, and reorder window, so
+        // producers appending to different arrays don't contend
+        std::unique_ptr<std::mutex> mutex;
     };
 
     std::string error_; // error message. If nonempty, an error occurred.
 
     std::string store_path_;
     std::optional<zarr::S3Settings> s3_settings_;
+    std::chrono::milliseconds metadata_update_interval_{ 0 };
+    bool consolidate_metadata_{ false };
+    std::chrono::milliseconds checkpoint_interval_{ 0 };
+    bool resume_{ false };
+    size_t max_region_buffer_bytes_{ 0 };
+    std::shared_ptr<zarr::ShardVerifier> shard_verifier_;
+
+    // what each configured array stores and how it compresses, for the
+    // startup calibration
+    std::vector<zarr::CalibrationArray> calibration_arrays_;
+    ZarrCalibration calibration_{};
+
+    // logs each append for replay, if capturing
+    std::unique_ptr<zarr::AppendRecorder> recorder_;
+
+    // claims arrays in and merges metadata of a store shared with other
+    // writers
+    std::unique_ptr<zarr::CooperativeStore> cooperative_store_;
+
+    // limits writes through the file handle or S3 connection pool
+    std::shared_ptr<zarr::BandwidthLimiter> bandwidth_limiter_;
+
+    // time-based flushes are run by the frame queue thread, explicit flushes
+    // are requested from the caller's thread and wait for it
+    std::chrono::milliseconds flush_interval_{ 0 };
+    std::chrono::steady_clock::time_point last_flush_;
+    std::atomic<bool> flush_requested_{ false };
+    bool flush_succeeded_{ true };
+    std::condition_variable flush_finished_cv_;
+
+    // final metadata of each array node, keyed by path relative to the store
+    // root, collected when the arrays are finalized
+    std::unordered_map<std::string, std::string> array_metadata_;
 
     // maps of plates and wells, key by their paths relative to the store root
     std::unordered_map<std::string, zarr::Plate> plates_;
@@ -98,6 +255,16 @@ struct ZarrStream_s
 
     bool is_s3_acquisition_() const;
 
+    /**
+     * @brief Append data to the stream with a specific key, without
+     * capturing the append.
+     * @see append
+     */
+    ZarrStatusCode append_(const char* key,
+                           const void* data_,
+                           size_t bytes_in,
+                           size_t& bytes_out);
+
     /**
      * @brief Check that the settings are valid.
      * @note Sets the error_ member if settings are invalid.
@@ -163,6 +330,27 @@ struct ZarrStream_s
      */
     [[nodiscard]] bool write_intermediate_metadata_();
 
+    /**
+     * @brief Push a frame onto the frame queue, waiting for space if it is
+     * full.
+     * @return True if the frame was queued, false if frame processing has
+     * stopped.
+     */
+    [[nodiscard]] bool enqueue_frame_(zarr::LockedBuffer& frame,
+                                      const std::string& key,
+                                      std::optional<uint64_t> frame_id);
+
+    /**
+     * @brief Check @p frame_index against the reorder window of @p output and
+     * move the window past it, as the array will once the frame is processed.
+     * @note Call with the array's mutex held.
+     * @return ZarrStatusCode_Success if the frame can be written, or
+     * ZarrStatusCode_InvalidIndex if its layer was already written or it was
+     * already appended.
+     */
+    [[nodiscard]] ZarrStatusCode advance_frame_window_(ZarrOutputArray& output,
+                                                       uint64_t frame_index);
+
     /** @brief Initialize the frame queue. */
     [[nodiscard]] bool init_frame_queue_();
 
@@ -172,6 +360,15 @@ struct ZarrStream_s
     /** @brief Wait for the frame queue to finish processing. */
     void finalize_frame_queue_();
 
+    /** @brief Check whether a timed flush is due. */
+    bool flush_due_() const;
+
+    /**
+     * @brief Flush every array, from the frame queue thread.
+     * @param requested True if an explicit flush is waiting on the result.
+     */
+    void flush_arrays_(bool requested);
+
     friend bool finalize_stream(struct ZarrStream_s* stream);
 };
 
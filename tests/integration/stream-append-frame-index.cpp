@@ -0,0 +1,219 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int array_channels = 3;
+const unsigned int chunk_timepoints = 2, shard_timepoints = 2;
+
+const size_t bytes_per_frame = array_width * array_height;
+
+// frames arrive out of order and reach into the next chunk layer; frame 13
+// never arrives
+const std::vector<uint64_t> frame_order = { 7,  6,  5, 3, 4, 1,  0,
+                                            2,  12, 11, 10, 9, 8, 14 };
+const uint64_t missing_frame = 13;
+const unsigned int n_timepoints = 5;
+
+const uint64_t frames_per_layer = chunk_timepoints * array_channels;
+
+ZarrStream*
+make_stream()
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint8,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 4));
+    array.dimensions[0] = DIM("t",
+                              ZarrDimensionType_Time,
+                              0,
+                              chunk_timepoints,
+                              shard_timepoints,
+                              nullptr,
+                              1.0);
+    array.dimensions[1] = DIM(
+      "c", ZarrDimensionType_Channel, array_channels, 1, 1, nullptr, 1.0);
+    array.dimensions[2] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              array_height,
+                              1,
+                              nullptr,
+                              1.0);
+    array.dimensions[3] = DIM(
+      "x", ZarrDimensionType_Space, array_width, array_width, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+append_frame(ZarrStream* stream, uint64_t frame_id)
+{
+    std::vector<uint8_t> frame(bytes_per_frame, frame_id + 1);
+    CHECK_OK(ZarrStream_append_frame(
+      stream, frame.data(), frame.size(), frame_id, nullptr));
+}
+
+void
+check_frame(uint64_t frame_id, const std::set<uint64_t>& missing_frames)
+{
+    const auto t = frame_id / array_channels;
+    const auto c = frame_id % array_channels;
+    const auto shard_t = t / (chunk_timepoints * shard_timepoints);
+    const auto shard_path = test_path / "c" / std::to_string(shard_t) /
+                            std::to_string(c) / "0" / "0";
+
+    std::ifstream ifs(shard_path, std::ios::binary);
+    EXPECT(ifs.good(), "Missing shard ", shard_path.string());
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const size_t table_size = 2 * shard_timepoints * sizeof(uint64_t);
+    CHECK(shard.size() >= table_size + sizeof(uint32_t));
+
+    const auto* index = shard.data() + shard.size() - table_size - 4;
+    uint32_t checksum;
+    memcpy(&checksum, index + table_size, sizeof(checksum));
+    EXPECT_EQ(uint32_t, checksum, crc32c::Crc32c(index, table_size));
+
+    std::vector<uint64_t> table(2 * shard_timepoints);
+    memcpy(table.data(), index, table_size);
+
+    const auto chunk = t / chunk_timepoints % shard_timepoints;
+    const auto offset =
+      table[2 * chunk] + (t % chunk_timepoints) * bytes_per_frame;
+    CHECK(offset + bytes_per_frame <= shard.size());
+
+    const uint8_t expected =
+      missing_frames.contains(frame_id) ? 0 : frame_id + 1;
+    for (auto i = 0; i < bytes_per_frame; ++i) {
+        EXPECT_EQ(int, shard[offset + i], expected);
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        std::vector<uint8_t> frame(bytes_per_frame);
+
+        // only whole frames can be appended by index
+        CHECK(ZarrStream_append_frame(
+                stream, frame.data(), frame.size() - 1, 0, nullptr) ==
+              ZarrStatusCode_InvalidArgument);
+
+        for (const auto frame_id : frame_order) {
+            std::ranges::fill(frame, static_cast<uint8_t>(frame_id + 1));
+            CHECK_OK(ZarrStream_append_frame(
+              stream, frame.data(), frame.size(), frame_id, nullptr));
+        }
+
+        ZarrStream_destroy(stream);
+
+        for (auto i = 0; i < n_timepoints * array_channels; ++i) {
+            check_frame(i, { missing_frame });
+        }
+
+        std::ifstream ifs(test_path / "zarr.json");
+        auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_timepoints);
+        ifs.close();
+
+        // bad indices fail the append, and leave the stream usable
+        stream = make_stream();
+        CHECK(stream);
+
+        // frame 5 is dropped, which holds the first layer open
+        for (auto i = 0; i < 5; ++i) {
+            append_frame(stream, i);
+        }
+        EXPECT_EQ(int,
+                  ZarrStream_append_frame(
+                    stream, frame.data(), frame.size(), 3, nullptr),
+                  ZarrStatusCode_InvalidIndex);
+        for (auto i = frames_per_layer; i < 2 * frames_per_layer; ++i) {
+            append_frame(stream, i);
+        }
+
+        // a frame past the window forces the first layer out without frame 5,
+        // which can no longer be appended
+        append_frame(stream, 2 * frames_per_layer);
+        EXPECT_EQ(int,
+                  ZarrStream_append_frame(
+                    stream, frame.data(), frame.size(), 5, nullptr),
+                  ZarrStatusCode_InvalidIndex);
+
+        // a frame far past the window forces out every layer before it
+        const uint64_t last_frame = 32;
+        for (auto i = 2 * frames_per_layer + 1; i < 3 * frames_per_layer;
+             ++i) {
+            append_frame(stream, i);
+        }
+        append_frame(stream, last_frame);
+        append_frame(stream, last_frame - 2);
+        append_frame(stream, last_frame - 1);
+
+        // an array written by index can't be appended to in order
+        size_t bytes_out;
+        EXPECT_EQ(int,
+                  ZarrStream_append(
+                    stream, frame.data(), frame.size(), &bytes_out, nullptr),
+                  ZarrStatusCode_InvalidArgument);
+
+        ZarrStream_destroy(stream);
+
+        std::set<uint64_t> missing_frames{ 5 };
+        for (auto i = 3 * frames_per_layer; i < last_frame - 2; ++i) {
+            missing_frames.insert(i);
+        }
+        for (auto i = 0; i <= last_frame; ++i) {
+            check_frame(i, missing_frames);
+        }
+
+        ifs.open(test_path / "zarr.json");
+        metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int,
+                  metadata["shape"][0].get<int>(),
+                  (last_frame + 1) / array_channels);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,133 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int n_frames = 16;
+const size_t frame_bytes = array_width * array_height;
+
+constexpr uint64_t bytes_per_second = 64 << 10;
+constexpr uint64_t burst_bytes = 8 << 10;
+
+ZarrStream*
+make_stream(ZarrBandwidthLimit* bandwidth_limit)
+{
+    ZarrArraySettings array = {
+        .output_key = "raw",
+        .data_type = ZarrDataType_uint8,
+    };
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, 2, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM(
+      "y", ZarrDimensionType_Space, array_height, 16, 1, nullptr, 1.0);
+    array.dimensions[2] =
+      DIM("x", ZarrDimensionType_Space, array_width, 16, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .max_threads = 2,
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+        .bandwidth_limit = bandwidth_limit,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+check_bandwidth_limit()
+{
+    ZarrBandwidthLimit limit = {
+        .bytes_per_second = bytes_per_second,
+        .burst_bytes = burst_bytes,
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    ZarrStream* stream = make_stream(&limit);
+    CHECK(stream);
+
+    std::vector<uint8_t> frame(frame_bytes);
+    for (auto t = 0; t < n_frames; ++t) {
+        std::fill(frame.begin(), frame.end(), t);
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(
+          stream, frame.data(), frame.size(), &bytes_out, nullptr));
+        EXPECT_EQ(int, bytes_out, frame.size());
+    }
+    ZarrStream_destroy(stream);
+
+    // everything beyond the first burst is written at the limit
+    const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    const double expected =
+      static_cast<double>(n_frames * frame_bytes - burst_bytes) /
+      bytes_per_second;
+    EXPECT(elapsed.count() >= 0.9 * expected,
+           "Expected writing to take at least ",
+           0.9 * expected,
+           " s, took ",
+           elapsed.count());
+
+    // all the data made it out
+    const auto chunk_dir = test_path / "raw" / "c";
+    CHECK(fs::is_directory(chunk_dir));
+    size_t n_bytes = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(chunk_dir)) {
+        if (entry.is_regular_file()) {
+            n_bytes += entry.file_size();
+        }
+    }
+    EXPECT(n_bytes >= n_frames * frame_bytes,
+           "Expected at least ",
+           n_frames * frame_bytes,
+           " bytes of chunks, got ",
+           n_bytes);
+}
+
+void
+check_invalid_settings()
+{
+    ZarrBandwidthLimit limit = {
+        .bytes_per_second = 0,
+    };
+    EXPECT(make_stream(&limit) == nullptr,
+           "Expected a zero bandwidth limit to fail");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_bandwidth_limit();
+        check_invalid_settings();
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,149 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 256, array_height = 192;
+const unsigned int n_frames = 8;
+
+ZarrStream*
+make_stream(bool calibrate, double frame_rate_hz)
+{
+    ZarrCompressionSettings compression = {
+        .compressor = ZarrCompressor_Blosc1,
+        .codec = ZarrCompressionCodec_BloscZstd,
+        .level = 1,
+        .shuffle = 1,
+    };
+
+    ZarrArraySettings array = {
+        .compression_settings = &compression,
+        .data_type = ZarrDataType_uint16,
+    };
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, 4, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM(
+      "y", ZarrDimensionType_Space, array_height, 64, 1, nullptr, 1.0);
+    array.dimensions[2] =
+      DIM("x", ZarrDimensionType_Space, array_width, 64, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .max_threads = 4,
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+        .calibrate = calibrate,
+        .frame_rate_hz = frame_rate_hz,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+write_frames(ZarrStream* stream)
+{
+    std::vector<uint16_t> frame(array_width * array_height, 42);
+    for (auto t = 0; t < n_frames; ++t) {
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(stream,
+                                   frame.data(),
+                                   frame.size() * sizeof(uint16_t),
+                                   &bytes_out,
+                                   nullptr));
+    }
+}
+
+void
+check_calibrated()
+{
+    // far faster than any host can keep up with, which only warns
+    ZarrStream* stream = make_stream(true, 1e9);
+    CHECK(stream);
+
+    ZarrCalibration calibration;
+    const auto status = ZarrStream_get_calibration(stream, &calibration);
+    write_frames(stream);
+    ZarrStream_destroy(stream);
+    CHECK_OK(status);
+
+    // the pool is never larger than the host
+    CHECK(calibration.calibrated);
+    CHECK(calibration.threads >= 1 && calibration.threads <= 4);
+    CHECK(calibration.compress_bytes_per_second > 0.0);
+    CHECK(calibration.write_bytes_per_second > 0.0);
+    CHECK(calibration.max_frame_rate_hz > 0.0);
+    CHECK(calibration.max_frame_rate_hz < 1e9);
+    if (calibration.threads > 1) {
+        EXPECT_EQ(int,
+                  calibration.compression_threads + calibration.io_threads,
+                  calibration.threads);
+    }
+
+    // the scratch file doesn't outlive the calibration
+    for (const auto& entry : fs::directory_iterator(test_path)) {
+        EXPECT(entry.path().filename() != ".calibration",
+               "Unexpected file: ",
+               entry.path());
+    }
+    CHECK(fs::exists(test_path / "c" / "0" / "0" / "0"));
+}
+
+void
+check_not_calibrated()
+{
+    ZarrStream* stream = make_stream(false, 0.0);
+    CHECK(stream);
+
+    ZarrCalibration calibration;
+    calibration.calibrated = true;
+    const auto status = ZarrStream_get_calibration(stream, &calibration);
+    ZarrStream_destroy(stream);
+    CHECK_OK(status);
+    CHECK(!calibration.calibrated);
+
+    EXPECT_EQ(int,
+              ZarrStream_get_calibration(nullptr, &calibration),
+              ZarrStatusCode_InvalidArgument);
+}
+
+void
+check_invalid_frame_rate()
+{
+    ZarrStream* stream = make_stream(true, -1.0);
+    EXPECT(stream == nullptr, "Expected a negative frame rate to fail");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_calibrated();
+        check_not_calibrated();
+        check_invalid_frame_rate();
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
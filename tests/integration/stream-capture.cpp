@@ -0,0 +1,173 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+const fs::path capture_path = TEST ".jsonl";
+const std::string payload_path = capture_path.string() + ".payloads";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int n_frames = 6;
+const size_t frame_bytes = array_width * array_height * sizeof(uint16_t);
+
+ZarrStream*
+make_stream(ZarrCaptureSettings* capture)
+{
+    ZarrArraySettings array = {
+        .output_key = "raw",
+        .data_type = ZarrDataType_uint16,
+    };
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, 2, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM(
+      "y", ZarrDimensionType_Space, array_height, 16, 1, nullptr, 1.0);
+    array.dimensions[2] =
+      DIM("x", ZarrDimensionType_Space, array_width, 16, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .max_threads = 2,
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+        .capture = capture,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+check_capture()
+{
+    ZarrCaptureSettings capture = {
+        .path = capture_path.c_str(),
+        .hash_payloads = true,
+        .payload_sample_interval = 3,
+    };
+    ZarrStream* stream = make_stream(&capture);
+    CHECK(stream);
+
+    std::vector<uint16_t> frame(array_width * array_height);
+    for (auto t = 0; t < n_frames; ++t) {
+        std::fill(frame.begin(), frame.end(), t);
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(
+          stream, frame.data(), frame_bytes, &bytes_out, "raw"));
+        EXPECT_EQ(int, bytes_out, frame_bytes);
+    }
+
+    // failed appends are captured too
+    size_t bytes_out;
+    EXPECT_EQ(
+      int,
+      ZarrStream_append(stream, frame.data(), frame_bytes, &bytes_out, "nope"),
+      ZarrStatusCode_KeyNotFound);
+
+    ZarrStream_destroy(stream);
+
+    std::ifstream file(capture_path);
+    CHECK(file.is_open());
+
+    std::vector<nlohmann::json> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(nlohmann::json::parse(line));
+    }
+    EXPECT_EQ(int, lines.size(), n_frames + 2);
+
+    const auto& settings = lines[0]["settings"];
+    EXPECT_STR_EQ(settings["store_path"].get<std::string>().c_str(),
+                  test_path.c_str());
+    EXPECT_EQ(int, settings["arrays"].size(), 1);
+    EXPECT_STR_EQ(
+      settings["arrays"][0]["output_key"].get<std::string>().c_str(), "raw");
+
+    for (auto t = 0; t < n_frames; ++t) {
+        const auto& record = lines[t + 1];
+        EXPECT_STR_EQ(record["key"].get<std::string>().c_str(), "raw");
+        EXPECT_EQ(int, record["bytes_in"].get<int>(), frame_bytes);
+        EXPECT_EQ(int, record["bytes_out"].get<int>(), frame_bytes);
+        EXPECT_EQ(int, record["status"].get<int>(), ZarrStatusCode_Success);
+        CHECK(record.contains("crc32c"));
+        CHECK(record["latency_ns"].get<int64_t>() > 0);
+        CHECK(record.contains("payload_offset") == (t % 3 == 0));
+    }
+
+    // the same frame content hashes the same
+    EXPECT_EQ(uint32_t,
+              lines[n_frames]["crc32c"].get<uint32_t>(),
+              lines[n_frames + 1]["crc32c"].get<uint32_t>());
+
+    const auto& failed = lines.back();
+    EXPECT_STR_EQ(failed["key"].get<std::string>().c_str(), "nope");
+    EXPECT_EQ(int, failed["bytes_out"].get<int>(), 0);
+    EXPECT_EQ(int, failed["status"].get<int>(), ZarrStatusCode_KeyNotFound);
+
+    // appends 0, 3 and the failed 6 are sampled
+    CHECK(failed.contains("payload_offset"));
+    EXPECT_EQ(int, fs::file_size(payload_path), 3 * frame_bytes);
+    std::ifstream payloads(payload_path, std::ios::binary);
+    std::vector<uint16_t> sampled(array_width * array_height);
+    payloads.seekg(lines[4]["payload_offset"].get<std::streamoff>());
+    payloads.read(reinterpret_cast<char*>(sampled.data()), frame_bytes);
+    CHECK(payloads.good());
+    EXPECT_EQ(int, sampled.front(), 3);
+    EXPECT_EQ(int, sampled.back(), 3);
+}
+
+void
+check_invalid_capture()
+{
+    ZarrCaptureSettings capture = { .path = "" };
+    EXPECT(make_stream(&capture) == nullptr,
+           "Expected an empty capture path to fail");
+
+    capture.path = nullptr;
+    EXPECT(make_stream(&capture) == nullptr,
+           "Expected a null capture path to fail");
+
+    const auto missing = fs::path(TEST "-missing") / "capture.jsonl";
+    capture.path = missing.c_str();
+    EXPECT(make_stream(&capture) == nullptr,
+           "Expected an unwritable capture path to fail");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_capture();
+        check_invalid_capture();
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    for (const auto& path :
+         { test_path, capture_path, fs::path(payload_path) }) {
+        if (fs::exists(path)) {
+            fs::remove_all(path);
+        }
+    }
+
+    return retval;
+}
@@ -0,0 +1,233 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 32, array_height = 32, array_planes = 4;
+const unsigned int chunk_width = 16, chunk_height = 16;
+const unsigned int n_timepoints = 2;
+
+// each shard holds one timepoint: 4 z chunks of 2x2 tiles
+const size_t chunks_per_shard = 16;
+
+uint8_t
+pixel_value(uint64_t t, uint64_t z, uint64_t y, uint64_t x)
+{
+    return static_cast<uint8_t>(t * 101 + z * 53 + y * 3 + x);
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrCompressionSettings compression = {
+        .compressor = ZarrCompressor_Blosc1,
+        .codec = ZarrCompressionCodec_BloscLZ4,
+        .level = 1,
+        .shuffle = 1,
+    };
+
+    ZarrArraySettings arrays[2] = {
+        {
+          .output_key = "tile",
+          .compression_settings = &compression,
+          .data_type = ZarrDataType_uint8,
+          .chunk_order = ZarrChunkOrder_TileMajor,
+        },
+        {
+          .output_key = "morton",
+          .data_type = ZarrDataType_uint8,
+          .chunk_order = ZarrChunkOrder_Morton,
+        },
+    };
+
+    for (auto& array : arrays) {
+        CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 4));
+        array.dimensions[0] =
+          DIM("t", ZarrDimensionType_Time, 0, 1, 1, nullptr, 1.0);
+        array.dimensions[1] = DIM(
+          "z", ZarrDimensionType_Space, array_planes, 1, 4, nullptr, 1.0);
+        array.dimensions[2] = DIM("y",
+                                  ZarrDimensionType_Space,
+                                  array_height,
+                                  chunk_height,
+                                  2,
+                                  nullptr,
+                                  1.0);
+        array.dimensions[3] = DIM("x",
+                                  ZarrDimensionType_Space,
+                                  array_width,
+                                  chunk_width,
+                                  2,
+                                  nullptr,
+                                  1.0);
+    }
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = arrays,
+        .array_count = 2,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    for (auto& array : arrays) {
+        ZarrArraySettings_destroy_dimension_array(&array);
+    }
+
+    return stream;
+}
+
+void
+write_frames(ZarrStream* stream)
+{
+    std::vector<uint8_t> frame(array_width * array_height);
+    for (auto t = 0; t < n_timepoints; ++t) {
+        for (auto z = 0; z < array_planes; ++z) {
+            for (auto y = 0; y < array_height; ++y) {
+                for (auto x = 0; x < array_width; ++x) {
+                    frame[y * array_width + x] = pixel_value(t, z, y, x);
+                }
+            }
+
+            size_t bytes_out;
+            for (const auto* key : { "tile", "morton" }) {
+                CHECK_OK(ZarrStream_append(
+                  stream, frame.data(), frame.size(), &bytes_out, key));
+            }
+        }
+    }
+}
+
+std::vector<uint64_t>
+read_shard_table(const fs::path& shard_path)
+{
+    std::vector<uint64_t> table(2 * chunks_per_shard);
+    const auto table_size = table.size() * sizeof(uint64_t);
+
+    std::ifstream file(shard_path, std::ios::binary);
+    file.seekg(-static_cast<std::streamoff>(table_size + sizeof(uint32_t)),
+               std::ios::end);
+    file.read(reinterpret_cast<char*>(table.data()), table_size);
+    CHECK(file.good());
+
+    return table;
+}
+
+size_t
+internal_index(size_t z, size_t y, size_t x)
+{
+    return (z * 2 + y) * 2 + x;
+}
+
+void
+check_tile_major(const std::vector<uint64_t>& table)
+{
+    // all four z chunks of each tile lie back to back
+    for (auto y = 0; y < 2; ++y) {
+        for (auto x = 0; x < 2; ++x) {
+            for (auto z = 1; z < array_planes; ++z) {
+                const auto prev = internal_index(z - 1, y, x);
+                const auto curr = internal_index(z, y, x);
+                EXPECT_EQ(uint64_t,
+                          table[2 * curr],
+                          table[2 * prev] + table[2 * prev + 1]);
+            }
+        }
+    }
+}
+
+void
+check_morton(const std::vector<uint64_t>& table)
+{
+    // the 2x2x2 block of chunks nearest the origin comes first, in one piece
+    std::vector<std::pair<uint64_t, uint64_t>> extents;
+    for (auto z = 0; z < 2; ++z) {
+        for (auto y = 0; y < 2; ++y) {
+            for (auto x = 0; x < 2; ++x) {
+                const auto i = internal_index(z, y, x);
+                extents.emplace_back(table[2 * i], table[2 * i + 1]);
+            }
+        }
+    }
+    std::ranges::sort(extents);
+
+    uint64_t end = 0;
+    for (const auto& [offset, nbytes] : extents) {
+        EXPECT_EQ(uint64_t, offset, end);
+        end = offset + nbytes;
+    }
+}
+
+void
+check_read_back(const char* key)
+{
+    const ZarrReaderSettings settings = {
+        .store_path = test_path.c_str(),
+        .array_key = key,
+    };
+    ZarrReader* reader = ZarrReader_open(&settings);
+    CHECK(reader);
+
+    std::vector<uint8_t> data(n_timepoints * array_planes * array_height *
+                              array_width);
+    const uint64_t offset[4] = { 0, 0, 0, 0 };
+    const uint64_t shape[4] = {
+        n_timepoints, array_planes, array_height, array_width
+    };
+    const auto status = ZarrReader_read_region(
+      reader, offset, shape, 4, data.data(), data.size());
+    ZarrReader_close(reader);
+    CHECK_OK(status);
+
+    size_t i = 0;
+    for (auto t = 0; t < n_timepoints; ++t) {
+        for (auto z = 0; z < array_planes; ++z) {
+            for (auto y = 0; y < array_height; ++y) {
+                for (auto x = 0; x < array_width; ++x) {
+                    EXPECT_EQ(int, data[i++], pixel_value(t, z, y, x));
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+        write_frames(stream);
+        ZarrStream_destroy(stream);
+
+        for (auto t = 0; t < n_timepoints; ++t) {
+            const auto shard = fs::path("c") / std::to_string(t) / "0/0/0";
+            check_tile_major(read_shard_table(test_path / "tile" / shard));
+            check_morton(read_shard_table(test_path / "morton" / shard));
+        }
+
+        check_read_back("tile");
+        check_read_back("morton");
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,202 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48, array_planes = 3;
+
+void
+set_dimensions(ZarrArraySettings* array)
+{
+    CHECK(ZarrArraySettings_create_dimension_array(array, 3) ==
+          ZarrStatusCode_Success);
+    array->dimensions[0] = {
+        .name = "z",
+        .type = ZarrDimensionType_Space,
+        .array_size_px = 0,
+        .chunk_size_px = 1,
+        .shard_size_chunks = 1,
+    };
+    array->dimensions[1] = {
+        .name = "y",
+        .type = ZarrDimensionType_Space,
+        .array_size_px = array_height,
+        .chunk_size_px = 16,
+        .shard_size_chunks = 2,
+    };
+    array->dimensions[2] = {
+        .name = "x",
+        .type = ZarrDimensionType_Space,
+        .array_size_px = array_width,
+        .chunk_size_px = 16,
+        .shard_size_chunks = 2,
+    };
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrHCSWell well = {
+        .row_name = "A",
+        .column_name = "1",
+    };
+    CHECK(ZarrHCSWell_create_image_array(&well, 1) == ZarrStatusCode_Success);
+
+    ZarrArraySettings fov{
+        .data_type = ZarrDataType_uint8,
+    };
+    set_dimensions(&fov);
+    well.images[0] = {
+        .path = "fov1", // full path: plate/A/1/fov1
+        .acquisition_id = 0,
+        .has_acquisition_id = true,
+        .array_settings = &fov,
+    };
+
+    ZarrHCSPlate plate{
+        .path = "plate",
+        .name = "Plate",
+    };
+    CHECK(ZarrHCSPlate_create_row_name_array(&plate, 1) ==
+          ZarrStatusCode_Success);
+    plate.row_names[0] = "A";
+    CHECK(ZarrHCSPlate_create_column_name_array(&plate, 1) ==
+          ZarrStatusCode_Success);
+    plate.column_names[0] = "1";
+    CHECK(ZarrHCSPlate_create_well_array(&plate, 1) == ZarrStatusCode_Success);
+    plate.wells[0] = well;
+    CHECK(ZarrHCSPlate_create_acquisition_array(&plate, 1) ==
+          ZarrStatusCode_Success);
+    plate.acquisitions[0] = {
+        .id = 0,
+        .name = "Acquisition",
+    };
+
+    ZarrHCSSettings hcs_settings = {
+        .plates = &plate,
+        .plate_count = 1,
+    };
+
+    ZarrArraySettings labels{
+        .output_key = "labels",
+        .data_type = ZarrDataType_uint8,
+    };
+    set_dimensions(&labels);
+
+    ZarrStreamSettings settings = {
+        .store_path = base_path.c_str(),
+        .overwrite = true,
+        .arrays = &labels,
+        .array_count = 1,
+        .hcs_settings = &hcs_settings,
+        .consolidate_metadata = true,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+
+    ZarrHCSPlate_destroy_well_array(&plate);
+    ZarrArraySettings_destroy_dimension_array(&labels);
+
+    return stream;
+}
+
+nlohmann::json
+read_metadata(const fs::path& path)
+{
+    EXPECT(fs::is_regular_file(path), "Missing metadata file: ", path.string());
+
+    std::ifstream ifs(path);
+    nlohmann::json metadata;
+    ifs >> metadata;
+
+    return metadata;
+}
+
+void
+check_consolidated(const nlohmann::json& group,
+                   const std::vector<std::string>& expected_keys)
+{
+    CHECK(group.contains("consolidated_metadata"));
+    const auto& consolidated = group["consolidated_metadata"];
+    CHECK(consolidated.is_object());
+    CHECK(consolidated["kind"] == "inline");
+    CHECK(consolidated["must_understand"] == false);
+
+    const auto& metadata = consolidated["metadata"];
+    EXPECT(metadata.size() == expected_keys.size(),
+           "Expected ",
+           expected_keys.size(),
+           " consolidated nodes, got ",
+           metadata.size());
+
+    for (const auto& key : expected_keys) {
+        EXPECT(metadata.contains(key), "Missing consolidated node: ", key);
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        std::vector<uint8_t> frame(array_width * array_height);
+        for (auto i = 0; i < array_planes; ++i) {
+            size_t bytes_out;
+            CHECK_OK(ZarrStream_append(
+              stream, frame.data(), frame.size(), &bytes_out, "labels"));
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size(),
+                                       &bytes_out,
+                                       "plate/A/1/fov1"));
+        }
+        ZarrStream_destroy(stream);
+
+        const auto root = read_metadata(base_path / "zarr.json");
+        check_consolidated(root,
+                           { "labels",
+                             "plate",
+                             "plate/A",
+                             "plate/A/1",
+                             "plate/A/1/fov1",
+                             "plate/A/1/fov1/0" });
+
+        // consolidated array metadata reflects the final shape
+        const auto& labels =
+          root["consolidated_metadata"]["metadata"]["labels"];
+        CHECK(labels["node_type"] == "array");
+        EXPECT_EQ(int, labels["shape"][0].get<int>(), array_planes);
+
+        const auto plate = read_metadata(base_path / "plate" / "zarr.json");
+        check_consolidated(plate, { "A", "A/1", "A/1/fov1", "A/1/fov1/0" });
+        CHECK(plate["attributes"]["ome"].contains("plate"));
+
+        const auto well =
+          read_metadata(base_path / "plate" / "A" / "1" / "zarr.json");
+        CHECK(well["consolidated_metadata"].is_null());
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(base_path)) {
+        fs::remove_all(base_path);
+    }
+
+    return retval;
+}
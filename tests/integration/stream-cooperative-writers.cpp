@@ -0,0 +1,155 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int n_frames = 4;
+
+ZarrStream*
+make_stream(const char* key, ZarrCooperativeSettings* cooperative)
+{
+    ZarrArraySettings array = {
+        .output_key = key,
+        .data_type = ZarrDataType_uint8,
+    };
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, 2, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM(
+      "y", ZarrDimensionType_Space, array_height, 16, 1, nullptr, 1.0);
+    array.dimensions[2] =
+      DIM("x", ZarrDimensionType_Space, array_width, 16, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .max_threads = 2,
+        .arrays = &array,
+        .array_count = 1,
+        .consolidate_metadata = true,
+        .cooperative = cooperative,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+write_frames(ZarrStream* stream, uint8_t value)
+{
+    std::vector<uint8_t> frame(array_width * array_height, value);
+    for (auto t = 0; t < n_frames; ++t) {
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(
+          stream, frame.data(), frame.size(), &bytes_out, nullptr));
+    }
+}
+
+nlohmann::json
+read_json(const fs::path& path)
+{
+    std::ifstream file(path);
+    CHECK(file.is_open());
+    return nlohmann::json::parse(file);
+}
+
+void
+check_cooperative_writers()
+{
+    ZarrCooperativeSettings camera0 = {
+        .writer_id = "camera0",
+        .writer_count = 2,
+        .coordinator = true,
+        .timeout_ms = 10000,
+    };
+    ZarrCooperativeSettings camera1 = camera0;
+    camera1.writer_id = "camera1";
+    camera1.coordinator = false;
+
+    ZarrStream* coordinator = make_stream("cameras/0", &camera0);
+    CHECK(coordinator);
+    ZarrStream* writer = make_stream("cameras/1", &camera1);
+    CHECK(writer);
+
+    // a third writer can't take an array that's already claimed
+    ZarrCooperativeSettings camera2 = camera1;
+    camera2.writer_id = "camera2";
+    EXPECT(make_stream("cameras/1", &camera2) == nullptr,
+           "Expected a claimed array to fail");
+
+    write_frames(coordinator, 0);
+    write_frames(writer, 1);
+
+    // the coordinator waits for the other writer to publish its metadata
+    ZarrStream_destroy(writer);
+    CHECK(fs::exists(test_path / ".writers" / "manifests" / "camera1.json"));
+    CHECK(!fs::exists(test_path / "zarr.json"));
+    ZarrStream_destroy(coordinator);
+
+    CHECK(!fs::exists(test_path / ".writers"));
+    CHECK(fs::exists(test_path / "cameras" / "zarr.json"));
+
+    // the root group lists the arrays of both writers
+    const auto root = read_json(test_path / "zarr.json");
+    const auto& metadata = root["consolidated_metadata"]["metadata"];
+    CHECK(metadata.contains("cameras"));
+    for (const auto* key : { "cameras/0", "cameras/1" }) {
+        EXPECT(metadata.contains(key), "Expected ", key, " in metadata");
+        EXPECT_EQ(int, metadata[key]["shape"][0].get<int>(), n_frames);
+        CHECK(fs::exists(test_path / key / "zarr.json"));
+    }
+}
+
+void
+check_invalid_settings()
+{
+    ZarrCooperativeSettings cooperative = {
+        .writer_id = nullptr,
+        .writer_count = 1,
+        .coordinator = true,
+    };
+    EXPECT(make_stream("labels", &cooperative) == nullptr,
+           "Expected a null writer id to fail");
+
+    cooperative.writer_id = "";
+    EXPECT(make_stream("labels", &cooperative) == nullptr,
+           "Expected an empty writer id to fail");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        if (fs::exists(test_path)) {
+            fs::remove_all(test_path);
+        }
+
+        check_cooperative_writers();
+        check_invalid_settings();
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
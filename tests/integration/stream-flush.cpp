@@ -0,0 +1,184 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int chunk_planes = 4, shard_chunks = 2;
+
+const size_t bytes_per_plane = array_width * array_height;
+
+ZarrStream*
+make_stream(unsigned int flush_interval_ms)
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint8,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] = DIM(
+      "z", ZarrDimensionType_Space, 0, chunk_planes, shard_chunks, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              array_height,
+                              1,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM(
+      "x", ZarrDimensionType_Space, array_width, array_width, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+        .flush_interval_ms = flush_interval_ms,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+append_planes(ZarrStream* stream, unsigned int first, unsigned int count)
+{
+    std::vector<uint8_t> frame(bytes_per_plane);
+    for (auto i = first; i < first + count; ++i) {
+        std::fill(frame.begin(), frame.end(), static_cast<uint8_t>(i + 1));
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(
+          stream, frame.data(), frame.size(), &bytes_out, nullptr));
+        EXPECT_EQ(size_t, bytes_out, frame.size());
+    }
+}
+
+size_t
+shard_size()
+{
+    return fs::file_size(test_path / "c" / "0" / "0" / "0");
+}
+
+// check that the first shard is readable and holds exactly @p n_planes planes
+void
+check_readable(unsigned int n_planes)
+{
+    const auto shard_path = test_path / "c" / "0" / "0" / "0";
+    EXPECT(fs::is_regular_file(shard_path), "Missing shard after flush");
+
+    std::ifstream ifs(shard_path, std::ios::binary);
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const size_t table_size = 2 * shard_chunks * sizeof(uint64_t);
+    CHECK(shard.size() >= table_size + sizeof(uint32_t));
+
+    const auto* index = shard.data() + shard.size() - table_size - 4;
+    uint32_t checksum;
+    memcpy(&checksum, index + table_size, sizeof(checksum));
+    EXPECT_EQ(uint32_t, checksum, crc32c::Crc32c(index, table_size));
+
+    std::vector<uint64_t> table(2 * shard_chunks);
+    memcpy(table.data(), index, table_size);
+
+    for (auto i = 0; i < shard_chunks * chunk_planes; ++i) {
+        const auto chunk = i / chunk_planes;
+        if (i >= n_planes) {
+            // chunks past the data are either absent or zero-filled
+            if (table[2 * chunk + 1] == std::numeric_limits<uint64_t>::max()) {
+                continue;
+            }
+        }
+
+        const auto offset =
+          table[2 * chunk] + (i % chunk_planes) * bytes_per_plane;
+        CHECK(offset + bytes_per_plane <= shard.size());
+
+        const uint8_t expected = i < n_planes ? i + 1 : 0;
+        for (auto j = 0; j < bytes_per_plane; ++j) {
+            EXPECT_EQ(int, shard[offset + j], expected);
+        }
+    }
+
+    std::ifstream metadata_file(test_path / "zarr.json");
+    const auto metadata = nlohmann::json::parse(metadata_file);
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_planes);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        CHECK(ZarrStream_flush(nullptr) == ZarrStatusCode_InvalidArgument);
+
+        // without flushes, for reference
+        ZarrStream* stream = make_stream(0);
+        CHECK(stream);
+        append_planes(stream, 0, 7);
+        ZarrStream_destroy(stream);
+        check_readable(7);
+        const auto unflushed_size = shard_size();
+
+        // explicit flushes, within and at the end of a chunk
+        stream = make_stream(0);
+        CHECK(stream);
+
+        append_planes(stream, 0, 3);
+        CHECK_OK(ZarrStream_flush(stream));
+        check_readable(3);
+
+        // flushing again without new data is a no-op
+        CHECK_OK(ZarrStream_flush(stream));
+        check_readable(3);
+
+        append_planes(stream, 3, 3);
+        CHECK_OK(ZarrStream_flush(stream));
+        check_readable(6);
+
+        append_planes(stream, 6, 1);
+        ZarrStream_destroy(stream);
+        check_readable(7);
+
+        // flushed layers are overwritten once complete, not left behind
+        EXPECT_EQ(size_t, shard_size(), unflushed_size);
+
+        // timed flushes
+        stream = make_stream(10);
+        CHECK(stream);
+
+        append_planes(stream, 0, 2);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        check_readable(2);
+        ZarrStream_destroy(stream);
+        check_readable(2);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,176 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int n_frames = 10;
+const size_t frame_bytes = array_width * array_height * sizeof(uint16_t);
+
+const char* field_names[] = { "time", "exposure" };
+
+void
+make_array(ZarrArraySettings& array, const char* key)
+{
+    array = {
+        .output_key = key,
+        .data_type = ZarrDataType_uint16,
+    };
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, 2, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM(
+      "y", ZarrDimensionType_Space, array_height, 16, 1, nullptr, 1.0);
+    array.dimensions[2] =
+      DIM("x", ZarrDimensionType_Space, array_width, 16, 1, nullptr, 1.0);
+}
+
+ZarrStream*
+make_stream(ZarrFrameMetadataSettings* frame_metadata, const char* key)
+{
+    ZarrArraySettings arrays[2];
+    make_array(arrays[0], key);
+    arrays[0].frame_metadata = frame_metadata;
+    make_array(arrays[1], "labels");
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .max_threads = 2,
+        .overwrite = true,
+        .arrays = arrays,
+        .array_count = 2,
+        .consolidate_metadata = true,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(arrays);
+    ZarrArraySettings_destroy_dimension_array(arrays + 1);
+
+    return stream;
+}
+
+nlohmann::json
+read_json(const fs::path& path)
+{
+    std::ifstream file(path);
+    CHECK(file.is_open());
+    return nlohmann::json::parse(file);
+}
+
+void
+check_frame_metadata()
+{
+    ZarrFrameMetadataSettings frame_metadata = {
+        .data_type = ZarrDataType_float64,
+        .field_count = 2,
+        .field_names = field_names,
+        .records_per_chunk = 4,
+        .chunks_per_shard = 2,
+    };
+    ZarrStream* stream = make_stream(&frame_metadata, "raw");
+    CHECK(stream);
+
+    // one record per frame
+    std::vector<uint16_t> frame(array_width * array_height);
+    for (auto t = 0; t < n_frames; ++t) {
+        std::fill(frame.begin(), frame.end(), t);
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(
+          stream, frame.data(), frame_bytes, &bytes_out, "raw"));
+
+        const double record[] = { 0.1 * t, 10.0 };
+        CHECK_OK(ZarrStream_append_frame_metadata(
+          stream, record, sizeof(record), &bytes_out, "raw"));
+        EXPECT_EQ(int, bytes_out, sizeof(record));
+    }
+
+    // records must be whole, and the array must keep frame metadata
+    const double record[] = { 0.0, 0.0 };
+    size_t bytes_out;
+    EXPECT_EQ(int,
+              ZarrStream_append_frame_metadata(
+                stream, record, sizeof(double), &bytes_out, "raw"),
+              ZarrStatusCode_InvalidArgument);
+    EXPECT_EQ(int,
+              ZarrStream_append_frame_metadata(
+                stream, record, sizeof(record), &bytes_out, "labels"),
+              ZarrStatusCode_InvalidArgument);
+    EXPECT_EQ(int,
+              ZarrStream_append_frame_metadata(
+                stream, record, sizeof(record), &bytes_out, "nope"),
+              ZarrStatusCode_KeyNotFound);
+
+    ZarrStream_destroy(stream);
+
+    const auto array_dir = test_path / "raw_frame_metadata";
+    const auto metadata = read_json(array_dir / "zarr.json");
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_frames);
+    EXPECT_EQ(int, metadata["shape"][1].get<int>(), 2);
+    EXPECT_STR_EQ(
+      metadata["attributes"]["fields"][0].get<std::string>().c_str(), "time");
+
+    // two shards of 8 records, the second written on close
+    CHECK(fs::is_regular_file(array_dir / "c" / "0" / "0"));
+    CHECK(fs::is_regular_file(array_dir / "c" / "1" / "0"));
+    CHECK(!fs::exists(array_dir / "c" / "2"));
+
+    const auto root = read_json(test_path / "zarr.json");
+    const auto& consolidated = root["consolidated_metadata"]["metadata"];
+    CHECK(consolidated.contains("raw_frame_metadata"));
+    CHECK(consolidated["raw_frame_metadata"] == metadata);
+}
+
+void
+check_invalid_settings()
+{
+    ZarrFrameMetadataSettings frame_metadata = {
+        .data_type = ZarrDataType_float64,
+        .field_count = 0,
+    };
+    EXPECT(make_stream(&frame_metadata, "raw") == nullptr,
+           "Expected a zero field count to fail");
+
+    frame_metadata.field_count = 2;
+    frame_metadata.data_type = ZarrDataTypeCount;
+    EXPECT(make_stream(&frame_metadata, "raw") == nullptr,
+           "Expected an invalid data type to fail");
+
+    const char* names[] = { "time", nullptr };
+    frame_metadata.data_type = ZarrDataType_float64;
+    frame_metadata.field_names = names;
+    EXPECT(make_stream(&frame_metadata, "raw") == nullptr,
+           "Expected a null field name to fail");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_frame_metadata();
+        check_invalid_settings();
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,186 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+// the camera streams 40x30 frames; a 24x20 window at (4, 2) is binned 2x2
+const uint32_t frame_width = 40, frame_height = 30;
+const uint32_t roi_x = 4, roi_y = 2, binning = 2;
+
+const unsigned int array_width = 12, array_height = 10;
+const unsigned int chunk_width = 8, chunk_height = 5, chunk_planes = 2;
+const unsigned int chunks_along_x = 2, chunks_along_y = 2;
+const unsigned int n_frames = 3;
+
+uint16_t
+pixel_value(uint64_t t, uint64_t y, uint64_t x)
+{
+    return t * 1000 + y * 30 + x;
+}
+
+// the rounded mean of a 2x2 block of the frame
+uint16_t
+binned_value(uint64_t t, uint64_t y, uint64_t x)
+{
+    const auto fy = roi_y + y * binning, fx = roi_x + x * binning;
+    const auto sum = pixel_value(t, fy, fx) + pixel_value(t, fy, fx + 1) +
+                     pixel_value(t, fy + 1, fx) + pixel_value(t, fy + 1, fx + 1);
+    return (sum + 2) / 4;
+}
+
+ZarrStream*
+make_stream(ZarrFrameReduction* reduction)
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint16,
+        .frame_reduction = reduction,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              chunk_height,
+                              chunks_along_y,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM("x",
+                              ZarrDimensionType_Space,
+                              array_width,
+                              chunk_width,
+                              chunks_along_x,
+                              nullptr,
+                              1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+check_shard(uint64_t shard_t)
+{
+    const auto shard_path = test_path / "c" / std::to_string(shard_t) / "0" /
+                            "0";
+    std::ifstream ifs(shard_path, std::ios::binary);
+    EXPECT(ifs.good(), "Missing shard ", shard_path.string());
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const auto chunks_per_shard = chunks_along_x * chunks_along_y;
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+    std::vector<uint64_t> table(2 * chunks_per_shard);
+    memcpy(table.data(),
+           shard.data() + shard.size() - table_size - 4,
+           table_size);
+
+    for (auto t = shard_t * chunk_planes;
+         t < std::min((shard_t + 1) * chunk_planes, uint64_t{ n_frames });
+         ++t) {
+        for (auto y = 0; y < array_height; ++y) {
+            for (auto x = 0; x < array_width; ++x) {
+                const auto chunk =
+                  (y / chunk_height) * chunks_along_x + x / chunk_width;
+                const auto px =
+                  ((t % chunk_planes) * chunk_height + y % chunk_height) *
+                    chunk_width +
+                  x % chunk_width;
+                const auto offset = table[2 * chunk] + px * sizeof(uint16_t);
+                CHECK(offset + sizeof(uint16_t) <= shard.size());
+
+                uint16_t value;
+                memcpy(&value, shard.data() + offset, sizeof(value));
+                EXPECT_EQ(int, value, binned_value(t, y, x));
+            }
+        }
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        // the window must fit in the frame
+        ZarrFrameReduction too_wide{
+            .frame_width = frame_width,
+            .frame_height = frame_height,
+            .roi_x = frame_width - array_width * binning + 1,
+            .binning = binning,
+        };
+        CHECK(make_stream(&too_wide) == nullptr);
+
+        ZarrFrameReduction reduction{
+            .frame_width = frame_width,
+            .frame_height = frame_height,
+            .roi_x = roi_x,
+            .roi_y = roi_y,
+            .binning = binning,
+            .binning_method = ZarrBinningMethod_Mean,
+        };
+        ZarrStream* stream = make_stream(&reduction);
+        CHECK(stream);
+
+        // full camera frames go in
+        std::vector<uint16_t> frame(frame_width * frame_height);
+        for (auto t = 0; t < n_frames; ++t) {
+            for (auto y = 0; y < frame_height; ++y) {
+                for (auto x = 0; x < frame_width; ++x) {
+                    frame[y * frame_width + x] = pixel_value(t, y, x);
+                }
+            }
+
+            size_t bytes_out;
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size() * sizeof(uint16_t),
+                                       &bytes_out,
+                                       nullptr));
+            EXPECT_EQ(size_t, bytes_out, frame.size() * sizeof(uint16_t));
+        }
+
+        ZarrStream_destroy(stream);
+
+        for (auto shard_t = 0; shard_t * chunk_planes < n_frames; ++shard_t) {
+            check_shard(shard_t);
+        }
+
+        std::ifstream ifs(test_path / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_frames);
+        EXPECT_EQ(int, metadata["shape"][1].get<int>(), array_height);
+        EXPECT_EQ(int, metadata["shape"][2].get<int>(), array_width);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
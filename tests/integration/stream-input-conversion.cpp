@@ -0,0 +1,181 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 30, array_height = 18;
+const unsigned int chunk_width = 16, chunk_height = 9, chunk_planes = 2;
+const unsigned int chunks_along_x = 2, chunks_along_y = 2;
+const unsigned int n_frames = 3;
+
+const size_t px_per_frame = array_width * array_height;
+
+// 12-bit samples in 16-bit words
+uint16_t
+pixel_value(uint64_t t, uint64_t y, uint64_t x)
+{
+    return (t * 1000 + y * 37 + x * 5) & 0xfff;
+}
+
+ZarrStream*
+make_stream(ZarrInputConversion* conversion,
+            ZarrPixelFormat pixel_format = ZarrPixelFormat_Native)
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint8,
+        .input_pixel_format = pixel_format,
+        .input_conversion = conversion,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              chunk_height,
+                              chunks_along_y,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM("x",
+                              ZarrDimensionType_Space,
+                              array_width,
+                              chunk_width,
+                              chunks_along_x,
+                              nullptr,
+                              1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+check_shard(uint64_t shard_t)
+{
+    const auto shard_path = test_path / "c" / std::to_string(shard_t) / "0" /
+                            "0";
+    std::ifstream ifs(shard_path, std::ios::binary);
+    EXPECT(ifs.good(), "Missing shard ", shard_path.string());
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const auto chunks_per_shard = chunks_along_x * chunks_along_y;
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+    std::vector<uint64_t> table(2 * chunks_per_shard);
+    memcpy(table.data(),
+           shard.data() + shard.size() - table_size - 4,
+           table_size);
+
+    for (auto i = 0; i < chunks_per_shard; ++i) {
+        EXPECT_EQ(uint64_t,
+                  table[2 * i + 1],
+                  chunk_width * chunk_height * chunk_planes);
+    }
+
+    for (auto t = shard_t * chunk_planes;
+         t < std::min((shard_t + 1) * chunk_planes, uint64_t{ n_frames });
+         ++t) {
+        for (auto y = 0; y < array_height; ++y) {
+            for (auto x = 0; x < array_width; ++x) {
+                const auto chunk =
+                  (y / chunk_height) * chunks_along_x + x / chunk_width;
+                const auto px =
+                  ((t % chunk_planes) * chunk_height + y % chunk_height) *
+                    chunk_width +
+                  x % chunk_width;
+                const auto offset = table[2 * chunk] + px;
+                CHECK(offset < shard.size());
+                EXPECT_EQ(int, shard[offset], pixel_value(t, y, x) >> 4);
+            }
+        }
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        // only integer samples can be shifted
+        ZarrInputConversion bad_shift{
+            .data_type = ZarrDataType_float32,
+            .right_shift = 4,
+        };
+        CHECK(make_stream(&bad_shift) == nullptr);
+
+        // packed pixels are 16-bit
+        ZarrInputConversion bad_packed{
+            .data_type = ZarrDataType_uint32,
+        };
+        CHECK(make_stream(&bad_packed, ZarrPixelFormat_Mono12p) == nullptr);
+
+        // 12 bits in, the top 8 stored
+        ZarrInputConversion conversion{
+            .data_type = ZarrDataType_uint16,
+            .right_shift = 4,
+        };
+        ZarrStream* stream = make_stream(&conversion);
+        CHECK(stream);
+
+        std::vector<uint16_t> frame(px_per_frame);
+        for (auto t = 0; t < n_frames; ++t) {
+            for (auto y = 0; y < array_height; ++y) {
+                for (auto x = 0; x < array_width; ++x) {
+                    frame[y * array_width + x] = pixel_value(t, y, x);
+                }
+            }
+
+            // frames are appended in the input type
+            size_t bytes_out;
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size() * sizeof(uint16_t),
+                                       &bytes_out,
+                                       nullptr));
+            EXPECT_EQ(size_t, bytes_out, frame.size() * sizeof(uint16_t));
+        }
+
+        ZarrStream_destroy(stream);
+
+        for (auto shard_t = 0; shard_t * chunk_planes < n_frames; ++shard_t) {
+            check_shard(shard_t);
+        }
+
+        std::ifstream ifs(test_path / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_frames);
+        EXPECT_STR_EQ(metadata["data_type"].get<std::string>().c_str(),
+                      "uint8");
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
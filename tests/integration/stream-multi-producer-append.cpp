@@ -0,0 +1,190 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <barrier>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int chunk_planes = 4, shard_chunks = 2;
+const unsigned int n_frames = 24;
+
+const size_t bytes_per_frame = array_width * array_height;
+
+// "a" and "b" are each appended to in order by their own producer; "c" is
+// shared by two producers that append by index
+const std::vector<std::string> keys = { "a", "b", "c" };
+
+ZarrStream*
+make_stream()
+{
+    std::vector<ZarrArraySettings> arrays(keys.size());
+    for (auto i = 0; i < keys.size(); ++i) {
+        auto& array = arrays[i];
+        array = {
+            .output_key = keys[i].c_str(),
+            .data_type = ZarrDataType_uint8,
+        };
+        CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+        array.dimensions[0] = DIM("z",
+                                  ZarrDimensionType_Space,
+                                  0,
+                                  chunk_planes,
+                                  shard_chunks,
+                                  nullptr,
+                                  1.0);
+        array.dimensions[1] = DIM("y",
+                                  ZarrDimensionType_Space,
+                                  array_height,
+                                  array_height,
+                                  1,
+                                  nullptr,
+                                  1.0);
+        array.dimensions[2] = DIM("x",
+                                  ZarrDimensionType_Space,
+                                  array_width,
+                                  array_width,
+                                  1,
+                                  nullptr,
+                                  1.0);
+    }
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .max_threads = 4,
+        .overwrite = true,
+        .arrays = arrays.data(),
+        .array_count = arrays.size(),
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    for (auto& array : arrays) {
+        ZarrArraySettings_destroy_dimension_array(&array);
+    }
+
+    return stream;
+}
+
+uint8_t
+frame_value(size_t array_index, uint64_t frame_id)
+{
+    return 1 + array_index * n_frames + frame_id;
+}
+
+void
+check_array(size_t array_index)
+{
+    const auto array_path = test_path / keys[array_index];
+
+    for (auto i = 0; i < n_frames; ++i) {
+        const auto chunk = i / chunk_planes;
+        const auto shard_path = array_path / "c" /
+                                std::to_string(chunk / shard_chunks) / "0" /
+                                "0";
+
+        std::ifstream ifs(shard_path, std::ios::binary);
+        EXPECT(ifs.good(), "Missing shard ", shard_path.string());
+        const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                          std::istreambuf_iterator<char>() };
+
+        const size_t table_size = 2 * shard_chunks * sizeof(uint64_t);
+        std::vector<uint64_t> table(2 * shard_chunks);
+        memcpy(table.data(),
+               shard.data() + shard.size() - table_size - 4,
+               table_size);
+
+        const auto offset = table[2 * (chunk % shard_chunks)] +
+                            (i % chunk_planes) * bytes_per_frame;
+        CHECK(offset + bytes_per_frame <= shard.size());
+        for (auto j = 0; j < bytes_per_frame; ++j) {
+            EXPECT_EQ(int, shard[offset + j], frame_value(array_index, i));
+        }
+    }
+
+    std::ifstream ifs(array_path / "zarr.json");
+    const auto metadata = nlohmann::json::parse(ifs);
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_frames);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        std::vector<std::thread> producers;
+
+        for (auto a = 0; a < 2; ++a) {
+            producers.emplace_back([stream, a] {
+                std::vector<uint8_t> frame(bytes_per_frame);
+                for (auto i = 0; i < n_frames; ++i) {
+                    std::ranges::fill(frame, frame_value(a, i));
+
+                    size_t bytes_out;
+                    CHECK_OK(ZarrStream_append(stream,
+                                               frame.data(),
+                                               frame.size(),
+                                               &bytes_out,
+                                               keys[a].c_str()));
+                    EXPECT_EQ(size_t, bytes_out, frame.size());
+                }
+            });
+        }
+
+        // keep the two producers of "c" within a chunk layer of each other, so
+        // their frames stay inside the reorder window
+        std::barrier sync(2);
+        for (auto p = 0; p < 2; ++p) {
+            producers.emplace_back([stream, p, &sync] {
+                std::vector<uint8_t> frame(bytes_per_frame);
+                for (auto i = p; i < n_frames; i += 2) {
+                    std::ranges::fill(frame, frame_value(2, i));
+                    CHECK_OK(ZarrStream_append_frame(stream,
+                                                     frame.data(),
+                                                     frame.size(),
+                                                     i,
+                                                     keys[2].c_str()));
+
+                    if (i / 2 % (chunk_planes / 2) == 0) {
+                        sync.arrive_and_wait();
+                    }
+                }
+            });
+        }
+
+        for (auto& producer : producers) {
+            producer.join();
+        }
+
+        ZarrStream_destroy(stream);
+
+        for (auto i = 0; i < keys.size(); ++i) {
+            check_array(i);
+        }
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
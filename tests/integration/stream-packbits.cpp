@@ -0,0 +1,218 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 20, array_height = 12;
+const unsigned int chunk_width = 7, chunk_height = 6, chunk_planes = 3;
+const unsigned int chunks_along_x = 3, chunks_along_y = 2;
+const unsigned int n_frames = 4;
+const uint8_t significant_bits = 12;
+
+const size_t px_per_chunk = chunk_width * chunk_height * chunk_planes;
+const size_t bytes_per_packed_chunk = (px_per_chunk * significant_bits + 7) / 8;
+
+uint16_t
+pixel_value(uint64_t t, uint64_t y, uint64_t x)
+{
+    return (t * 1000 + y * 37 + x * 5) & 0xfff;
+}
+
+ZarrStream*
+make_stream(ZarrDataType data_type,
+            uint8_t bits,
+            ZarrCompressionSettings* compression = nullptr)
+{
+    ZarrArraySettings array{
+        .compression_settings = compression,
+        .data_type = data_type,
+        .significant_bits = bits,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              chunk_height,
+                              chunks_along_y,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM("x",
+                              ZarrDimensionType_Space,
+                              array_width,
+                              chunk_width,
+                              chunks_along_x,
+                              nullptr,
+                              1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+write_frames(ZarrStream* stream)
+{
+    std::vector<uint16_t> frame(array_width * array_height);
+    for (auto t = 0; t < n_frames; ++t) {
+        for (auto y = 0; y < array_height; ++y) {
+            for (auto x = 0; x < array_width; ++x) {
+                frame[y * array_width + x] = pixel_value(t, y, x);
+            }
+        }
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(stream,
+                                   frame.data(),
+                                   frame.size() * sizeof(uint16_t),
+                                   &bytes_out,
+                                   nullptr));
+        EXPECT_EQ(size_t, bytes_out, frame.size() * sizeof(uint16_t));
+    }
+}
+
+// read element i back out of a little-endian bit stream
+uint16_t
+unpack(const uint8_t* packed, size_t i)
+{
+    uint16_t value = 0;
+    for (auto b = 0; b < significant_bits; ++b) {
+        const auto bit = i * significant_bits + b;
+        value |= ((packed[bit / 8] >> (bit % 8)) & 1) << b;
+    }
+
+    return value;
+}
+
+void
+check_shard(uint64_t shard_t)
+{
+    const auto shard_path = test_path / "c" / std::to_string(shard_t) / "0" /
+                            "0";
+    std::ifstream ifs(shard_path, std::ios::binary);
+    EXPECT(ifs.good(), "Missing shard ", shard_path.string());
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const auto chunks_per_shard = chunks_along_x * chunks_along_y;
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+    std::vector<uint64_t> table(2 * chunks_per_shard);
+    memcpy(table.data(),
+           shard.data() + shard.size() - table_size - 4,
+           table_size);
+
+    for (auto i = 0; i < chunks_per_shard; ++i) {
+        EXPECT_EQ(uint64_t, table[2 * i + 1], bytes_per_packed_chunk);
+        CHECK(table[2 * i] + bytes_per_packed_chunk <= shard.size());
+    }
+
+    for (auto t = shard_t * chunk_planes;
+         t < std::min((shard_t + 1) * chunk_planes, uint64_t{ n_frames });
+         ++t) {
+        for (auto y = 0; y < array_height; ++y) {
+            for (auto x = 0; x < array_width; ++x) {
+                const auto chunk =
+                  (y / chunk_height) * chunks_along_x + x / chunk_width;
+                const auto px =
+                  ((t % chunk_planes) * chunk_height + y % chunk_height) *
+                    chunk_width +
+                  x % chunk_width;
+                EXPECT_EQ(int,
+                          unpack(shard.data() + table[2 * chunk], px),
+                          pixel_value(t, y, x));
+            }
+        }
+    }
+}
+
+nlohmann::json
+read_codecs()
+{
+    std::ifstream ifs(test_path / "zarr.json");
+    const auto metadata = nlohmann::json::parse(ifs);
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_frames);
+
+    return metadata["codecs"][0]["configuration"]["codecs"];
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        // only unsigned integers narrower than the requested bits
+        CHECK(make_stream(ZarrDataType_int16, significant_bits) == nullptr);
+        CHECK(make_stream(ZarrDataType_float32, significant_bits) == nullptr);
+        CHECK(make_stream(ZarrDataType_uint16, 16) == nullptr);
+
+        ZarrStream* stream = make_stream(ZarrDataType_uint16, significant_bits);
+        CHECK(stream);
+        write_frames(stream);
+        ZarrStream_destroy(stream);
+
+        for (auto shard_t = 0; shard_t * chunk_planes < n_frames; ++shard_t) {
+            check_shard(shard_t);
+        }
+
+        auto codecs = read_codecs();
+        EXPECT_EQ(size_t, codecs.size(), 1);
+        EXPECT_STR_EQ(codecs[0]["name"].get<std::string>().c_str(),
+                      "packbits");
+        const auto& config = codecs[0]["configuration"];
+        EXPECT_EQ(int, config["first_bit"].get<int>(), 0);
+        EXPECT_EQ(int, config["last_bit"].get<int>(), significant_bits - 1);
+        EXPECT_STR_EQ(config["padding_encoding"].get<std::string>().c_str(),
+                      "none");
+
+        // Blosc sees packed bytes, so it shuffles byte by byte
+        ZarrCompressionSettings compression{
+            .compressor = ZarrCompressor_Blosc1,
+            .codec = ZarrCompressionCodec_BloscZstd,
+            .level = 1,
+            .shuffle = 1,
+        };
+        stream = make_stream(ZarrDataType_uint16, significant_bits, &compression);
+        CHECK(stream);
+        write_frames(stream);
+        ZarrStream_destroy(stream);
+
+        codecs = read_codecs();
+        EXPECT_EQ(size_t, codecs.size(), 2);
+        EXPECT_STR_EQ(codecs[0]["name"].get<std::string>().c_str(),
+                      "packbits");
+        EXPECT_STR_EQ(codecs[1]["name"].get<std::string>().c_str(), "blosc");
+        EXPECT_EQ(int, codecs[1]["configuration"]["typesize"].get<int>(), 1);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
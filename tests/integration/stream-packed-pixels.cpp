@@ -0,0 +1,174 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+// tiles that don't start on a pixel group boundary, and ragged edges
+const unsigned int array_width = 22, array_height = 20;
+const unsigned int chunk_width = 9, chunk_height = 7, chunk_planes = 2;
+const unsigned int chunks_along_x = 3, chunks_along_y = 3;
+const unsigned int n_frames = 5;
+
+const size_t px_per_frame = array_width * array_height;
+const size_t bytes_per_packed_frame = px_per_frame * 3 / 2;
+
+uint16_t
+pixel_value(uint64_t t, uint64_t y, uint64_t x)
+{
+    return (t * 1000 + y * 37 + x * 5) & 0xfff;
+}
+
+// Mono12p: two pixels in three bytes, least significant bits first
+std::vector<uint8_t>
+make_packed_frame(uint64_t t)
+{
+    std::vector<uint8_t> frame(bytes_per_packed_frame);
+    for (auto i = 0; i < px_per_frame; i += 2) {
+        const auto p0 = pixel_value(t, i / array_width, i % array_width);
+        const auto p1 =
+          pixel_value(t, (i + 1) / array_width, (i + 1) % array_width);
+        auto* group = frame.data() + i / 2 * 3;
+        group[0] = p0 & 0xff;
+        group[1] = (p0 >> 8) | (p1 & 0x0f) << 4;
+        group[2] = p1 >> 4;
+    }
+
+    return frame;
+}
+
+ZarrStream*
+make_stream(ZarrDataType data_type)
+{
+    ZarrArraySettings array{
+        .data_type = data_type,
+        .input_pixel_format = ZarrPixelFormat_Mono12p,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 1, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              chunk_height,
+                              chunks_along_y,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM("x",
+                              ZarrDimensionType_Space,
+                              array_width,
+                              chunk_width,
+                              chunks_along_x,
+                              nullptr,
+                              1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+check_shard(uint64_t shard_t)
+{
+    const auto shard_path = test_path / "c" / std::to_string(shard_t) / "0" /
+                            "0";
+    std::ifstream ifs(shard_path, std::ios::binary);
+    EXPECT(ifs.good(), "Missing shard ", shard_path.string());
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const auto chunks_per_shard = chunks_along_x * chunks_along_y;
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+    std::vector<uint64_t> table(2 * chunks_per_shard);
+    memcpy(table.data(),
+           shard.data() + shard.size() - table_size - 4,
+           table_size);
+
+    for (auto t = shard_t * chunk_planes;
+         t < std::min((shard_t + 1) * chunk_planes, uint64_t{ n_frames });
+         ++t) {
+        for (auto y = 0; y < array_height; ++y) {
+            for (auto x = 0; x < array_width; ++x) {
+                const auto chunk =
+                  (y / chunk_height) * chunks_along_x + x / chunk_width;
+                const auto px =
+                  ((t % chunk_planes) * chunk_height + y % chunk_height) *
+                    chunk_width +
+                  x % chunk_width;
+                const auto offset = table[2 * chunk] + px * sizeof(uint16_t);
+                CHECK(offset + sizeof(uint16_t) <= shard.size());
+
+                uint16_t value;
+                memcpy(&value, shard.data() + offset, sizeof(value));
+                EXPECT_EQ(int, value, pixel_value(t, y, x));
+            }
+        }
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        // packed pixels are unpacked to uint16
+        CHECK(make_stream(ZarrDataType_uint8) == nullptr);
+
+        ZarrStream* stream = make_stream(ZarrDataType_uint16);
+        CHECK(stream);
+
+        // frames are appended packed, several at a time
+        std::vector<uint8_t> frames;
+        for (auto t = 0; t < n_frames; ++t) {
+            const auto frame = make_packed_frame(t);
+            frames.insert(frames.end(), frame.begin(), frame.end());
+        }
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(
+          stream, frames.data(), frames.size(), &bytes_out, nullptr));
+        EXPECT_EQ(size_t, bytes_out, frames.size());
+
+        ZarrStream_destroy(stream);
+
+        for (auto shard_t = 0; shard_t * chunk_planes < n_frames; ++shard_t) {
+            check_shard(shard_t);
+        }
+
+        std::ifstream ifs(test_path / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_frames);
+        EXPECT_STR_EQ(metadata["data_type"].get<std::string>().c_str(),
+                      "uint16");
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,176 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int chunk_width = 16, chunk_height = 16, chunk_planes = 2;
+const unsigned int n_timepoints = 5;
+
+const size_t px_per_frame = array_width * array_height;
+
+// frames are uniform, so each downsampled frame has the same value
+uint16_t
+pixel_value(uint64_t t)
+{
+    return 100 + t * 7;
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrArraySettings arrays[2] = {
+        {
+          .output_key = "live",
+          .data_type = ZarrDataType_uint16,
+          .multiscale = true,
+          .downsampling_method = ZarrDownsamplingMethod_Mean,
+          .enable_preview = true,
+        },
+        {
+          .output_key = "quiet",
+          .data_type = ZarrDataType_uint16,
+        },
+    };
+
+    for (auto& array : arrays) {
+        CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+        array.dimensions[0] =
+          DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 1, nullptr, 1.0);
+        array.dimensions[1] = DIM("y",
+                                  ZarrDimensionType_Space,
+                                  array_height,
+                                  chunk_height,
+                                  1,
+                                  nullptr,
+                                  1.0);
+        array.dimensions[2] = DIM("x",
+                                  ZarrDimensionType_Space,
+                                  array_width,
+                                  chunk_width,
+                                  1,
+                                  nullptr,
+                                  1.0);
+    }
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = arrays,
+        .array_count = 2,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    for (auto& array : arrays) {
+        ZarrArraySettings_destroy_dimension_array(&array);
+    }
+
+    return stream;
+}
+
+void
+check_preview(ZarrStream* stream,
+              uint16_t level,
+              uint32_t width,
+              uint32_t height,
+              uint64_t t)
+{
+    std::vector<uint16_t> frame(width * height);
+    ZarrPreviewInfo info;
+    CHECK_OK(ZarrStream_get_preview(stream,
+                                    "live",
+                                    level,
+                                    frame.data(),
+                                    frame.size() * sizeof(uint16_t),
+                                    &info));
+    CHECK(info.has_frame);
+    EXPECT_EQ(int, info.width, width);
+    EXPECT_EQ(int, info.height, height);
+    EXPECT_EQ(int, info.data_type, ZarrDataType_uint16);
+    EXPECT_EQ(int, info.frame_id, t);
+
+    const auto expected = pixel_value(t);
+    EXPECT(std::ranges::all_of(frame,
+                               [expected](auto v) { return v == expected; }),
+           "Unexpected preview of frame ",
+           t,
+           " at level ",
+           level);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        // nothing to show yet
+        ZarrPreviewInfo info;
+        CHECK_OK(ZarrStream_get_preview(stream, "live", 0, nullptr, 0, &info));
+        CHECK(!info.has_frame);
+        EXPECT_EQ(int, info.width, array_width);
+        EXPECT_EQ(int, info.height, array_height);
+
+        for (auto t = 0; t < n_timepoints; ++t) {
+            std::vector<uint16_t> frame(px_per_frame, pixel_value(t));
+            size_t bytes_out;
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size() * sizeof(uint16_t),
+                                       &bytes_out,
+                                       "live"));
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size() * sizeof(uint16_t),
+                                       &bytes_out,
+                                       "quiet"));
+
+            // wait for the queued frames to be ingested
+            CHECK_OK(ZarrStream_flush(stream));
+            check_preview(stream, 0, array_width, array_height, t);
+            check_preview(stream, 1, array_width / 2, array_height / 2, t);
+        }
+        check_preview(
+          stream, 2, array_width / 4, array_height / 4, n_timepoints - 1);
+
+        // a buffer too small for the frame
+        std::vector<uint16_t> small(px_per_frame - 1);
+        CHECK(ZarrStream_get_preview(stream,
+                                     "live",
+                                     0,
+                                     small.data(),
+                                     small.size() * sizeof(uint16_t),
+                                     &info) == ZarrStatusCode_Overflow);
+
+        // no such level, or no preview kept
+        CHECK(ZarrStream_get_preview(stream, "live", 3, nullptr, 0, &info) ==
+              ZarrStatusCode_InvalidArgument);
+        CHECK(ZarrStream_get_preview(stream, "quiet", 0, nullptr, 0, &info) ==
+              ZarrStatusCode_InvalidArgument);
+        CHECK(ZarrStream_get_preview(stream, "nope", 0, nullptr, 0, &info) ==
+              ZarrStatusCode_KeyNotFound);
+
+        ZarrStream_destroy(stream);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,217 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 16, array_height = 12, n_planes = 4;
+const unsigned int chunk_planes = 2;
+const unsigned int n_timepoints = 3;
+
+const size_t px_per_frame = array_width * array_height;
+
+uint16_t
+pixel_value(uint64_t t, uint64_t z, size_t px)
+{
+    return (t * 1000 + z * 313 + px * 17) % 4096;
+}
+
+std::vector<uint16_t>
+make_frame(uint64_t t, uint64_t z)
+{
+    std::vector<uint16_t> frame(px_per_frame);
+    for (auto i = 0; i < px_per_frame; ++i) {
+        frame[i] = pixel_value(t, z, i);
+    }
+    return frame;
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrProjection max_z{
+        .dimension_name = "z",
+        .method = ZarrProjectionMethod_Max,
+    };
+    ZarrProjection mean_t{
+        .dimension_name = "t",
+        .method = ZarrProjectionMethod_Mean,
+    };
+
+    ZarrArraySettings arrays[2] = {
+        {
+          .output_key = "stack",
+          .data_type = ZarrDataType_uint16,
+          .projection = &max_z,
+        },
+        {
+          .output_key = "series",
+          .data_type = ZarrDataType_uint16,
+          .projection = &mean_t,
+        },
+    };
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(arrays, 4));
+    arrays[0].dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 1, nullptr, 1.0);
+    arrays[0].dimensions[1] =
+      DIM("z", ZarrDimensionType_Space, n_planes, 1, 1, nullptr, 1.0);
+    arrays[0].dimensions[2] = DIM(
+      "y", ZarrDimensionType_Space, array_height, array_height, 1, nullptr, 1.0);
+    arrays[0].dimensions[3] = DIM(
+      "x", ZarrDimensionType_Space, array_width, array_width, 1, nullptr, 1.0);
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(arrays + 1, 3));
+    arrays[1].dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, 1, 1, nullptr, 1.0);
+    arrays[1].dimensions[1] = DIM(
+      "y", ZarrDimensionType_Space, array_height, array_height, 1, nullptr, 1.0);
+    arrays[1].dimensions[2] = DIM(
+      "x", ZarrDimensionType_Space, array_width, array_width, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = arrays,
+        .array_count = 2,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(arrays);
+    ZarrArraySettings_destroy_dimension_array(arrays + 1);
+
+    return stream;
+}
+
+// the single chunk of a single-chunk shard
+std::vector<uint16_t>
+read_chunk(const fs::path& shard_path, size_t n_px)
+{
+    std::ifstream ifs(shard_path, std::ios::binary);
+    EXPECT(ifs.good(), "Missing shard ", shard_path.string());
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    uint64_t table[2];
+    CHECK(shard.size() >= sizeof(table) + 4);
+    memcpy(table, shard.data() + shard.size() - sizeof(table) - 4, sizeof(table));
+    EXPECT_EQ(uint64_t, table[1], n_px * sizeof(uint16_t));
+
+    std::vector<uint16_t> chunk(n_px);
+    memcpy(chunk.data(), shard.data() + table[0], table[1]);
+    return chunk;
+}
+
+void
+check_max_projection()
+{
+    std::ifstream ifs(test_path / "stack_max_z" / "zarr.json");
+    const auto metadata = nlohmann::json::parse(ifs);
+    const auto shape = metadata["shape"].get<std::vector<int>>();
+    EXPECT_EQ(int, shape.size(), 3);
+    EXPECT_EQ(int, shape[0], n_timepoints);
+    EXPECT_EQ(int, shape[1], array_height);
+    EXPECT_EQ(int, shape[2], array_width);
+
+    for (auto shard_t = 0; shard_t * chunk_planes < n_timepoints; ++shard_t) {
+        const auto chunk = read_chunk(test_path / "stack_max_z" / "c" /
+                                        std::to_string(shard_t) / "0" / "0",
+                                      chunk_planes * px_per_frame);
+        for (auto t = shard_t * chunk_planes;
+             t < std::min((shard_t + 1) * chunk_planes, n_timepoints);
+             ++t) {
+            for (auto i = 0; i < px_per_frame; ++i) {
+                uint16_t expected = 0;
+                for (auto z = 0; z < n_planes; ++z) {
+                    expected = std::max(expected, pixel_value(t, z, i));
+                }
+                EXPECT_EQ(
+                  int,
+                  chunk[(t % chunk_planes) * px_per_frame + i],
+                  expected);
+            }
+        }
+    }
+}
+
+void
+check_mean_projection()
+{
+    std::ifstream ifs(test_path / "series_mean_t" / "zarr.json");
+    const auto metadata = nlohmann::json::parse(ifs);
+    const auto shape = metadata["shape"].get<std::vector<int>>();
+    EXPECT_EQ(int, shape.size(), 2);
+    EXPECT_EQ(int, shape[0], array_height);
+    EXPECT_EQ(int, shape[1], array_width);
+
+    const auto chunk =
+      read_chunk(test_path / "series_mean_t" / "c" / "0" / "0", px_per_frame);
+    for (auto i = 0; i < px_per_frame; ++i) {
+        double sum = 0;
+        for (auto t = 0; t < n_timepoints; ++t) {
+            sum += pixel_value(t, 0, i);
+        }
+        EXPECT_EQ(int, chunk[i], static_cast<int>(sum / n_timepoints + 0.5));
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        size_t bytes_out;
+        for (auto t = 0; t < n_timepoints; ++t) {
+            for (auto z = 0; z < n_planes; ++z) {
+                const auto frame = make_frame(t, z);
+                CHECK_OK(ZarrStream_append(stream,
+                                           frame.data(),
+                                           frame.size() * sizeof(uint16_t),
+                                           &bytes_out,
+                                           "stack"));
+            }
+
+            const auto frame = make_frame(t, 0);
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size() * sizeof(uint16_t),
+                                       &bytes_out,
+                                       "series"));
+        }
+
+        ZarrStream_destroy(stream);
+
+        check_max_projection();
+        check_mean_projection();
+
+        // the source arrays are written as usual
+        std::ifstream ifs(test_path / "stack" / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_timepoints);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
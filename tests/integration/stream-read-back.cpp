@@ -0,0 +1,305 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 20, array_height = 12;
+const unsigned int chunk_width = 7, chunk_height = 5, chunk_planes = 2;
+const unsigned int n_frames = 5;
+const uint8_t significant_bits = 12;
+
+const size_t px_per_chunk = chunk_width * chunk_height * chunk_planes;
+
+uint16_t
+pixel_value(uint64_t t, uint64_t y, uint64_t x)
+{
+    return (t * 1000 + y * 37 + x * 5) & 0xfff;
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrCompressionSettings compression = {
+        .compressor = ZarrCompressor_Blosc1,
+        .codec = ZarrCompressionCodec_BloscZstd,
+        .level = 1,
+        .shuffle = 1,
+    };
+
+    ZarrArraySettings arrays[2] = {
+        {
+          .output_key = "compressed",
+          .compression_settings = &compression,
+          .data_type = ZarrDataType_uint16,
+        },
+        {
+          .output_key = "packed",
+          .data_type = ZarrDataType_uint16,
+          .significant_bits = significant_bits,
+        },
+    };
+
+    for (auto& array : arrays) {
+        CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+        array.dimensions[0] =
+          DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 2, nullptr, 1.0);
+        array.dimensions[1] = DIM("y",
+                                  ZarrDimensionType_Space,
+                                  array_height,
+                                  chunk_height,
+                                  2,
+                                  nullptr,
+                                  1.0);
+        array.dimensions[2] = DIM("x",
+                                  ZarrDimensionType_Space,
+                                  array_width,
+                                  chunk_width,
+                                  2,
+                                  nullptr,
+                                  1.0);
+    }
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = arrays,
+        .array_count = 2,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    for (auto& array : arrays) {
+        ZarrArraySettings_destroy_dimension_array(&array);
+    }
+
+    return stream;
+}
+
+void
+write_frames(ZarrStream* stream)
+{
+    std::vector<uint16_t> frame(array_width * array_height);
+    for (auto t = 0; t < n_frames; ++t) {
+        for (auto y = 0; y < array_height; ++y) {
+            for (auto x = 0; x < array_width; ++x) {
+                frame[y * array_width + x] = pixel_value(t, y, x);
+            }
+        }
+
+        size_t bytes_out;
+        for (const auto* key : { "compressed", "packed" }) {
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size() * sizeof(uint16_t),
+                                       &bytes_out,
+                                       key));
+        }
+    }
+}
+
+ZarrReader*
+open_reader(const char* key)
+{
+    ZarrReaderSettings settings = {
+        .store_path = test_path.c_str(),
+        .array_key = key,
+        .max_threads = 4,
+    };
+
+    return ZarrReader_open(&settings);
+}
+
+void
+check_metadata(ZarrReader* reader)
+{
+    ZarrDataType data_type;
+    size_t ndims;
+    CHECK_OK(ZarrReader_get_array_info(reader, &data_type, &ndims));
+    EXPECT_EQ(int, data_type, ZarrDataType_uint16);
+    EXPECT_EQ(size_t, ndims, 3);
+
+    uint64_t shape[3], chunk_shape[3];
+    CHECK_OK(ZarrReader_get_shape(reader, shape, chunk_shape, 3));
+    EXPECT_EQ(uint64_t, shape[0], n_frames);
+    EXPECT_EQ(uint64_t, shape[1], array_height);
+    EXPECT_EQ(uint64_t, shape[2], array_width);
+    EXPECT_EQ(uint64_t, chunk_shape[0], chunk_planes);
+    EXPECT_EQ(uint64_t, chunk_shape[1], chunk_height);
+    EXPECT_EQ(uint64_t, chunk_shape[2], chunk_width);
+}
+
+void
+check_region(ZarrReader* reader,
+             const std::vector<uint64_t>& offset,
+             const std::vector<uint64_t>& shape)
+{
+    std::vector<uint16_t> region(shape[0] * shape[1] * shape[2]);
+    CHECK_OK(ZarrReader_read_region(reader,
+                                    offset.data(),
+                                    shape.data(),
+                                    3,
+                                    region.data(),
+                                    region.size() * sizeof(uint16_t)));
+
+    size_t i = 0;
+    for (auto t = offset[0]; t < offset[0] + shape[0]; ++t) {
+        for (auto y = offset[1]; y < offset[1] + shape[1]; ++y) {
+            for (auto x = offset[2]; x < offset[2] + shape[2]; ++x) {
+                EXPECT_EQ(int, region[i++], pixel_value(t, y, x));
+            }
+        }
+    }
+}
+
+void
+check_chunk(ZarrReader* reader)
+{
+    // the last chunk along each dimension, partly past the edge of the array
+    const uint64_t coords[3] = { 2, 2, 2 };
+    std::vector<uint16_t> chunk(px_per_chunk);
+    CHECK_OK(ZarrReader_read_chunk(
+      reader, coords, 3, chunk.data(), chunk.size() * sizeof(uint16_t)));
+
+    for (auto t = 0; t < chunk_planes; ++t) {
+        for (auto y = 0; y < chunk_height; ++y) {
+            for (auto x = 0; x < chunk_width; ++x) {
+                const auto at = coords[0] * chunk_planes + t;
+                const auto ay = coords[1] * chunk_height + y;
+                const auto ax = coords[2] * chunk_width + x;
+                if (at < n_frames && ay < array_height && ax < array_width) {
+                    EXPECT_EQ(int,
+                              chunk[(t * chunk_height + y) * chunk_width + x],
+                              pixel_value(at, ay, ax));
+                }
+            }
+        }
+    }
+
+    // out of bounds, too small a buffer, or the wrong number of coordinates
+    const uint64_t past_end[3] = { 3, 0, 0 };
+    EXPECT_EQ(int,
+              ZarrReader_read_chunk(reader,
+                                    past_end,
+                                    3,
+                                    chunk.data(),
+                                    chunk.size() * sizeof(uint16_t)),
+              ZarrStatusCode_InvalidIndex);
+    EXPECT_EQ(int,
+              ZarrReader_read_chunk(reader, coords, 3, chunk.data(), 2),
+              ZarrStatusCode_Overflow);
+    EXPECT_EQ(int,
+              ZarrReader_read_chunk(reader,
+                                    coords,
+                                    2,
+                                    chunk.data(),
+                                    chunk.size() * sizeof(uint16_t)),
+              ZarrStatusCode_InvalidArgument);
+}
+
+void
+check_array(const char* key)
+{
+    ZarrReader* reader = open_reader(key);
+    CHECK(reader);
+
+    try {
+        check_metadata(reader);
+        check_region(
+          reader, { 0, 0, 0 }, { n_frames, array_height, array_width });
+        check_region(reader, { 1, 3, 4 }, { 3, 7, 11 });
+        check_region(reader, { 4, 11, 19 }, { 1, 1, 1 });
+        check_chunk(reader);
+    } catch (...) {
+        ZarrReader_close(reader);
+        throw;
+    }
+
+    ZarrReader_close(reader);
+}
+
+void
+check_missing_and_corrupt_shards()
+{
+    // shard (1, 1, 1) holds the chunks past both the second row and column
+    fs::remove(test_path / "compressed" / "c" / "1" / "1" / "1");
+
+    // corrupt the index checksum of shard (0, 0, 0)
+    {
+        const auto shard_path =
+          test_path / "compressed" / "c" / "0" / "0" / "0";
+        std::fstream file(shard_path,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        char last;
+        file.seekg(-1, std::ios::end);
+        file.get(last);
+        file.seekp(-1, std::ios::end);
+        file.put(static_cast<char>(~last));
+    }
+
+    ZarrReader* reader = open_reader("compressed");
+    CHECK(reader);
+
+    try {
+        const uint64_t missing[3] = { 2, 2, 2 };
+        std::vector<uint16_t> chunk(px_per_chunk, 1);
+        CHECK_OK(ZarrReader_read_chunk(reader,
+                                       missing,
+                                       3,
+                                       chunk.data(),
+                                       chunk.size() * sizeof(uint16_t)));
+        for (const auto px : chunk) {
+            EXPECT_EQ(int, px, 0);
+        }
+
+        const uint64_t corrupt[3] = { 0, 0, 0 };
+        EXPECT_EQ(int,
+                  ZarrReader_read_chunk(reader,
+                                        corrupt,
+                                        3,
+                                        chunk.data(),
+                                        chunk.size() * sizeof(uint16_t)),
+                  ZarrStatusCode_IOError);
+    } catch (...) {
+        ZarrReader_close(reader);
+        throw;
+    }
+
+    ZarrReader_close(reader);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+        write_frames(stream);
+        ZarrStream_destroy(stream);
+
+        check_array("compressed");
+        check_array("packed");
+        check_missing_and_corrupt_shards();
+
+        // nothing to read
+        CHECK(open_reader("absent") == nullptr);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
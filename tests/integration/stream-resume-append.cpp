@@ -0,0 +1,204 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int chunk_planes = 2, shard_chunks = 2;
+const unsigned int planes_per_shard = chunk_planes * shard_chunks;
+
+// the first session ends inside a chunk of the second shard
+const unsigned int first_session_planes = planes_per_shard + 1;
+const unsigned int second_session_planes = 2 * planes_per_shard - 1;
+const unsigned int total_planes = first_session_planes + second_session_planes;
+
+const size_t bytes_per_plane = array_width * array_height;
+
+// frames in each plane of the append dimension when resuming a 4D array
+const unsigned int channels = 2;
+
+ZarrStream*
+make_stream(bool overwrite, bool resume, unsigned int n_channels = 1)
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint8,
+    };
+    const auto ndims = n_channels > 1 ? 4 : 3;
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, ndims));
+    array.dimensions[0] = DIM(
+      "z", ZarrDimensionType_Space, 0, chunk_planes, shard_chunks, nullptr, 1.0);
+    if (n_channels > 1) {
+        array.dimensions[1] = DIM("c",
+                                  ZarrDimensionType_Channel,
+                                  n_channels,
+                                  1,
+                                  n_channels,
+                                  nullptr,
+                                  1.0);
+    }
+    array.dimensions[ndims - 2] = DIM("y",
+                                      ZarrDimensionType_Space,
+                                      array_height,
+                                      array_height,
+                                      1,
+                                      nullptr,
+                                      1.0);
+    array.dimensions[ndims - 1] = DIM(
+      "x", ZarrDimensionType_Space, array_width, array_width, 1, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = overwrite,
+        .arrays = &array,
+        .array_count = 1,
+        .resume = resume,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+append_planes(ZarrStream* stream, unsigned int first, unsigned int count)
+{
+    std::vector<uint8_t> frame(bytes_per_plane);
+    for (auto i = first; i < first + count; ++i) {
+        std::fill(frame.begin(), frame.end(), static_cast<uint8_t>(i + 1));
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(
+          stream, frame.data(), frame.size(), &bytes_out, nullptr));
+        EXPECT_EQ(size_t, bytes_out, frame.size());
+    }
+}
+
+std::vector<uint8_t>
+read_file(const fs::path& path)
+{
+    EXPECT(fs::is_regular_file(path), "Missing file: ", path.string());
+
+    std::ifstream ifs(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(ifs),
+             std::istreambuf_iterator<char>() };
+}
+
+void
+check_shard(unsigned int shard_index)
+{
+    const auto shard = read_file(test_path / "c" /
+                                 std::to_string(shard_index) / "0" / "0");
+
+    const size_t table_size = 2 * shard_chunks * sizeof(uint64_t);
+    CHECK(shard.size() >= table_size + sizeof(uint32_t));
+
+    const auto* index = shard.data() + shard.size() - table_size - 4;
+    uint32_t checksum;
+    memcpy(&checksum, index + table_size, sizeof(checksum));
+    EXPECT_EQ(uint32_t, checksum, crc32c::Crc32c(index, table_size));
+
+    std::vector<uint64_t> table(2 * shard_chunks);
+    memcpy(table.data(), index, table_size);
+
+    for (auto i = 0; i < planes_per_shard; ++i) {
+        const auto plane = shard_index * planes_per_shard + i;
+        if (plane >= total_planes) {
+            break;
+        }
+
+        const auto chunk = i / chunk_planes;
+        const auto offset =
+          table[2 * chunk] + (i % chunk_planes) * bytes_per_plane;
+        EXPECT(offset + bytes_per_plane <= shard.size(),
+               "Plane ",
+               plane,
+               " lies outside of shard ",
+               shard_index);
+
+        for (auto j = 0; j < bytes_per_plane; ++j) {
+            EXPECT_EQ(int, shard[offset + j], plane + 1);
+        }
+    }
+}
+
+void
+check_partial_plane_not_resumed()
+{
+    // the last plane is missing one of its channels
+    ZarrStream* stream = make_stream(true, false, channels);
+    CHECK(stream);
+    append_planes(stream, 0, 2 * channels - 1);
+    ZarrStream_destroy(stream);
+
+    std::ifstream ifs(test_path / "zarr.json");
+    const auto metadata = nlohmann::json::parse(ifs);
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), 2);
+    EXPECT_EQ(int,
+              metadata["attributes"]["frames_written"].get<int>(),
+              2 * channels - 1);
+
+    // resuming would count the missing frame as written
+    CHECK(make_stream(false, true, channels) == nullptr);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream(true, false);
+        CHECK(stream);
+        append_planes(stream, 0, first_session_planes);
+        ZarrStream_destroy(stream);
+
+        const auto first_shard = read_file(test_path / "c" / "0" / "0" / "0");
+
+        // resuming an overwritten store is a contradiction
+        CHECK(make_stream(true, true) == nullptr);
+
+        stream = make_stream(false, true);
+        CHECK(stream);
+        append_planes(stream, first_session_planes, second_session_planes);
+        ZarrStream_destroy(stream);
+
+        // completed shards are left untouched
+        CHECK(read_file(test_path / "c" / "0" / "0" / "0") == first_shard);
+
+        for (auto i = 0; i * planes_per_shard < total_planes; ++i) {
+            check_shard(i);
+        }
+
+        std::ifstream ifs(test_path / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int, metadata["shape"][0].get<int>(), total_planes);
+        CHECK(!metadata["attributes"].contains("frames_written"));
+
+        fs::remove_all(test_path);
+        check_partial_plane_not_resumed();
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
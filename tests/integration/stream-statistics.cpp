@@ -0,0 +1,169 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+// ragged chunks, so the chunk buffers hold padding that must not be counted
+const unsigned int array_width = 12, array_height = 10, n_channels = 2;
+const unsigned int chunk_width = 5, chunk_height = 4, chunk_planes = 2;
+const unsigned int n_timepoints = 3;
+
+const size_t px_per_frame = array_width * array_height;
+
+uint16_t
+pixel_value(uint64_t t, uint64_t c, uint64_t y, uint64_t x)
+{
+    return 1 + c * 2000 + t * 100 + y * array_width + x;
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint16,
+        .compute_statistics = true,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 4));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 1, nullptr, 1.0);
+    array.dimensions[1] =
+      DIM("c", ZarrDimensionType_Channel, n_channels, 1, 1, nullptr, 1.0);
+    array.dimensions[2] = DIM(
+      "y", ZarrDimensionType_Space, array_height, chunk_height, 3, nullptr, 1.0);
+    array.dimensions[3] = DIM(
+      "x", ZarrDimensionType_Space, array_width, chunk_width, 3, nullptr, 1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+// sum of a channel's pixels over all timepoints
+double
+expected_sum(uint64_t c)
+{
+    double sum = 0;
+    for (auto t = 0; t < n_timepoints; ++t) {
+        for (auto i = 0; i < px_per_frame; ++i) {
+            sum += pixel_value(t, c, i / array_width, i % array_width);
+        }
+    }
+    return sum;
+}
+
+void
+check_channel(const ZarrArrayStatistics& stats, uint64_t c)
+{
+    EXPECT_EQ(int, stats.count, n_timepoints * px_per_frame);
+    EXPECT_EQ(double, stats.min, pixel_value(0, c, 0, 0));
+    EXPECT_EQ(double,
+              stats.max,
+              pixel_value(
+                n_timepoints - 1, c, array_height - 1, array_width - 1));
+    EXPECT_EQ(double, stats.sum, expected_sum(c));
+
+    uint64_t histogram_count = 0;
+    for (auto i = 0; i < stats.histogram_bins; ++i) {
+        histogram_count += stats.histogram[i];
+    }
+    EXPECT_EQ(int, histogram_count, stats.count);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        for (auto t = 0; t < n_timepoints; ++t) {
+            for (auto c = 0; c < n_channels; ++c) {
+                std::vector<uint16_t> frame(px_per_frame);
+                for (auto i = 0; i < px_per_frame; ++i) {
+                    frame[i] =
+                      pixel_value(t, c, i / array_width, i % array_width);
+                }
+
+                size_t bytes_out;
+                CHECK_OK(ZarrStream_append(stream,
+                                           frame.data(),
+                                           frame.size() * sizeof(uint16_t),
+                                           &bytes_out,
+                                           nullptr));
+            }
+        }
+
+        // wait for the queued frames to be ingested
+        CHECK_OK(ZarrStream_flush(stream));
+
+        ZarrArrayStatistics stats;
+        CHECK_OK(ZarrStream_get_statistics(stream, nullptr, -1, &stats));
+        EXPECT_EQ(int, stats.count, n_timepoints * n_channels * px_per_frame);
+        EXPECT_EQ(double, stats.sum, expected_sum(0) + expected_sum(1));
+        EXPECT_EQ(int, stats.histogram_bins, 256);
+        EXPECT_EQ(double, stats.histogram_max, 65536.0);
+
+        for (auto c = 0; c < n_channels; ++c) {
+            CHECK_OK(ZarrStream_get_statistics(stream, nullptr, c, &stats));
+            check_channel(stats, c);
+        }
+
+        CHECK(ZarrStream_get_statistics(stream, nullptr, n_channels, &stats) ==
+              ZarrStatusCode_InvalidArgument);
+        CHECK(ZarrStream_get_statistics(stream, "nope", -1, &stats) ==
+              ZarrStatusCode_KeyNotFound);
+
+        ZarrStream_destroy(stream);
+
+        std::ifstream ifs(test_path / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        const auto& statistics = metadata["attributes"]["statistics"];
+        EXPECT_EQ(int,
+                  statistics["count"].get<int>(),
+                  n_timepoints * n_channels * px_per_frame);
+        EXPECT_STR_EQ(
+          statistics["channel_dimension"].get<std::string>().c_str(), "c");
+
+        const auto& channels = statistics["channels"];
+        EXPECT_EQ(int, channels.size(), n_channels);
+        for (auto c = 0; c < n_channels; ++c) {
+            EXPECT_EQ(double,
+                      channels[c]["sum"].get<double>(),
+                      expected_sum(c));
+            EXPECT_EQ(double,
+                      channels[c]["min"].get<double>(),
+                      pixel_value(0, c, 0, 0));
+            EXPECT_EQ(int, channels[c]["histogram"]["counts"].size(), 256);
+        }
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
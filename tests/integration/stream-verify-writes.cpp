@@ -0,0 +1,215 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 16, array_height = 12;
+const unsigned int chunk_width = 8, chunk_height = 6, chunk_planes = 2;
+const unsigned int n_frames = 6;
+
+const size_t px_per_chunk = chunk_width * chunk_height * chunk_planes;
+const size_t chunks_per_shard = 8;
+
+uint16_t
+pixel_value(uint64_t t, uint64_t y, uint64_t x)
+{
+    return t * 1000 + y * 31 + x * 7;
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrCompressionSettings compression = {
+        .compressor = ZarrCompressor_Blosc1,
+        .codec = ZarrCompressionCodec_BloscLZ4,
+        .level = 1,
+        .shuffle = 1,
+    };
+
+    ZarrArraySettings array = {
+        .compression_settings = &compression,
+        .data_type = ZarrDataType_uint16,
+        .chunk_checksums = true,
+    };
+
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, chunk_planes, 2, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              chunk_height,
+                              2,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM("x",
+                              ZarrDimensionType_Space,
+                              array_width,
+                              chunk_width,
+                              2,
+                              nullptr,
+                              1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+        .verify_writes = true,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+write_frames(ZarrStream* stream)
+{
+    std::vector<uint16_t> frame(array_width * array_height);
+    for (auto t = 0; t < n_frames; ++t) {
+        for (auto y = 0; y < array_height; ++y) {
+            for (auto x = 0; x < array_width; ++x) {
+                frame[y * array_width + x] = pixel_value(t, y, x);
+            }
+        }
+
+        size_t bytes_out;
+        CHECK_OK(ZarrStream_append(stream,
+                                   frame.data(),
+                                   frame.size() * sizeof(uint16_t),
+                                   &bytes_out,
+                                   nullptr));
+    }
+}
+
+void
+check_metadata()
+{
+    std::ifstream file(test_path / "zarr.json");
+    const auto metadata = nlohmann::json::parse(file);
+
+    const auto& codecs = metadata["codecs"][0]["configuration"]["codecs"];
+    EXPECT_EQ(size_t, codecs.size(), 3);
+    EXPECT_EQ(std::string, codecs[0]["name"].get<std::string>(), "bytes");
+    EXPECT_EQ(std::string, codecs[1]["name"].get<std::string>(), "blosc");
+    EXPECT_EQ(std::string, codecs[2]["name"].get<std::string>(), "crc32c");
+}
+
+ZarrStatusCode
+read_chunk(ZarrReader* reader, uint64_t t, std::vector<uint16_t>& chunk)
+{
+    const uint64_t coords[3] = { t, 0, 0 };
+    return ZarrReader_read_chunk(
+      reader, coords, 3, chunk.data(), chunk.size() * sizeof(uint16_t));
+}
+
+void
+check_read_back()
+{
+    const ZarrReaderSettings settings = { .store_path = test_path.c_str() };
+    ZarrReader* reader = ZarrReader_open(&settings);
+    CHECK(reader);
+
+    try {
+        std::vector<uint16_t> region(n_frames * array_height * array_width);
+        const uint64_t offset[3] = { 0, 0, 0 };
+        const uint64_t shape[3] = { n_frames, array_height, array_width };
+        CHECK_OK(ZarrReader_read_region(reader,
+                                        offset,
+                                        shape,
+                                        3,
+                                        region.data(),
+                                        region.size() * sizeof(uint16_t)));
+
+        size_t i = 0;
+        for (auto t = 0; t < n_frames; ++t) {
+            for (auto y = 0; y < array_height; ++y) {
+                for (auto x = 0; x < array_width; ++x) {
+                    EXPECT_EQ(int, region[i++], pixel_value(t, y, x));
+                }
+            }
+        }
+    } catch (...) {
+        ZarrReader_close(reader);
+        throw;
+    }
+
+    ZarrReader_close(reader);
+}
+
+void
+check_corrupt_chunk()
+{
+    // flip the first byte of chunk (0, 0, 0), wherever it lies in its shard
+    {
+        std::fstream file(test_path / "c" / "0" / "0" / "0",
+                          std::ios::binary | std::ios::in | std::ios::out);
+        const auto index_size = 2 * chunks_per_shard * sizeof(uint64_t) + 4;
+        uint64_t offset;
+        file.seekg(-static_cast<std::streamoff>(index_size), std::ios::end);
+        file.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+
+        char first;
+        file.seekg(offset);
+        file.get(first);
+        file.seekp(offset);
+        file.put(static_cast<char>(~first));
+    }
+
+    const ZarrReaderSettings settings = { .store_path = test_path.c_str() };
+    ZarrReader* reader = ZarrReader_open(&settings);
+    CHECK(reader);
+
+    try {
+        std::vector<uint16_t> chunk(px_per_chunk);
+        EXPECT_EQ(int, read_chunk(reader, 0, chunk), ZarrStatusCode_IOError);
+
+        // the other chunks in the shard are intact
+        CHECK_OK(read_chunk(reader, 1, chunk));
+        EXPECT_EQ(int, chunk[0], pixel_value(chunk_planes, 0, 0));
+    } catch (...) {
+        ZarrReader_close(reader);
+        throw;
+    }
+
+    ZarrReader_close(reader);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+        write_frames(stream);
+        ZarrStream_destroy(stream);
+
+        check_metadata();
+        check_read_back();
+        check_corrupt_chunk();
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
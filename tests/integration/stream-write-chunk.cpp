@@ -0,0 +1,215 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int chunk_width = 32, chunk_height = 24, chunk_planes = 2;
+const unsigned int shard_width = 1, shard_height = 2, shard_planes = 2;
+
+const unsigned int chunks_along_x = array_width / chunk_width;
+const unsigned int chunks_along_y = array_height / chunk_height;
+const unsigned int chunks_per_shard = shard_width * shard_height * shard_planes;
+
+// the second row of shards along z is left incomplete
+const unsigned int chunks_along_z = 3;
+
+const size_t bytes_per_chunk = chunk_width * chunk_height * chunk_planes;
+
+uint8_t
+chunk_value(uint64_t z, uint64_t y, uint64_t x)
+{
+    return 1 + (z * chunks_along_y + y) * chunks_along_x + x;
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint8,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] = DIM(
+      "z", ZarrDimensionType_Space, 0, chunk_planes, shard_planes, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              chunk_height,
+                              shard_height,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM("x",
+                              ZarrDimensionType_Space,
+                              array_width,
+                              chunk_width,
+                              shard_width,
+                              nullptr,
+                              1.0);
+
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+check_shard(uint64_t shard_z, uint64_t x)
+{
+    const auto shard_path = test_path / "c" / std::to_string(shard_z) / "0" /
+                            std::to_string(x);
+    EXPECT(fs::is_regular_file(shard_path),
+           "Missing shard ",
+           shard_path.string());
+
+    std::ifstream ifs(shard_path, std::ios::binary);
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+    CHECK(shard.size() >= table_size + sizeof(uint32_t));
+
+    const auto* index = shard.data() + shard.size() - table_size - 4;
+    uint32_t checksum;
+    memcpy(&checksum, index + table_size, sizeof(checksum));
+    EXPECT_EQ(uint32_t, checksum, crc32c::Crc32c(index, table_size));
+
+    std::vector<uint64_t> table(2 * chunks_per_shard);
+    memcpy(table.data(), index, table_size);
+
+    for (auto i = 0; i < shard_planes; ++i) {
+        const auto z = shard_z * shard_planes + i;
+        for (auto y = 0; y < shard_height; ++y) {
+            const auto internal_index = i * shard_height + y;
+            const auto offset = table[2 * internal_index];
+            const auto nbytes = table[2 * internal_index + 1];
+
+            if (z >= chunks_along_z) {
+                EXPECT_EQ(uint64_t, nbytes, std::numeric_limits<uint64_t>::max());
+                continue;
+            }
+
+            EXPECT_EQ(uint64_t, nbytes, bytes_per_chunk);
+            CHECK(offset + nbytes <= shard.size());
+            for (auto j = 0; j < nbytes; ++j) {
+                EXPECT_EQ(int, shard[offset + j], chunk_value(z, y, x));
+            }
+        }
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        std::vector<uint8_t> chunk(bytes_per_chunk);
+
+        // write the chunks in reverse order
+        for (int64_t z = chunks_along_z - 1; z >= 0; --z) {
+            for (int64_t y = chunks_along_y - 1; y >= 0; --y) {
+                for (int64_t x = chunks_along_x - 1; x >= 0; --x) {
+                    std::ranges::fill(chunk, chunk_value(z, y, x));
+                    const uint64_t coords[] = { static_cast<uint64_t>(z),
+                                                static_cast<uint64_t>(y),
+                                                static_cast<uint64_t>(x) };
+                    CHECK_OK(ZarrStream_write_chunk(stream,
+                                                    nullptr,
+                                                    coords,
+                                                    3,
+                                                    chunk.data(),
+                                                    chunk.size(),
+                                                    false));
+                }
+            }
+        }
+
+        const uint64_t coords[] = { 0, 0, 0 };
+
+        // shards are closed once all of their chunks are in
+        CHECK(ZarrStream_write_chunk(
+                stream, nullptr, coords, 3, chunk.data(), chunk.size(), false) ==
+              ZarrStatusCode_InvalidArgument);
+        check_shard(0, 0);
+
+        const uint64_t bad_coords[] = { 0, chunks_along_y, 0 };
+        CHECK(ZarrStream_write_chunk(stream,
+                                     nullptr,
+                                     bad_coords,
+                                     3,
+                                     chunk.data(),
+                                     chunk.size(),
+                                     false) == ZarrStatusCode_WriteOutOfBounds);
+
+        // one coordinate per dimension
+        CHECK(ZarrStream_write_chunk(
+                stream, nullptr, coords, 2, chunk.data(), chunk.size(), false) ==
+              ZarrStatusCode_InvalidArgument);
+
+        // the chunk must have the full chunk size
+        const uint64_t next_coords[] = { chunks_along_z, 0, 0 };
+        CHECK(ZarrStream_write_chunk(stream,
+                                     nullptr,
+                                     next_coords,
+                                     3,
+                                     chunk.data(),
+                                     chunk.size() - 1,
+                                     false) == ZarrStatusCode_InvalidArgument);
+
+        // the array has no compression codec
+        CHECK(ZarrStream_write_chunk(stream,
+                                     nullptr,
+                                     next_coords,
+                                     3,
+                                     chunk.data(),
+                                     chunk.size(),
+                                     true) == ZarrStatusCode_InvalidArgument);
+
+        ZarrStream_destroy(stream);
+
+        for (auto shard_z = 0; shard_z * shard_planes < chunks_along_z;
+             ++shard_z) {
+            for (auto x = 0; x < chunks_along_x; ++x) {
+                check_shard(shard_z, x);
+            }
+        }
+
+        std::ifstream ifs(test_path / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(
+          int, metadata["shape"][0].get<int>(), chunks_along_z * chunk_planes);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,292 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48;
+const unsigned int chunk_width = 32, chunk_height = 24, chunk_planes = 2;
+const unsigned int shard_width = 1, shard_height = 2, shard_planes = 2;
+const unsigned int chunks_per_shard = shard_width * shard_height * shard_planes;
+
+const size_t px_per_chunk = chunk_width * chunk_height * chunk_planes;
+const size_t bytes_per_chunk = px_per_chunk * sizeof(uint16_t);
+
+// overlapping tiles cover the first two chunk layers; a small patch is then
+// written into the third, which is never completed
+const unsigned int tile_planes = 4, tile_height = 28, tile_width = 36;
+const std::vector<std::pair<uint64_t, uint64_t>> tile_offsets = {
+    { 20, 28 },
+    { 0, 0 },
+    { 20, 0 },
+    { 0, 28 },
+};
+const unsigned int patch_plane = 4, patch_size = 10;
+const unsigned int n_planes = patch_plane + 1;
+
+// a second patch overlaps the first, which keeps its pixels
+const unsigned int overlap_offset = 5;
+const uint16_t overlap_bias = 20000;
+
+uint16_t
+pixel_value(uint64_t z, uint64_t y, uint64_t x)
+{
+    return 1 + (z * array_height + y) * array_width + x;
+}
+
+std::vector<uint16_t>
+make_region(uint64_t z0,
+            uint64_t y0,
+            uint64_t x0,
+            uint64_t planes,
+            uint64_t height,
+            uint64_t width)
+{
+    std::vector<uint16_t> region(planes * height * width);
+    for (auto z = 0; z < planes; ++z) {
+        for (auto y = 0; y < height; ++y) {
+            for (auto x = 0; x < width; ++x) {
+                region[(z * height + y) * width + x] =
+                  pixel_value(z0 + z, y0 + y, x0 + x);
+            }
+        }
+    }
+
+    return region;
+}
+
+ZarrStream*
+make_stream()
+{
+    ZarrArraySettings array{
+        .data_type = ZarrDataType_uint16,
+    };
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 3));
+    array.dimensions[0] = DIM(
+      "z", ZarrDimensionType_Space, 0, chunk_planes, shard_planes, nullptr, 1.0);
+    array.dimensions[1] = DIM("y",
+                              ZarrDimensionType_Space,
+                              array_height,
+                              chunk_height,
+                              shard_height,
+                              nullptr,
+                              1.0);
+    array.dimensions[2] = DIM("x",
+                              ZarrDimensionType_Space,
+                              array_width,
+                              chunk_width,
+                              shard_width,
+                              nullptr,
+                              1.0);
+
+    // room for a single partly written chunk, so tiles evict each other's
+    // chunks and read them back
+    ZarrStreamSettings settings = {
+        .store_path = test_path.c_str(),
+        .overwrite = true,
+        .arrays = &array,
+        .array_count = 1,
+        .max_region_buffer_bytes = bytes_per_chunk,
+    };
+
+    ZarrStream* stream = ZarrStream_create(&settings);
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    return stream;
+}
+
+void
+check_shard(uint64_t shard_z, uint64_t x)
+{
+    const auto shard_path = test_path / "c" / std::to_string(shard_z) / "0" /
+                            std::to_string(x);
+    EXPECT(fs::is_regular_file(shard_path),
+           "Missing shard ",
+           shard_path.string());
+
+    std::ifstream ifs(shard_path, std::ios::binary);
+    const std::vector<uint8_t> shard{ std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>() };
+
+    const size_t table_size = 2 * chunks_per_shard * sizeof(uint64_t);
+    CHECK(shard.size() >= table_size + sizeof(uint32_t));
+
+    const auto* index = shard.data() + shard.size() - table_size - 4;
+    uint32_t checksum;
+    memcpy(&checksum, index + table_size, sizeof(checksum));
+    EXPECT_EQ(uint32_t, checksum, crc32c::Crc32c(index, table_size));
+
+    std::vector<uint64_t> table(2 * chunks_per_shard);
+    memcpy(table.data(), index, table_size);
+
+    for (auto i = 0; i < shard_planes; ++i) {
+        const auto chunk_z = shard_z * shard_planes + i;
+        for (auto chunk_y = 0; chunk_y < shard_height; ++chunk_y) {
+            const auto internal_index = i * shard_height + chunk_y;
+            const auto offset = table[2 * internal_index];
+            const auto nbytes = table[2 * internal_index + 1];
+
+            // only the chunk holding the patch was written past the tiles
+            const bool has_patch = chunk_z * chunk_planes <= patch_plane &&
+                                   chunk_y == 0 && x == 0;
+            if (chunk_z * chunk_planes >= tile_planes && !has_patch) {
+                EXPECT_EQ(uint64_t, nbytes, std::numeric_limits<uint64_t>::max());
+                continue;
+            }
+
+            EXPECT_EQ(uint64_t, nbytes, bytes_per_chunk);
+            CHECK(offset + nbytes <= shard.size());
+
+            std::vector<uint16_t> chunk(px_per_chunk);
+            memcpy(chunk.data(), shard.data() + offset, nbytes);
+
+            for (auto cz = 0; cz < chunk_planes; ++cz) {
+                for (auto cy = 0; cy < chunk_height; ++cy) {
+                    for (auto cx = 0; cx < chunk_width; ++cx) {
+                        const auto z = chunk_z * chunk_planes + cz;
+                        const auto y = chunk_y * chunk_height + cy;
+                        const auto xx = x * chunk_width + cx;
+
+                        uint16_t expected = 0;
+                        if (z < tile_planes ||
+                            (z == patch_plane && y < patch_size &&
+                             xx < patch_size)) {
+                            expected = pixel_value(z, y, xx);
+                        } else if (z == patch_plane && y >= overlap_offset &&
+                                   y < overlap_offset + patch_size &&
+                                   xx >= overlap_offset &&
+                                   xx < overlap_offset + patch_size) {
+                            expected = pixel_value(z, y, xx) + overlap_bias;
+                        }
+
+                        EXPECT_EQ(
+                          int,
+                          chunk[(cz * chunk_height + cy) * chunk_width + cx],
+                          expected);
+                    }
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        ZarrStream* stream = make_stream();
+        CHECK(stream);
+
+        for (const auto& [y0, x0] : tile_offsets) {
+            const auto tile =
+              make_region(0, y0, x0, tile_planes, tile_height, tile_width);
+            const uint64_t offset[] = { 0, y0, x0 };
+            const uint64_t shape[] = { tile_planes, tile_height, tile_width };
+            CHECK_OK(ZarrStream_write_region(stream,
+                                             nullptr,
+                                             offset,
+                                             shape,
+                                             3,
+                                             tile.data(),
+                                             tile.size() * sizeof(uint16_t)));
+        }
+
+        const auto patch =
+          make_region(patch_plane, 0, 0, 1, patch_size, patch_size);
+        const uint64_t patch_offset[] = { patch_plane, 0, 0 };
+        const uint64_t patch_shape[] = { 1, patch_size, patch_size };
+        CHECK_OK(ZarrStream_write_region(stream,
+                                         nullptr,
+                                         patch_offset,
+                                         patch_shape,
+                                         3,
+                                         patch.data(),
+                                         patch.size() * sizeof(uint16_t)));
+
+        auto overlap = make_region(patch_plane,
+                                   overlap_offset,
+                                   overlap_offset,
+                                   1,
+                                   patch_size,
+                                   patch_size);
+        for (auto& px : overlap) {
+            px += overlap_bias;
+        }
+        const uint64_t overlap_offsets[] = { patch_plane,
+                                             overlap_offset,
+                                             overlap_offset };
+        CHECK_OK(ZarrStream_write_region(stream,
+                                         nullptr,
+                                         overlap_offsets,
+                                         patch_shape,
+                                         3,
+                                         overlap.data(),
+                                         overlap.size() * sizeof(uint16_t)));
+
+        // the region must lie within the array
+        const uint64_t bad_offset[] = { 0, array_height - patch_size + 1, 0 };
+        CHECK(ZarrStream_write_region(stream,
+                                      nullptr,
+                                      bad_offset,
+                                      patch_shape,
+                                      3,
+                                      patch.data(),
+                                      patch.size() * sizeof(uint16_t)) ==
+              ZarrStatusCode_WriteOutOfBounds);
+
+        // the data must match the region shape
+        CHECK(ZarrStream_write_region(stream,
+                                      nullptr,
+                                      patch_offset,
+                                      patch_shape,
+                                      3,
+                                      patch.data(),
+                                      patch.size() * sizeof(uint16_t) - 1) ==
+              ZarrStatusCode_InvalidArgument);
+
+        ZarrStream_destroy(stream);
+
+        for (auto shard_z = 0; shard_z * shard_planes * chunk_planes < n_planes;
+             ++shard_z) {
+            for (auto x = 0; x < array_width / chunk_width; ++x) {
+                // shards no region reached are never created
+                if (shard_z * shard_planes * chunk_planes >= tile_planes &&
+                    x > 0) {
+                    CHECK(!fs::exists(test_path / "c" /
+                                      std::to_string(shard_z) / "0" /
+                                      std::to_string(x)));
+                    continue;
+                }
+                check_shard(shard_z, x);
+            }
+        }
+
+        std::ifstream ifs(test_path / "zarr.json");
+        const auto metadata = nlohmann::json::parse(ifs);
+        EXPECT_EQ(int, metadata["shape"][0].get<int>(), n_planes);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
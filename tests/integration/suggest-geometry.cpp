@@ -0,0 +1,158 @@
+#include "acquire.zarr.h"
+#include "test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path test_path = TEST ".zarr";
+
+const unsigned int array_width = 64, array_height = 48, array_planes = 6;
+const unsigned int n_timepoints = 3;
+
+constexpr size_t KiB = 1 << 10;
+
+void
+initialize_array(ZarrArraySettings& array)
+{
+    CHECK_OK(ZarrArraySettings_create_dimension_array(&array, 4));
+    array.dimensions[0] =
+      DIM("t", ZarrDimensionType_Time, 0, 0, 0, nullptr, 1.0);
+    array.dimensions[1] =
+      DIM("z", ZarrDimensionType_Space, array_planes, 0, 0, nullptr, 1.0);
+    array.dimensions[2] =
+      DIM("y", ZarrDimensionType_Space, array_height, 0, 0, nullptr, 1.0);
+    array.dimensions[3] =
+      DIM("x", ZarrDimensionType_Space, array_width, 0, 0, nullptr, 1.0);
+}
+
+void
+check_invalid_arguments(ZarrArraySettings& array)
+{
+    ZarrGeometrySuggestion suggestion;
+
+    EXPECT_EQ(int,
+              ZarrArraySettings_suggest_geometry(
+                nullptr, KiB, KiB, ZarrReadPattern_Frames, 0.0, &suggestion),
+              ZarrStatusCode_InvalidArgument);
+    EXPECT_EQ(int,
+              ZarrArraySettings_suggest_geometry(
+                &array, KiB, KiB, ZarrReadPattern_Frames, 0.0, nullptr),
+              ZarrStatusCode_InvalidArgument);
+    EXPECT_EQ(int,
+              ZarrArraySettings_suggest_geometry(
+                &array, KiB, KiB, ZarrReadPatternCount, 0.0, &suggestion),
+              ZarrStatusCode_InvalidArgument);
+    EXPECT_EQ(int,
+              ZarrArraySettings_suggest_geometry(
+                &array, 0, KiB, ZarrReadPattern_Frames, 0.0, &suggestion),
+              ZarrStatusCode_InvalidArgument);
+    EXPECT_EQ(int,
+              ZarrArraySettings_suggest_geometry(
+                &array, KiB, 0, ZarrReadPattern_Frames, 0.0, &suggestion),
+              ZarrStatusCode_InvalidArgument);
+    EXPECT_EQ(int,
+              ZarrArraySettings_suggest_geometry(
+                &array, KiB, KiB, ZarrReadPattern_Frames, -1.0, &suggestion),
+              ZarrStatusCode_InvalidArgument);
+}
+
+void
+check_metadata(const ZarrArraySettings& array)
+{
+    std::ifstream file(test_path / "zarr.json");
+    const auto metadata = nlohmann::json::parse(file);
+
+    const auto& configuration = metadata["codecs"][0]["configuration"];
+    const auto& chunk_shape = configuration["chunk_shape"];
+    const auto& shard_shape = metadata["chunk_grid"]["configuration"];
+    EXPECT_EQ(size_t, chunk_shape.size(), 4);
+    for (auto i = 0; i < 4; ++i) {
+        const auto& dim = array.dimensions[i];
+        EXPECT_EQ(int, chunk_shape[i].get<int>(), dim.chunk_size_px);
+        EXPECT_EQ(int,
+                  shard_shape["chunk_shape"][i].get<int>(),
+                  dim.chunk_size_px * dim.shard_size_chunks);
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    ZarrArraySettings array = {
+        .data_type = ZarrDataType_uint16,
+    };
+
+    try {
+        initialize_array(array);
+        check_invalid_arguments(array);
+
+        // after the 6 KiB frame buffer, a budget of 128 KiB holds a layer of
+        // whole-frame chunks 3 timepoints deep, at 36 KiB per timepoint
+        ZarrGeometrySuggestion suggestion;
+        CHECK_OK(ZarrArraySettings_suggest_geometry(&array,
+                                                    128 * KiB,
+                                                    1024 * KiB,
+                                                    ZarrReadPattern_Frames,
+                                                    10.0,
+                                                    &suggestion));
+        EXPECT_EQ(int, array.dimensions[0].chunk_size_px, 3);
+        EXPECT_EQ(int, array.dimensions[1].chunk_size_px, 1);
+        EXPECT_EQ(int, array.dimensions[2].chunk_size_px, array_height);
+        EXPECT_EQ(int, array.dimensions[3].chunk_size_px, array_width);
+        EXPECT(suggestion.memory_bytes <= 128 * KiB,
+               "Expected at most 128 KiB, got ",
+               suggestion.memory_bytes);
+        EXPECT_EQ(uint64_t, suggestion.frames_per_flush, 3 * array_planes);
+
+        ZarrStreamSettings settings = {
+            .store_path = test_path.c_str(),
+            .overwrite = true,
+            .arrays = &array,
+            .array_count = 1,
+        };
+
+        // the stream's estimate counts the array the same way, plus the
+        // frame queue
+        size_t usage;
+        CHECK_OK(ZarrStreamSettings_estimate_max_memory_usage(&settings,
+                                                               &usage));
+        EXPECT_EQ(size_t, usage, (1 << 30) + suggestion.memory_bytes);
+
+        ZarrStream* stream = ZarrStream_create(&settings);
+        CHECK(stream);
+
+        std::vector<uint16_t> frame(array_width * array_height, 7);
+        for (auto i = 0; i < n_timepoints * array_planes; ++i) {
+            size_t bytes_out;
+            CHECK_OK(ZarrStream_append(stream,
+                                       frame.data(),
+                                       frame.size() * sizeof(uint16_t),
+                                       &bytes_out,
+                                       nullptr));
+        }
+        ZarrStream_destroy(stream);
+
+        check_metadata(array);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Failed: ", exc.what());
+    }
+
+    ZarrArraySettings_destroy_dimension_array(&array);
+
+    if (fs::exists(test_path)) {
+        fs::remove_all(test_path);
+    }
+
+    return retval;
+}
@@ -0,0 +1,264 @@
+#include "append.recorder.hh"
+#include "unit.test.macros.hh"
+
+#include <crc32c/crc32c.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+std::vector<nlohmann::json>
+read_lines(const fs::path& path)
+{
+    std::ifstream file(path);
+    CHECK(file.is_open());
+
+    std::vector<nlohmann::json> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(nlohmann::json::parse(line));
+    }
+
+    return lines;
+}
+
+ZarrStreamSettings
+make_settings(std::vector<ZarrDimensionProperties>& dims,
+              ZarrCompressionSettings& compression,
+              ZarrArraySettings& array)
+{
+    dims = {
+        { "t", ZarrDimensionType_Time, 0, 4, 1, nullptr, 1.0 },
+        { "y", ZarrDimensionType_Space, 48, 16, 1, "micrometer", 0.5 },
+        { "x", ZarrDimensionType_Space, 64, 16, 2, "micrometer", 0.5 },
+    };
+    compression = { .compressor = ZarrCompressor_Blosc1,
+                    .codec = ZarrCompressionCodec_BloscZstd,
+                    .level = 3,
+                    .shuffle = 1 };
+
+    array = {};
+    array.output_key = "labels";
+    array.compression_settings = &compression;
+    array.dimensions = dims.data();
+    array.dimension_count = dims.size();
+    array.data_type = ZarrDataType_uint16;
+
+    ZarrStreamSettings settings{};
+    settings.store_path = "/data/acquisition.zarr";
+    settings.max_threads = 3;
+    settings.flush_interval_ms = 250;
+    settings.arrays = &array;
+    settings.array_count = 1;
+
+    return settings;
+}
+
+void
+check_settings_header()
+{
+    std::vector<ZarrDimensionProperties> dims;
+    ZarrCompressionSettings compression;
+    ZarrArraySettings array;
+    auto settings = make_settings(dims, compression, array);
+    settings.frame_rate_hz = 30.0;
+
+    const char* field_names[] = { "timestamp", "exposure" };
+    ZarrFrameMetadataSettings frame_metadata{ .data_type = ZarrDataType_float64,
+                                              .field_count = 2,
+                                              .field_names = field_names };
+    array.frame_metadata = &frame_metadata;
+
+    ZarrBandwidthLimit bandwidth_limit{ .bytes_per_second = 1 << 20 };
+    settings.bandwidth_limit = &bandwidth_limit;
+
+    const auto path = base_dir / "header.jsonl";
+    const ZarrCaptureSettings capture{ .path = path.c_str() };
+    {
+        zarr::AppendRecorder recorder(capture, settings);
+    }
+
+    const auto lines = read_lines(path);
+    EXPECT_EQ(int, lines.size(), 1);
+    CHECK(!fs::exists(path.string() + ".payloads"));
+
+    const auto& header = lines[0];
+    EXPECT_EQ(int, header["version"].get<int>(), 2);
+    EXPECT_EQ(int, header["payload_sample_interval"].get<int>(), 0);
+
+    const auto& described = header["settings"];
+    EXPECT_STR_EQ(described["store_path"].get<std::string>().c_str(),
+                  "/data/acquisition.zarr");
+    EXPECT_EQ(int, described["max_threads"].get<int>(), 3);
+    EXPECT_EQ(int, described["flush_interval_ms"].get<int>(), 250);
+    CHECK(!described["s3"].get<bool>());
+    CHECK(!described["calibrate"].get<bool>());
+    EXPECT_EQ(double, described["frame_rate_hz"].get<double>(), 30.0);
+    EXPECT_EQ(int,
+              described["bandwidth_limit"]["bytes_per_second"].get<int>(),
+              1 << 20);
+    CHECK(!described["bandwidth_limit"]["shared"].get<bool>());
+
+    const auto& arrays = described["arrays"];
+    EXPECT_EQ(int, arrays.size(), 1);
+    EXPECT_STR_EQ(arrays[0]["output_key"].get<std::string>().c_str(),
+                  "labels");
+    EXPECT_EQ(int, arrays[0]["data_type"].get<int>(), ZarrDataType_uint16);
+    EXPECT_EQ(int,
+              arrays[0]["compression"]["codec"].get<int>(),
+              ZarrCompressionCodec_BloscZstd);
+    CHECK(arrays[0]["input_conversion"].is_null());
+
+    const auto& metadata = arrays[0]["frame_metadata"];
+    EXPECT_EQ(int, metadata["field_count"].get<int>(), 2);
+    EXPECT_STR_EQ(metadata["field_names"][1].get<std::string>().c_str(),
+                  "exposure");
+    EXPECT_EQ(int, metadata["records_per_chunk"].get<int>(), 0);
+
+    const auto& dimensions = arrays[0]["dimensions"];
+    EXPECT_EQ(int, dimensions.size(), 3);
+    EXPECT_STR_EQ(dimensions[2]["name"].get<std::string>().c_str(), "x");
+    EXPECT_EQ(int, dimensions[2]["array_size_px"].get<int>(), 64);
+    EXPECT_EQ(int, dimensions[2]["shard_size_chunks"].get<int>(), 2);
+    CHECK(dimensions[0]["unit"].is_null());
+    EXPECT_EQ(double, dimensions[1]["scale"].get<double>(), 0.5);
+}
+
+void
+check_records()
+{
+    std::vector<ZarrDimensionProperties> dims;
+    ZarrCompressionSettings compression;
+    ZarrArraySettings array;
+    const auto settings = make_settings(dims, compression, array);
+
+    const auto path = base_dir / "records.jsonl";
+    const ZarrCaptureSettings capture{ .path = path.c_str(),
+                                       .hash_payloads = true,
+                                       .payload_sample_interval = 2 };
+
+    constexpr size_t n_appends = 5;
+    std::vector<std::vector<uint8_t>> payloads;
+    {
+        zarr::AppendRecorder recorder(capture, settings);
+
+        for (auto i = 0; i < n_appends; ++i) {
+            auto& payload = payloads.emplace_back(100 + i);
+            for (auto j = 0; j < payload.size(); ++j) {
+                payload[j] = static_cast<uint8_t>(i * 31 + j);
+            }
+
+            const auto start = zarr::AppendRecorder::Clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            const auto end = zarr::AppendRecorder::Clock::now();
+
+            recorder.record(i % 2 ? nullptr : "labels",
+                            payload.data(),
+                            payload.size(),
+                            payload.size(),
+                            ZarrStatusCode_Success,
+                            start,
+                            end);
+        }
+
+        // a null payload is neither hashed nor sampled
+        const auto now = zarr::AppendRecorder::Clock::now();
+        recorder.record(
+          "labels", nullptr, 10, 10, ZarrStatusCode_Success, now, now);
+    }
+
+    const auto lines = read_lines(path);
+    EXPECT_EQ(int, lines.size(), n_appends + 2);
+
+    std::ifstream sidecar(path.string() + ".payloads", std::ios::binary);
+    CHECK(sidecar.is_open());
+
+    int64_t last_t_ns = 0;
+    for (auto i = 0; i < n_appends; ++i) {
+        const auto& record = lines[i + 1];
+        const auto& payload = payloads[i];
+
+        if (i % 2) {
+            CHECK(record["key"].is_null());
+        } else {
+            EXPECT_STR_EQ(record["key"].get<std::string>().c_str(),
+                          "labels");
+        }
+        EXPECT_EQ(int, record["bytes_in"].get<int>(), payload.size());
+        EXPECT_EQ(int, record["bytes_out"].get<int>(), payload.size());
+        EXPECT_EQ(int, record["status"].get<int>(), ZarrStatusCode_Success);
+        CHECK(record["latency_ns"].get<int64_t>() >= 1000000);
+
+        const auto t_ns = record["t_ns"].get<int64_t>();
+        CHECK(t_ns >= last_t_ns);
+        last_t_ns = t_ns;
+
+        EXPECT_EQ(uint32_t,
+                  record["crc32c"].get<uint32_t>(),
+                  crc32c::Crc32c(payload.data(), payload.size()));
+
+        // every other payload is copied to the sidecar
+        CHECK(record.contains("payload_offset") == (i % 2 == 0));
+        if (record.contains("payload_offset")) {
+            std::vector<uint8_t> copy(payload.size());
+            sidecar.seekg(record["payload_offset"].get<std::streamoff>());
+            sidecar.read(reinterpret_cast<char*>(copy.data()), copy.size());
+            CHECK(sidecar.good());
+            CHECK(copy == payload);
+        }
+    }
+
+    const auto& null_record = lines.back();
+    CHECK(null_record["null_data"].get<bool>());
+    CHECK(!null_record.contains("crc32c"));
+    CHECK(!null_record.contains("payload_offset"));
+}
+
+void
+check_bad_path()
+{
+    std::vector<ZarrDimensionProperties> dims;
+    ZarrCompressionSettings compression;
+    ZarrArraySettings array;
+    const auto settings = make_settings(dims, compression, array);
+
+    const auto path = base_dir / "missing" / "capture.jsonl";
+    const ZarrCaptureSettings capture{ .path = path.c_str() };
+
+    bool threw = false;
+    try {
+        zarr::AppendRecorder recorder(capture, settings);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        fs::create_directories(base_dir);
+
+        check_settings_header();
+        check_records();
+        check_bad_path();
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    fs::remove_all(base_dir);
+
+    return retval;
+}
@@ -0,0 +1,143 @@
+#include "array.hh"
+#include "checkpoint.hh"
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+const unsigned int array_width = 32, array_height = 32;
+const unsigned int chunk_width = 16, chunk_height = 16, chunk_planes = 1;
+const unsigned int shard_width = 2, shard_height = 2, shard_planes = 8;
+
+const unsigned int chunks_per_layer = shard_width * shard_height;
+const unsigned int chunks_per_shard = chunks_per_layer * shard_planes;
+
+// frames covered by the last checkpoint, and frames written after it
+const unsigned int checkpointed_frames = 3, lost_frames = 1;
+} // namespace
+
+int
+main()
+{
+    Logger::set_log_level(LogLevel_Debug);
+
+    int retval = 1;
+
+    const ZarrDataType dtype = ZarrDataType_uint16;
+    const unsigned int nbytes_px = zarr::bytes_of_type(dtype);
+
+    try {
+        auto thread_pool = std::make_shared<zarr::ThreadPool>(
+          std::thread::hardware_concurrency(),
+          [](const std::string& err) { LOG_ERROR("Error: ", err.c_str()); });
+
+        std::vector<ZarrDimension> dims;
+        dims.emplace_back(
+          "z", ZarrDimensionType_Space, 0, chunk_planes, shard_planes);
+        dims.emplace_back(
+          "y", ZarrDimensionType_Space, array_height, chunk_height, shard_height);
+        dims.emplace_back(
+          "x", ZarrDimensionType_Space, array_width, chunk_width, shard_width);
+
+        auto config = std::make_shared<zarr::ArrayConfig>(
+          base_dir.string(),
+          "",
+          std::nullopt,
+          std::nullopt,
+          std::make_shared<ArrayDimensions>(std::move(dims), dtype),
+          dtype,
+          std::nullopt,
+          0);
+        config->checkpoint_interval = std::chrono::milliseconds(1);
+
+        {
+            auto writer = std::make_unique<zarr::Array>(
+              config,
+              thread_pool,
+              std::make_shared<zarr::FileHandlePool>(),
+              nullptr);
+
+            const size_t frame_size = array_width * array_height * nbytes_px;
+            zarr::LockedBuffer data(std::move(ByteVector(frame_size, 1)));
+
+            for (auto i = 0; i < checkpointed_frames + lost_frames; ++i) {
+                if (i == checkpointed_frames) {
+                    config->checkpoint_interval = std::chrono::hours(1);
+                }
+
+                size_t bytes_out;
+                CHECK(writer->write_frame(data, bytes_out) ==
+                      zarr::WriteResult::Ok);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+
+            // simulate a crash: the writer goes away without being closed
+        }
+
+        CHECK(fs::is_regular_file(base_dir / zarr::checkpoint_manifest_name));
+        CHECK(zarr::recover_array(base_dir.string()));
+        CHECK(!fs::exists(base_dir / zarr::checkpoint_manifest_name));
+
+        // the shard holds the checkpointed layers followed by their index
+        const auto shard_path = base_dir / "c" / "0" / "0" / "0";
+        CHECK(fs::is_regular_file(shard_path));
+
+        const size_t chunk_size = chunk_width * chunk_height * nbytes_px;
+        const size_t data_size =
+          checkpointed_frames * chunks_per_layer * chunk_size;
+        const size_t index_size = 2 * chunks_per_shard * sizeof(uint64_t);
+        EXPECT_EQ(size_t,
+                  fs::file_size(shard_path),
+                  data_size + index_size + sizeof(uint32_t));
+
+        std::ifstream shard(shard_path, std::ios::binary);
+        std::vector<uint64_t> table(2 * chunks_per_shard);
+        uint32_t checksum;
+        shard.seekg(data_size);
+        shard.read(reinterpret_cast<char*>(table.data()), index_size);
+        shard.read(reinterpret_cast<char*>(&checksum), sizeof(checksum));
+        EXPECT_EQ(uint32_t,
+                  checksum,
+                  crc32c::Crc32c(reinterpret_cast<uint8_t*>(table.data()),
+                                 index_size));
+
+        const auto n_written = checkpointed_frames * chunks_per_layer;
+        for (auto i = 0; i < chunks_per_shard; ++i) {
+            if (i < n_written) {
+                EXPECT_EQ(uint64_t, table[2 * i], i * chunk_size);
+                EXPECT_EQ(uint64_t, table[2 * i + 1], chunk_size);
+            } else {
+                EXPECT_EQ(uint64_t,
+                          table[2 * i + 1],
+                          std::numeric_limits<uint64_t>::max());
+            }
+        }
+
+        std::ifstream meta_file(base_dir / "zarr.json");
+        const auto meta = nlohmann::json::parse(meta_file);
+        EXPECT_EQ(int, meta["shape"][0].get<int>(), checkpointed_frames);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    // cleanup
+    if (fs::exists(base_dir)) {
+        fs::remove_all(base_dir);
+    }
+
+    return retval;
+}
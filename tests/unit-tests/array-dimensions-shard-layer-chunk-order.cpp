@@ -0,0 +1,108 @@
+#include "array.dimensions.hh"
+#include "unit.test.macros.hh"
+
+#include <stdexcept>
+
+namespace {
+void
+check_order(const std::vector<uint32_t>& actual,
+            const std::vector<uint32_t>& expected)
+{
+    EXPECT_EQ(size_t, actual.size(), expected.size());
+    for (auto i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(int, actual[i], expected[i]);
+    }
+}
+
+void
+check_3d()
+{
+    std::vector<ZarrDimension> dims;
+    dims.emplace_back("t",
+                      ZarrDimensionType_Time,
+                      0,
+                      32, // 32 timepoints / chunk
+                      2); // 2 layers / shard
+    dims.emplace_back("y",
+                      ZarrDimensionType_Space,
+                      64,
+                      16, // 4 chunks
+                      4); // 1 shard
+    dims.emplace_back("x",
+                      ZarrDimensionType_Space,
+                      64,
+                      16, // 4 chunks
+                      4); // 1 shard
+    ArrayDimensions dimensions(std::move(dims), ZarrDataType_uint8);
+
+    check_order(dimensions.shard_layer_chunk_order(ZarrChunkOrder_RowMajor),
+                { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+
+    // 2x2 blocks of chunks, themselves in 2x2 blocks
+    check_order(dimensions.shard_layer_chunk_order(ZarrChunkOrder_Morton),
+                { 0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15 });
+
+    // with only the YX dimensions in a layer, each tile is a single chunk
+    check_order(dimensions.shard_layer_chunk_order(ZarrChunkOrder_TileMajor),
+                { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+}
+
+void
+check_4d()
+{
+    std::vector<ZarrDimension> dims;
+    dims.emplace_back("t",
+                      ZarrDimensionType_Time,
+                      0,
+                      1,  // 1 timepoint / chunk
+                      1); // 1 layer / shard
+    dims.emplace_back("z",
+                      ZarrDimensionType_Space,
+                      20,
+                      10, // 2 chunks
+                      2); // 1 shard
+    dims.emplace_back("y",
+                      ZarrDimensionType_Space,
+                      72,
+                      24, // 3 chunks
+                      3); // 1 shard
+    dims.emplace_back("x",
+                      ZarrDimensionType_Space,
+                      64,
+                      64, // 1 chunk
+                      1); // 1 shard
+    ArrayDimensions dimensions(std::move(dims), ZarrDataType_uint16);
+
+    // both z chunks of the first tile, then of the second, then the third
+    check_order(dimensions.shard_layer_chunk_order(ZarrChunkOrder_TileMajor),
+                { 0, 3, 1, 4, 2, 5 });
+
+    // x needs no bits, z one and y two, so the key bits are y0 z0 y1
+    check_order(dimensions.shard_layer_chunk_order(ZarrChunkOrder_Morton),
+                { 0, 1, 3, 4, 2, 5 });
+
+    bool threw = false;
+    try {
+        (void)dimensions.shard_layer_chunk_order(ZarrChunkOrderCount);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    EXPECT(threw, "Expected an invalid chunk order to be rejected");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_3d();
+        check_4d();
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    return retval;
+}
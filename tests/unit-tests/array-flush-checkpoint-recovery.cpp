@@ -0,0 +1,137 @@
+#include "array.hh"
+#include "checkpoint.hh"
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+const unsigned int array_width = 16, array_height = 16;
+const unsigned int chunk_planes = 2, shard_planes = 4;
+
+const unsigned int chunks_per_shard = shard_planes;
+const size_t frame_size = array_width * array_height;
+const size_t chunk_size = chunk_planes * frame_size;
+
+// frames appended before the flush, and the frame that completes the
+// flushed layer before the crash
+const unsigned int flushed_frames = 3;
+} // namespace
+
+int
+main()
+{
+    Logger::set_log_level(LogLevel_Debug);
+
+    int retval = 1;
+
+    const ZarrDataType dtype = ZarrDataType_uint8;
+
+    try {
+        auto thread_pool = std::make_shared<zarr::ThreadPool>(
+          std::thread::hardware_concurrency(),
+          [](const std::string& err) { LOG_ERROR("Error: ", err.c_str()); });
+
+        std::vector<ZarrDimension> dims;
+        dims.emplace_back(
+          "z", ZarrDimensionType_Space, 0, chunk_planes, shard_planes);
+        dims.emplace_back(
+          "y", ZarrDimensionType_Space, array_height, array_height, 1);
+        dims.emplace_back(
+          "x", ZarrDimensionType_Space, array_width, array_width, 1);
+
+        auto config = std::make_shared<zarr::ArrayConfig>(
+          base_dir.string(),
+          "",
+          std::nullopt,
+          std::nullopt,
+          std::make_shared<ArrayDimensions>(std::move(dims), dtype),
+          dtype,
+          std::nullopt,
+          0);
+        config->checkpoint_interval = std::chrono::hours(1);
+
+        {
+            auto writer = std::make_unique<zarr::Array>(
+              config,
+              thread_pool,
+              std::make_shared<zarr::FileHandlePool>(),
+              nullptr);
+
+            for (auto i = 0; i <= flushed_frames; ++i) {
+                const auto value = static_cast<uint8_t>(i + 1);
+                zarr::LockedBuffer data(
+                  std::move(ByteVector(frame_size, value)));
+
+                size_t bytes_out;
+                CHECK(writer->write_frame(data, bytes_out) ==
+                      zarr::WriteResult::Ok);
+
+                // the open layer is flushed and checkpointed, then completed
+                // with no checkpoint due
+                if (i + 1 == flushed_frames) {
+                    CHECK(writer->flush());
+                }
+            }
+
+            // simulate a crash: the writer goes away without being closed
+        }
+
+        CHECK(fs::is_regular_file(base_dir / zarr::checkpoint_manifest_name));
+        CHECK(zarr::recover_array(base_dir.string()));
+
+        // the shard holds the first layer and the flushed copy of the second,
+        // followed by their index
+        const auto shard_path = base_dir / "c" / "0" / "0" / "0";
+        std::ifstream shard_file(shard_path, std::ios::binary);
+        const ByteVector shard{ std::istreambuf_iterator<char>(shard_file),
+                                std::istreambuf_iterator<char>() };
+
+        const size_t index_size = 2 * chunks_per_shard * sizeof(uint64_t);
+        EXPECT_EQ(size_t,
+                  shard.size(),
+                  2 * chunk_size + index_size + sizeof(uint32_t));
+
+        std::vector<uint64_t> table(2 * chunks_per_shard);
+        memcpy(table.data(), shard.data() + 2 * chunk_size, index_size);
+
+        for (auto i = 0; i < 2 * chunk_planes; ++i) {
+            const auto chunk = i / chunk_planes;
+            EXPECT_EQ(uint64_t, table[2 * chunk + 1], chunk_size);
+
+            // the frame appended after the flush was never checkpointed, so
+            // the recovered chunk must still hold the flushed fill
+            const uint8_t expected = i < flushed_frames ? i + 1 : 0;
+            const auto offset =
+              table[2 * chunk] + (i % chunk_planes) * frame_size;
+            for (auto j = 0; j < frame_size; ++j) {
+                EXPECT_EQ(int, shard[offset + j], expected);
+            }
+        }
+
+        std::ifstream meta_file(base_dir / "zarr.json");
+        const auto meta = nlohmann::json::parse(meta_file);
+        EXPECT_EQ(int, meta["shape"][0].get<int>(), flushed_frames);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    // cleanup
+    if (fs::exists(base_dir)) {
+        fs::remove_all(base_dir);
+    }
+
+    return retval;
+}
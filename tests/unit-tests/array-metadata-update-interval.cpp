@@ -0,0 +1,153 @@
+#include "array.hh"
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+const unsigned int array_width = 64, array_height = 48, array_planes = 6;
+const unsigned int n_frames = array_planes;
+
+const unsigned int chunk_width = 16, chunk_height = 16, chunk_planes = 2;
+
+const unsigned int shard_width = 2, shard_height = 1, shard_planes = 1;
+
+// read the append dimension size from zarr.json, or -1 if it isn't readable
+int
+read_append_size()
+{
+    const fs::path meta_path = base_dir / "zarr.json";
+    if (!fs::is_regular_file(meta_path)) {
+        return -1;
+    }
+
+    std::ifstream f(meta_path);
+    const auto meta = nlohmann::json::parse(f, nullptr, false);
+    if (meta.is_discarded()) {
+        return -1;
+    }
+
+    return meta["shape"][0].get<int>();
+}
+} // namespace
+
+int
+main()
+{
+    Logger::set_log_level(LogLevel_Debug);
+
+    int retval = 1;
+
+    const ZarrDataType dtype = ZarrDataType_uint8;
+    const unsigned int nbytes_px = zarr::bytes_of_type(dtype);
+
+    try {
+        auto thread_pool = std::make_shared<zarr::ThreadPool>(
+          std::thread::hardware_concurrency(),
+          [](const std::string& err) { LOG_ERROR("Error: ", err.c_str()); });
+
+        std::vector<ZarrDimension> dims;
+        dims.emplace_back(
+          "z", ZarrDimensionType_Space, array_planes, chunk_planes, shard_planes);
+        dims.emplace_back(
+          "y", ZarrDimensionType_Space, array_height, chunk_height, shard_height);
+        dims.emplace_back(
+          "x", ZarrDimensionType_Space, array_width, chunk_width, shard_width);
+
+        auto config = std::make_shared<zarr::ArrayConfig>(
+          base_dir.string(),
+          "",
+          std::nullopt,
+          std::nullopt,
+          std::make_shared<ArrayDimensions>(std::move(dims), dtype),
+          dtype,
+          std::nullopt,
+          0);
+
+        // only the first rollover should update the metadata before close
+        config->metadata_update_interval = std::chrono::hours(1);
+
+        {
+            auto writer = std::make_unique<zarr::Array>(
+              config,
+              thread_pool,
+              std::make_shared<zarr::FileHandlePool>(),
+              nullptr);
+
+            const size_t frame_size = array_width * array_height * nbytes_px;
+            zarr::LockedBuffer data(std::move(ByteVector(frame_size, 0)));
+
+            for (auto i = 0; i < n_frames; ++i) {
+                size_t bytes_out;
+                CHECK(writer->write_frame(data, bytes_out) ==
+                      zarr::WriteResult::Ok);
+                CHECK(bytes_out == data.size());
+            }
+
+            // the intermediate update is written in the background
+            int append_size = -1;
+            for (auto i = 0; i < 100 && append_size != chunk_planes; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                append_size = read_append_size();
+            }
+            EXPECT_EQ(int, append_size, chunk_planes);
+
+            CHECK(finalize_array(std::move(writer)));
+        }
+
+        EXPECT_EQ(int, read_append_size(), array_planes);
+        fs::remove_all(base_dir);
+
+        // chunks written directly are rate limited the same way
+        {
+            auto writer = std::make_unique<zarr::Array>(
+              config,
+              thread_pool,
+              std::make_shared<zarr::FileHandlePool>(),
+              nullptr);
+
+            const ByteVector chunk(
+              chunk_width * chunk_height * chunk_planes * nbytes_px, 0);
+            for (uint64_t z = 0; z < array_planes / chunk_planes; ++z) {
+                for (uint64_t y = 0; y < array_height / chunk_height; ++y) {
+                    for (uint64_t x = 0; x < array_width / chunk_width; ++x) {
+                        const std::vector<uint64_t> coords{ z, y, x };
+                        CHECK(writer->write_chunk(coords, chunk, false) ==
+                              zarr::WriteResult::Ok);
+                    }
+                }
+            }
+
+            int append_size = -1;
+            for (auto i = 0; i < 100 && append_size != chunk_planes; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                append_size = read_append_size();
+            }
+            EXPECT_EQ(int, append_size, chunk_planes);
+
+            CHECK(finalize_array(std::move(writer)));
+        }
+
+        EXPECT_EQ(int, read_append_size(), array_planes);
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    // cleanup
+    if (fs::exists(base_dir)) {
+        fs::remove_all(base_dir);
+    }
+
+    return retval;
+}
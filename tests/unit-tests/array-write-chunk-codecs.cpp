@@ -0,0 +1,124 @@
+#include "array.hh"
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+const unsigned int array_width = 64, array_height = 64;
+
+const zarr::BloscCompressionParams array_params(
+  zarr::blosc_codec_to_string(ZarrCompressionCodec_BloscZstd),
+  1,
+  1);
+
+// a ramp, so that every codec below compresses it rather than storing it
+ByteVector
+make_chunk()
+{
+    std::vector<uint16_t> values(array_width * array_height);
+    std::iota(values.begin(), values.end(), uint16_t{ 0 });
+
+    ByteVector chunk(values.size() * sizeof(uint16_t));
+    memcpy(chunk.data(), values.data(), chunk.size());
+    return chunk;
+}
+
+zarr::WriteResult
+write_compressed(zarr::Array& writer,
+                 uint64_t z,
+                 const zarr::BloscCompressionParams& params,
+                 size_t type_size)
+{
+    auto chunk = make_chunk();
+    CHECK(zarr::compress_in_place(chunk, params, type_size));
+
+    const std::vector<uint64_t> coords{ z, 0, 0 };
+    return writer.write_chunk(coords, chunk, true);
+}
+} // namespace
+
+int
+main()
+{
+    Logger::set_log_level(LogLevel_Debug);
+
+    int retval = 1;
+
+    const ZarrDataType dtype = ZarrDataType_uint16;
+
+    try {
+        auto thread_pool = std::make_shared<zarr::ThreadPool>(
+          std::thread::hardware_concurrency(),
+          [](const std::string& err) { LOG_ERROR("Error: ", err.c_str()); });
+
+        std::vector<ZarrDimension> dims;
+        dims.emplace_back("z", ZarrDimensionType_Space, 0, 1, 1);
+        dims.emplace_back(
+          "y", ZarrDimensionType_Space, array_height, array_height, 1);
+        dims.emplace_back(
+          "x", ZarrDimensionType_Space, array_width, array_width, 1);
+
+        auto config = std::make_shared<zarr::ArrayConfig>(
+          base_dir.string(),
+          "",
+          std::nullopt,
+          array_params,
+          std::make_shared<ArrayDimensions>(std::move(dims), dtype),
+          dtype,
+          std::nullopt,
+          0);
+
+        auto writer = std::make_unique<zarr::Array>(
+          config,
+          thread_pool,
+          std::make_shared<zarr::FileHandlePool>(),
+          nullptr);
+
+        CHECK(write_compressed(*writer, 0, array_params, 2) ==
+              zarr::WriteResult::Ok);
+
+        // another compressor
+        const zarr::BloscCompressionParams lz4(
+          zarr::blosc_codec_to_string(ZarrCompressionCodec_BloscLZ4),
+          1,
+          1);
+        CHECK(write_compressed(*writer, 1, lz4, 2) ==
+              zarr::WriteResult::InvalidChunk);
+
+        // bit instead of byte shuffle
+        const zarr::BloscCompressionParams bitshuffle(
+          array_params.codec_id, 1, 2);
+        CHECK(write_compressed(*writer, 1, bitshuffle, 2) ==
+              zarr::WriteResult::InvalidChunk);
+
+        // shuffled by the wrong element size
+        CHECK(write_compressed(*writer, 1, array_params, 1) ==
+              zarr::WriteResult::InvalidChunk);
+
+        // a different compression level decodes the same
+        const zarr::BloscCompressionParams level(
+          array_params.codec_id, 5, 1);
+        CHECK(write_compressed(*writer, 1, level, 2) == zarr::WriteResult::Ok);
+
+        CHECK(finalize_array(std::move(writer)));
+
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    // cleanup
+    if (fs::exists(base_dir)) {
+        fs::remove_all(base_dir);
+    }
+
+    return retval;
+}
@@ -0,0 +1,139 @@
+#include "bandwidth.limiter.hh"
+#include "unit.test.macros.hh"
+
+#include <thread>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t rate = 1 << 20;      // 1 MiB/s
+constexpr uint64_t burst = 100 << 10;   // 100 KiB
+
+double
+seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void
+check_rate()
+{
+    zarr::TokenBucket bucket(rate, burst);
+
+    // the first burst is free, the rest comes at the sustained rate
+    const auto start = Clock::now();
+    bucket.acquire(burst + rate / 4, false);
+    const auto elapsed = seconds_since(start);
+    EXPECT(elapsed >= 0.24, "Expected to wait at least 0.24 s, got ", elapsed);
+    EXPECT(elapsed < 1.0, "Expected to wait less than 1 s, got ", elapsed);
+}
+
+void
+check_borrow()
+{
+    zarr::TokenBucket bucket(rate, burst);
+
+    // empty the bucket, then go a burst into debt without waiting
+    bucket.acquire(burst, false);
+    auto start = Clock::now();
+    bucket.acquire(burst, true);
+    auto elapsed = seconds_since(start);
+    EXPECT(elapsed < 0.05, "Expected not to wait, got ", elapsed);
+
+    // the debt is repaid before anyone else writes
+    start = Clock::now();
+    bucket.acquire(1, false);
+    elapsed = seconds_since(start);
+    EXPECT(elapsed >= 0.08, "Expected to wait at least 0.08 s, got ", elapsed);
+}
+
+void
+check_limiter()
+{
+    auto bucket = std::make_shared<zarr::TokenBucket>(rate, burst);
+    zarr::BandwidthLimiter limiter(bucket);
+
+    limiter.acquire(burst);
+    limiter.set_under_pressure(true);
+
+    const auto start = Clock::now();
+    limiter.acquire(burst);
+    const auto elapsed = seconds_since(start);
+    EXPECT(elapsed < 0.05, "Expected not to wait, got ", elapsed);
+}
+
+void
+check_concurrent_writers()
+{
+    zarr::TokenBucket bucket(rate, burst);
+
+    // four writers share the rate; together they wait for what they take
+    // beyond the first burst
+    const auto start = Clock::now();
+    std::vector<std::thread> writers;
+    for (auto i = 0; i < 4; ++i) {
+        writers.emplace_back([&bucket] { bucket.acquire(burst, false); });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    const auto elapsed = seconds_since(start);
+    EXPECT(elapsed >= 0.25, "Expected to wait at least 0.25 s, got ", elapsed);
+}
+
+void
+check_shared()
+{
+    auto a = zarr::TokenBucket::shared(rate, burst);
+    auto b = zarr::TokenBucket::shared(2 * rate, burst);
+    CHECK(a == b);
+    EXPECT_EQ(uint64_t, b->bytes_per_second(), rate);
+
+    // once no one holds it, the next caller creates a new one
+    a.reset();
+    b.reset();
+    auto c = zarr::TokenBucket::shared(2 * rate, burst);
+    EXPECT_EQ(uint64_t, c->bytes_per_second(), 2 * rate);
+}
+
+void
+check_invalid()
+{
+    bool threw = false;
+    try {
+        zarr::TokenBucket bucket(0, burst);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    threw = false;
+    try {
+        zarr::BandwidthLimiter limiter(nullptr);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_rate();
+        check_borrow();
+        check_limiter();
+        check_concurrent_writers();
+        check_shared();
+        check_invalid();
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    return retval;
+}
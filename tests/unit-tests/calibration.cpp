@@ -0,0 +1,136 @@
+#include "calibration.hh"
+#include "unit.test.macros.hh"
+
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+const size_t frame_bytes = 512 * 512 * 2;
+
+void
+check_compressed_and_raw()
+{
+    const std::vector<zarr::CalibrationArray> arrays = {
+        {
+          .data_type = ZarrDataType_uint16,
+          .frame_bytes = frame_bytes,
+          .compression_params = zarr::BloscCompressionParams(
+            zarr::blosc_codec_to_string(ZarrCompressionCodec_BloscLZ4), 1, 1),
+          .multiscale = false,
+        },
+        {
+          .data_type = ZarrDataType_uint16,
+          .frame_bytes = frame_bytes,
+          .multiscale = true,
+        },
+    };
+
+    const auto calibration =
+      zarr::calibrate(arrays,
+                      base_dir.string(),
+                      std::make_shared<zarr::FileHandlePool>(),
+                      4,
+                      0.0);
+
+    CHECK(calibration.calibrated);
+    EXPECT_EQ(int, calibration.threads, 4);
+    CHECK(calibration.compress_bytes_per_second > 0.0);
+    CHECK(calibration.write_bytes_per_second > 0.0);
+    CHECK(calibration.max_frame_rate_hz > 0.0);
+
+    // a thread each at least, and the whole pool between them
+    CHECK(calibration.compression_threads >= 1);
+    CHECK(calibration.io_threads >= 1);
+    EXPECT_EQ(int,
+              calibration.compression_threads + calibration.io_threads,
+              4);
+
+    // the rate can't beat the store, with 3 frames' worth of bytes per set
+    CHECK(calibration.max_frame_rate_hz <=
+          calibration.write_bytes_per_second / (3 * frame_bytes) * 1.0001);
+
+    // the scratch file is cleaned up
+    CHECK(fs::is_empty(base_dir));
+}
+
+void
+check_bandwidth_limit()
+{
+    const std::vector<zarr::CalibrationArray> arrays = {
+        {
+          .data_type = ZarrDataType_uint16,
+          .frame_bytes = frame_bytes,
+          .multiscale = false,
+        },
+    };
+
+    // a limit well under a measurement block neither slows calibration down
+    // nor is exceeded by the estimate
+    constexpr uint64_t limit = 1 << 20;
+    auto file_handle_pool = std::make_shared<zarr::FileHandlePool>();
+    file_handle_pool->set_bandwidth_limiter(
+      std::make_shared<zarr::BandwidthLimiter>(
+        std::make_shared<zarr::TokenBucket>(limit, limit / 10)));
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto calibration = zarr::calibrate(
+      arrays, base_dir.string(), file_handle_pool, 2, 0.0);
+    const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    EXPECT(elapsed.count() < 1.0,
+           "Expected calibration to take under 1 s, took ",
+           elapsed.count());
+    CHECK(calibration.write_bytes_per_second > 0.0);
+    CHECK(calibration.write_bytes_per_second <= limit);
+    CHECK(fs::is_empty(base_dir));
+}
+
+void
+check_raw_without_writes()
+{
+    const std::vector<zarr::CalibrationArray> arrays = {
+        {
+          .data_type = ZarrDataType_float32,
+          .frame_bytes = frame_bytes,
+          .multiscale = false,
+        },
+    };
+
+    // e.g., an S3 store: nothing is measured, so nothing limits the rate
+    const auto calibration = zarr::calibrate(
+      arrays, "", std::make_shared<zarr::FileHandlePool>(), 2, 10.0);
+
+    CHECK(calibration.calibrated);
+    EXPECT_EQ(double, calibration.compress_bytes_per_second, 0.0);
+    EXPECT_EQ(double, calibration.write_bytes_per_second, 0.0);
+    EXPECT_EQ(double, calibration.max_frame_rate_hz, 0.0);
+    EXPECT_EQ(int, calibration.compression_threads, 0);
+    EXPECT_EQ(int, calibration.io_threads, 2);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        fs::create_directories(base_dir);
+
+        check_compressed_and_raw();
+        check_bandwidth_limit();
+        check_raw_without_writes();
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    fs::remove_all(base_dir);
+
+    return retval;
+}
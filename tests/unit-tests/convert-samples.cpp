@@ -0,0 +1,143 @@
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+template<typename In, typename Out>
+std::vector<Out>
+convert(const std::vector<In>& in,
+        ZarrDataType in_type,
+        ZarrDataType out_type,
+        double scale,
+        double offset,
+        uint8_t right_shift = 0)
+{
+    const ZarrInputConversion conversion{
+        .data_type = in_type,
+        .scale = scale,
+        .offset = offset,
+        .right_shift = right_shift,
+    };
+
+    std::vector<Out> out(in.size());
+    zarr::convert_samples(reinterpret_cast<const uint8_t*>(in.data()),
+                          reinterpret_cast<uint8_t*>(out.data()),
+                          in.size(),
+                          out_type,
+                          conversion);
+    return out;
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        // shift a 12-bit range down to 8 bits
+        {
+            std::vector<uint16_t> in(1000);
+            for (auto i = 0; i < in.size(); ++i) {
+                in[i] = i * 4 % 4096;
+            }
+            const auto out = convert<uint16_t, uint8_t>(
+              in, ZarrDataType_uint16, ZarrDataType_uint8, 1.0, 0.0, 4);
+            for (auto i = 0; i < in.size(); ++i) {
+                EXPECT_EQ(int, out[i], in[i] >> 4);
+            }
+        }
+
+        // integer casts saturate
+        {
+            const std::vector<int32_t> in = { -70000, -1, 0, 300, 70000 };
+            const auto out = convert<int32_t, uint16_t>(
+              in, ZarrDataType_int32, ZarrDataType_uint16, 1.0, 0.0);
+            EXPECT_EQ(int, out[0], 0);
+            EXPECT_EQ(int, out[1], 0);
+            EXPECT_EQ(int, out[2], 0);
+            EXPECT_EQ(int, out[3], 300);
+            EXPECT_EQ(int, out[4], 65535);
+
+            const auto out8 = convert<int32_t, int8_t>(
+              in, ZarrDataType_int32, ZarrDataType_int8, 1.0, 0.0);
+            EXPECT_EQ(int, out8[0], -128);
+            EXPECT_EQ(int, out8[1], -1);
+            EXPECT_EQ(int, out8[3], 127);
+        }
+
+        // floating point rescaling rounds to nearest and saturates
+        {
+            const std::vector<float> in = {
+                -1.f, 0.f, 0.2f, 0.5f, 1.f, 2.f, std::numeric_limits<float>::quiet_NaN()
+            };
+            const auto out = convert<float, uint16_t>(
+              in, ZarrDataType_float32, ZarrDataType_uint16, 65535.0, 0.0);
+            EXPECT_EQ(int, out[0], 0);
+            EXPECT_EQ(int, out[1], 0);
+            EXPECT_EQ(int, out[2], 13107);
+            EXPECT_EQ(int, out[3], 32768); // 32767.5 rounds to even
+            EXPECT_EQ(int, out[4], 65535);
+            EXPECT_EQ(int, out[5], 65535);
+            EXPECT_EQ(int, out[6], 0);
+        }
+
+        // shift, scale, and offset together, into floating point
+        {
+            const std::vector<uint16_t> in = { 0, 16, 4095 };
+            const auto out = convert<uint16_t, float>(
+              in, ZarrDataType_uint16, ZarrDataType_float32, 0.5, -1.0, 4);
+            EXPECT_EQ(float, out[0], -1.f);
+            EXPECT_EQ(float, out[1], -0.5f);
+            EXPECT_EQ(float, out[2], 126.5f);
+        }
+
+        // 64-bit bounds don't overflow
+        {
+            const std::vector<double> in = { 1e30, -1e30 };
+            const auto out = convert<double, uint64_t>(
+              in, ZarrDataType_float64, ZarrDataType_uint64, 1.0, 0.0);
+            EXPECT_EQ(uint64_t, out[0], std::numeric_limits<uint64_t>::max());
+            EXPECT_EQ(uint64_t, out[1], 0);
+
+            const auto out_signed = convert<double, int64_t>(
+              in, ZarrDataType_float64, ZarrDataType_int64, 1.0, 0.0);
+            EXPECT_EQ(int64_t,
+                      out_signed[0],
+                      std::numeric_limits<int64_t>::max());
+            EXPECT_EQ(int64_t,
+                      out_signed[1],
+                      std::numeric_limits<int64_t>::min());
+        }
+
+        // packed pixels are unpacked before they're converted
+        {
+            // two Mono12p pixels, 0xabc and 0x123
+            const uint8_t packed[] = { 0xbc, 0x3a, 0x12 };
+            const ZarrInputConversion conversion{
+                .data_type = ZarrDataType_uint16,
+                .scale = 1.0,
+                .right_shift = 4,
+            };
+            uint8_t out[2];
+            zarr::decode_pixels(ZarrPixelFormat_Mono12p,
+                                conversion,
+                                ZarrDataType_uint8,
+                                packed,
+                                0,
+                                2,
+                                out);
+            EXPECT_EQ(int, out[0], 0xab);
+            EXPECT_EQ(int, out[1], 0x12);
+        }
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    return retval;
+}
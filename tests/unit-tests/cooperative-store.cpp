@@ -0,0 +1,249 @@
+#include "cooperative.store.hh"
+#include "unit.test.macros.hh"
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+ZarrCooperativeSettings
+make_settings(const char* writer_id, bool coordinator)
+{
+    return { .writer_id = writer_id,
+             .writer_count = 2,
+             .coordinator = coordinator,
+             .timeout_ms = 1000 };
+}
+
+nlohmann::json
+make_group(const nlohmann::json& ome)
+{
+    nlohmann::json group = {
+        { "zarr_format", 3 },
+        { "consolidated_metadata", nullptr },
+        { "node_type", "group" },
+        { "attributes", nlohmann::json::object() },
+    };
+    if (!ome.is_null()) {
+        group["attributes"]["ome"] = ome;
+    }
+    return group;
+}
+
+nlohmann::json
+make_plate(const nlohmann::json& wells, uint32_t max_fields)
+{
+    return {
+        { "version", "0.5" },
+        { "plate",
+          {
+            { "name", "plate" },
+            { "field_count", max_fields },
+            { "rows", { { { "name", "A" } }, { { "name", "B" } } } },
+            { "columns", { { { "name", "1" } } } },
+            { "wells", wells },
+            { "acquisitions",
+              { { { "id", 0 }, { "maximumfieldcount", max_fields } } } },
+          } },
+    };
+}
+
+nlohmann::json
+make_well(const nlohmann::json& images)
+{
+    return { { "version", "0.5" }, { "well", { { "images", images } } } };
+}
+
+void
+check_claims()
+{
+    const auto store = (base_dir / "claims.zarr").string();
+
+    auto settings = make_settings("a", true);
+    zarr::CooperativeStore a(store, settings);
+    settings = make_settings("b", false);
+    zarr::CooperativeStore b(store, settings);
+
+    std::string error;
+    CHECK(a.claim("plate/A/1/0", error));
+    CHECK(a.claim("plate/A/1/0", error)); // claims are idempotent
+    CHECK(b.claim("plate/B/1/0", error));
+
+    CHECK(!b.claim("plate/A/1/0", error));
+    CHECK(error.find("claimed by writer 'a'") != std::string::npos);
+
+    bool threw = false;
+    try {
+        settings = make_settings("../c", false);
+        zarr::CooperativeStore c(store, settings);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    a.clean_up();
+    CHECK(!fs::exists(fs::path(store) / ".writers"));
+}
+
+void
+check_merge_plate()
+{
+    const auto store = (base_dir / "merge.zarr").string();
+
+    auto settings = make_settings("a", true);
+    zarr::CooperativeStore a(store, settings);
+    settings = make_settings("b", false);
+    zarr::CooperativeStore b(store, settings);
+    CHECK(a.is_coordinator());
+    CHECK(!b.is_coordinator());
+
+    // a writes well A/1 with one field, b writes well B/1 with two, and a
+    // second field of A/1
+    zarr::CooperativeStore::GroupMetadata groups_a = {
+        { "", make_group(nullptr) },
+        { "plate",
+          make_group(make_plate(
+            { { { "path", "A/1" }, { "rowIndex", 0 }, { "columnIndex", 0 } } },
+            1)) },
+        { "plate/A/1", make_group(make_well({ { { "path", "0" } } })) },
+    };
+    zarr::CooperativeStore::ArrayMetadata arrays_a = {
+        { "plate/A/1/0", R"({"node_type": "array"})" },
+    };
+
+    const zarr::CooperativeStore::GroupMetadata groups_b = {
+        { "", make_group(nullptr) },
+        { "plate",
+          make_group(make_plate(
+            { { { "path", "A/1" }, { "rowIndex", 0 }, { "columnIndex", 0 } },
+              { { "path", "B/1" }, { "rowIndex", 1 }, { "columnIndex", 0 } } },
+            2)) },
+        { "plate/A/1", make_group(make_well({ { { "path", "1" } } })) },
+        { "plate/B/1",
+          make_group(make_well({ { { "path", "0" } }, { { "path", "1" } } })) },
+    };
+    const zarr::CooperativeStore::ArrayMetadata arrays_b = {
+        { "plate/A/1/1", R"({"node_type": "array"})" },
+        { "plate/B/1/0", R"({"node_type": "array"})" },
+        { "plate/B/1/1", R"({"node_type": "array"})" },
+    };
+
+    std::string error;
+    CHECK(b.publish(groups_b, arrays_b, error));
+    CHECK(a.merge(groups_a, arrays_a, error));
+
+    EXPECT_EQ(int, groups_a.size(), 4);
+    EXPECT_EQ(int, arrays_a.size(), 4);
+
+    const auto& plate = groups_a["plate"]["attributes"]["ome"]["plate"];
+    EXPECT_EQ(int, plate["wells"].size(), 2);
+    EXPECT_STR_EQ(plate["wells"][1]["path"].get<std::string>().c_str(),
+                  "B/1");
+    EXPECT_EQ(int, plate["field_count"].get<int>(), 2);
+    EXPECT_EQ(int, plate["acquisitions"].size(), 1);
+    EXPECT_EQ(
+      int, plate["acquisitions"][0]["maximumfieldcount"].get<int>(), 2);
+
+    const auto& images =
+      groups_a["plate/A/1"]["attributes"]["ome"]["well"]["images"];
+    EXPECT_EQ(int, images.size(), 2);
+    EXPECT_STR_EQ(images[1]["path"].get<std::string>().c_str(), "1");
+
+    a.clean_up();
+}
+
+void
+check_merge_conflicts()
+{
+    const auto store = (base_dir / "conflicts.zarr").string();
+
+    auto settings = make_settings("a", true);
+    zarr::CooperativeStore a(store, settings);
+    settings = make_settings("b", false);
+    zarr::CooperativeStore b(store, settings);
+
+    // the same array from both writers
+    zarr::CooperativeStore::GroupMetadata groups = {
+        { "", make_group(nullptr) },
+    };
+    zarr::CooperativeStore::ArrayMetadata arrays = {
+        { "labels", "{}" },
+    };
+
+    std::string error;
+    CHECK(b.publish(groups, arrays, error));
+    CHECK(!a.merge(groups, arrays, error));
+    CHECK(error.find("more than one writer") != std::string::npos);
+
+    // a group that's a plate in one writer and not in the other
+    zarr::CooperativeStore::GroupMetadata other_groups = {
+        { "", make_group(nullptr) },
+        { "plate", make_group(nullptr) },
+    };
+    CHECK(b.publish(other_groups, {}, error));
+
+    groups["plate"] = make_group(make_plate(nlohmann::json::array(), 1));
+    arrays.clear();
+    CHECK(!a.merge(groups, arrays, error));
+    CHECK(error.find("different type") != std::string::npos);
+
+    a.clean_up();
+}
+
+void
+check_timeout()
+{
+    const auto store = (base_dir / "timeout.zarr").string();
+
+    ZarrCooperativeSettings settings{ .writer_id = "a",
+                                      .writer_count = 3,
+                                      .coordinator = true,
+                                      .timeout_ms = 100 };
+    zarr::CooperativeStore a(store, settings);
+    settings.writer_id = "b";
+    settings.coordinator = false;
+    zarr::CooperativeStore b(store, settings);
+
+    zarr::CooperativeStore::GroupMetadata groups = {
+        { "", make_group(nullptr) },
+    };
+    zarr::CooperativeStore::ArrayMetadata arrays = { { "b", "{}" } };
+
+    std::string error;
+    CHECK(b.publish(groups, arrays, error));
+
+    // the third writer never shows up; what's there is merged anyway
+    arrays = { { "a", "{}" } };
+    const auto start = std::chrono::steady_clock::now();
+    CHECK(a.merge(groups, arrays, error));
+    CHECK(std::chrono::steady_clock::now() - start >=
+          std::chrono::milliseconds(100));
+    EXPECT_EQ(int, arrays.size(), 2);
+
+    a.clean_up();
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        fs::create_directories(base_dir);
+
+        check_claims();
+        check_merge_plate();
+        check_merge_conflicts();
+        check_timeout();
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    fs::remove_all(base_dir);
+
+    return retval;
+}
@@ -0,0 +1,280 @@
+#include "frame.metadata.array.hh"
+#include "unit.test.macros.hh"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+std::shared_ptr<zarr::ThreadPool>
+make_thread_pool()
+{
+    return std::make_shared<zarr::ThreadPool>(
+      std::thread::hardware_concurrency(),
+      [](const std::string& err) { LOG_ERROR("Error: ", err); });
+}
+
+nlohmann::json
+read_json(const fs::path& path)
+{
+    std::ifstream file(path);
+    CHECK(file.is_open());
+    return nlohmann::json::parse(file);
+}
+
+std::vector<uint8_t>
+read_file(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    CHECK(file.is_open());
+    return { std::istreambuf_iterator<char>(file), {} };
+}
+
+void
+append_records(zarr::FrameMetadataArray& array,
+               std::vector<double>& records,
+               size_t first,
+               size_t count)
+{
+    const auto* data = reinterpret_cast<const uint8_t*>(records.data());
+    const auto bytes_per_record = array.bytes_per_record();
+
+    std::string error;
+    CHECK(array.append(
+      { data + first * bytes_per_record, count * bytes_per_record }, error));
+}
+
+void
+check_2d()
+{
+    const auto node_key = "raw_frame_metadata";
+    const auto array_dir = base_dir / node_key;
+
+    zarr::FrameMetadataConfig config{
+        .store_root = base_dir.string(),
+        .node_key = node_key,
+        .dtype = ZarrDataType_float64,
+        .field_count = 3,
+        .records_per_chunk = 4,
+        .chunks_per_shard = 2,
+        .field_names = { "time", "x", "y" },
+    };
+
+    auto thread_pool = make_thread_pool();
+    zarr::FrameMetadataArray array(config,
+                                   thread_pool,
+                                   std::make_shared<zarr::FileHandlePool>(),
+                                   nullptr);
+    EXPECT_EQ(int, array.bytes_per_record(), 3 * sizeof(double));
+    CHECK(fs::is_regular_file(array_dir / "zarr.json"));
+
+    // 19 records fill two shards of 8, and start a third
+    std::vector<double> records(19 * 3);
+    for (auto i = 0; i < records.size(); ++i) {
+        records[i] = 0.5 * i;
+    }
+    append_records(array, records, 0, 5);
+    append_records(array, records, 5, 1);
+    append_records(array, records, 6, 13);
+    EXPECT_EQ(int, array.record_count(), 19);
+
+    // a partial record is refused
+    std::string error;
+    CHECK(!array.append(
+      { reinterpret_cast<const uint8_t*>(records.data()), 10 }, error));
+    EXPECT_EQ(int, array.record_count(), 19);
+
+    // full shards are written in the background
+    thread_pool->await_stop();
+    CHECK(fs::is_regular_file(array_dir / "c" / "0" / "0"));
+    CHECK(fs::is_regular_file(array_dir / "c" / "1" / "0"));
+    CHECK(!fs::exists(array_dir / "c" / "2"));
+    auto metadata = read_json(array_dir / "zarr.json");
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), 16);
+
+    std::string final_metadata;
+    CHECK(array.close(final_metadata, error));
+    CHECK(fs::is_regular_file(array_dir / "c" / "2" / "0"));
+
+    metadata = read_json(array_dir / "zarr.json");
+    CHECK(metadata == nlohmann::json::parse(final_metadata));
+    EXPECT_EQ(int, metadata["shape"].size(), 2);
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), 19);
+    EXPECT_EQ(int, metadata["shape"][1].get<int>(), 3);
+    EXPECT_EQ(int, metadata["chunk_grid"]["configuration"]["chunk_shape"][0]
+                     .get<int>(), 8);
+    EXPECT_STR_EQ(metadata["data_type"].get<std::string>().c_str(), "float64");
+    EXPECT_STR_EQ(
+      metadata["attributes"]["fields"][1].get<std::string>().c_str(), "x");
+
+    // the last shard holds one chunk of records 16-18, padded with zeros,
+    // and no second chunk
+    const auto shard = read_file(array_dir / "c" / "2" / "0");
+    const size_t chunk_bytes = 4 * 3 * sizeof(double);
+    const size_t index_bytes = 2 * 2 * sizeof(uint64_t) + sizeof(uint32_t);
+    EXPECT_EQ(int, shard.size(), chunk_bytes + index_bytes);
+
+    uint64_t table[4];
+    memcpy(table, shard.data() + chunk_bytes, sizeof(table));
+    EXPECT_EQ(uint64_t, table[0], 0);
+    EXPECT_EQ(uint64_t, table[1], chunk_bytes);
+    EXPECT_EQ(uint64_t, table[2], std::numeric_limits<uint64_t>::max());
+
+    std::vector<double> chunk(4 * 3);
+    memcpy(chunk.data(), shard.data(), chunk_bytes);
+    for (auto i = 0; i < 3 * 3; ++i) {
+        EXPECT_EQ(double, chunk[i], records[16 * 3 + i]);
+    }
+    for (auto i = 3 * 3; i < chunk.size(); ++i) {
+        EXPECT_EQ(double, chunk[i], 0.0);
+    }
+}
+
+void
+check_1d_compressed()
+{
+    const auto node_key = "labels_frame_metadata";
+    const auto array_dir = base_dir / node_key;
+
+    zarr::FrameMetadataConfig config{
+        .store_root = base_dir.string(),
+        .node_key = node_key,
+        .compression_params = zarr::BloscCompressionParams(
+          zarr::blosc_codec_to_string(ZarrCompressionCodec_BloscZstd), 1, 1),
+        .dtype = ZarrDataType_uint64,
+        .field_count = 1,
+        .records_per_chunk = 4,
+        .chunks_per_shard = 1,
+    };
+
+    auto thread_pool = make_thread_pool();
+    zarr::FrameMetadataArray array(config,
+                                   thread_pool,
+                                   std::make_shared<zarr::FileHandlePool>(),
+                                   nullptr);
+
+    std::vector<uint64_t> timestamps(10);
+    for (auto i = 0; i < timestamps.size(); ++i) {
+        timestamps[i] = 1000 * i;
+    }
+
+    std::string error;
+    CHECK(array.append({ reinterpret_cast<const uint8_t*>(timestamps.data()),
+                         timestamps.size() * sizeof(uint64_t) },
+                       error));
+
+    thread_pool->await_stop();
+    std::string metadata_str;
+    CHECK(array.close(metadata_str, error));
+
+    for (const auto* shard : { "0", "1", "2" }) {
+        CHECK(fs::is_regular_file(array_dir / "c" / shard));
+    }
+
+    const auto metadata = nlohmann::json::parse(metadata_str);
+    EXPECT_EQ(int, metadata["shape"].size(), 1);
+    EXPECT_EQ(int, metadata["shape"][0].get<int>(), 10);
+    EXPECT_STR_EQ(metadata["dimension_names"][0].get<std::string>().c_str(),
+                  "frame");
+    CHECK(!metadata["attributes"].contains("fields"));
+
+    const auto& codecs =
+      metadata["codecs"][0]["configuration"]["codecs"];
+    EXPECT_EQ(int, codecs.size(), 2);
+    EXPECT_STR_EQ(codecs[1]["name"].get<std::string>().c_str(), "blosc");
+    EXPECT_EQ(int, codecs[1]["configuration"]["typesize"].get<int>(), 8);
+}
+
+void
+check_failed_shard()
+{
+    const auto node_key = "failed_frame_metadata";
+    const auto array_dir = base_dir / node_key;
+
+    zarr::FrameMetadataConfig config{
+        .store_root = base_dir.string(),
+        .node_key = node_key,
+        .records_per_chunk = 4,
+        .chunks_per_shard = 1,
+    };
+
+    auto thread_pool = make_thread_pool();
+    zarr::FrameMetadataArray array(config,
+                                   thread_pool,
+                                   std::make_shared<zarr::FileHandlePool>(),
+                                   nullptr);
+
+    // shards can't be written under a file
+    std::ofstream(array_dir / "c").put('x');
+
+    std::vector<double> records(5, 1.0);
+    append_records(array, records, 0, 4);
+    thread_pool->await_stop();
+
+    // the failed background write is reported by the next call
+    std::string error;
+    CHECK(!array.append(
+      { reinterpret_cast<const uint8_t*>(records.data()), sizeof(double) },
+      error));
+    CHECK(!error.empty());
+
+    std::string metadata;
+    error.clear();
+    CHECK(!array.close(metadata, error));
+    CHECK(!error.empty());
+}
+
+void
+check_invalid()
+{
+    zarr::FrameMetadataConfig config{
+        .store_root = base_dir.string(),
+        .node_key = "invalid_frame_metadata",
+        .field_count = 2,
+        .records_per_chunk = 4,
+        .chunks_per_shard = 1,
+        .field_names = { "only one" },
+    };
+
+    bool threw = false;
+    try {
+        zarr::FrameMetadataArray array(config,
+                                       make_thread_pool(),
+                                       std::make_shared<zarr::FileHandlePool>(),
+                                       nullptr);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        fs::create_directories(base_dir);
+
+        check_2d();
+        check_1d_compressed();
+        check_failed_shard();
+        check_invalid();
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    fs::remove_all(base_dir);
+
+    return retval;
+}
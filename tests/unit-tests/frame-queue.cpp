@@ -1,6 +1,7 @@
 #include "unit.test.macros.hh"
 #include "frame.queue.hh"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iostream>
@@ -78,6 +79,40 @@ test_capacity()
     CHECK(queue.size() == capacity);
 }
 
+void
+test_clear()
+{
+    const size_t capacity = 4;
+    zarr::FrameQueue queue(capacity, 100);
+
+    for (size_t i = 0; i < 3; ++i) {
+        zarr::LockedBuffer frame(std::move(ByteVector(100, i)));
+        CHECK(queue.push(frame, std::to_string(i)));
+    }
+    CHECK(queue.front_ready());
+
+    queue.clear();
+    CHECK(queue.empty());
+    CHECK(!queue.front_ready());
+
+    // once the cleared slots are reused, only the new frames come out
+    zarr::LockedBuffer received_frame;
+    std::string received_key;
+    for (size_t i = 0; i < 2 * capacity; ++i) {
+        CHECK(!queue.pop(received_frame, received_key));
+
+        zarr::LockedBuffer frame(std::move(ByteVector(100, 10 + i)));
+        CHECK(queue.push(frame, std::to_string(10 + i)));
+        CHECK(queue.front_ready());
+
+        CHECK(queue.pop(received_frame, received_key));
+        CHECK(received_key == std::to_string(10 + i));
+        CHECK(received_frame.with_lock(
+          [i](auto& data) { return data[0] == 10 + i; }));
+    }
+    CHECK(queue.empty());
+}
+
 // Test producer-consumer pattern with threads
 void
 test_producer_consumer()
@@ -129,6 +164,62 @@ test_producer_consumer()
     CHECK(queue.empty());
 }
 
+// Test several producers pushing concurrently
+void
+test_multiple_producers()
+{
+    const size_t n_producers = 4;
+    const size_t n_frames = 500; // per producer
+    const size_t frame_size = 64;
+
+    zarr::FrameQueue queue(8, frame_size);
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < n_producers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (size_t i = 0; i < n_frames; ++i) {
+                zarr::LockedBuffer frame(
+                  std::move(ByteVector(frame_size, i % 256)));
+
+                while (!queue.push(frame, std::to_string(p), i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // each producer's frames arrive intact and in the order it pushed them
+    std::vector<size_t> frames_received(n_producers, 0);
+    size_t total_received = 0;
+    while (total_received < n_producers * n_frames) {
+        zarr::LockedBuffer frame;
+        std::string key;
+        std::optional<uint64_t> frame_id;
+        if (!queue.pop(frame, key, frame_id)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto p = std::stoul(key);
+        CHECK(p < n_producers);
+        CHECK(frame_id == frames_received[p]);
+        CHECK(frame.size() == frame_size);
+        CHECK(frame.with_lock([expected = *frame_id % 256](auto& data) {
+            return std::ranges::all_of(
+              data, [expected](uint8_t b) { return b == expected; });
+        }));
+
+        ++frames_received[p];
+        ++total_received;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    CHECK(queue.empty());
+}
+
 // Test high throughput
 void
 test_throughput()
@@ -176,7 +267,9 @@ main()
     try {
         test_basic_operations();
         test_capacity();
+        test_clear();
         test_producer_consumer();
+        test_multiple_producers();
         test_throughput();
         retval = 0;
     } catch (const std::exception& e) {
@@ -0,0 +1,231 @@
+#include "geometry.advisor.hh"
+#include "unit.test.macros.hh"
+
+#include <vector>
+
+namespace {
+constexpr size_t MiB = 1 << 20;
+
+std::vector<ZarrDimensionProperties>
+make_5d_dims()
+{
+    return {
+        { "t", ZarrDimensionType_Time, 0, 1, 1, nullptr, 1.0 },
+        { "c", ZarrDimensionType_Channel, 2, 1, 1, nullptr, 1.0 },
+        { "z", ZarrDimensionType_Space, 10, 1, 1, nullptr, 1.0 },
+        { "y", ZarrDimensionType_Space, 512, 1, 1, nullptr, 1.0 },
+        { "x", ZarrDimensionType_Space, 512, 1, 1, nullptr, 1.0 },
+    };
+}
+
+ZarrArraySettings
+make_settings(std::vector<ZarrDimensionProperties>& dims, ZarrDataType type)
+{
+    return {
+        .dimensions = dims.data(),
+        .dimension_count = dims.size(),
+        .data_type = type,
+    };
+}
+
+void
+check_chunks(const std::vector<ZarrDimensionProperties>& dims,
+             const std::vector<uint32_t>& expected)
+{
+    EXPECT_EQ(size_t, dims.size(), expected.size());
+    for (auto i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(int, dims[i].chunk_size_px, expected[i]);
+    }
+}
+
+void
+check_frames()
+{
+    auto dims = make_5d_dims();
+    auto settings = make_settings(dims, ZarrDataType_uint16);
+
+    ZarrGeometrySuggestion suggestion;
+    std::string error;
+    CHECK(zarr::suggest_geometry(settings,
+                                 256 * MiB,
+                                 64 * MiB,
+                                 ZarrReadPattern_Frames,
+                                 100.0,
+                                 suggestion,
+                                 error));
+
+    // whole frames, 8 deep to make up a 4 MiB chunk
+    check_chunks(dims, { 8, 1, 1, 512, 512 });
+    EXPECT_EQ(size_t, suggestion.chunk_bytes, 4 * MiB);
+
+    // 16 chunks per shard, as wide as the array allows: all 10 z planes
+    EXPECT_EQ(int, dims[2].shard_size_chunks, 10);
+    EXPECT_EQ(int, dims[3].shard_size_chunks, 1);
+    EXPECT_EQ(int, dims[4].shard_size_chunks, 1);
+    EXPECT_EQ(size_t, suggestion.shard_bytes, 40 * MiB);
+
+    // a flush every 8 timepoints of 2 channels and 10 planes, into 2 shards
+    EXPECT_EQ(uint64_t, suggestion.frames_per_flush, 160);
+    EXPECT_EQ(double, suggestion.seconds_per_flush, 1.6);
+    EXPECT_EQ(double, suggestion.files_per_hour, 4500.0);
+
+    EXPECT_EQ(size_t,
+              suggestion.memory_bytes,
+              zarr::estimate_array_memory_usage(settings));
+    EXPECT(suggestion.memory_bytes <= 256 * MiB,
+           "Expected at most 256 MiB, got ",
+           suggestion.memory_bytes);
+}
+
+void
+check_tiles()
+{
+    auto dims = make_5d_dims();
+    auto settings = make_settings(dims, ZarrDataType_uint16);
+
+    ZarrGeometrySuggestion suggestion;
+    std::string error;
+    CHECK(zarr::suggest_geometry(settings,
+                                 256 * MiB,
+                                 64 * MiB,
+                                 ZarrReadPattern_Tiles,
+                                 0.0,
+                                 suggestion,
+                                 error));
+
+    // small tiles through every plane, one channel at a time
+    check_chunks(dims, { 3, 1, 10, 256, 256 });
+    EXPECT(suggestion.shard_bytes <= 64 * MiB,
+           "Expected at most 64 MiB, got ",
+           suggestion.shard_bytes);
+
+    // no frame rate, no timing
+    EXPECT_EQ(double, suggestion.seconds_per_flush, 0.0);
+    EXPECT_EQ(double, suggestion.files_per_hour, 0.0);
+}
+
+void
+check_volumes()
+{
+    std::vector<ZarrDimensionProperties> dims = {
+        { "t", ZarrDimensionType_Time, 0, 1, 1, nullptr, 1.0 },
+        { "z", ZarrDimensionType_Space, 256, 1, 1, nullptr, 1.0 },
+        { "y", ZarrDimensionType_Space, 512, 1, 1, nullptr, 1.0 },
+        { "x", ZarrDimensionType_Space, 512, 1, 1, nullptr, 1.0 },
+    };
+    auto settings = make_settings(dims, ZarrDataType_uint8);
+
+    ZarrGeometrySuggestion suggestion;
+    std::string error;
+    CHECK(zarr::suggest_geometry(settings,
+                                 1024 * MiB,
+                                 256 * MiB,
+                                 ZarrReadPattern_Volumes,
+                                 0.0,
+                                 suggestion,
+                                 error));
+
+    // the largest power-of-two cube under 4 MiB
+    check_chunks(dims, { 1, 128, 128, 128 });
+}
+
+void
+check_memory_cap()
+{
+    auto dims = make_5d_dims();
+    auto settings = make_settings(dims, ZarrDataType_uint16);
+
+    ZarrGeometrySuggestion suggestion;
+    std::string error;
+    CHECK(zarr::suggest_geometry(settings,
+                                 32 * MiB,
+                                 64 * MiB,
+                                 ZarrReadPattern_Frames,
+                                 0.0,
+                                 suggestion,
+                                 error));
+
+    // a layer 8 deep would need 80 MiB, so stop at 3
+    check_chunks(dims, { 3, 1, 1, 512, 512 });
+    EXPECT(suggestion.memory_bytes <= 32 * MiB,
+           "Expected at most 32 MiB, got ",
+           suggestion.memory_bytes);
+}
+
+void
+check_2d()
+{
+    std::vector<ZarrDimensionProperties> dims = {
+        { "y", ZarrDimensionType_Space, 1080, 1, 1, nullptr, 1.0 },
+        { "x", ZarrDimensionType_Space, 1920, 1, 1, nullptr, 1.0 },
+    };
+    auto settings = make_settings(dims, ZarrDataType_uint8);
+
+    ZarrGeometrySuggestion suggestion;
+    std::string error;
+    CHECK(zarr::suggest_geometry(settings,
+                                 256 * MiB,
+                                 64 * MiB,
+                                 ZarrReadPattern_Frames,
+                                 0.0,
+                                 suggestion,
+                                 error));
+
+    check_chunks(dims, { 1080, 1920 });
+    EXPECT_EQ(int, dims[0].shard_size_chunks, 1);
+    EXPECT_EQ(int, dims[1].shard_size_chunks, 1);
+    EXPECT_EQ(uint64_t, suggestion.frames_per_flush, 1);
+}
+
+void
+check_invalid()
+{
+    ZarrGeometrySuggestion suggestion;
+    std::string error;
+
+    // only the append dimension may be unbounded
+    auto dims = make_5d_dims();
+    dims[2].array_size_px = 0;
+    auto settings = make_settings(dims, ZarrDataType_uint16);
+    EXPECT(!zarr::suggest_geometry(settings,
+                                   256 * MiB,
+                                   64 * MiB,
+                                   ZarrReadPattern_Frames,
+                                   0.0,
+                                   suggestion,
+                                   error),
+           "Expected an unbounded inner dimension to be rejected");
+
+    dims = make_5d_dims();
+    dims[3].type = ZarrDimensionType_Channel;
+    settings = make_settings(dims, ZarrDataType_uint16);
+    EXPECT(!zarr::suggest_geometry(settings,
+                                   256 * MiB,
+                                   64 * MiB,
+                                   ZarrReadPattern_Frames,
+                                   0.0,
+                                   suggestion,
+                                   error),
+           "Expected a non-spatial frame dimension to be rejected");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_frames();
+        check_tiles();
+        check_volumes();
+        check_memory_cap();
+        check_2d();
+        check_invalid();
+        retval = 0;
+    } catch (const std::exception& exc) {
+        LOG_ERROR("Exception: ", exc.what());
+    }
+
+    return retval;
+}
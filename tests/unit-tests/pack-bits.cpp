@@ -0,0 +1,81 @@
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+template<typename T>
+void
+check_roundtrip(ZarrDataType type, uint8_t bits, std::mt19937& rng)
+{
+    std::uniform_int_distribution<uint64_t> dist(0, (uint64_t{ 1 } << bits) - 1);
+
+    // odd lengths, so the stream ends partway through a byte
+    for (size_t n : { 1, 7, 31, 1000 }) {
+        std::vector<T> values(n);
+        for (auto& value : values) {
+            value = static_cast<T>(dist(rng));
+        }
+
+        ByteVector data(n * sizeof(T));
+        memcpy(data.data(), values.data(), data.size());
+
+        zarr::pack_bits(data, type, bits);
+        EXPECT_EQ(size_t, data.size(), (n * bits + 7) / 8);
+
+        // element i occupies stream bits [i * bits, (i + 1) * bits)
+        for (auto i = 0; i < n; ++i) {
+            for (auto b = 0; b < bits; ++b) {
+                const auto bit = i * bits + b;
+                const auto expected = (values[i] >> b) & 1;
+                EXPECT_EQ(int, (data[bit / 8] >> (bit % 8)) & 1, expected);
+            }
+        }
+
+        CHECK(zarr::unpack_bits(data, type, bits, n));
+        EXPECT_EQ(size_t, data.size(), n * sizeof(T));
+        CHECK(memcmp(data.data(), values.data(), data.size()) == 0);
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        std::mt19937 rng(86);
+        for (uint8_t bits = 1; bits < 8; ++bits) {
+            check_roundtrip<uint8_t>(ZarrDataType_uint8, bits, rng);
+        }
+        for (uint8_t bits : { 1, 9, 10, 12, 14, 15 }) {
+            check_roundtrip<uint16_t>(ZarrDataType_uint16, bits, rng);
+        }
+        for (uint8_t bits : { 17, 24, 31 }) {
+            check_roundtrip<uint32_t>(ZarrDataType_uint32, bits, rng);
+        }
+
+        // high bits beyond the significant ones are dropped
+        ByteVector data(4);
+        const uint16_t values[] = { 0xf123, 0x0fff };
+        memcpy(data.data(), values, sizeof(values));
+        zarr::pack_bits(data, ZarrDataType_uint16, 12);
+        CHECK(zarr::unpack_bits(data, ZarrDataType_uint16, 12, 2));
+        uint16_t unpacked[2];
+        memcpy(unpacked, data.data(), sizeof(unpacked));
+        EXPECT_EQ(int, unpacked[0], 0x0123);
+        EXPECT_EQ(int, unpacked[1], 0x0fff);
+
+        // the packed size must match the element count
+        CHECK(!zarr::unpack_bits(data, ZarrDataType_uint16, 12, 3));
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    return retval;
+}
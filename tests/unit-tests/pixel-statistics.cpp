@@ -0,0 +1,146 @@
+#include "unit.test.macros.hh"
+#include "statistics.hh"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+template<typename T>
+ZarrArrayStatistics
+statistics_of(ZarrDataType type,
+              uint8_t significant_bits,
+              const std::vector<T>& pixels)
+{
+    zarr::PixelStatistics statistics(type, significant_bits);
+    statistics.add(reinterpret_cast<const uint8_t*>(pixels.data()),
+                   pixels.size());
+
+    ZarrArrayStatistics stats;
+    statistics.to_zarr(stats);
+    return stats;
+}
+
+void
+check_uint8()
+{
+    std::vector<uint8_t> pixels(1000);
+    for (auto i = 0; i < pixels.size(); ++i) {
+        pixels[i] = i % 251;
+    }
+
+    const auto stats = statistics_of(ZarrDataType_uint8, 0, pixels);
+    EXPECT_EQ(int, stats.count, pixels.size());
+    EXPECT_EQ(double, stats.min, 0.0);
+    EXPECT_EQ(double, stats.max, 250.0);
+
+    double sum = 0;
+    for (auto px : pixels) {
+        sum += px;
+    }
+    EXPECT_EQ(double, stats.sum, sum);
+
+    // one bin per value
+    EXPECT_EQ(int, stats.histogram_bins, 256);
+    EXPECT_EQ(double, stats.histogram_min, 0.0);
+    EXPECT_EQ(double, stats.histogram_max, 256.0);
+    for (auto v = 0; v < 256; ++v) {
+        uint64_t expected = 0;
+        for (auto px : pixels) {
+            expected += px == v;
+        }
+        EXPECT_EQ(int, stats.histogram[v], expected);
+    }
+}
+
+void
+check_significant_bits()
+{
+    // 12 significant bits in 16: 256 bins of 16 values each
+    std::vector<uint16_t> pixels = { 0, 15, 16, 4095, 4000, 65535 };
+    const auto stats = statistics_of(ZarrDataType_uint16, 12, pixels);
+
+    EXPECT_EQ(int, stats.histogram_bins, 256);
+    EXPECT_EQ(double, stats.histogram_max, 4096.0);
+    EXPECT_EQ(int, stats.histogram[0], 2);
+    EXPECT_EQ(int, stats.histogram[1], 1);
+    EXPECT_EQ(int, stats.histogram[250], 1);
+
+    // out of range values land in the last bin
+    EXPECT_EQ(int, stats.histogram[255], 2);
+    EXPECT_EQ(double, stats.max, 65535.0);
+}
+
+void
+check_signed_and_merge()
+{
+    zarr::PixelStatistics a(ZarrDataType_int16, 0);
+    zarr::PixelStatistics b(ZarrDataType_int16, 0);
+
+    const std::vector<int16_t> lo = { -32768, -1 };
+    const std::vector<int16_t> hi = { 0, 32767, 255 };
+    a.add(reinterpret_cast<const uint8_t*>(lo.data()), lo.size());
+    b.add(reinterpret_cast<const uint8_t*>(hi.data()), hi.size());
+    a.merge(b);
+
+    ZarrArrayStatistics stats;
+    a.to_zarr(stats);
+    EXPECT_EQ(int, stats.count, 5);
+    EXPECT_EQ(double, stats.min, -32768.0);
+    EXPECT_EQ(double, stats.max, 32767.0);
+    EXPECT_EQ(double, stats.sum, -32768.0 - 1 + 32767 + 255);
+
+    // offset binary: bins of 256 values starting at the most negative value
+    EXPECT_EQ(double, stats.histogram_min, -32768.0);
+    EXPECT_EQ(double, stats.histogram_max, 32768.0);
+    EXPECT_EQ(int, stats.histogram[0], 1);
+    EXPECT_EQ(int, stats.histogram[127], 1);
+    EXPECT_EQ(int, stats.histogram[128], 2);
+    EXPECT_EQ(int, stats.histogram[255], 1);
+
+    // statistics of different types can't be merged
+    zarr::PixelStatistics c(ZarrDataType_uint16, 0);
+    bool threw = false;
+    try {
+        a.merge(c);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void
+check_float()
+{
+    const std::vector<float> pixels = { -1.5f, 2.25f, 0.5f };
+    const auto stats = statistics_of(ZarrDataType_float32, 0, pixels);
+    EXPECT_EQ(int, stats.count, 3);
+    EXPECT_EQ(double, stats.min, -1.5);
+    EXPECT_EQ(double, stats.max, 2.25);
+    EXPECT_EQ(double, stats.sum, 1.25);
+    EXPECT_EQ(int, stats.histogram_bins, 0);
+
+    const auto json =
+      zarr::PixelStatistics(ZarrDataType_float32, 0).to_json();
+    CHECK(json["min"].is_null());
+    CHECK(!json.contains("histogram"));
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_uint8();
+        check_significant_bits();
+        check_signed_and_merge();
+        check_float();
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    return retval;
+}
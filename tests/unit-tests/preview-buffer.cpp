@@ -0,0 +1,102 @@
+#include "preview.buffer.hh"
+#include "unit.test.macros.hh"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+const size_t frame_bytes = 4096;
+
+ByteVector
+make_frame(uint64_t frame_id)
+{
+    return ByteVector(frame_bytes, static_cast<uint8_t>(frame_id % 251));
+}
+
+void
+check_latest_frame()
+{
+    zarr::PreviewBuffer buffer(frame_bytes);
+    EXPECT_EQ(size_t, buffer.frame_bytes(), frame_bytes);
+
+    ByteVector frame(frame_bytes);
+    CHECK(!buffer.read(frame));
+
+    // unread frames are replaced, not queued
+    for (uint64_t i = 0; i < 5; ++i) {
+        buffer.publish(make_frame(i), i);
+    }
+
+    auto frame_id = buffer.read(frame);
+    CHECK(frame_id);
+    EXPECT_EQ(int, *frame_id, 4);
+    CHECK(frame == make_frame(4));
+
+    // reading again returns the same frame
+    std::ranges::fill(frame, 0);
+    frame_id = buffer.read(frame);
+    CHECK(frame_id);
+    EXPECT_EQ(int, *frame_id, 4);
+    CHECK(frame == make_frame(4));
+
+    // an empty buffer only queries the index
+    buffer.publish(make_frame(5), 5);
+    frame_id = buffer.read({});
+    CHECK(frame_id);
+    EXPECT_EQ(int, *frame_id, 5);
+}
+
+void
+check_concurrent_reads()
+{
+    zarr::PreviewBuffer buffer(frame_bytes);
+    const uint64_t n_frames = 20000;
+
+    std::thread writer([&buffer] {
+        for (uint64_t i = 0; i < n_frames; ++i) {
+            buffer.publish(make_frame(i), i);
+        }
+    });
+
+    // every frame read is whole, and frames never go back in time
+    ByteVector frame(frame_bytes);
+    uint64_t last_id = 0;
+    while (last_id + 1 < n_frames) {
+        const auto frame_id = buffer.read(frame);
+        if (!frame_id) {
+            continue;
+        }
+
+        EXPECT(*frame_id >= last_id,
+               "Frame ",
+               *frame_id,
+               " read after frame ",
+               last_id);
+        const auto expected = static_cast<uint8_t>(*frame_id % 251);
+        EXPECT(std::ranges::all_of(
+                 frame, [expected](auto b) { return b == expected; }),
+               "Torn read of frame ",
+               *frame_id);
+        last_id = *frame_id;
+    }
+
+    writer.join();
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_latest_frame();
+        check_concurrent_reads();
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    return retval;
+}
@@ -0,0 +1,202 @@
+#include "projector.hh"
+#include "unit.test.macros.hh"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+const uint32_t n_channels = 2, n_planes = 3, width = 4, height = 2;
+const size_t px_per_frame = width * height;
+
+// t, c, z, y, x
+std::shared_ptr<zarr::ArrayConfig>
+make_config(ZarrDataType type,
+            ZarrProjectionMethod method,
+            const std::string& dimension)
+{
+    auto dims = std::make_shared<ArrayDimensions>(
+      std::vector<ZarrDimension>{
+        { "t", ZarrDimensionType_Time, 0, 1, 1 },
+        { "c", ZarrDimensionType_Channel, n_channels, 1, 1 },
+        { "z", ZarrDimensionType_Space, n_planes, 1, 1 },
+        { "y", ZarrDimensionType_Space, height, height, 1 },
+        { "x", ZarrDimensionType_Space, width, width, 1 } },
+      type);
+
+    auto config = std::make_shared<zarr::ArrayConfig>(
+      "", "raw", std::nullopt, std::nullopt, dims, type, std::nullopt, 0);
+    config->projection_method = method;
+    config->projection_dimension = dimension;
+    config->projection_key = "raw_projection";
+
+    return config;
+}
+
+uint16_t
+pixel_value(uint64_t frame_id, size_t px)
+{
+    return (frame_id * 7 + px * 13) % 50;
+}
+
+ByteVector
+make_frame(uint64_t frame_id)
+{
+    std::vector<uint16_t> pixels(px_per_frame);
+    for (auto i = 0; i < px_per_frame; ++i) {
+        pixels[i] = pixel_value(frame_id, i);
+    }
+
+    ByteVector frame(px_per_frame * sizeof(uint16_t));
+    memcpy(frame.data(), pixels.data(), frame.size());
+    return frame;
+}
+
+std::vector<uint16_t>
+take(zarr::Projector& projector)
+{
+    zarr::LockedBuffer frame;
+    CHECK(projector.take_frame(frame));
+
+    std::vector<uint16_t> pixels(px_per_frame);
+    frame.with_lock([&](const auto& data) {
+        EXPECT_EQ(size_t, data.size(), px_per_frame * sizeof(uint16_t));
+        memcpy(pixels.data(), data.data(), data.size());
+    });
+    return pixels;
+}
+
+void
+check_max_along_z()
+{
+    auto config =
+      make_config(ZarrDataType_uint16, ZarrProjectionMethod_Max, "z");
+    zarr::Projector projector(config);
+
+    // t, c, y, x
+    const auto& dims = projector.writer_configuration()->dimensions;
+    EXPECT_EQ(int, dims->ndims(), 4);
+    EXPECT_STR_EQ(dims->at(1).name.c_str(), "c");
+    EXPECT_STR_EQ(projector.writer_configuration()->node_key.c_str(),
+                  "raw_projection");
+
+    const auto frames_per_timepoint = n_channels * n_planes;
+    for (uint64_t f = 0; f < 2 * frames_per_timepoint; ++f) {
+        const auto frame = make_frame(f);
+        projector.add_frame(frame, f);
+
+        // a projection is complete once z wraps
+        zarr::LockedBuffer projected;
+        if ((f + 1) % n_planes != 0) {
+            CHECK(!projector.take_frame(projected));
+            continue;
+        }
+
+        const auto pixels = take(projector);
+        for (auto i = 0; i < px_per_frame; ++i) {
+            uint16_t expected = 0;
+            for (auto z = f + 1 - n_planes; z <= f; ++z) {
+                expected = std::max(expected, pixel_value(z, i));
+            }
+            EXPECT_EQ(int, pixels[i], expected);
+        }
+        CHECK(!projector.take_frame(projected));
+    }
+}
+
+void
+check_mean_along_t()
+{
+    auto config =
+      make_config(ZarrDataType_uint16, ZarrProjectionMethod_Mean, "t");
+    zarr::Projector projector(config);
+
+    // c, z, y, x, the channel dimension now bounding the array
+    const auto& dims = projector.writer_configuration()->dimensions;
+    EXPECT_EQ(int, dims->ndims(), 4);
+    EXPECT_EQ(int, dims->at(0).array_size_px, n_channels);
+
+    const auto frames_per_timepoint = n_channels * n_planes;
+    const uint64_t n_timepoints = 3;
+    for (uint64_t f = 0; f < n_timepoints * frames_per_timepoint; ++f) {
+        projector.add_frame(make_frame(f), f);
+    }
+
+    // the append dimension never wraps
+    zarr::LockedBuffer projected;
+    CHECK(!projector.take_frame(projected));
+
+    projector.finish();
+    for (uint64_t k = 0; k < frames_per_timepoint; ++k) {
+        const auto pixels = take(projector);
+        for (auto i = 0; i < px_per_frame; ++i) {
+            double sum = 0;
+            for (uint64_t t = 0; t < n_timepoints; ++t) {
+                sum += pixel_value(t * frames_per_timepoint + k, i);
+            }
+            EXPECT_EQ(int, pixels[i], static_cast<int>(sum / n_timepoints + 0.5));
+        }
+    }
+    CHECK(!projector.take_frame(projected));
+}
+
+void
+check_partial_on_finish()
+{
+    auto config =
+      make_config(ZarrDataType_uint16, ZarrProjectionMethod_Max, "c");
+    zarr::Projector projector(config);
+
+    // the first channel of the first timepoint only, out of order
+    for (auto z : { 2, 0, 1 }) {
+        projector.add_frame(make_frame(z), z);
+    }
+
+    zarr::LockedBuffer projected;
+    CHECK(!projector.take_frame(projected));
+
+    projector.finish();
+    for (uint64_t z = 0; z < n_planes; ++z) {
+        const auto pixels = take(projector);
+        for (auto i = 0; i < px_per_frame; ++i) {
+            EXPECT_EQ(int, pixels[i], pixel_value(z, i));
+        }
+    }
+    CHECK(!projector.take_frame(projected));
+}
+
+void
+check_invalid_dimension()
+{
+    for (const auto* name : { "y", "x", "w" }) {
+        auto config =
+          make_config(ZarrDataType_uint16, ZarrProjectionMethod_Max, name);
+        bool threw = false;
+        try {
+            zarr::Projector projector(config);
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        EXPECT(threw, "Expected projection along '", name, "' to fail");
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_max_along_z();
+        check_mean_along_t();
+        check_partial_on_finish();
+        check_invalid_dimension();
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    return retval;
+}
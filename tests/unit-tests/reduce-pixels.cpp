@@ -0,0 +1,160 @@
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+const uint32_t frame_width = 11, frame_height = 9;
+
+template<typename T>
+std::vector<T>
+make_frame()
+{
+    std::vector<T> frame(frame_width * frame_height);
+    for (auto y = 0; y < frame_height; ++y) {
+        for (auto x = 0; x < frame_width; ++x) {
+            frame[y * frame_width + x] = static_cast<T>(y * 20 + x);
+        }
+    }
+
+    return frame;
+}
+
+template<typename T>
+std::vector<T>
+reduce(const std::vector<T>& frame,
+       ZarrDataType type,
+       const ZarrFrameReduction& reduction,
+       size_t row,
+       size_t first_col,
+       size_t n_px)
+{
+    std::vector<T> out(n_px);
+    zarr::reduce_pixels(reduction,
+                        ZarrPixelFormat_Native,
+                        std::nullopt,
+                        type,
+                        reinterpret_cast<const uint8_t*>(frame.data()),
+                        row,
+                        first_col,
+                        n_px,
+                        reinterpret_cast<uint8_t*>(out.data()));
+    return out;
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        // cropping alone
+        {
+            const auto frame = make_frame<uint16_t>();
+            const ZarrFrameReduction crop{
+                .frame_width = frame_width,
+                .frame_height = frame_height,
+                .roi_x = 3,
+                .roi_y = 2,
+                .binning = 1,
+            };
+            const auto out = reduce(frame, ZarrDataType_uint16, crop, 1, 2, 4);
+            for (auto i = 0; i < out.size(); ++i) {
+                EXPECT_EQ(int, out[i], (2 + 1) * 20 + 3 + 2 + i);
+            }
+        }
+
+        // 3x3 mean, rounded to nearest
+        {
+            const auto frame = make_frame<uint8_t>();
+            const ZarrFrameReduction bin{
+                .frame_width = frame_width,
+                .frame_height = frame_height,
+                .roi_x = 1,
+                .roi_y = 0,
+                .binning = 3,
+                .binning_method = ZarrBinningMethod_Mean,
+            };
+            const auto out = reduce(frame, ZarrDataType_uint8, bin, 2, 0, 3);
+            for (auto i = 0; i < out.size(); ++i) {
+                // rows 6-8, columns 1 + 3i to 3 + 3i
+                EXPECT_EQ(int, out[i], 7 * 20 + 1 + 3 * i + 1);
+            }
+        }
+
+        // 2x2 sum saturates
+        {
+            const auto frame = make_frame<uint8_t>();
+            const ZarrFrameReduction bin{
+                .frame_width = frame_width,
+                .frame_height = frame_height,
+                .binning = 2,
+                .binning_method = ZarrBinningMethod_Sum,
+            };
+            const auto out = reduce(frame, ZarrDataType_uint8, bin, 0, 0, 5);
+            EXPECT_EQ(int, out[0], 0 + 1 + 20 + 21);
+            EXPECT_EQ(int, out[4], 8 + 9 + 28 + 29);
+
+            const auto saturated =
+              reduce(frame, ZarrDataType_uint8, bin, 3, 0, 1);
+            EXPECT_EQ(int, saturated[0], 255);
+        }
+
+        // float mean, over runs longer than the kernel's block size
+        {
+            const uint32_t width = 1200;
+            std::vector<float> frame(2 * width);
+            for (auto x = 0; x < width; ++x) {
+                frame[x] = x;
+                frame[width + x] = x + 1;
+            }
+            const ZarrFrameReduction bin{
+                .frame_width = width,
+                .frame_height = 2,
+                .binning = 2,
+                .binning_method = ZarrBinningMethod_Mean,
+            };
+            const auto out =
+              reduce(frame, ZarrDataType_float32, bin, 0, 0, width / 2);
+            for (auto i = 0; i < out.size(); ++i) {
+                EXPECT_EQ(float, out[i], 2.f * i + 1.f);
+            }
+        }
+
+        // whole frames
+        {
+            const auto frame = make_frame<int16_t>();
+            const ZarrFrameReduction bin{
+                .frame_width = frame_width,
+                .frame_height = frame_height,
+                .roi_x = 1,
+                .roi_y = 1,
+                .binning = 2,
+                .binning_method = ZarrBinningMethod_Sum,
+            };
+            std::vector<int16_t> out(4 * 5);
+            zarr::decode_frame(ZarrPixelFormat_Native,
+                               std::nullopt,
+                               bin,
+                               ZarrDataType_int16,
+                               4,
+                               5,
+                               reinterpret_cast<const uint8_t*>(frame.data()),
+                               reinterpret_cast<uint8_t*>(out.data()));
+            for (auto y = 0; y < 4; ++y) {
+                for (auto x = 0; x < 5; ++x) {
+                    const auto top = (1 + 2 * y) * 20 + 1 + 2 * x;
+                    EXPECT_EQ(int, out[y * 5 + x], 2 * top + 1 + 2 * (top + 20) + 1);
+                }
+            }
+        }
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    return retval;
+}
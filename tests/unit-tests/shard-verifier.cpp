@@ -0,0 +1,167 @@
+#include "shard.verifier.hh"
+#include "zarr.common.hh"
+#include "unit.test.macros.hh"
+
+#include <crc32c/crc32c.h>
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+const fs::path shard_path = base_dir / "0";
+
+// four chunks of 8 bytes each, chunk 2 never written
+constexpr uint64_t chunks_per_shard = 4;
+constexpr uint64_t bytes_per_chunk = 8;
+
+void
+write_shard()
+{
+    constexpr auto missing = std::numeric_limits<uint64_t>::max();
+    std::vector<uint64_t> table(2 * chunks_per_shard, missing);
+
+    ByteVector shard;
+    for (auto i = 0; i < chunks_per_shard; ++i) {
+        if (i == 2) {
+            continue;
+        }
+
+        ByteVector chunk(bytes_per_chunk);
+        for (auto j = 0; j < chunk.size(); ++j) {
+            chunk[j] = static_cast<uint8_t>(i * bytes_per_chunk + j);
+        }
+        zarr::append_crc32c(chunk);
+
+        table[2 * i] = shard.size();
+        table[2 * i + 1] = chunk.size();
+        shard.insert(shard.end(), chunk.begin(), chunk.end());
+    }
+
+    const auto* table_bytes = reinterpret_cast<const uint8_t*>(table.data());
+    const auto table_size = table.size() * sizeof(uint64_t);
+    shard.insert(shard.end(), table_bytes, table_bytes + table_size);
+
+    const uint32_t checksum = crc32c::Crc32c(table_bytes, table_size);
+    const auto* checksum_bytes = reinterpret_cast<const uint8_t*>(&checksum);
+    shard.insert(
+      shard.end(), checksum_bytes, checksum_bytes + sizeof(checksum));
+
+    fs::create_directories(base_dir);
+    std::ofstream(shard_path, std::ios::binary)
+      .write(reinterpret_cast<const char*>(shard.data()), shard.size());
+}
+
+void
+flip_byte(size_t offset)
+{
+    std::fstream file(shard_path,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    char byte;
+    file.seekg(offset);
+    file.get(byte);
+    file.seekp(offset);
+    file.put(static_cast<char>(~byte));
+}
+
+void
+check_crc32c_round_trip()
+{
+    ByteVector data(16, 0x5a);
+    zarr::append_crc32c(data);
+    EXPECT_EQ(size_t, data.size(), 20);
+
+    ByteVector copy = data;
+    EXPECT(zarr::strip_crc32c(copy), "Expected the checksum to match");
+    EXPECT_EQ(size_t, copy.size(), 16);
+
+    data[3] = 0;
+    EXPECT(!zarr::strip_crc32c(data), "Expected a checksum mismatch");
+
+    ByteVector too_short(3);
+    EXPECT(!zarr::strip_crc32c(too_short), "Expected a too-short buffer");
+}
+
+void
+check_verify()
+{
+    std::string error;
+
+    write_shard();
+    CHECK(zarr::ShardVerifier::verify(
+      shard_path.string(), chunks_per_shard, true, error));
+
+    // corrupt the first byte of chunk 1
+    flip_byte(bytes_per_chunk + sizeof(uint32_t));
+    EXPECT(!zarr::ShardVerifier::verify(
+             shard_path.string(), chunks_per_shard, true, error),
+           "Expected a corrupted chunk to fail verification");
+    EXPECT(error.find("chunk 1") != std::string::npos,
+           "Unexpected error: ",
+           error);
+
+    // without chunk checksums only the index is checked
+    CHECK(zarr::ShardVerifier::verify(
+      shard_path.string(), chunks_per_shard, false, error));
+
+    // corrupt the index checksum
+    write_shard();
+    flip_byte(fs::file_size(shard_path) - 1);
+    EXPECT(!zarr::ShardVerifier::verify(
+             shard_path.string(), chunks_per_shard, false, error),
+           "Expected a corrupted index to fail verification");
+
+    EXPECT(!zarr::ShardVerifier::verify(
+             (base_dir / "absent").string(), chunks_per_shard, false, error),
+           "Expected a missing shard to fail verification");
+}
+
+void
+check_background_verification()
+{
+    write_shard();
+
+    std::vector<std::string> errors;
+    zarr::ShardVerifier verifier(
+      [&errors](const std::string& err) { errors.push_back(err); });
+
+    verifier.enqueue("file://" + shard_path.string(), chunks_per_shard, true);
+    verifier.enqueue((base_dir / "absent").string(), chunks_per_shard, true);
+    verifier.finish();
+
+    size_t n_failed;
+    EXPECT_EQ(size_t, verifier.shards_verified(n_failed), 2);
+    EXPECT_EQ(size_t, n_failed, 1);
+    EXPECT_EQ(size_t, errors.size(), 1);
+
+    // shards queued after finishing are ignored
+    verifier.enqueue(shard_path.string(), chunks_per_shard, true);
+    EXPECT_EQ(size_t, verifier.shards_verified(n_failed), 2);
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_crc32c_round_trip();
+        check_verify();
+        check_background_verification();
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    if (fs::exists(base_dir)) {
+        fs::remove_all(base_dir);
+    }
+
+    return retval;
+}
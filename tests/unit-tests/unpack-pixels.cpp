@@ -0,0 +1,99 @@
+#include "unit.test.macros.hh"
+#include "zarr.common.hh"
+
+#include <random>
+#include <vector>
+
+namespace {
+// pack pixels bit by bit, as a reference for the unpacking kernels
+std::vector<uint8_t>
+pack(ZarrPixelFormat format, const std::vector<uint16_t>& pixels)
+{
+    std::vector<uint8_t> packed(
+      zarr::bytes_of_pixels(format, pixels.size(), ZarrDataType_uint16), 0);
+
+    if (format == ZarrPixelFormat_Mono12Packed) {
+        for (auto i = 0; i < pixels.size(); ++i) {
+            auto* group = packed.data() + i / 2 * 3;
+            if (i % 2 == 0) {
+                group[0] = pixels[i] >> 4;
+                group[1] |= pixels[i] & 0x0f;
+            } else {
+                group[2] = pixels[i] >> 4;
+                group[1] |= (pixels[i] & 0x0f) << 4;
+            }
+        }
+        return packed;
+    }
+
+    // Mono10p and Mono12p are little-endian bit streams
+    const auto bits = format == ZarrPixelFormat_Mono10p ? 10 : 12;
+    for (auto i = 0; i < pixels.size(); ++i) {
+        for (auto b = 0; b < bits; ++b) {
+            const auto bit = i * bits + b;
+            if (pixels[i] >> b & 1) {
+                packed[bit / 8] |= 1 << bit % 8;
+            }
+        }
+    }
+
+    return packed;
+}
+
+void
+check_format(ZarrPixelFormat format, std::mt19937& rng)
+{
+    const auto bits = format == ZarrPixelFormat_Mono10p ? 10 : 12;
+    std::uniform_int_distribution<uint16_t> dist(0, (1 << bits) - 1);
+
+    const size_t n_px = 101;
+    std::vector<uint16_t> pixels(n_px);
+    for (auto& px : pixels) {
+        px = dist(rng);
+    }
+    const auto packed = pack(format, pixels);
+
+    // runs starting and ending at every offset within a pixel group
+    for (size_t first = 0; first < 8; ++first) {
+        for (size_t n = 0; first + n <= n_px; n += 7) {
+            std::vector<uint16_t> out(n, 0xffff);
+            zarr::unpack_pixels(format, packed.data(), first, n, out.data());
+            for (auto i = 0; i < n; ++i) {
+                EXPECT_EQ(int, out[i], pixels[first + i]);
+            }
+        }
+    }
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        EXPECT_EQ(int,
+                  zarr::bytes_of_pixels(
+                    ZarrPixelFormat_Native, 10, ZarrDataType_uint16),
+                  20);
+        EXPECT_EQ(int,
+                  zarr::bytes_of_pixels(
+                    ZarrPixelFormat_Mono10p, 10, ZarrDataType_uint16),
+                  15);
+        EXPECT_EQ(int,
+                  zarr::bytes_of_pixels(
+                    ZarrPixelFormat_Mono12p, 11, ZarrDataType_uint16),
+                  18);
+
+        std::mt19937 rng(85);
+        check_format(ZarrPixelFormat_Mono10p, rng);
+        check_format(ZarrPixelFormat_Mono12p, rng);
+        check_format(ZarrPixelFormat_Mono12Packed, rng);
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    return retval;
+}
@@ -0,0 +1,174 @@
+#include "zarr.reader.hh"
+#include "unit.test.macros.hh"
+
+#include <crc32c/crc32c.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const fs::path base_dir = fs::temp_directory_path() / TEST;
+
+// a single 4x6 shard of four 2x3 chunks
+const uint64_t array_height = 4, array_width = 6;
+const uint64_t chunk_height = 2, chunk_width = 3;
+
+uint8_t
+pixel_value(uint64_t y, uint64_t x)
+{
+    return static_cast<uint8_t>(1 + y * array_width + x);
+}
+
+nlohmann::json
+make_metadata(const std::string& inner_codec)
+{
+    return {
+        { "zarr_format", 3 },
+        { "node_type", "array" },
+        { "shape", { array_height, array_width } },
+        { "chunk_grid",
+          { { "name", "regular" },
+            { "configuration",
+              { { "chunk_shape", { array_height, array_width } } } } } },
+        { "chunk_key_encoding",
+          { { "name", "default" },
+            { "configuration", { { "separator", "/" } } } } },
+        { "data_type", "uint8" },
+        { "fill_value", 0 },
+        { "codecs",
+          { { { "name", "sharding_indexed" },
+              { "configuration",
+                { { "chunk_shape", { chunk_height, chunk_width } },
+                  { "codecs", { { { "name", inner_codec } } } },
+                  { "index_codecs",
+                    { { { "name", "bytes" },
+                        { "configuration", { { "endian", "little" } } } },
+                      { { "name", "crc32c" } } } },
+                  { "index_location", "end" } } } } } },
+    };
+}
+
+void
+write_array(const nlohmann::json& metadata)
+{
+    fs::create_directories(base_dir / "c" / "0");
+    std::ofstream(base_dir / "zarr.json") << metadata.dump(4);
+
+    // chunks are stored in reverse order, and chunk (1, 0) is never written
+    constexpr auto missing = std::numeric_limits<uint64_t>::max();
+    std::vector<uint8_t> shard;
+    uint64_t table[8] = { missing, missing, missing, missing,
+                          missing, missing, missing, missing };
+    for (int i = 3; i >= 0; --i) {
+        if (i == 2) {
+            continue;
+        }
+
+        const auto cy = i / 2, cx = i % 2;
+        table[2 * i] = shard.size();
+        table[2 * i + 1] = chunk_height * chunk_width;
+        for (auto y = 0; y < chunk_height; ++y) {
+            for (auto x = 0; x < chunk_width; ++x) {
+                shard.push_back(
+                  pixel_value(cy * chunk_height + y, cx * chunk_width + x));
+            }
+        }
+    }
+
+    const auto* table_bytes = reinterpret_cast<const uint8_t*>(table);
+    shard.insert(shard.end(), table_bytes, table_bytes + sizeof(table));
+    const uint32_t checksum = crc32c::Crc32c(table_bytes, sizeof(table));
+    const auto* checksum_bytes = reinterpret_cast<const uint8_t*>(&checksum);
+    shard.insert(
+      shard.end(), checksum_bytes, checksum_bytes + sizeof(checksum));
+
+    std::ofstream(base_dir / "c" / "0" / "0", std::ios::binary)
+      .write(reinterpret_cast<const char*>(shard.data()), shard.size());
+}
+
+void
+check_read_region()
+{
+    write_array(make_metadata("bytes"));
+
+    const ZarrReaderSettings settings{ .store_path = base_dir.c_str() };
+    ZarrReader_s reader(&settings);
+    EXPECT_EQ(int, reader.data_type(), ZarrDataType_uint8);
+    EXPECT_EQ(size_t, reader.shape().size(), 2);
+    EXPECT_EQ(uint64_t, reader.chunk_shape()[1], chunk_width);
+
+    const uint64_t offset[2] = { 0, 0 };
+    const uint64_t shape[2] = { array_height, array_width };
+    std::vector<uint8_t> region(array_height * array_width, 0xff);
+    EXPECT_EQ(int,
+              reader.read_region(offset, shape, region.data(), region.size()),
+              ZarrStatusCode_Success);
+
+    for (auto y = 0; y < array_height; ++y) {
+        for (auto x = 0; x < array_width; ++x) {
+            const auto expected =
+              (y >= chunk_height && x < chunk_width) ? 0 : pixel_value(y, x);
+            EXPECT_EQ(int, region[y * array_width + x], expected);
+        }
+    }
+
+    // a window straddling all four chunks
+    const uint64_t window_offset[2] = { 1, 2 };
+    const uint64_t window_shape[2] = { 2, 2 };
+    uint8_t window[4];
+    EXPECT_EQ(int,
+              reader.read_region(window_offset, window_shape, window, 4),
+              ZarrStatusCode_Success);
+    EXPECT_EQ(int, window[0], pixel_value(1, 2));
+    EXPECT_EQ(int, window[1], pixel_value(1, 3));
+    EXPECT_EQ(int, window[2], 0);
+    EXPECT_EQ(int, window[3], pixel_value(2, 3));
+
+    const uint64_t past_end[2] = { 3, 0 };
+    EXPECT_EQ(int,
+              reader.read_region(past_end, window_shape, window, 4),
+              ZarrStatusCode_InvalidIndex);
+}
+
+void
+check_unsupported_codec()
+{
+    write_array(make_metadata("transpose"));
+
+    const ZarrReaderSettings settings{ .store_path = base_dir.c_str() };
+    bool threw = false;
+    try {
+        ZarrReader_s reader(&settings);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    EXPECT(threw, "Expected an unsupported codec to be rejected");
+}
+} // namespace
+
+int
+main()
+{
+    int retval = 1;
+
+    try {
+        check_read_region();
+        check_unsupported_codec();
+
+        retval = 0;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Test failed: ", e.what());
+    }
+
+    if (fs::exists(base_dir)) {
+        fs::remove_all(base_dir);
+    }
+
+    return retval;
+}